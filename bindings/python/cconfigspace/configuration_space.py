@@ -27,6 +27,7 @@ ccs_configuration_space_check_configuration_values = _ccs_get_function("ccs_conf
 ccs_configuration_space_get_default_configuration = _ccs_get_function("ccs_configuration_space_get_default_configuration", [ccs_configuration_space, ct.POINTER(ccs_configuration)])
 ccs_configuration_space_sample = _ccs_get_function("ccs_configuration_space_sample", [ccs_configuration_space, ct.POINTER(ccs_configuration)])
 ccs_configuration_space_samples = _ccs_get_function("ccs_configuration_space_samples", [ccs_configuration_space, ct.c_size_t, ct.POINTER(ccs_configuration)])
+ccs_configuration_space_get_neighbors = _ccs_get_function("ccs_configuration_space_get_neighbors", [ccs_configuration_space, ccs_configuration, ct.c_size_t, ccs_rng, ct.POINTER(ccs_configuration)])
 
 class ConfigurationSpace(Context):
   def __init__(self, handle = None, retain = False, auto_release = True,
@@ -229,4 +230,12 @@ class ConfigurationSpace(Context):
     Error.check(res)
     return [Configuration(handle = ccs_configuration(x), retain = False) for x in v]
 
+  def neighbors(self, configuration, count, rng = None):
+    if count == 0:
+      return []
+    v = (ccs_configuration * count)()
+    res = ccs_configuration_space_get_neighbors(self.handle, configuration.handle, count, rng.handle if rng else None, v)
+    Error.check(res)
+    return [Configuration(handle = ccs_configuration(x), retain = False) for x in v]
+
 from .configuration import Configuration
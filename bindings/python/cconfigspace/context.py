@@ -11,6 +11,8 @@ ccs_context_get_parameter_index = _ccs_get_function("ccs_context_get_parameter_i
 ccs_context_get_parameter_indexes = _ccs_get_function("ccs_context_get_parameter_indexes", [ccs_context, ct.c_size_t, ct.POINTER(ccs_parameter), ct.POINTER(ct.c_size_t)])
 ccs_context_get_parameters = _ccs_get_function("ccs_context_get_parameters", [ccs_context, ct.c_size_t, ct.POINTER(ccs_parameter), ct.POINTER(ct.c_size_t)])
 ccs_context_validate_value = _ccs_get_function("ccs_context_validate_value", [ccs_context, ct.c_size_t, DatumFix, ct.POINTER(Datum)])
+ccs_context_set_binding_pool_capacity = _ccs_get_function("ccs_context_set_binding_pool_capacity", [ccs_context, ct.c_size_t])
+ccs_context_get_binding_pool_capacity = _ccs_get_function("ccs_context_get_binding_pool_capacity", [ccs_context, ct.POINTER(ct.c_size_t)])
 
 class Context(Object):
 
@@ -76,3 +78,15 @@ class Context(Object):
     res = ccs_context_validate_value(self.handle, parameter, v, ct.byref(vo))
     Error.check(res)
     return vo.value
+
+  @property
+  def binding_pool_capacity(self):
+    v = ct.c_size_t(0)
+    res = ccs_context_get_binding_pool_capacity(self.handle, ct.byref(v))
+    Error.check(res)
+    return v.value
+
+  @binding_pool_capacity.setter
+  def binding_pool_capacity(self, capacity):
+    res = ccs_context_set_binding_pool_capacity(self.handle, capacity)
+    Error.check(res)
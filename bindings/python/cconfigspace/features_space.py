@@ -8,6 +8,9 @@ ccs_features_space_add_parameter = _ccs_get_function("ccs_features_space_add_par
 ccs_features_space_add_parameters = _ccs_get_function("ccs_features_space_add_parameters", [ccs_features_space, ct.c_size_t, ct.POINTER(ccs_parameter)])
 ccs_features_space_check_features = _ccs_get_function("ccs_features_space_check_features", [ccs_features_space, ccs_features, ct.POINTER(ccs_bool)])
 ccs_features_space_check_features_values = _ccs_get_function("ccs_features_space_check_features_values", [ccs_features_space, ct.c_size_t, ct.POINTER(Datum), ct.POINTER(ccs_bool)])
+ccs_features_space_intern_features = _ccs_get_function("ccs_features_space_intern_features", [ccs_features_space, ct.c_size_t, ct.POINTER(Datum), ct.POINTER(ccs_features)])
+ccs_features_space_set_interned_features_capacity = _ccs_get_function("ccs_features_space_set_interned_features_capacity", [ccs_features_space, ct.c_size_t])
+ccs_features_space_get_interned_features_capacity = _ccs_get_function("ccs_features_space_get_interned_features_capacity", [ccs_features_space, ct.POINTER(ct.c_size_t)])
 
 class FeaturesSpace(Context):
   def __init__(self, handle = None, retain = False, auto_release = True,
@@ -54,3 +57,28 @@ class FeaturesSpace(Context):
     res = ccs_features_space_check_features_values(self.handle, count, v, ct.byref(valid))
     Error.check(res)
     return False if valid.value == 0 else True
+
+  def intern_features(self, values):
+    count = len(values)
+    v = (Datum * count)()
+    ss = []
+    for i in range(count):
+      v[i].set_value(values[i], string_store = ss)
+    handle = ccs_features()
+    res = ccs_features_space_intern_features(self.handle, count, v, ct.byref(handle))
+    Error.check(res)
+    return Features(handle = handle, retain = False)
+
+  @property
+  def interned_features_capacity(self):
+    v = ct.c_size_t(0)
+    res = ccs_features_space_get_interned_features_capacity(self.handle, ct.byref(v))
+    Error.check(res)
+    return v.value
+
+  @interned_features_capacity.setter
+  def interned_features_capacity(self, capacity):
+    res = ccs_features_space_set_interned_features_capacity(self.handle, capacity)
+    Error.check(res)
+
+from .features import Features
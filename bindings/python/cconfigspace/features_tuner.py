@@ -19,11 +19,16 @@ ccs_features_tuner_get_name = _ccs_get_function("ccs_features_tuner_get_name", [
 ccs_features_tuner_get_configuration_space = _ccs_get_function("ccs_features_tuner_get_configuration_space", [ccs_features_tuner, ct.POINTER(ccs_configuration_space)])
 ccs_features_tuner_get_objective_space = _ccs_get_function("ccs_features_tuner_get_objective_space", [ccs_features_tuner, ct.POINTER(ccs_objective_space)])
 ccs_features_tuner_get_features_space = _ccs_get_function("ccs_features_tuner_get_features_space", [ccs_features_tuner, ct.POINTER(ccs_features_space)])
+ccs_features_tuner_set_nearest_features = _ccs_get_function("ccs_features_tuner_set_nearest_features", [ccs_features_tuner, ct.c_size_t])
+ccs_features_tuner_get_nearest_features = _ccs_get_function("ccs_features_tuner_get_nearest_features", [ccs_features_tuner, ct.POINTER(ct.c_size_t)])
+ccs_features_tuner_set_suggestion_cache_capacity = _ccs_get_function("ccs_features_tuner_set_suggestion_cache_capacity", [ccs_features_tuner, ct.c_size_t])
+ccs_features_tuner_get_suggestion_cache_capacity = _ccs_get_function("ccs_features_tuner_get_suggestion_cache_capacity", [ccs_features_tuner, ct.POINTER(ct.c_size_t)])
 ccs_features_tuner_ask = _ccs_get_function("ccs_features_tuner_ask", [ccs_features_tuner, ccs_features, ct.c_size_t, ct.POINTER(ccs_configuration), ct.POINTER(ct.c_size_t)])
 ccs_features_tuner_tell = _ccs_get_function("ccs_features_tuner_tell", [ccs_features_tuner, ct.c_size_t, ct.POINTER(ccs_features_evaluation)])
 ccs_features_tuner_get_optima = _ccs_get_function("ccs_features_tuner_get_optima", [ccs_features_tuner, ccs_features, ct.c_size_t, ct.POINTER(ccs_features_evaluation), ct.POINTER(ct.c_size_t)])
 ccs_features_tuner_get_history = _ccs_get_function("ccs_features_tuner_get_history", [ccs_features_tuner, ccs_features, ct.c_size_t, ct.POINTER(ccs_features_evaluation), ct.POINTER(ct.c_size_t)])
 ccs_features_tuner_suggest = _ccs_get_function("ccs_features_tuner_suggest", [ccs_features_tuner, ccs_features, ct.POINTER(ccs_configuration)])
+ccs_features_tuner_suggest_values = _ccs_get_function("ccs_features_tuner_suggest_values", [ccs_features_tuner, ct.c_size_t, ct.POINTER(Datum), ct.c_size_t, ct.POINTER(Datum), ct.POINTER(ct.c_size_t)])
 
 class FeaturesTuner(Object):
   @classmethod
@@ -89,6 +94,30 @@ class FeaturesTuner(Object):
     self._configuration_space = ConfigurationSpace.from_handle(v)
     return self._configuration_space
 
+  @property
+  def nearest_features(self):
+    v = ct.c_size_t()
+    res = ccs_features_tuner_get_nearest_features(self.handle, ct.byref(v))
+    Error.check(res)
+    return v.value
+
+  @nearest_features.setter
+  def nearest_features(self, count):
+    res = ccs_features_tuner_set_nearest_features(self.handle, count)
+    Error.check(res)
+
+  @property
+  def suggestion_cache_capacity(self):
+    v = ct.c_size_t()
+    res = ccs_features_tuner_get_suggestion_cache_capacity(self.handle, ct.byref(v))
+    Error.check(res)
+    return v.value
+
+  @suggestion_cache_capacity.setter
+  def suggestion_cache_capacity(self, capacity):
+    res = ccs_features_tuner_set_suggestion_cache_capacity(self.handle, capacity)
+    Error.check(res)
+
   def ask(self, features, count = 1):
     v = (ccs_configuration * count)()
     c = ct.c_size_t()
@@ -143,6 +172,18 @@ class FeaturesTuner(Object):
     Error.check(res)
     return Configuration(handle = config, retain = False)
 
+  def suggest_values(self, features_values):
+    count = len(features_values)
+    v = (Datum * count)()
+    ss = []
+    for i in range(count):
+      v[i].set_value(features_values[i], string_store = ss)
+    sz = self.configuration_space.num_parameters
+    vals = (Datum * sz)()
+    res = ccs_features_tuner_suggest_values(self.handle, count, v, sz, vals, None)
+    Error.check(res)
+    return [x.value for x in vals]
+
 ccs_create_random_features_tuner = _ccs_get_function("ccs_create_random_features_tuner", [ct.c_char_p, ccs_configuration_space, ccs_features_space, ccs_objective_space, ct.POINTER(ccs_features_tuner)])
 
 class RandomFeaturesTuner(FeaturesTuner):
@@ -1,6 +1,6 @@
 import ctypes as ct
 from . import libcconfigspace
-from .base import Object, Error, Result, ccs_rng, ccs_tree, ccs_tree_space, ccs_tree_configuration, Datum, ccs_bool, _ccs_get_function, CEnumeration, _register_vector, _unregister_vector, ccs_retain_object
+from .base import Object, Error, Result, ccs_rng, ccs_tree, ccs_tree_space, ccs_tree_configuration, ccs_tree_evaluation, Datum, ccs_bool, _ccs_get_function, CEnumeration, _register_vector, _unregister_vector, _register_callback, ccs_retain_object
 from .rng import Rng
 from .tree import Tree
 
@@ -20,6 +20,9 @@ ccs_tree_space_check_position = _ccs_get_function("ccs_tree_space_check_position
 ccs_tree_space_check_configuration = _ccs_get_function("ccs_tree_space_check_configuration", [ccs_tree_space, ccs_tree_configuration, ct.POINTER(ccs_bool)])
 ccs_tree_space_sample = _ccs_get_function("ccs_tree_space_sample", [ccs_tree_space, ct.POINTER(ccs_tree_configuration)])
 ccs_tree_space_samples = _ccs_get_function("ccs_tree_space_samples", [ccs_tree_space, ct.c_size_t, ct.POINTER(ccs_tree_configuration)])
+ccs_tree_space_transposition_key_callback_type = ct.CFUNCTYPE(Result, ccs_tree_space, ct.c_size_t, ct.POINTER(Datum), ct.c_void_p, ct.POINTER(Datum))
+ccs_tree_space_set_transposition_table = _ccs_get_function("ccs_tree_space_set_transposition_table", [ccs_tree_space, ccs_tree_space_transposition_key_callback_type, ct.c_void_p, ct.c_size_t])
+ccs_tree_space_get_transposition = _ccs_get_function("ccs_tree_space_get_transposition", [ccs_tree_space, ccs_tree_configuration, ct.POINTER(ccs_tree_evaluation)])
 
 class TreeSpace(Object):
 
@@ -122,8 +125,40 @@ class TreeSpace(Object):
     Error.check(res)
     return [TreeConfiguration(handle = ccs_tree_configuration(x), retain = False) for x in v]
 
+  def set_transposition_table(self, key, capacity = 1024):
+    if key is None:
+      res = ccs_tree_space_set_transposition_table(self.handle, ccs_tree_space_transposition_key_callback_type(), None, 0)
+      Error.check(res)
+      return
+    last_key = [None]
+    def key_wrapper(ts, num_values, values, data, p_key):
+      try:
+        ts = ct.cast(ts, ccs_tree_space)
+        k = Datum(key(TreeSpace.from_handle(ts), [values[i].value for i in range(num_values)]))
+        # keeps strings alive until the key is copied
+        last_key[0] = k
+        p_key[0] = k
+        return Result.SUCCESS
+      except Exception as e:
+        return Error.set_error(e)
+    key_wrapper_func = ccs_tree_space_transposition_key_callback_type(key_wrapper)
+    res = ccs_tree_space_set_transposition_table(self.handle, key_wrapper_func, None, capacity)
+    Error.check(res)
+    _register_callback(self.handle, [key_wrapper, key_wrapper_func, last_key])
+
+  def get_transposition(self, configuration):
+    v = ccs_tree_evaluation()
+    res = ccs_tree_space_get_transposition(self.handle, configuration.handle, ct.byref(v))
+    Error.check(res)
+    if v.value is None:
+      return None
+    return TreeEvaluation(handle = v, retain = False)
+
 
 ccs_create_static_tree_space = _ccs_get_function("ccs_create_static_tree_space", [ct.c_char_p, ccs_tree, ct.POINTER(ccs_tree_space)])
+ccs_static_tree_space_freeze = _ccs_get_function("ccs_static_tree_space_freeze", [ccs_tree_space])
+ccs_static_tree_space_thaw = _ccs_get_function("ccs_static_tree_space_thaw", [ccs_tree_space])
+ccs_static_tree_space_is_frozen = _ccs_get_function("ccs_static_tree_space_is_frozen", [ccs_tree_space, ct.POINTER(ccs_bool)])
 
 class StaticTreeSpace(TreeSpace):
 
@@ -137,6 +172,21 @@ class StaticTreeSpace(TreeSpace):
     else:
       super().__init__(handle = handle, retain = retain, auto_release = auto_release)
 
+  def freeze(self):
+    res = ccs_static_tree_space_freeze(self.handle)
+    Error.check(res)
+
+  def thaw(self):
+    res = ccs_static_tree_space_thaw(self.handle)
+    Error.check(res)
+
+  @property
+  def frozen(self):
+    v = ccs_bool()
+    res = ccs_static_tree_space_is_frozen(self.handle, ct.byref(v))
+    Error.check(res)
+    return False if v.value == 0 else True
+
 TreeSpace.Static = StaticTreeSpace
 
 ccs_dynamic_tree_space_del_type = ct.CFUNCTYPE(Result, ccs_tree_space)
@@ -153,6 +203,8 @@ class DynamicTreeSpaceVector(ct.Structure):
 
 ccs_create_dynamic_tree_space = _ccs_get_function("ccs_create_dynamic_tree_space", [ct.c_char_p, ccs_tree, ct.POINTER(DynamicTreeSpaceVector), ct.py_object, ct.POINTER(ccs_tree_space)])
 ccs_dynamic_tree_space_get_tree_space_data = _ccs_get_function("ccs_dynamic_tree_space_get_tree_space_data", [ccs_tree_space, ct.POINTER(ct.c_void_p)])
+ccs_dynamic_tree_space_set_prefetch = _ccs_get_function("ccs_dynamic_tree_space_set_prefetch", [ccs_tree_space, ct.c_size_t, ct.c_size_t, ct.c_size_t])
+ccs_dynamic_tree_space_get_prefetch = _ccs_get_function("ccs_dynamic_tree_space_get_prefetch", [ccs_tree_space, ct.POINTER(ct.c_size_t), ct.POINTER(ct.c_size_t), ct.POINTER(ct.c_size_t)])
 
 def _wrap_user_defined_callbacks(delete, get_child, serialize, deserialize):
   def delete_wrapper(ts):
@@ -169,7 +221,11 @@ def _wrap_user_defined_callbacks(delete, get_child, serialize, deserialize):
     try:
       ts = ct.cast(ts, ccs_tree_space)
       parent = ct.cast(parent, ccs_tree)
-      child = get_child(TreeSpace.from_handle(ts), Tree.from_handle(parent), index)
+      # may run on a prefetch worker thread, where reference counts must not
+      # be updated: the tree space and parent are borrowed
+      ts = DynamicTreeSpace(handle = ts, retain = False, auto_release = False)
+      parent = Tree(handle = parent, retain = False, auto_release = False)
+      child = get_child(ts, parent, index)
       res = ccs_retain_object(child.handle)
       Error.check(res)
       p_child[0] = child.handle.value
@@ -289,6 +345,20 @@ class DynamicTreeSpace(TreeSpace):
       self._tree_space_data = None
     return self._tuner_data
 
+  def set_prefetch(self, num_threads, depth = 1, max_pending = 64):
+    res = ccs_dynamic_tree_space_set_prefetch(self.handle, num_threads, depth, max_pending)
+    Error.check(res)
+
+  @property
+  def prefetch(self):
+    num_threads = ct.c_size_t()
+    depth = ct.c_size_t()
+    max_pending = ct.c_size_t()
+    res = ccs_dynamic_tree_space_get_prefetch(self.handle, ct.byref(num_threads), ct.byref(depth), ct.byref(max_pending))
+    Error.check(res)
+    return (num_threads.value, depth.value, max_pending.value)
+
 TreeSpace.Dynamic = DynamicTreeSpace
 
 from .tree_configuration import TreeConfiguration
+from .tree_evaluation import TreeEvaluation
@@ -1,5 +1,5 @@
 import ctypes as ct
-from .base import Object, Error, CEnumeration, Result, _ccs_get_function, ccs_context, ccs_parameter, ccs_tree_space, ccs_tree_configuration, Datum, ccs_objective_space, ccs_tree_evaluation, ccs_tree_tuner, ccs_retain_object, _register_vector, _unregister_vector
+from .base import Object, Error, CEnumeration, Result, _ccs_get_function, ccs_context, ccs_float, ccs_parameter, ccs_tree_space, ccs_tree_configuration, Datum, ccs_objective_space, ccs_tree_evaluation, ccs_tree_tuner, ccs_retain_object, _register_vector, _unregister_vector
 from .context import Context
 from .parameter import Parameter
 from .tree_space import TreeSpace
@@ -10,7 +10,8 @@ from .tree_evaluation import TreeEvaluation
 class TreeTunerType(CEnumeration):
   _members_ = [
     ('RANDOM',0),
-    'USER_DEFINED' ]
+    'USER_DEFINED',
+    'MCTS' ]
 
 ccs_tree_tuner_get_type = _ccs_get_function("ccs_tree_tuner_get_type", [ccs_tree_tuner, ct.POINTER(TreeTunerType)])
 ccs_tree_tuner_get_name = _ccs_get_function("ccs_tree_tuner_get_name", [ccs_tree_tuner, ct.POINTER(ct.c_char_p)])
@@ -33,6 +34,8 @@ class TreeTuner(Object):
       return RandomTreeTuner(handle = handle, retain = retain, auto_release = auto_release)
     elif v == TreeTunerType.USER_DEFINED:
       return UserDefinedTreeTuner(handle = handle, retain = retain, auto_release = auto_release)
+    elif v == TreeTunerType.MCTS:
+      return MctsTreeTuner(handle = handle, retain = retain, auto_release = auto_release)
     else:
       raise Error(Result(Result.ERROR_INVALID_TREE_TUNER))
 
@@ -142,6 +145,32 @@ class RandomTreeTuner(TreeTuner):
 
 TreeTuner.Random = RandomTreeTuner
 
+ccs_create_mcts_tree_tuner = _ccs_get_function("ccs_create_mcts_tree_tuner", [ct.c_char_p, ccs_tree_space, ccs_objective_space, ccs_float, ct.POINTER(ccs_tree_tuner)])
+ccs_mcts_tree_tuner_get_properties = _ccs_get_function("ccs_mcts_tree_tuner_get_properties", [ccs_tree_tuner, ct.POINTER(ccs_float)])
+
+class MctsTreeTuner(TreeTuner):
+  def __init__(self, handle = None, retain = False, auto_release = True,
+               name = "", tree_space = None, objective_space = None, exploration = 0.0):
+    if handle is None:
+      handle = ccs_tree_tuner()
+      res = ccs_create_mcts_tree_tuner(str.encode(name), tree_space.handle, objective_space.handle, exploration, ct.byref(handle))
+      Error.check(res)
+      super().__init__(handle = handle, retain = False)
+    else:
+      super().__init__(handle = handle, retain = retain, auto_release = auto_release)
+
+  @property
+  def exploration(self):
+    if hasattr(self, "_exploration"):
+      return self._exploration
+    v = ccs_float()
+    res = ccs_mcts_tree_tuner_get_properties(self.handle, ct.byref(v))
+    Error.check(res)
+    self._exploration = v.value
+    return self._exploration
+
+TreeTuner.Mcts = MctsTreeTuner
+
 ccs_user_defined_tree_tuner_del_type = ct.CFUNCTYPE(Result, ccs_tree_tuner)
 ccs_user_defined_tree_tuner_ask_type = ct.CFUNCTYPE(Result, ccs_tree_tuner, ct.c_size_t, ct.POINTER(ccs_tree_configuration), ct.POINTER(ct.c_size_t))
 ccs_user_defined_tree_tuner_tell_type = ct.CFUNCTYPE(Result, ccs_tree_tuner, ct.c_size_t, ct.POINTER(ccs_tree_evaluation))
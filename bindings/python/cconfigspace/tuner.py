@@ -1,5 +1,5 @@
 import ctypes as ct
-from .base import Object, Error, CEnumeration, Result, _ccs_get_function, ccs_context, ccs_parameter, ccs_configuration_space, ccs_configuration, Datum, ccs_objective_space, ccs_evaluation, ccs_tuner, ccs_retain_object, _register_vector, _unregister_vector
+from .base import Object, Error, CEnumeration, Result, _ccs_get_function, ccs_float, ccs_context, ccs_parameter, ccs_configuration_space, ccs_configuration, Datum, ccs_objective_space, ccs_evaluation, ccs_tuner, ccs_retain_object, _register_vector, _unregister_vector
 from .context import Context
 from .parameter import Parameter
 from .configuration_space import ConfigurationSpace
@@ -10,7 +10,10 @@ from .evaluation import Evaluation
 class TunerType(CEnumeration):
   _members_ = [
     ('RANDOM',0),
-    'USER_DEFINED' ]
+    'USER_DEFINED',
+    'TPE',
+    'HYPERBAND',
+    'CMA_ES' ]
 
 ccs_tuner_get_type = _ccs_get_function("ccs_tuner_get_type", [ccs_tuner, ct.POINTER(TunerType)])
 ccs_tuner_get_name = _ccs_get_function("ccs_tuner_get_name", [ccs_tuner, ct.POINTER(ct.c_char_p)])
@@ -33,6 +36,12 @@ class Tuner(Object):
       return RandomTuner(handle = handle, retain = retain, auto_release = auto_release)
     elif v == TunerType.USER_DEFINED:
       return UserDefinedTuner(handle = handle, retain = retain, auto_release = auto_release)
+    elif v == TunerType.TPE:
+      return TpeTuner(handle = handle, retain = retain, auto_release = auto_release)
+    elif v == TunerType.HYPERBAND:
+      return HyperbandTuner(handle = handle, retain = retain, auto_release = auto_release)
+    elif v == TunerType.CMA_ES:
+      return CmaEsTuner(handle = handle, retain = retain, auto_release = auto_release)
     else:
       raise Error(Result(Result.ERROR_INVALID_TUNER))
 
@@ -142,6 +151,93 @@ class RandomTuner(Tuner):
 
 Tuner.Random = RandomTuner
 
+ccs_create_tpe_tuner = _ccs_get_function("ccs_create_tpe_tuner", [ct.c_char_p, ccs_configuration_space, ccs_objective_space, ct.POINTER(ccs_tuner)])
+
+class TpeTuner(Tuner):
+  def __init__(self, handle = None, retain = False, auto_release = True,
+               name = "", configuration_space = None, objective_space = None):
+    if handle is None:
+      handle = ccs_tuner()
+      res = ccs_create_tpe_tuner(str.encode(name), configuration_space.handle, objective_space.handle, ct.byref(handle))
+      Error.check(res)
+      super().__init__(handle = handle, retain = False)
+    else:
+      super().__init__(handle = handle, retain = retain, auto_release = auto_release)
+
+Tuner.Tpe = TpeTuner
+
+ccs_create_hyperband_tuner = _ccs_get_function("ccs_create_hyperband_tuner", [ct.c_char_p, ccs_configuration_space, ccs_objective_space, ct.c_size_t, ccs_float, ct.POINTER(ccs_tuner)])
+ccs_hyperband_tuner_get_properties = _ccs_get_function("ccs_hyperband_tuner_get_properties", [ccs_tuner, ct.POINTER(ct.c_size_t), ct.POINTER(ccs_float)])
+
+class HyperbandTuner(Tuner):
+  def __init__(self, handle = None, retain = False, auto_release = True,
+               name = "", configuration_space = None, objective_space = None, fidelity_index = 0, eta = 3.0):
+    if handle is None:
+      handle = ccs_tuner()
+      res = ccs_create_hyperband_tuner(str.encode(name), configuration_space.handle, objective_space.handle, fidelity_index, eta, ct.byref(handle))
+      Error.check(res)
+      super().__init__(handle = handle, retain = False)
+    else:
+      super().__init__(handle = handle, retain = retain, auto_release = auto_release)
+
+  @property
+  def fidelity_index(self):
+    if hasattr(self, "_fidelity_index"):
+      return self._fidelity_index
+    v = ct.c_size_t()
+    res = ccs_hyperband_tuner_get_properties(self.handle, ct.byref(v), None)
+    Error.check(res)
+    self._fidelity_index = v.value
+    return self._fidelity_index
+
+  @property
+  def eta(self):
+    if hasattr(self, "_eta"):
+      return self._eta
+    v = ccs_float()
+    res = ccs_hyperband_tuner_get_properties(self.handle, None, ct.byref(v))
+    Error.check(res)
+    self._eta = v.value
+    return self._eta
+
+Tuner.Hyperband = HyperbandTuner
+
+ccs_create_cma_es_tuner = _ccs_get_function("ccs_create_cma_es_tuner", [ct.c_char_p, ccs_configuration_space, ccs_objective_space, ct.c_size_t, ccs_float, ct.POINTER(ccs_tuner)])
+ccs_cma_es_tuner_get_properties = _ccs_get_function("ccs_cma_es_tuner_get_properties", [ccs_tuner, ct.POINTER(ct.c_size_t), ct.POINTER(ccs_float)])
+
+class CmaEsTuner(Tuner):
+  def __init__(self, handle = None, retain = False, auto_release = True,
+               name = "", configuration_space = None, objective_space = None, population_size = 0, sigma = 0.0):
+    if handle is None:
+      handle = ccs_tuner()
+      res = ccs_create_cma_es_tuner(str.encode(name), configuration_space.handle, objective_space.handle, population_size, sigma, ct.byref(handle))
+      Error.check(res)
+      super().__init__(handle = handle, retain = False)
+    else:
+      super().__init__(handle = handle, retain = retain, auto_release = auto_release)
+
+  @property
+  def population_size(self):
+    if hasattr(self, "_population_size"):
+      return self._population_size
+    v = ct.c_size_t()
+    res = ccs_cma_es_tuner_get_properties(self.handle, ct.byref(v), None)
+    Error.check(res)
+    self._population_size = v.value
+    return self._population_size
+
+  @property
+  def sigma(self):
+    if hasattr(self, "_sigma"):
+      return self._sigma
+    v = ccs_float()
+    res = ccs_cma_es_tuner_get_properties(self.handle, None, ct.byref(v))
+    Error.check(res)
+    self._sigma = v.value
+    return self._sigma
+
+Tuner.CmaEs = CmaEsTuner
+
 ccs_user_defined_tuner_del_type = ct.CFUNCTYPE(Result, ccs_tuner)
 ccs_user_defined_tuner_ask_type = ct.CFUNCTYPE(Result, ccs_tuner, ct.c_size_t, ct.POINTER(ccs_configuration), ct.POINTER(ct.c_size_t))
 ccs_user_defined_tuner_tell_type = ct.CFUNCTYPE(Result, ccs_tuner, ct.c_size_t, ct.POINTER(ccs_evaluation))
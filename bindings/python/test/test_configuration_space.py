@@ -33,6 +33,11 @@ class TestConfigurationSpace(unittest.TestCase):
     self.assertTrue( cs.check_values(cs.sample().values) )
     for c in cs.samples(100):
       self.assertTrue( cs.check(c) )
+    c = cs.sample()
+    for n in cs.neighbors(c, 100):
+      self.assertTrue( cs.check(n) )
+      self.assertEqual( 1, sum(a != b for a, b in zip(c.values, n.values)) )
+    self.assertEqual( 10, len(cs.neighbors(c, 10, rng = ccs.Rng())) )
 
   def test_set_distribution(self):
     cs = ccs.ConfigurationSpace(name = "space")
@@ -24,5 +24,27 @@ class TestFeaturesSpace(unittest.TestCase):
     self.assertEqual( [h1, h2, h3], cs.parameters )
     self.assertEqual( h2, cs.parameter_by_name(h2.name) )
 
+  def test_intern_features(self):
+    fs = ccs.FeaturesSpace(name = "space")
+    h1 = ccs.NumericalParameter.Float(lower = 0.0, upper = 1.0)
+    h2 = ccs.CategoricalParameter(values = ["small", "large"])
+    fs.add_parameters([h1, h2])
+    self.assertEqual( 64, fs.interned_features_capacity )
+    f1 = fs.intern_features([0.5, "large"])
+    f2 = fs.intern_features([0.5, "large"])
+    self.assertEqual( f1.handle.value, f2.handle.value )
+    self.assertEqual( 2, f1.refcount )
+    self.assertEqual( [0.5, "large"], f1.values )
+    f3 = ccs.Features(features_space = fs, values = [0.5, "large"])
+    self.assertEqual( f1, f3 )
+    self.assertEqual( f1.hash, f3.hash )
+    self.assertNotEqual( f1.handle.value, f3.handle.value )
+    with self.assertRaises( ccs.Error ):
+      f1.set_value(0, 0.2)
+    with self.assertRaises( ccs.Error ):
+      fs.intern_features([2.0, "large"])
+    fs.interned_features_capacity = 0
+    self.assertEqual( 0, fs.interned_features_capacity )
+
 if __name__ == '__main__':
     unittest.main()
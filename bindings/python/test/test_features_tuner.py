@@ -66,6 +66,46 @@ class TestFeaturesTuner(unittest.TestCase):
     optims_2 = t_copy.optima()
     self.assertEqual(len(optims_ref), len(optims_2))
 
+  def test_nearest_features(self):
+    (cs, fs, os) = self.create_tuning_problem()
+    t = ccs.RandomFeaturesTuner(name = "tuner", configuration_space = cs, features_space = fs, objective_space = os)
+    self.assertEqual(0, t.nearest_features)
+    with self.assertRaises( ccs.Error ):
+      t.nearest_features = 2
+    fs = ccs.FeaturesSpace(name = "sizes")
+    fs.add_parameter(ccs.NumericalParameter.Float(lower = 0.0, upper = 100.0))
+    t = ccs.RandomFeaturesTuner(name = "tuner", configuration_space = cs, features_space = fs, objective_space = os)
+    t.nearest_features = 2
+    self.assertEqual(2, t.nearest_features)
+    func = lambda x, y, z: [(x-2)*(x-2), sin(z+y)]
+    features = ccs.Features(features_space = fs, values = [10.0])
+    evals = [ccs.FeaturesEvaluation(objective_space = os, configuration = c, features = features, values = func(*(c.values))) for c in t.ask(features, 20)]
+    t.tell(evals)
+    optims = [x.configuration for x in t.optima(features = features)]
+    unseen = ccs.Features(features_space = fs, values = [12.0])
+    self.assertTrue(t.suggest(unseen) in optims)
+    self.assertTrue(t.ask(unseen, 1)[0] in optims)
+
+  def test_suggest_values(self):
+    (cs, fs, os) = self.create_tuning_problem()
+    t = ccs.RandomFeaturesTuner(name = "tuner", configuration_space = cs, features_space = fs, objective_space = os)
+    func = lambda x, y, z: [(x-2)*(x-2), sin(z+y)]
+    features_on = ccs.Features(features_space = fs, values = [True])
+    self.assertEqual(1024, t.suggestion_cache_capacity)
+    values = t.suggest_values([True])
+    self.assertEqual(3, len(values))
+    evals = [ccs.FeaturesEvaluation(objective_space = os, configuration = c, features = features_on, values = func(*(c.values))) for c in t.ask(features_on, 50)]
+    t.tell(evals)
+    optims = [x.configuration.values for x in t.optima(features = features_on)]
+    self.assertTrue(t.suggest_values([True]) in optims)
+    self.assertEqual(t.suggest_values([True]), t.suggest_values([True]))
+    self.assertTrue(t.suggest(features_on).values in optims)
+    t.suggestion_cache_capacity = 0
+    self.assertEqual(0, t.suggestion_cache_capacity)
+    self.assertTrue(t.suggest_values([True]) in optims)
+    with self.assertRaises( ccs.Error ):
+      t.suggest_values([])
+
 
   def test_user_defined(self):
     class TunerData:
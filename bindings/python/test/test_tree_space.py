@@ -43,6 +43,25 @@ class TestTreeSpace(unittest.TestCase):
     ts2 = ccs.Object.deserialize(buffer = buff)
     self.assertEqual( [400, 301, 201], ts2.get_values_at_position([1, 1]) )
 
+  def test_frozen_tree_space(self):
+    tree = generate_tree(4, 0)
+    ts = ccs.StaticTreeSpace(name = 'space', tree = tree)
+    self.assertFalse( ts.frozen )
+    ts.freeze()
+    self.assertTrue( ts.frozen )
+    self.assertEqual( 201, ts.get_node_at_position([1, 1]).value )
+    self.assertEqual( [400, 301, 201], ts.get_values_at_position([1, 1]) )
+    self.assertTrue( ts.check_position([1, 1]) )
+    self.assertFalse( ts.check_position([1, 4]) )
+    for x in ts.samples(100):
+      self.assertTrue( ts.check_configuration(x) )
+    with self.assertRaises( ccs.Error ):
+      tree.weight = 2.0
+    ts.thaw()
+    self.assertFalse( ts.frozen )
+    tree.weight = 2.0
+    self.assertEqual( 2.0, tree.weight )
+
   def test_dynamic_tree_space(self):
 
     def delete(tree_space):
@@ -79,6 +98,32 @@ class TestTreeSpace(unittest.TestCase):
     ts2 = ccs.DynamicTreeSpace.deserialize(buffer = buff, delete = delete, get_child = get_child)
     self.assertEqual( [400, 301, 201], ts2.get_values_at_position([1, 1]) )
 
+  def test_dynamic_tree_space_prefetch(self):
+
+    def get_child(tree_space, parent, child_index):
+      child_depth = parent.depth + 1
+      arity = 4 - child_depth - child_index
+      arity = 0 if arity < 0 else arity
+      return ccs.Tree(arity = arity, value = (4 - child_depth)*100 + child_index)
+
+    tree = ccs.Tree(arity = 4, value = 400)
+    ts = ccs.DynamicTreeSpace(name = 'space', tree = tree, get_child = get_child)
+    self.assertEqual( (0, 0, 0), ts.prefetch )
+    try:
+      ts.set_prefetch(2, depth = 2, max_pending = 8)
+    except ccs.Error as e:
+      if e._code.value != ccs.Result.ERROR_UNSUPPORTED_OPERATION:
+        raise
+      self.skipTest("built without POSIX threads")
+    self.assertEqual( (2, 2, 8), ts.prefetch )
+    self.assertEqual( [400, 301, 201], ts.get_values_at_position([1, 1]) )
+    self.assertEqual( [400, 300, 200, 100], ts.get_values_at_position([0, 0, 0]) )
+    self.assertTrue( ts.check_position([0, 0, 0, 0]) )
+    self.assertFalse( ts.check_position([2, 1]) )
+    ts.set_prefetch(0)
+    self.assertEqual( (0, 0, 0), ts.prefetch )
+    self.assertEqual( [400, 302, 200], ts.get_values_at_position([2, 0]) )
+
   def test_tree_configuration(self):
     tree = generate_tree(4, 0)
     ts = ccs.StaticTreeSpace(name = 'space', tree = tree)
@@ -61,6 +61,59 @@ class TestTreeTuner(unittest.TestCase):
     self.assertTrue(all(best2 >= x.objective_values[0] for x in hist))
     self.assertTrue(t_copy.suggest in [x.configuration for x in optims_2])
 
+  def test_transpositions(self):
+    (ts, os) = self.create_tuning_problem()
+    t = ccs.RandomTreeTuner(name = "tuner", tree_space = ts, objective_space = os)
+    ts.set_transposition_table(lambda tree_space, values: "depth {}".format(len(values)), capacity = 16)
+    c1 = ccs.TreeConfiguration(tree_space = ts, position = [1])
+    c2 = ccs.TreeConfiguration(tree_space = ts, position = [2])
+    c3 = ccs.TreeConfiguration(tree_space = ts, position = [0, 0])
+    self.assertIsNone(ts.get_transposition(c2))
+    e1 = ccs.TreeEvaluation(objective_space = os, configuration = c1, values = [reduce(c1.values)])
+    t.tell([e1])
+    e2 = ts.get_transposition(c2)
+    self.assertEqual(c2, e2.configuration)
+    self.assertEqual(e1.objective_values, e2.objective_values)
+    self.assertIsNone(ts.get_transposition(c3))
+    for i in range(10):
+      evals = [ccs.TreeEvaluation(objective_space = os, configuration = c, values = [reduce(c.values)]) for c in t.ask(2)]
+      t.tell(evals)
+    hist = t.history
+    self.assertTrue(len(hist) > 21)
+    self.assertTrue(all(x.objective_values[0] == reduce(x.configuration.values) or
+                        ts.get_transposition(x.configuration).objective_values[0] == x.objective_values[0] for x in hist))
+    ts.set_transposition_table(None)
+    self.assertIsNone(ts.get_transposition(c2))
+
+  def test_create_mcts(self):
+    (ts, os) = self.create_tuning_problem()
+    t = ccs.MctsTreeTuner(name = "tuner", tree_space = ts, objective_space = os, exploration = 0.5)
+    t2 = ccs.Object.from_handle(t.handle)
+    self.assertIsInstance(t2, ccs.MctsTreeTuner)
+    self.assertEqual("tuner", t.name)
+    self.assertEqual(ccs.TreeTunerType.MCTS, t.type)
+    self.assertEqual(0.5, t.exploration)
+    for i in range(10):
+      evals = [ccs.TreeEvaluation(objective_space = os, configuration = c, values = [reduce(c.values)]) for c in t.ask(20)]
+      t.tell(evals)
+    hist = t.history
+    self.assertEqual(200, len(hist))
+    optims = t.optima
+    self.assertEqual(1, len(optims))
+    best = optims[0].objective_values[0]
+    self.assertTrue(all(best >= x.objective_values[0] for x in hist))
+    self.assertTrue(t.suggest in [x.configuration for x in optims])
+    buff = t.serialize()
+    t_copy = ccs.deserialize(buffer = buff)
+    self.assertEqual(ccs.TreeTunerType.MCTS, t_copy.type)
+    self.assertEqual(0.5, t_copy.exploration)
+    hist = t_copy.history
+    self.assertEqual(200, len(hist))
+    optims_2 = t_copy.optima
+    self.assertEqual(len(optims), len(optims_2))
+    best2 = optims_2[0].objective_values[0]
+    self.assertEqual(best, best2)
+
   def test_user_defined(self):
     class TunerData:
       def __init__(self):
@@ -56,6 +56,91 @@ class TestTuner(unittest.TestCase):
     self.assertTrue(all(objs[i][1] >= objs[i+1][1] for i in range(len(objs)-1)))
     self.assertTrue(t_copy.suggest in [x.configuration for x in optims_2])
 
+  def test_create_tpe(self):
+    (cs, os) = self.create_tuning_problem()
+    t = ccs.TpeTuner(name = "tuner", configuration_space = cs, objective_space = os)
+    t2 = ccs.Object.from_handle(t.handle)
+    self.assertEqual(t.__class__, t2.__class__)
+    self.assertEqual("tuner", t.name)
+    self.assertEqual(ccs.TunerType.TPE, t.type)
+    func = lambda x, y, z: [(x-2)*(x-2), sin(z+y)]
+    for i in range(10):
+      evals = [ccs.Evaluation(objective_space = os, configuration = c, values = func(*(c.values))) for c in t.ask(10)]
+      t.tell(evals)
+    hist = t.history
+    self.assertEqual(100, len(hist))
+    optims = t.optima
+    objs = [x.objective_values for x in optims]
+    objs.sort(key = lambda x: x[0])
+    # assert pareto front
+    self.assertTrue(all(objs[i][1] >= objs[i+1][1] for i in range(len(objs)-1)))
+    self.assertTrue(t.suggest in [x.configuration for x in optims])
+    # test serialization
+    buff = t.serialize()
+    t_copy = ccs.deserialize(buffer = buff)
+    self.assertEqual(ccs.TunerType.TPE, t_copy.type)
+    hist = t_copy.history
+    self.assertEqual(100, len(hist))
+    optims_2 = t_copy.optima
+    self.assertEqual(len(optims), len(optims_2))
+
+  def test_create_hyperband(self):
+    cs = ccs.ConfigurationSpace(name = "cspace")
+    h1 = ccs.NumericalParameter.Float(lower = -5.0, upper = 5.0)
+    h2 = ccs.NumericalParameter.Float(lower = -5.0, upper = 5.0)
+    f = ccs.NumericalParameter.Int(lower = 1, upper = 28)
+    cs.add_parameters([h1, h2, f])
+    os = ccs.ObjectiveSpace(name = "ospace")
+    v1 = ccs.NumericalParameter.Float(lower = float('-inf'), upper = float('inf'))
+    os.add_parameters([v1])
+    os.add_objectives( [ccs.Expression.Variable(parameter = v1)] )
+    t = ccs.HyperbandTuner(name = "tuner", configuration_space = cs, objective_space = os, fidelity_index = 2, eta = 3.0)
+    t2 = ccs.Object.from_handle(t.handle)
+    self.assertEqual(t.__class__, t2.__class__)
+    self.assertEqual(ccs.TunerType.HYPERBAND, t.type)
+    self.assertEqual(2, t.fidelity_index)
+    self.assertEqual(3.0, t.eta)
+    func = lambda x, y, it: [(x-2)*(x-2) + y*y + 1.0/it]
+    for i in range(20):
+      confs = t.ask(10)
+      self.assertTrue(all(c.values[2] in [1, 3, 9, 27] for c in confs))
+      evals = [ccs.Evaluation(objective_space = os, configuration = c, values = func(*(c.values))) for c in confs]
+      t.tell(evals)
+    self.assertEqual(200, len(t.history))
+    self.assertTrue(all(x.configuration.values[2] == 27 for x in t.optima))
+    buff = t.serialize()
+    t_copy = ccs.deserialize(buffer = buff)
+    self.assertEqual(200, len(t_copy.history))
+    self.assertEqual(2, t_copy.fidelity_index)
+
+  def test_create_cma_es(self):
+    cs = ccs.ConfigurationSpace(name = "cspace")
+    h1 = ccs.NumericalParameter.Float(lower = -5.0, upper = 5.0)
+    h2 = ccs.NumericalParameter.Float(lower = -5.0, upper = 5.0)
+    h3 = ccs.CategoricalParameter(values = [0, 1, 2])
+    cs.add_parameters([h1, h2, h3])
+    os = ccs.ObjectiveSpace(name = "ospace")
+    v1 = ccs.NumericalParameter.Float(lower = float('-inf'), upper = float('inf'))
+    os.add_parameters([v1])
+    os.add_objectives( [ccs.Expression.Variable(parameter = v1)] )
+    t = ccs.CmaEsTuner(name = "tuner", configuration_space = cs, objective_space = os, population_size = 8)
+    t2 = ccs.Object.from_handle(t.handle)
+    self.assertEqual(t.__class__, t2.__class__)
+    self.assertEqual(ccs.TunerType.CMA_ES, t.type)
+    self.assertEqual(8, t.population_size)
+    self.assertEqual(0.3, t.sigma)
+    func = lambda x, y, z: [(x-2)*(x-2) + (y-1)*(y-1) + z]
+    for i in range(20):
+      confs = t.ask(8)
+      evals = [ccs.Evaluation(objective_space = os, configuration = c, values = func(*(c.values))) for c in confs]
+      t.tell(evals)
+    self.assertEqual(160, len(t.history))
+    self.assertTrue(t.optima[0].objective_values[0] < 0.5)
+    buff = t.serialize()
+    t_copy = ccs.deserialize(buffer = buff)
+    self.assertEqual(160, len(t_copy.history))
+    self.assertEqual(8, t_copy.population_size)
+
   def test_user_defined(self):
     class TunerData:
       def __init__(self):
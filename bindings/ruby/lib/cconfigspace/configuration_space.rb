@@ -18,6 +18,7 @@ module CCS
   attach_function :ccs_configuration_space_get_default_configuration, [:ccs_configuration_space_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_sample, [:ccs_configuration_space_t, :pointer], :ccs_result_t
   attach_function :ccs_configuration_space_samples, [:ccs_configuration_space_t, :size_t, :pointer], :ccs_result_t
+  attach_function :ccs_configuration_space_get_neighbors, [:ccs_configuration_space_t, :ccs_configuration_t, :size_t, :ccs_rng_t, :pointer], :ccs_result_t
 
   class ConfigurationSpace < Context
 
@@ -227,5 +228,12 @@ module CCS
       CCS.error_check CCS.ccs_configuration_space_samples(@handle, count, ptr)
       count.times.collect { |i| Configuration::new(ptr[i].read_pointer, retain: false) }
     end
+
+    def neighbors(configuration, count, rng: nil)
+      return [] if count == 0
+      ptr = MemoryPointer::new(:ccs_configuration_t, count)
+      CCS.error_check CCS.ccs_configuration_space_get_neighbors(@handle, configuration, count, rng, ptr)
+      count.times.collect { |i| Configuration::new(ptr[i].read_pointer, retain: false) }
+    end
   end
 end
@@ -8,9 +8,17 @@ module CCS
   attach_function :ccs_context_get_parameter_indexes, [:ccs_context_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_context_get_parameters, [:ccs_context_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_context_validate_value, [:ccs_context_t, :size_t, :ccs_datum_t, :pointer], :ccs_result_t
+  attach_function :ccs_context_set_binding_pool_capacity, [:ccs_context_t, :size_t], :ccs_result_t
+  attach_function :ccs_context_get_binding_pool_capacity, [:ccs_context_t, :pointer], :ccs_result_t
 
   class Context < Object
     add_property :num_parameters, :size_t, :ccs_context_get_num_parameters, memoize: false
+    add_property :binding_pool_capacity, :size_t, :ccs_context_get_binding_pool_capacity, memoize: false
+
+    def binding_pool_capacity=(capacity)
+      CCS.error_check CCS.ccs_context_set_binding_pool_capacity(@handle, capacity)
+      capacity
+    end
 
     def name
       @name ||= begin
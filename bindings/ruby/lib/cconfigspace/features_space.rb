@@ -4,8 +4,13 @@ module CCS
   attach_function :ccs_features_space_add_parameters, [:ccs_features_space_t, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_features_space_check_features, [:ccs_features_space_t, :ccs_features_t, :pointer], :ccs_result_t
   attach_function :ccs_features_space_check_features_values, [:ccs_features_space_t, :size_t, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_features_space_intern_features, [:ccs_features_space_t, :size_t, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_features_space_set_interned_features_capacity, [:ccs_features_space_t, :size_t], :ccs_result_t
+  attach_function :ccs_features_space_get_interned_features_capacity, [:ccs_features_space_t, :pointer], :ccs_result_t
 
   class FeaturesSpace < Context
+    add_property :interned_features_capacity, :size_t, :ccs_features_space_get_interned_features_capacity, memoize: false
+
     def initialize(handle = nil, retain: false, auto_release: true,
                    name: "")
       if handle
@@ -51,5 +56,20 @@ module CCS
       CCS.error_check CCS.ccs_features_space_check_features_values(@handle, count, ptr, ptr2)
       return ptr2.read_ccs_bool_t == CCS::FALSE ? false : true
     end
+
+    def interned_features_capacity=(capacity)
+      CCS.error_check CCS.ccs_features_space_set_interned_features_capacity(@handle, capacity)
+      capacity
+    end
+
+    def intern_features(values)
+      count = values.size
+      ss = []
+      ptr = MemoryPointer::new(:ccs_datum_t, count)
+      values.each_with_index {  |v, i| Datum::new(ptr[i]).set_value(v, string_store: ss) }
+      ptr2 = MemoryPointer::new(:ccs_features_t)
+      CCS.error_check CCS.ccs_features_space_intern_features(@handle, count, ptr, ptr2)
+      Features::new(ptr2.read_ccs_features_t, retain: false)
+    end
   end
 end
@@ -15,11 +15,16 @@ module CCS
   attach_function :ccs_features_tuner_get_configuration_space, [:ccs_features_tuner_t, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_get_objective_space, [:ccs_features_tuner_t, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_get_features_space, [:ccs_features_tuner_t, :pointer], :ccs_result_t
+  attach_function :ccs_features_tuner_set_nearest_features, [:ccs_features_tuner_t, :size_t], :ccs_result_t
+  attach_function :ccs_features_tuner_get_nearest_features, [:ccs_features_tuner_t, :pointer], :ccs_result_t
+  attach_function :ccs_features_tuner_set_suggestion_cache_capacity, [:ccs_features_tuner_t, :size_t], :ccs_result_t
+  attach_function :ccs_features_tuner_get_suggestion_cache_capacity, [:ccs_features_tuner_t, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_ask, [:ccs_features_tuner_t, :ccs_features_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_tell, [:ccs_features_tuner_t, :size_t, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_get_optima, [:ccs_features_tuner_t, :ccs_features_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_get_history, [:ccs_features_tuner_t, :ccs_features_t, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_features_tuner_suggest, [:ccs_features_tuner_t, :ccs_features_t, :pointer], :ccs_result_t
+  attach_function :ccs_features_tuner_suggest_values, [:ccs_features_tuner_t, :size_t, :pointer, :size_t, :pointer, :pointer], :ccs_result_t
   attach_function :ccs_create_random_features_tuner, [:string, :ccs_configuration_space_t, :ccs_features_space_t, :ccs_objective_space_t, :pointer], :ccs_result_t
 
   class FeaturesTuner < Object
@@ -27,6 +32,8 @@ module CCS
     add_handle_property :configuration_space, :ccs_configuration_space_t, :ccs_features_tuner_get_configuration_space, memoize: true
     add_handle_property :features_space, :ccs_features_space_t, :ccs_features_tuner_get_features_space, memoize: true
     add_handle_property :objective_space, :ccs_objective_space_t, :ccs_features_tuner_get_objective_space, memoize: true
+    add_property :nearest_features, :size_t, :ccs_features_tuner_get_nearest_features, memoize: false
+    add_property :suggestion_cache_capacity, :size_t, :ccs_features_tuner_get_suggestion_cache_capacity, memoize: false
 
     def self.from_handle(handle, retain: true, auto_release: true)
       ptr = MemoryPointer::new(:ccs_features_tuner_type_t)
@@ -49,6 +56,14 @@ module CCS
       end
     end
 
+    def nearest_features=(count)
+      CCS.error_check CCS.ccs_features_tuner_set_nearest_features(@handle, count)
+    end
+
+    def suggestion_cache_capacity=(capacity)
+      CCS.error_check CCS.ccs_features_tuner_set_suggestion_cache_capacity(@handle, capacity)
+    end
+
     def ask(features, count = 1)
       p_confs = MemoryPointer::new(:ccs_configuration_t, count)
       p_num = MemoryPointer::new(:size_t)
@@ -97,6 +112,17 @@ module CCS
       Configuration::new(p_conf.read_pointer, retain: false)
     end
 
+    def suggest_values(features_values)
+      count = features_values.size
+      ss = []
+      ptr = MemoryPointer::new(:ccs_datum_t, count)
+      features_values.each_with_index {  |v, i| Datum::new(ptr[i]).set_value(v, string_store: ss) }
+      sz = configuration_space.num_parameters
+      values = MemoryPointer::new(:ccs_datum_t, sz)
+      CCS.error_check CCS.ccs_features_tuner_suggest_values(@handle, count, ptr, sz, values, nil)
+      sz.times.collect { |i| Datum::new(values[i]).value }
+    end
+
   end
 
   class RandomFeaturesTuner < FeaturesTuner
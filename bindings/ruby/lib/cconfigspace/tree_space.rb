@@ -21,6 +21,9 @@ module CCS
   attach_function :ccs_tree_space_check_configuration, [:ccs_tree_space_t, :ccs_tree_configuration_t, :pointer], :ccs_result_t
   attach_function :ccs_tree_space_sample, [:ccs_tree_space_t, :pointer], :ccs_result_t
   attach_function :ccs_tree_space_samples, [:ccs_tree_space_t, :size_t, :pointer], :ccs_result_t
+  callback :ccs_tree_space_transposition_key_callback, [:ccs_tree_space_t, :size_t, :pointer, :pointer, :pointer], :ccs_result_t
+  attach_function :ccs_tree_space_set_transposition_table, [:ccs_tree_space_t, :ccs_tree_space_transposition_key_callback, :pointer, :size_t], :ccs_result_t
+  attach_function :ccs_tree_space_get_transposition, [:ccs_tree_space_t, :ccs_tree_configuration_t, :pointer], :ccs_result_t
 
   class TreeSpace < Object
     add_property :type, :ccs_tree_space_type_t, :ccs_tree_space_get_type, memoize: true
@@ -100,9 +103,40 @@ module CCS
       count.times.collect { |i| TreeConfiguration::new(ptr[i].read_pointer, retain: false) }
     end
 
+    def set_transposition_table(capacity: 1024, &key)
+      unless key
+        CCS.error_check CCS.ccs_tree_space_set_transposition_table(@handle, nil, nil, 0)
+        return self
+      end
+      last_key = []
+      key_wrapper = lambda { |ts, num_values, p_values, data, p_key|
+        begin
+          values = num_values.times.collect { |i| Datum::new(p_values + i * Datum.size).value }
+          last_key.clear
+          Datum::new(p_key).set_value(key.call(TreeSpace.from_handle(ts), values), string_store: last_key)
+          CCSError.to_native(:CCS_RESULT_SUCCESS)
+        rescue => e
+          CCS.set_error(e)
+        end
+      }
+      CCS.error_check CCS.ccs_tree_space_set_transposition_table(@handle, key_wrapper, nil, capacity)
+      CCS.register_callback(@handle, [key_wrapper, last_key])
+      self
+    end
+
+    def get_transposition(configuration)
+      ptr = MemoryPointer::new(:ccs_tree_evaluation_t)
+      CCS.error_check CCS.ccs_tree_space_get_transposition(@handle, configuration, ptr)
+      handle = ptr.read_ccs_tree_evaluation_t
+      handle.null? ? nil : TreeEvaluation::new(handle, retain: false)
+    end
+
   end
 
   attach_function :ccs_create_static_tree_space, [:string, :ccs_tree_t, :pointer], :ccs_result_t
+  attach_function :ccs_static_tree_space_freeze, [:ccs_tree_space_t], :ccs_result_t
+  attach_function :ccs_static_tree_space_thaw, [:ccs_tree_space_t], :ccs_result_t
+  attach_function :ccs_static_tree_space_is_frozen, [:ccs_tree_space_t, :pointer], :ccs_result_t
 
   class StaticTreeSpace < TreeSpace
 
@@ -117,6 +151,23 @@ module CCS
       end
     end
 
+    # Not named freeze, thaw and frozen? to leave Object#freeze alone.
+    def freeze_tree
+      CCS.error_check CCS.ccs_static_tree_space_freeze(@handle)
+      self
+    end
+
+    def thaw_tree
+      CCS.error_check CCS.ccs_static_tree_space_thaw(@handle)
+      self
+    end
+
+    def tree_frozen?
+      ptr = MemoryPointer::new(:ccs_bool_t)
+      CCS.error_check CCS.ccs_static_tree_space_is_frozen(@handle, ptr)
+      return ptr.read_ccs_bool_t == CCS::FALSE ? false : true
+    end
+
   end
 
   TreeSpace::Static = StaticTreeSpace
@@ -146,7 +197,11 @@ module CCS
     }
     get_childwrapper = lambda { |ts, parent, index, p_child|
       begin
-        child = get_child.call(TreeSpace.from_handle(ts), Tree.from_handle(parent), index)
+        # may run on a prefetch worker thread, where reference counts must
+        # not be updated: the tree space and parent are borrowed
+        ts = DynamicTreeSpace.new(ts, retain: false, auto_release: false)
+        parent = Tree.new(parent, retain: false, auto_release: false)
+        child = get_child.call(ts, parent, index)
         CCS.error_check CCS.ccs_retain_object(child.handle)
         Pointer.new(p_child).write_pointer(child.handle)
         CCSError.to_native(:CCS_RESULT_SUCCESS)
@@ -189,6 +244,8 @@ module CCS
 
   attach_function :ccs_create_dynamic_tree_space, [:string, :ccs_tree_t, DynamicTreeSpaceVector.by_ref, :value, :pointer], :ccs_result_t
   attach_function :ccs_dynamic_tree_space_get_tree_space_data, [:ccs_tree_space_t, :pointer], :ccs_result_t
+  attach_function :ccs_dynamic_tree_space_set_prefetch, [:ccs_tree_space_t, :size_t, :size_t, :size_t], :ccs_result_t
+  attach_function :ccs_dynamic_tree_space_get_prefetch, [:ccs_tree_space_t, :pointer, :pointer, :pointer], :ccs_result_t
 
   class DynamicTreeSpace < TreeSpace
     add_property :tree_space_data, :value, :ccs_dynamic_tree_space_get_tree_space_data, memoize: true
@@ -228,6 +285,17 @@ module CCS
       res
     end
 
+    def set_prefetch(num_threads, depth: 1, max_pending: 64)
+      CCS.error_check CCS.ccs_dynamic_tree_space_set_prefetch(@handle, num_threads, depth, max_pending)
+      self
+    end
+
+    def prefetch
+      ptr = MemoryPointer::new(:size_t, 3)
+      CCS.error_check CCS.ccs_dynamic_tree_space_get_prefetch(@handle, ptr, ptr + ptr.type_size, ptr + 2 * ptr.type_size)
+      ptr.read_array_of_size_t(3)
+    end
+
   end
 
   TreeSpace::Dynamic = DynamicTreeSpace
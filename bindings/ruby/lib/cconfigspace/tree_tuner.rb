@@ -2,7 +2,8 @@ module CCS
 
   TreeTunerType = enum FFI::Type::INT32, :ccs_tree_tuner_type_t, [
     :CCS_TREE_TUNER_TYPE_RANDOM,
-    :CCS_TREE_TUNER_TYPE_USER_DEFINED
+    :CCS_TREE_TUNER_TYPE_USER_DEFINED,
+    :CCS_TREE_TUNER_TYPE_MCTS
   ]
   class MemoryPointer
     def read_ccs_tree_tuner_type_t
@@ -33,6 +34,8 @@ module CCS
 	RandomTreeTuner
       when :CCS_TREE_TUNER_TYPE_USER_DEFINED
         UserDefinedTreeTuner
+      when :CCS_TREE_TUNER_TYPE_MCTS
+        MctsTreeTuner
       else
         raise CCSError, :CCS_RESULT_ERROR_INVALID_TREE_TUNER
       end.new(handle, retain: retain, auto_release: auto_release)
@@ -113,6 +116,32 @@ module CCS
 
   TreeTuner::Random = RandomTreeTuner
 
+  attach_function :ccs_create_mcts_tree_tuner, [:string, :ccs_tree_space_t, :ccs_objective_space_t, :ccs_float_t, :pointer], :ccs_result_t
+  attach_function :ccs_mcts_tree_tuner_get_properties, [:ccs_tree_tuner_t, :pointer], :ccs_result_t
+
+  class MctsTreeTuner < TreeTuner
+    def initialize(handle = nil, retain: false, auto_release: true,
+                   name: "", tree_space: nil, objective_space: nil, exploration: 0.0)
+      if handle
+        super(handle, retain: retain, auto_release: auto_release)
+      else
+        ptr = MemoryPointer::new(:ccs_tree_tuner_t)
+        CCS.error_check CCS.ccs_create_mcts_tree_tuner(name, tree_space, objective_space, exploration, ptr)
+        super(ptr.read_ccs_tree_tuner_t, retain: false)
+      end
+    end
+
+    def exploration
+      @exploration ||= begin
+        ptr = MemoryPointer::new(:ccs_float_t)
+        CCS.error_check CCS.ccs_mcts_tree_tuner_get_properties(@handle, ptr)
+        ptr.read_ccs_float_t
+      end
+    end
+  end
+
+  TreeTuner::Mcts = MctsTreeTuner
+
   callback :ccs_user_defined_tree_tuner_del, [:ccs_tree_tuner_t], :ccs_result_t
   callback :ccs_user_defined_tree_tuner_ask, [:ccs_tree_tuner_t, :size_t, :pointer, :pointer], :ccs_result_t
   callback :ccs_user_defined_tree_tuner_tell, [:ccs_tree_tuner_t, :size_t, :pointer], :ccs_result_t
@@ -2,7 +2,10 @@ module CCS
 
   TunerType = enum FFI::Type::INT32, :ccs_tuner_type_t, [
     :CCS_TUNER_TYPE_RANDOM,
-    :CCS_TUNER_TYPE_USER_DEFINED
+    :CCS_TUNER_TYPE_USER_DEFINED,
+    :CCS_TUNER_TYPE_TPE,
+    :CCS_TUNER_TYPE_HYPERBAND,
+    :CCS_TUNER_TYPE_CMA_ES
   ]
   class MemoryPointer
     def read_ccs_tuner_type_t
@@ -33,6 +36,12 @@ module CCS
 	RandomTuner
       when :CCS_TUNER_TYPE_USER_DEFINED
         UserDefinedTuner
+      when :CCS_TUNER_TYPE_TPE
+        TpeTuner
+      when :CCS_TUNER_TYPE_HYPERBAND
+        HyperbandTuner
+      when :CCS_TUNER_TYPE_CMA_ES
+        CmaEsTuner
       else
         raise CCSError, :CCS_RESULT_ERROR_INVALID_TUNER
       end.new(handle, retain: retain, auto_release: auto_release)
@@ -113,6 +122,91 @@ module CCS
 
   Tuner::Random = RandomTuner
 
+  attach_function :ccs_create_tpe_tuner, [:string, :ccs_configuration_space_t, :ccs_objective_space_t, :pointer], :ccs_result_t
+
+  class TpeTuner < Tuner
+    def initialize(handle = nil, retain: false, auto_release: true,
+                   name: "", configuration_space: nil, objective_space: nil)
+      if handle
+        super(handle, retain: retain, auto_release: auto_release)
+      else
+        ptr = MemoryPointer::new(:ccs_tuner_t)
+        CCS.error_check CCS.ccs_create_tpe_tuner(name, configuration_space, objective_space, ptr)
+        super(ptr.read_ccs_tuner_t, retain: false)
+      end
+    end
+  end
+
+  Tuner::Tpe = TpeTuner
+
+  attach_function :ccs_create_hyperband_tuner, [:string, :ccs_configuration_space_t, :ccs_objective_space_t, :size_t, :ccs_float_t, :pointer], :ccs_result_t
+  attach_function :ccs_hyperband_tuner_get_properties, [:ccs_tuner_t, :pointer, :pointer], :ccs_result_t
+
+  class HyperbandTuner < Tuner
+    def initialize(handle = nil, retain: false, auto_release: true,
+                   name: "", configuration_space: nil, objective_space: nil, fidelity_index: 0, eta: 3.0)
+      if handle
+        super(handle, retain: retain, auto_release: auto_release)
+      else
+        ptr = MemoryPointer::new(:ccs_tuner_t)
+        CCS.error_check CCS.ccs_create_hyperband_tuner(name, configuration_space, objective_space, fidelity_index, eta, ptr)
+        super(ptr.read_ccs_tuner_t, retain: false)
+      end
+    end
+
+    def fidelity_index
+      @fidelity_index ||= begin
+        ptr = MemoryPointer::new(:size_t)
+        CCS.error_check CCS.ccs_hyperband_tuner_get_properties(@handle, ptr, nil)
+        ptr.read_size_t
+      end
+    end
+
+    def eta
+      @eta ||= begin
+        ptr = MemoryPointer::new(:ccs_float_t)
+        CCS.error_check CCS.ccs_hyperband_tuner_get_properties(@handle, nil, ptr)
+        ptr.read_ccs_float_t
+      end
+    end
+  end
+
+  Tuner::Hyperband = HyperbandTuner
+
+  attach_function :ccs_create_cma_es_tuner, [:string, :ccs_configuration_space_t, :ccs_objective_space_t, :size_t, :ccs_float_t, :pointer], :ccs_result_t
+  attach_function :ccs_cma_es_tuner_get_properties, [:ccs_tuner_t, :pointer, :pointer], :ccs_result_t
+
+  class CmaEsTuner < Tuner
+    def initialize(handle = nil, retain: false, auto_release: true,
+                   name: "", configuration_space: nil, objective_space: nil, population_size: 0, sigma: 0.0)
+      if handle
+        super(handle, retain: retain, auto_release: auto_release)
+      else
+        ptr = MemoryPointer::new(:ccs_tuner_t)
+        CCS.error_check CCS.ccs_create_cma_es_tuner(name, configuration_space, objective_space, population_size, sigma, ptr)
+        super(ptr.read_ccs_tuner_t, retain: false)
+      end
+    end
+
+    def population_size
+      @population_size ||= begin
+        ptr = MemoryPointer::new(:size_t)
+        CCS.error_check CCS.ccs_cma_es_tuner_get_properties(@handle, ptr, nil)
+        ptr.read_size_t
+      end
+    end
+
+    def sigma
+      @sigma ||= begin
+        ptr = MemoryPointer::new(:ccs_float_t)
+        CCS.error_check CCS.ccs_cma_es_tuner_get_properties(@handle, nil, ptr)
+        ptr.read_ccs_float_t
+      end
+    end
+  end
+
+  Tuner::CmaEs = CmaEsTuner
+
   callback :ccs_user_defined_tuner_del, [:ccs_tuner_t], :ccs_result_t
   callback :ccs_user_defined_tuner_ask, [:ccs_tuner_t, :size_t, :pointer, :pointer], :ccs_result_t
   callback :ccs_user_defined_tuner_tell, [:ccs_tuner_t, :size_t, :pointer], :ccs_result_t
@@ -33,6 +33,12 @@ class CConfigSpaceTestConfigurationSpace < Minitest::Test
     cs.samples(100).each { |c|
       assert( cs.check(c) )
     }
+    c = cs.sample
+    cs.neighbors(c, 100).each { |n|
+      assert( cs.check(n) )
+      assert_equal( 1, c.values.zip(n.values).count { |a, b| a != b } )
+    }
+    assert_equal( 10, cs.neighbors(c, 10, rng: CCS::Rng::new).size )
   end
 
   def test_set_distribution
@@ -24,4 +24,25 @@ class CConfigSpaceTestFeaturesSpace < Minitest::Test
     assert_equal( h2, cs.parameter_by_name(h2.name) )
   end
 
+  def test_intern_features
+    fs = CCS::FeaturesSpace::new(name: "space")
+    h1 = CCS::NumericalParameter::Float.new(lower: 0.0, upper: 1.0)
+    h2 = CCS::CategoricalParameter::new(values: ["small", "large"])
+    fs.add_parameters([h1, h2])
+    assert_equal( 64, fs.interned_features_capacity )
+    f1 = fs.intern_features([0.5, "large"])
+    f2 = fs.intern_features([0.5, "large"])
+    assert_equal( f1.handle, f2.handle )
+    assert_equal( 2, f1.refcount )
+    assert_equal( [0.5, "large"], f1.values )
+    f3 = CCS::Features::new(features_space: fs, values: [0.5, "large"])
+    assert_equal( f1, f3 )
+    assert_equal( f1.hash, f3.hash )
+    refute_equal( f1.handle, f3.handle )
+    assert_raises(CCS::CCSError, :CCS_RESULT_ERROR_UNSUPPORTED_OPERATION) { f1.set_value(0, 0.2) }
+    assert_raises(CCS::CCSError, :CCS_RESULT_ERROR_INVALID_VALUE) { fs.intern_features([2.0, "large"]) }
+    fs.interned_features_capacity = 0
+    assert_equal( 0, fs.interned_features_capacity )
+  end
+
 end
@@ -76,6 +76,54 @@ class CConfigSpaceTestFeaturesTuner < Minitest::Test
     end
   end
 
+  def test_nearest_features
+    cs, fs, os = create_tuning_problem
+    t = CCS::RandomFeaturesTuner::new(name: "tuner", configuration_space: cs, features_space: fs, objective_space: os)
+    assert_equal( 0, t.nearest_features )
+    assert_raises(CCS::CCSError, :CCS_RESULT_ERROR_UNSUPPORTED_OPERATION) { t.nearest_features = 2 }
+    fs = CCS::FeaturesSpace::new(name: "sizes")
+    fs.add_parameter CCS::NumericalParameter::Float.new(lower: 0.0, upper: 100.0)
+    t = CCS::RandomFeaturesTuner::new(name: "tuner", configuration_space: cs, features_space: fs, objective_space: os)
+    t.nearest_features = 2
+    assert_equal( 2, t.nearest_features )
+    func = lambda { |(x, y, z)|
+      [(x-2)**2, Math.sin(z+y)]
+    }
+    features = CCS::Features.new(features_space: fs, values: [10.0])
+    evals = t.ask(features, 20).collect { |c|
+      CCS::FeaturesEvaluation::new(objective_space: os, configuration: c, features: features, values: func[c.values])
+    }
+    t.tell evals
+    optims = t.optima(features: features).collect(&:configuration)
+    unseen = CCS::Features.new(features_space: fs, values: [12.0])
+    assert( optims.include?(t.suggest(unseen)) )
+    assert( optims.include?(t.ask(unseen, 1).first) )
+  end
+
+  def test_suggest_values
+    cs, fs, os = create_tuning_problem
+    t = CCS::RandomFeaturesTuner::new(name: "tuner", configuration_space: cs, features_space: fs, objective_space: os)
+    func = lambda { |(x, y, z)|
+      [(x-2)**2, Math.sin(z+y)]
+    }
+    features_on = CCS::Features.new(features_space: fs, values: [true])
+    assert_equal( 1024, t.suggestion_cache_capacity )
+    values = t.suggest_values([true])
+    assert_equal( 3, values.size )
+    evals = t.ask(features_on, 50).collect { |c|
+      CCS::FeaturesEvaluation::new(objective_space: os, configuration: c, features: features_on, values: func[c.values])
+    }
+    t.tell evals
+    optims = t.optima(features: features_on).collect { |e| e.configuration.values }
+    assert( optims.include?(t.suggest_values([true])) )
+    assert_equal( t.suggest_values([true]), t.suggest_values([true]) )
+    assert( optims.include?(t.suggest(features_on).values) )
+    t.suggestion_cache_capacity = 0
+    assert_equal( 0, t.suggestion_cache_capacity )
+    assert( optims.include?(t.suggest_values([true])) )
+    assert_raises(CCS::CCSError, :CCS_RESULT_ERROR_INVALID_VALUE) { t.suggest_values([]) }
+  end
+
   def test_user_defined
     del = lambda { |tuner| nil }
     ask = lambda { |tuner, features, count|
@@ -46,6 +46,26 @@ class CConfigSpaceTestTreeSpace < Minitest::Test
     assert_equal( [400, 301, 201], ts2.get_values_at_position([1, 1]) )
   end
 
+  def test_frozen_tree_space
+    tree = generate_tree(4, 0)
+    ts = CCS::StaticTreeSpace.new(name: 'space', tree: tree)
+    refute( ts.tree_frozen? )
+    ts.freeze_tree
+    assert( ts.tree_frozen? )
+    assert_equal( 201, ts.get_node_at_position([1, 1]).value )
+    assert_equal( [400, 301, 201], ts.get_values_at_position([1, 1]) )
+    assert( ts.check_position([1, 1]) )
+    refute( ts.check_position([1, 4]) )
+    ts.samples(100).each{ |x|
+      assert( ts.check_configuration(x) )
+    }
+    assert_raises(CCS::CCSError, :CCS_RESULT_ERROR_UNSUPPORTED_OPERATION) { tree.weight = 2.0 }
+    ts.thaw_tree
+    refute( ts.tree_frozen? )
+    tree.weight = 2.0
+    assert_equal( 2.0, tree.weight )
+  end
+
   def test_dynamic_tree_space
     del = lambda { |tree_space| nil }
     get_child = lambda { |tree_space, parent, child_index|
@@ -79,6 +99,33 @@ class CConfigSpaceTestTreeSpace < Minitest::Test
     assert_equal( [400, 301, 201], ts2.get_values_at_position([1, 1]) )
   end
 
+  def test_dynamic_tree_space_prefetch
+    get_child = lambda { |tree_space, parent, child_index|
+      child_depth = parent.depth + 1
+      arity = 4 - child_depth - child_index
+      arity = 0 if arity < 0
+      CCS::Tree.new(arity: arity, value: (4 - child_depth)*100 + child_index)
+    }
+
+    tree = CCS::Tree.new(arity: 4, value: 400)
+    ts = CCS::DynamicTreeSpace.new(name: 'space', tree: tree, get_child: get_child)
+    assert_equal( [0, 0, 0], ts.prefetch )
+    begin
+      ts.set_prefetch(2, depth: 2, max_pending: 8)
+    rescue CCS::CCSError => e
+      raise unless e.code == CCS::CCSError.to_native(:CCS_RESULT_ERROR_UNSUPPORTED_OPERATION)
+      skip "built without POSIX threads"
+    end
+    assert_equal( [2, 2, 8], ts.prefetch )
+    assert_equal( [400, 301, 201], ts.get_values_at_position([1, 1]) )
+    assert_equal( [400, 300, 200, 100], ts.get_values_at_position([0, 0, 0]) )
+    assert( ts.check_position([0, 0, 0, 0]) )
+    refute( ts.check_position([2, 1]) )
+    ts.set_prefetch(0)
+    assert_equal( [0, 0, 0], ts.prefetch )
+    assert_equal( [400, 302, 200], ts.get_values_at_position([2, 0]) )
+  end
+
   def test_tree_configuration
     tree = generate_tree(4, 0)
     ts = CCS::StaticTreeSpace.new(name: 'space', tree: tree)
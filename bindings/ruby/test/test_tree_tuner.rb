@@ -65,6 +65,64 @@ class CConfigSpaceTestTreeTuner < Minitest::Test
     assert(optims_2.map(&:configuration).include?(t_copy.suggest))
   end
 
+  def test_transpositions
+    ts, os = create_tuning_problem
+    t = CCS::RandomTreeTuner.new(name: "tuner", tree_space: ts, objective_space: os)
+    ts.set_transposition_table(capacity: 16) { |tree_space, values| "depth #{values.size}" }
+    c1 = CCS::TreeConfiguration.new(tree_space: ts, position: [1])
+    c2 = CCS::TreeConfiguration.new(tree_space: ts, position: [2])
+    c3 = CCS::TreeConfiguration.new(tree_space: ts, position: [0, 0])
+    assert_nil(ts.get_transposition(c2))
+    e1 = CCS::TreeEvaluation.new(objective_space: os, configuration: c1, values: [c1.values.reduce(:+)])
+    t.tell([e1])
+    e2 = ts.get_transposition(c2)
+    assert_equal(c2.handle, e2.configuration.handle)
+    assert_equal(e1.objective_values, e2.objective_values)
+    assert_nil(ts.get_transposition(c3))
+    10.times {
+      evals = t.ask(2).map { |c|
+        CCS::TreeEvaluation.new(objective_space: os, configuration: c, values: [c.values.reduce(:+)])
+      }
+      t.tell(evals)
+    }
+    assert(t.history.size > 21)
+    ts.set_transposition_table
+    assert_nil(ts.get_transposition(c2))
+  end
+
+  def test_create_mcts
+    ts, os = create_tuning_problem
+    t = CCS::MctsTreeTuner.new(name: "tuner", tree_space: ts, objective_space: os, exploration: 0.5)
+    t2 = CCS::Object.from_handle(t)
+    assert_equal(t.class, t2.class)
+    assert_equal("tuner", t.name)
+    assert_equal(:CCS_TREE_TUNER_TYPE_MCTS, t.type)
+    assert_equal(0.5, t.exploration)
+    10.times {
+      evals = t.ask(20).map { |c|
+        CCS::TreeEvaluation.new(objective_space: os, configuration: c, values: [c.values.reduce(:+)])
+      }
+      t.tell(evals)
+    }
+    hist = t.history
+    assert_equal(200, hist.size)
+    optims = t.optima
+    assert_equal(1, optims.size)
+    best = optims[0].objective_values[0]
+    assert_equal(hist.map { |e| e.objective_values.first }.max, best)
+    assert(optims.map(&:configuration).include?(t.suggest))
+    buff = t.serialize
+    t_copy = CCS.deserialize(buffer: buff)
+    assert_equal(:CCS_TREE_TUNER_TYPE_MCTS, t_copy.type)
+    assert_equal(0.5, t_copy.exploration)
+    hist = t_copy.history
+    assert_equal(200, hist.size)
+    optims_2 = t_copy.optima
+    assert_equal(optims.size, optims_2.size)
+    best2 = optims_2[0].objective_values[0]
+    assert_equal(best, best2)
+  end
+
   class TreeTunerData
     attr_accessor :history, :optima
     def initialize
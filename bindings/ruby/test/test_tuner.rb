@@ -57,6 +57,103 @@ class CConfigSpaceTestTuner < Minitest::Test
     assert( t_copy.optima.collect(&:configuration).include?(t_copy.suggest) )
   end
 
+  def test_create_tpe
+    cs, os = create_tuning_problem
+    t = CCS::TpeTuner::new(name: "tuner", configuration_space: cs, objective_space: os)
+    t2 = CCS::Object::from_handle(t)
+    assert_equal( t.class, t2.class)
+    assert_equal( "tuner", t.name )
+    assert_equal( :CCS_TUNER_TYPE_TPE, t.type )
+    func = lambda { |(x, y, z)|
+      [(x-2)**2, Math.sin(z+y)]
+    }
+    10.times {
+      evals = t.ask(10).collect { |c|
+        CCS::Evaluation::new(objective_space: os, configuration: c, values: func[c.values])
+      }
+      t.tell evals
+    }
+    assert_equal(100, t.history_size)
+    objs = t.optima.collect(&:objective_values).sort
+    objs.collect { |(_, v)| v }.each_cons(2) { |v1, v2| assert( (v1 <=> v2) > 0 ) }
+    assert( t.optima.collect(&:configuration).include?(t.suggest) )
+
+    buff = t.serialize
+    t_copy = CCS.deserialize(buffer: buff)
+    assert_equal( :CCS_TUNER_TYPE_TPE, t_copy.type )
+    assert_equal(100, t_copy.history.size)
+    assert_equal(t.num_optima, t_copy.num_optima)
+  end
+
+  def test_create_hyperband
+    cs = CCS::ConfigurationSpace::new(name: "cspace")
+    h1 = CCS::NumericalParameter::Float.new(lower: -5.0, upper: 5.0)
+    h2 = CCS::NumericalParameter::Float.new(lower: -5.0, upper: 5.0)
+    f = CCS::NumericalParameter::Int.new(lower: 1, upper: 28)
+    cs.add_parameters [h1, h2, f]
+    os = CCS::ObjectiveSpace::new(name: "ospace")
+    v1 = CCS::NumericalParameter::Float.new(lower: -Float::INFINITY, upper: Float::INFINITY)
+    os.add_parameters [v1]
+    os.add_objectives [CCS::Expression::Variable::new(parameter: v1)]
+    t = CCS::HyperbandTuner::new(name: "tuner", configuration_space: cs, objective_space: os, fidelity_index: 2, eta: 3.0)
+    t2 = CCS::Object::from_handle(t)
+    assert_equal( t.class, t2.class)
+    assert_equal( :CCS_TUNER_TYPE_HYPERBAND, t.type )
+    assert_equal( 2, t.fidelity_index )
+    assert_equal( 3.0, t.eta )
+    func = lambda { |(x, y, it)|
+      [(x-2)**2 + y**2 + 1.0/it]
+    }
+    20.times {
+      confs = t.ask(10)
+      confs.each { |c| assert( [1, 3, 9, 27].include?(c.values[2]) ) }
+      evals = confs.collect { |c|
+        CCS::Evaluation::new(objective_space: os, configuration: c, values: func[c.values])
+      }
+      t.tell evals
+    }
+    assert_equal(200, t.history_size)
+    t.optima.each { |e| assert_equal( 27, e.configuration.values[2] ) }
+    buff = t.serialize
+    t_copy = CCS.deserialize(buffer: buff)
+    assert_equal(200, t_copy.history.size)
+    assert_equal(2, t_copy.fidelity_index)
+  end
+
+  def test_create_cma_es
+    cs = CCS::ConfigurationSpace::new(name: "cspace")
+    h1 = CCS::NumericalParameter::Float.new(lower: -5.0, upper: 5.0)
+    h2 = CCS::NumericalParameter::Float.new(lower: -5.0, upper: 5.0)
+    h3 = CCS::CategoricalParameter::new(values: [0, 1, 2])
+    cs.add_parameters [h1, h2, h3]
+    os = CCS::ObjectiveSpace::new(name: "ospace")
+    v1 = CCS::NumericalParameter::Float.new(lower: -Float::INFINITY, upper: Float::INFINITY)
+    os.add_parameters [v1]
+    os.add_objectives [CCS::Expression::Variable::new(parameter: v1)]
+    t = CCS::CmaEsTuner::new(name: "tuner", configuration_space: cs, objective_space: os, population_size: 8)
+    t2 = CCS::Object::from_handle(t)
+    assert_equal( t.class, t2.class)
+    assert_equal( :CCS_TUNER_TYPE_CMA_ES, t.type )
+    assert_equal( 8, t.population_size )
+    assert_equal( 0.3, t.sigma )
+    func = lambda { |(x, y, z)|
+      [(x-2)**2 + (y-1)**2 + z]
+    }
+    20.times {
+      confs = t.ask(8)
+      evals = confs.collect { |c|
+        CCS::Evaluation::new(objective_space: os, configuration: c, values: func[c.values])
+      }
+      t.tell evals
+    }
+    assert_equal(160, t.history_size)
+    assert( t.optima.first.objective_values.first < 0.5 )
+    buff = t.serialize
+    t_copy = CCS.deserialize(buffer: buff)
+    assert_equal(160, t_copy.history.size)
+    assert_equal(8, t_copy.population_size)
+  end
+
   class TunerData
     attr_accessor :history, :optima
     def initialize
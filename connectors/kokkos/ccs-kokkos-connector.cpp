@@ -3,13 +3,24 @@
 #include <string>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <atomic>
 #include <map>
-#include <set>
+#include <mutex>
+#include <shared_mutex>
 #include <stack>
+#include <unordered_map>
 #include <vector>
+#include <math.h>
 #include <time.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 #include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
 
 #define CCS_CHECK(expr)                                                        \
 	do {                                                                   \
@@ -37,23 +48,57 @@
 #endif
 
 #if CCS_PROFILE
-static int64_t ccs_time = 0;
+static std::atomic<int64_t> ccs_time(0);
 #endif
 
 static constexpr const double epsilon = 1E-24;
 
 using namespace Kokkos::Tools::Experimental;
 
-// initialize the stack to true, so it should never be empty.
-static std::stack<bool, std::vector<bool> > convergence_stack;
-static constexpr const size_t               convergence_cutoff = 500;
+// Kernels can be launched from several host threads, each thread has its
+// own stack, an empty stack is in a converged state.
+static thread_local std::stack<bool, std::vector<bool> > convergence_stack;
+
+// Convergence policies, selected with CCS_KOKKOS_CONVERGENCE. A region stops
+// exploring as soon as one of the selected policies is satisfied.
+enum convergence_policy_e {
+	// the history size reaches a cutoff
+	CONVERGENCE_HISTORY    = 1 << 0,
+	// every configuration of a finite space was evaluated for every
+	// features value seen
+	CONVERGENCE_EXHAUSTION = 1 << 1,
+	// the best time has not improved for a number of evaluations
+	CONVERGENCE_STALL      = 1 << 2,
+	// for every features value seen, the best configuration is faster than
+	// the others with 95% confidence
+	CONVERGENCE_CONFIDENCE = 1 << 3
+};
+
+// Settings are read from the environment at initialization
+static unsigned convergence_policies = CONVERGENCE_HISTORY;
+static size_t   convergence_cutoff   = 500;
+static size_t   exhaustion_samples   = 1;
+static size_t   stall_window         = 100;
+static double   stall_tolerance      = 0.01;
+static size_t   confidence_samples   = 3;
+static constexpr const double confidence_z = 1.96;
+// every reexplore_period launches of a converged region one is timed, and
+// the region restarts exploring if reexplore_probes consecutive timed
+// launches are slower than the best time by more than reexplore_tolerance
+static size_t   reexplore_period    = 0;
+static double   reexplore_tolerance = 0.2;
+static constexpr const size_t reexplore_probes = 3;
+// unseen features values of regions with numeric context variables start
+// from the optima of this many nearest seen values, 0 disables
+static size_t   nearest_features    = 0;
 
 static Kokkos::Tools::Experimental::ToolProgrammingInterface helper_functions;
 static void
 invoke_fence(uint32_t devID)
 {
-	if (!convergence_stack.top()) // if we are in a non converged state, we
-				      // fence
+	if (!convergence_stack.empty() &&
+	    !convergence_stack.top()) // if we are in a non converged state,
+				      // we fence
 		helper_functions.fence(devID);
 }
 
@@ -128,8 +173,305 @@ kokkosp_end_parallel_reduce(const uint64_t kID)
 
 static std::map<size_t, ccs_parameter_t> features;
 static std::map<size_t, ccs_parameter_t> parameters;
-static std::map<std::set<size_t>, std::tuple<ccs_features_tuner_t, bool> >
-	tuners;
+static std::map<size_t, std::string>     feature_signatures;
+static std::map<size_t, std::string>     parameter_signatures;
+
+// CCS objects are not thread safe. Variable declarations, region creation
+// and destruction, and the tuning database are protected by the global
+// mutex. The objects of a region (tuner, spaces and bindings) are only
+// shared with the parameters, that regions retain at creation, so they are
+// protected by the region mutex.
+static std::mutex global_mutex;
+
+struct timing_stats_s {
+	size_t count;
+	double mean;
+	double m2;
+};
+typedef struct timing_stats_s timing_stats_t;
+
+// Timings of the configurations evaluated for a features value
+struct features_stats_s {
+	std::unordered_map<ccs_hash_t, timing_stats_t> configurations;
+	// configurations with at least exhaustion_samples timings
+	size_t                                         complete;
+	bool                                           confident;
+};
+typedef struct features_stats_s features_stats_t;
+
+// Launch statistics of a region, reported in the file given by
+// CCS_KOKKOS_STATS. They are updated at the end of each launch with relaxed
+// atomics so that converged launches remain lock free. The connector
+// overhead of launches that query the tuner is always timed, but only one
+// out of overhead_sample_period launches served from the thread caches is,
+// as reading the clock would cost as much as the launch. Overhead samples
+// are weighted accordingly in the total and in a log-linear histogram, 4 bins
+// per power of two nanoseconds, from which percentiles are estimated.
+static constexpr const unsigned overhead_sample_period = 16;
+static constexpr const size_t   overhead_bins          = 160;
+struct launch_stats_s {
+	std::atomic<size_t>  explore_launches;
+	std::atomic<size_t>  exploit_launches;
+	// timed launches of converged regions, included in exploit_launches
+	std::atomic<size_t>  probe_launches;
+	std::atomic<int64_t> explore_time;
+	std::atomic<int64_t> exploit_time;
+	std::atomic<int64_t> last_time;
+	// estimated from the samples
+	std::atomic<int64_t> overhead;
+	std::atomic<int64_t> max_overhead;
+	std::atomic<size_t>  overhead_histogram[overhead_bins];
+};
+typedef struct launch_stats_s launch_stats_t;
+
+// Tuning regions are identified by the set of their context and tuning
+// variables. Everything a request needs is cached in the region descriptor
+// at the first request, so that subsequent requests only marshal values.
+struct region_s {
+	ccs_features_tuner_t      tuner;
+	ccs_features_space_t      features_space;
+	ccs_configuration_space_t configuration_space;
+	ccs_objective_space_t     objective_space;
+	int                       id;
+	std::mutex                lock;
+	std::atomic<bool>         converged;
+	// incremented when the tuner is replaced, invalidates thread caches
+	// and in flight contexts
+	std::atomic<unsigned>     generation;
+	// number of converged launches, for re-exploration
+	std::atomic<size_t>       launches;
+	// the tuner was replaced and its database entry must be overwritten
+	bool                      reset;
+	size_t                    history_size;
+	// history size when the region was loaded from the tuning database
+	size_t                    loaded_history_size;
+	// stable identifier of the region across runs
+	std::string               signature;
+	// type ids in the order of the first request, requests usually list
+	// variables in that same order
+	std::vector<size_t>       context_ids;
+	std::vector<size_t>       tuning_ids;
+	// index of each of the above variables in the features space and
+	// configuration space
+	std::vector<size_t>       context_indexes;
+	std::vector<size_t>       tuning_indexes;
+	// convergence state
+	size_t                    space_size; // 0 if infinite
+	double                    best_time;
+	size_t                    stall_count;
+	size_t                    drift_count;
+	size_t                    num_incomplete;
+	size_t                    num_unconfident;
+	std::unordered_map<ccs_hash_t, features_stats_t> stats;
+	launch_stats_t            launch_stats;
+	// next region with the same hash
+	struct region_s          *next;
+};
+typedef struct region_s region_t;
+
+// The region table is sharded by hash. Shards are only modified with the
+// global mutex held, and are rarely accessed as threads cache the regions
+// they use.
+struct region_shard_s {
+	std::shared_timed_mutex                  lock;
+	std::unordered_map<uint64_t, region_t *> regions;
+};
+typedef struct region_shard_s region_shard_t;
+
+static constexpr const size_t num_region_shards = 16;
+static region_shard_t         region_shards[num_region_shards];
+// incremented when regions are destroyed, invalidates thread caches
+static std::atomic<unsigned>  regions_epoch(0);
+
+// Thread view of a region. For converged regions it also keeps the last
+// features and suggested configuration values, so that repeated launches
+// with the same features do not need to lock the region.
+static constexpr const size_t thread_cache_size = 16;
+struct thread_region_s {
+	unsigned                 epoch;
+	region_t                *region;
+	unsigned                 generation;
+	size_t                   num_cached;
+	size_t                   next_slot;
+	// thread_cache_size slots of features and configuration values
+	std::vector<ccs_datum_t> feature_values;
+	std::vector<ccs_datum_t> configuration_values;
+};
+typedef struct thread_region_s thread_region_t;
+
+static thread_local std::unordered_map<uint64_t, thread_region_t>
+	thread_regions;
+// value buffers, their capacity is retained between requests
+static thread_local std::vector<ccs_datum_t> feature_values;
+static thread_local std::vector<ccs_datum_t> configuration_values;
+
+// number of released features and configurations kept by each region for
+// reuse
+static constexpr const size_t binding_pool_capacity = 16;
+
+// Tuning database: serialized tuners indexed by region signature. The path
+// is given by the CCS_KOKKOS_DB environment variable, entries are loaded at
+// initialization and deserialized at the first request of their region.
+static std::string                        db_path;
+static std::map<std::string, std::string> db_entries;
+static constexpr const char               db_magic[8] = {
+        'C', 'C', 'S', 'K', 'D', 'B', '0', '1'};
+
+// Launch statistics report, given by the CCS_KOKKOS_STATS environment
+// variable, written at finalization.
+static std::string stats_path;
+
+// The length prefix is not trusted: it must fit in the bytes left before
+// the end of the file.
+static bool
+read_db_string(FILE *f, off_t end, std::string &str)
+{
+  uint64_t size;
+  off_t    pos;
+  if (fread(&size, sizeof(size), 1, f) != 1)
+	  return false;
+  pos = ftello(f);
+  if (pos < 0 || pos > end || size > (uint64_t)(end - pos))
+	  return false;
+  str.resize(size);
+  return size == 0 || fread(&str[0], size, 1, f) == 1;
+}
+
+static bool
+write_db_string(FILE *f, const std::string &str)
+{
+  uint64_t size = str.size();
+  if (fwrite(&size, sizeof(size), 1, f) != 1)
+	  return false;
+  return size == 0 || fwrite(str.data(), size, 1, f) == 1;
+}
+
+// Database layout: magic, followed by (signature, tuner) pairs of length
+// prefixed strings.
+static void
+read_db(const std::string &path, std::map<std::string, std::string> &entries)
+{
+  char        magic[sizeof(db_magic)];
+  struct stat st;
+  FILE       *f = fopen(path.c_str(), "rb");
+  if (!f)
+	  return;
+  if (fstat(fileno(f), &st) != 0 ||
+      fread(magic, sizeof(magic), 1, f) != 1 ||
+      memcmp(magic, db_magic, sizeof(magic))) {
+	  std::cerr << "CCS: ignoring invalid tuning database " << path
+		    << std::endl;
+	  fclose(f);
+	  return;
+  }
+  while (ftello(f) < st.st_size) {
+	  std::string signature, tuner;
+	  if (!read_db_string(f, st.st_size, signature) ||
+	      !read_db_string(f, st.st_size, tuner)) {
+		  std::cerr << "CCS: truncated tuning database " << path
+			    << std::endl;
+		  break;
+	  }
+	  entries[signature] = tuner;
+  }
+  fclose(f);
+}
+
+// The database is written in a temporary file and renamed, so readers
+// always see a complete database.
+static bool
+write_db(
+	const std::string                        &path,
+	const std::map<std::string, std::string> &entries)
+{
+  std::string tmp_path = path + "." + std::to_string(getpid()) + ".tmp";
+  FILE       *f        = fopen(tmp_path.c_str(), "wb");
+  bool        ok;
+  if (!f)
+	  return false;
+  ok = fwrite(db_magic, sizeof(db_magic), 1, f) == 1;
+  for (auto const &x : entries) {
+	  if (!ok)
+		  break;
+	  ok = write_db_string(f, x.first) && write_db_string(f, x.second);
+  }
+  ok = (fclose(f) == 0) && ok;
+  if (ok)
+	  ok = rename(tmp_path.c_str(), path.c_str()) == 0;
+  if (!ok)
+	  unlink(tmp_path.c_str());
+  return ok;
+}
+
+static void save_db();
+static void write_stats();
+
+static size_t
+env_size(const char *name, size_t value)
+{
+  const char *str = getenv(name);
+  if (str && *str)
+	  value = strtoull(str, NULL, 10);
+  return value;
+}
+
+static double
+env_double(const char *name, double value)
+{
+  const char *str = getenv(name);
+  if (str && *str)
+	  value = strtod(str, NULL);
+  return value;
+}
+
+static void
+read_convergence_settings()
+{
+  const char *str = getenv("CCS_KOKKOS_CONVERGENCE");
+  if (str && *str) {
+	  std::string policies(str);
+	  size_t      start = 0;
+	  convergence_policies = 0;
+	  while (start <= policies.size()) {
+		  size_t end = policies.find(',', start);
+		  if (end == std::string::npos)
+			  end = policies.size();
+		  std::string policy = policies.substr(start, end - start);
+		  if (policy == "history")
+			  convergence_policies |= CONVERGENCE_HISTORY;
+		  else if (policy == "exhaustion")
+			  convergence_policies |= CONVERGENCE_EXHAUSTION;
+		  else if (policy == "stall")
+			  convergence_policies |= CONVERGENCE_STALL;
+		  else if (policy == "confidence")
+			  convergence_policies |= CONVERGENCE_CONFIDENCE;
+		  else if (!policy.empty())
+			  std::cerr << "CCS: unknown convergence policy "
+				    << policy << std::endl;
+		  start = end + 1;
+	  }
+	  if (!convergence_policies)
+		  convergence_policies = CONVERGENCE_HISTORY;
+  }
+  convergence_cutoff =
+	  env_size("CCS_KOKKOS_HISTORY_SIZE", convergence_cutoff);
+  exhaustion_samples = std::max(
+	  env_size("CCS_KOKKOS_EXHAUSTION_SAMPLES", exhaustion_samples),
+	  (size_t)1);
+  stall_window = std::max(
+	  env_size("CCS_KOKKOS_STALL_WINDOW", stall_window), (size_t)1);
+  stall_tolerance =
+	  env_double("CCS_KOKKOS_STALL_TOLERANCE", stall_tolerance);
+  confidence_samples = std::max(
+	  env_size("CCS_KOKKOS_CONFIDENCE_SAMPLES", confidence_samples),
+	  (size_t)2);
+  reexplore_period =
+	  env_size("CCS_KOKKOS_REEXPLORE_PERIOD", reexplore_period);
+  reexplore_tolerance =
+	  env_double("CCS_KOKKOS_REEXPLORE_TOLERANCE", reexplore_tolerance);
+  nearest_features =
+	  env_size("CCS_KOKKOS_NEAREST_FEATURES", nearest_features);
+}
 
 extern "C" void
 kokkosp_parse_args(int argc, char **argv)
@@ -147,6 +489,32 @@ kokkosp_print_help(char *exe)
 CConfigSpace connector for Kokkos, supported options
 
 --autotuner=[string] : chose autotuner to use, supported values: 'random', default: 'random'
+
+Environment variables
+
+CCS_KOKKOS_DB=[path] : tuning database, tuners are loaded from it at startup and
+                       merged back into it at exit
+CCS_KOKKOS_STATS=[path] : per region launch statistics, written in JSON at exit
+CCS_KOKKOS_CONVERGENCE=[list] : comma separated convergence policies, a region
+                       stops exploring when one is satisfied: 'history',
+                       'exhaustion', 'stall', 'confidence', default: 'history'
+CCS_KOKKOS_HISTORY_SIZE=[int] : history policy cutoff, default: 500
+CCS_KOKKOS_EXHAUSTION_SAMPLES=[int] : exhaustion policy, evaluations of each
+                       configuration, default: 1
+CCS_KOKKOS_STALL_WINDOW=[int] : stall policy, evaluations without improvement,
+                       default: 100
+CCS_KOKKOS_STALL_TOLERANCE=[float] : stall policy, minimum relative
+                       improvement, default: 0.01
+CCS_KOKKOS_CONFIDENCE_SAMPLES=[int] : confidence policy, evaluations of each
+                       configuration, default: 3
+CCS_KOKKOS_REEXPLORE_PERIOD=[int] : time one out of this many launches of
+                       converged regions, 0 disables, default: 0
+CCS_KOKKOS_REEXPLORE_TOLERANCE=[float] : restart exploring a region when a
+                       timed launch is slower than the best by this ratio,
+                       default: 0.2
+CCS_KOKKOS_NEAREST_FEATURES=[int] : start unseen context values from the best
+                       configurations of this many nearest seen values, for
+                       numeric context variables, 0 disables, default: 0
 )";
 
   std::cout << OPTIONS_BLOCK;
@@ -165,7 +533,17 @@ kokkosp_init_library(
   std::cout << "Initializing CConfigSpace adapter" << std::endl;
   assert(interfaceVer >= KOKKOSP_INTERFACE_VERSION);
   CCS_CHECK(ccs_init());
-  convergence_stack.push(true);
+  read_convergence_settings();
+  const char *path = getenv("CCS_KOKKOS_DB");
+  if (path && *path) {
+	  db_path = path;
+	  read_db(db_path, db_entries);
+	  std::cout << "CCS: " << db_entries.size()
+		    << " regions in tuning database " << db_path << std::endl;
+  }
+  path = getenv("CCS_KOKKOS_STATS");
+  if (path && *path)
+	  stats_path = path;
 }
 
 extern "C" void
@@ -178,22 +556,47 @@ kokkosp_finalize_library()
   clock_gettime(CLOCK_MONOTONIC, &prof_start);
 #endif
 
-  for (auto const &x : features)
-	  CCS_CHECK(ccs_release_object(x.second));
-  features.clear();
-  for (auto const &x : parameters)
-	  CCS_CHECK(ccs_release_object(x.second));
-  parameters.clear();
-  for (auto const &x : tuners)
-	  CCS_CHECK(ccs_release_object(std::get<0>(x.second)));
-  tuners.clear();
+  {
+	  std::lock_guard<std::mutex> global_lock(global_mutex);
+	  if (!db_path.empty())
+		  save_db();
+	  db_entries.clear();
+	  if (!stats_path.empty())
+		  write_stats();
+
+	  for (auto const &x : features)
+		  CCS_CHECK(ccs_release_object(x.second));
+	  features.clear();
+	  feature_signatures.clear();
+	  for (auto const &x : parameters)
+		  CCS_CHECK(ccs_release_object(x.second));
+	  parameters.clear();
+	  parameter_signatures.clear();
+	  for (size_t i = 0; i < num_region_shards; i++) {
+		  std::unique_lock<std::shared_timed_mutex> lock(
+			  region_shards[i].lock);
+		  for (auto const &x : region_shards[i].regions) {
+			  region_t *region = x.second;
+			  while (region) {
+				  region_t *next = region->next;
+				  CCS_CHECK(ccs_release_object(region->tuner));
+				  delete region;
+				  region = next;
+			  }
+		  }
+		  region_shards[i].regions.clear();
+	  }
+	  regions_epoch++;
+  }
+  thread_regions.clear();
   CCS_CHECK(ccs_fini());
 #if CCS_PROFILE
   clock_gettime(CLOCK_MONOTONIC, &prof_stop);
   ccs_time += ((int64_t)(prof_stop.tv_sec) - (int64_t)(prof_start.tv_sec)) *
 		      1000000000 +
 	      (int64_t)(prof_stop.tv_nsec) - (int64_t)(prof_start.tv_nsec);
-  std::cout << "CCS profiling: " << (double)ccs_time / 1000000.0 << " ms"
+  std::cout << "CCS profiling: " << (double)ccs_time.load() / 1000000.0
+	    << " ms"
 	    << std::endl;
 #endif
 }
@@ -360,6 +763,92 @@ variable_info_to_parameter(const char *name, VariableInfo *info)
   return ret;
 }
 
+static inline void
+append_field(std::string &str, const std::string &field)
+{
+  str += std::to_string(field.size());
+  str += ':';
+  str += field;
+}
+
+static inline void
+append_string(std::string &str, const char *value)
+{
+  size_t length = strnlen(value, KOKKOS_TOOLS_TUNING_STRING_LENGTH);
+  append_field(str, std::string(value, length));
+}
+
+static inline void
+append_value(
+	std::string                                 &str,
+	ValueType                                    type,
+	const Kokkos_Tools_VariableValue_ValueUnion &value)
+{
+  char buff[64];
+  switch (type) {
+  case ValueType::kokkos_value_double:
+	  snprintf(buff, sizeof(buff), "%a", value.double_value);
+	  append_field(str, buff);
+	  break;
+  case ValueType::kokkos_value_int64:
+	  snprintf(buff, sizeof(buff), "%" PRId64, value.int_value);
+	  append_field(str, buff);
+	  break;
+  case ValueType::kokkos_value_string:
+	  append_string(str, value.string_value);
+	  break;
+  default:
+	  assert(false && "Unknown ValueType");
+  }
+}
+
+// Description of a variable that is stable across runs, contrary to its
+// type id.
+static std::string
+variable_signature(const char *name, VariableInfo *info)
+{
+  std::string sig;
+  append_field(sig, name);
+  append_field(sig, std::to_string((int)info->type));
+  append_field(sig, std::to_string((int)info->category));
+  append_field(sig, std::to_string((int)info->valueQuantity));
+  switch (info->valueQuantity) {
+  case CandidateValueType::kokkos_value_set:
+	  for (size_t i = 0; i < info->candidates.set.size; i++) {
+		  Kokkos_Tools_VariableValue_ValueUnion value;
+		  switch (info->type) {
+		  case ValueType::kokkos_value_double:
+			  value.double_value = info->candidates.set.values
+						       .double_value[i];
+			  break;
+		  case ValueType::kokkos_value_int64:
+			  value.int_value =
+				  info->candidates.set.values.int_value[i];
+			  break;
+		  case ValueType::kokkos_value_string:
+			  append_string(
+				  sig, info->candidates.set.values
+					       .string_value[i]);
+			  continue;
+		  default:
+			  assert(false && "Unknown ValueType");
+		  }
+		  append_value(sig, info->type, value);
+	  }
+	  break;
+  case CandidateValueType::kokkos_value_range:
+	  append_value(sig, info->type, info->candidates.range.lower);
+	  append_value(sig, info->type, info->candidates.range.upper);
+	  append_value(sig, info->type, info->candidates.range.step);
+	  append_field(sig, info->candidates.range.openLower ? "(" : "[");
+	  append_field(sig, info->candidates.range.openUpper ? ")" : "]");
+	  break;
+  default:
+	  break;
+  }
+  return sig;
+}
+
 extern "C" void
 kokkosp_declare_input_type(
 	const char                                *name,
@@ -372,7 +861,9 @@ kokkosp_declare_input_type(
 #endif
 
   CCS_DEBUG_MSG_ARGS("Got context variable: %s\n", name);
+  std::lock_guard<std::mutex> global_lock(global_mutex);
   features[id] = variable_info_to_parameter(name, info);
+  feature_signatures[id] = variable_signature(name, info);
   CCS_DEBUG_MSG_ARGS("...mapped to %p\n", (void *)features[id]);
 
 #if CCS_PROFILE
@@ -395,7 +886,9 @@ kokkosp_declare_output_type(
 #endif
 
   CCS_DEBUG_MSG_ARGS("Got tuning variable: %s\n", name);
+  std::lock_guard<std::mutex> global_lock(global_mutex);
   parameters[id] = variable_info_to_parameter(name, info);
+  parameter_signatures[id] = variable_signature(name, info);
   CCS_DEBUG_MSG_ARGS("...mapped to %p\n", (void *)parameters[id]);
 
 #if CCS_PROFILE
@@ -456,162 +949,1034 @@ extract_value(
   }
 }
 
-static std::map<
-	size_t,
-	std::tuple<
-		struct timespec,
-		ccs_features_tuner_t,
-		ccs_features_t,
-		ccs_configuration_t,
-		bool> >
-	   contexts;
-static int regionCounter = 0;
+struct context_s {
+	size_t              id;
+	struct timespec     start;
+	region_t           *region;
+	ccs_features_t      features;
+	ccs_configuration_t configuration;
+	bool                converged;
+	// timed launch of a converged region
+	bool                probe;
+	unsigned            generation;
+	// connector time spent in request_values in ns, -1 if not timed
+	int64_t             overhead;
+};
+typedef struct context_s context_t;
+
+// contexts are nested, so the innermost one of the thread is usually the
+// last one, the vector capacity is retained between requests.
+static thread_local std::vector<context_t> contexts;
+static thread_local unsigned               overhead_sample_count = 0;
+static int                                 regionCounter = 0;
+
+static inline uint64_t
+mix_id(uint64_t x)
+{
+  // splitmix64 finalizer
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+// order independent hash of the variables of a region
+static inline uint64_t
+region_hash(
+	size_t                                      numContextVariables,
+	Kokkos::Tools::Experimental::VariableValue *contextValues,
+	size_t                                      numTuningVariables,
+	Kokkos::Tools::Experimental::VariableValue *tuningValues)
+{
+  uint64_t h = mix_id(numContextVariables) ^ mix_id(~numTuningVariables);
+  for (size_t i = 0; i < numContextVariables; i++)
+	  h += mix_id(contextValues[i].type_id);
+  for (size_t i = 0; i < numTuningVariables; i++)
+	  h += mix_id(tuningValues[i].type_id ^ 0x5555555555555555ULL);
+  return h;
+}
+
+// index of the variable with the given type id, checking the expected
+// position first
+static inline size_t
+find_variable(const std::vector<size_t> &ids, size_t id, size_t hint)
+{
+  if (hint < ids.size() && ids[hint] == id)
+	  return hint;
+  for (size_t i = 0; i < ids.size(); i++)
+	  if (ids[i] == id)
+		  return i;
+  return ids.size();
+}
 
-extern "C" void
-kokkosp_request_values(
-	size_t                                      contextId,
+static bool
+region_match(
+	region_t                                   *region,
 	size_t                                      numContextVariables,
 	Kokkos::Tools::Experimental::VariableValue *contextValues,
 	size_t                                      numTuningVariables,
 	Kokkos::Tools::Experimental::VariableValue *tuningValues)
 {
+  if (region->context_ids.size() != numContextVariables ||
+      region->tuning_ids.size() != numTuningVariables)
+	  return false;
+  for (size_t i = 0; i < numContextVariables; i++)
+	  if (find_variable(
+		      region->context_ids, contextValues[i].type_id, i) ==
+	      numContextVariables)
+		  return false;
+  for (size_t i = 0; i < numTuningVariables; i++)
+	  if (find_variable(region->tuning_ids, tuningValues[i].type_id, i) ==
+	      numTuningVariables)
+		  return false;
+  return true;
+}
 
-  std::set<size_t>          regionId;
-  ccs_features_tuner_t      tuner;
-  ccs_features_t            feat;
-  ccs_features_space_t      features_space;
-  ccs_configuration_t       configuration;
-  ccs_configuration_space_t configuration_space;
-  struct timespec           start;
-  bool                      converged;
+// Sort the variables of a region by signature, so that the order of the
+// space parameters, and thus of the values of serialized tuners, depends
+// neither on the order of the request nor on the type ids.
+static void
+canonical_order(
+	size_t                                      numVariables,
+	Kokkos::Tools::Experimental::VariableValue *values,
+	std::map<size_t, std::string>              &signatures,
+	std::vector<size_t>                        &ids,
+	std::vector<size_t>                        &indexes,
+	std::string                                &signature)
+{
+  std::vector<size_t> order(numVariables);
+  for (size_t i = 0; i < numVariables; i++) {
+	  ids.push_back(values[i].type_id);
+	  order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+	  const std::string &sa = signatures[ids[a]];
+	  const std::string &sb = signatures[ids[b]];
+	  return sa < sb || (sa == sb && ids[a] < ids[b]);
+  });
+  indexes.resize(numVariables);
+  for (size_t i = 0; i < numVariables; i++) {
+	  indexes[order[i]] = i;
+	  append_field(signature, signatures[ids[order[i]]]);
+  }
+}
 
-  CCS_DEBUG_MSG_ARGS(
-	  "Querying variables: %zu, numContextVariables: %zu, numTuningVariables: %zu\n",
-	  contextId, numContextVariables, numTuningVariables);
+// Parameters are added to the spaces in canonical order. Called with the
+// global mutex held.
+static ccs_features_tuner_t
+create_tuner(region_t *region)
+{
+  ccs_configuration_space_t cs;
+  ccs_features_space_t      fs;
+  ccs_objective_space_t     os;
+  ccs_parameter_t           htime;
+  ccs_expression_t          expression;
+  ccs_features_tuner_t      tuner;
+  std::vector<size_t>       order;
+  std::string               suffix =
+	  " (region: " + std::to_string(region->id) + ")";
+
+  CCS_CHECK(ccs_create_configuration_space(("cs" + suffix).c_str(), &cs));
+  order.resize(region->tuning_ids.size());
+  for (size_t i = 0; i < order.size(); i++)
+	  order[region->tuning_indexes[i]] = i;
+  for (size_t i = 0; i < order.size(); i++)
+	  CCS_CHECK(ccs_configuration_space_add_parameter(
+		  cs, parameters[region->tuning_ids[order[i]]], NULL));
+
+  CCS_CHECK(ccs_create_features_space(("fs" + suffix).c_str(), &fs));
+  order.resize(region->context_ids.size());
+  for (size_t i = 0; i < order.size(); i++)
+	  order[region->context_indexes[i]] = i;
+  for (size_t i = 0; i < order.size(); i++)
+	  CCS_CHECK(ccs_features_space_add_parameter(
+		  fs, features[region->context_ids[order[i]]]));
+
+  ccs_int_t lower = 0;
+  ccs_int_t upper = CCS_INT_MAX;
+  ccs_int_t step  = 0;
+  CCS_CHECK(ccs_create_objective_space(("os" + suffix).c_str(), &os));
+  CCS_CHECK(ccs_create_numerical_parameter(
+	  "time", CCS_NUMERIC_TYPE_INT, lower, upper, step, lower, &htime));
+  CCS_CHECK(ccs_create_variable(htime, &expression));
+  CCS_CHECK(ccs_objective_space_add_parameter(os, htime));
+  CCS_CHECK(ccs_objective_space_add_objective(
+	  os, expression, CCS_OBJECTIVE_TYPE_MINIMIZE));
+  CCS_CHECK(ccs_release_object(expression));
+  CCS_CHECK(ccs_release_object(htime));
+
+  CCS_CHECK(ccs_create_random_features_tuner(
+	  ("random tuner" + suffix).c_str(), cs, fs, os, &tuner));
+  CCS_CHECK(ccs_release_object(cs));
+  CCS_CHECK(ccs_release_object(fs));
+  CCS_CHECK(ccs_release_object(os));
+  return tuner;
+}
 
-#if CCS_PROFILE
-  struct timespec prof_start, prof_stop;
-  clock_gettime(CLOCK_MONOTONIC, &prof_start);
-#endif
+// Deserialize a tuner from the tuning database, database content is not
+// trusted.
+static ccs_features_tuner_t
+load_tuner(
+	const std::string &buffer,
+	size_t             numContextVariables,
+	size_t             numTuningVariables)
+{
+  ccs_features_tuner_t      tuner;
+  ccs_object_type_t         type;
+  ccs_features_space_t      fs;
+  ccs_configuration_space_t cs;
+  size_t                    num_features, num_parameters;
+
+  if (ccs_object_deserialize(
+	      (ccs_object_t *)&tuner, CCS_SERIALIZE_FORMAT_BINARY,
+	      CCS_SERIALIZE_OPERATION_MEMORY, buffer.size(), buffer.data(),
+	      CCS_DESERIALIZE_OPTION_END) != CCS_RESULT_SUCCESS)
+	  return NULL;
+  CCS_CHECK(ccs_object_get_type(tuner, &type));
+  if (type == CCS_OBJECT_TYPE_FEATURES_TUNER) {
+	  CCS_CHECK(ccs_features_tuner_get_features_space(tuner, &fs));
+	  CCS_CHECK(ccs_features_tuner_get_configuration_space(tuner, &cs));
+	  CCS_CHECK(ccs_context_get_num_parameters(
+		  (ccs_context_t)fs, &num_features));
+	  CCS_CHECK(ccs_context_get_num_parameters(
+		  (ccs_context_t)cs, &num_parameters));
+	  if (num_features == numContextVariables &&
+	      num_parameters == numTuningVariables)
+		  return tuner;
+  }
+  CCS_CHECK(ccs_release_object(tuner));
+  return NULL;
+}
 
-  for (size_t i = 0; i < numContextVariables; i++)
-	  regionId.insert(contextValues[i].type_id);
-  for (size_t i = 0; i < numTuningVariables; i++)
-	  regionId.insert(tuningValues[i].type_id);
-
-  auto tun = tuners.find(regionId);
-  if (tun == tuners.end()) {
-	  ccs_configuration_space_t cs;
-	  ccs_features_space_t      fs;
-	  ccs_objective_space_t     os;
-	  ccs_parameter_t           htime;
-	  ccs_expression_t          expression;
-
-	  CCS_CHECK(ccs_create_configuration_space(
-		  ("cs (region: " + std::to_string(regionCounter) + ")").c_str(),
-		  &cs));
-	  for (size_t i = 0; i < numTuningVariables; i++)
-		  CCS_CHECK(ccs_configuration_space_add_parameter(
-			  cs, parameters[tuningValues[i].type_id], NULL));
+static void
+save_tuner(ccs_features_tuner_t tuner, std::string &buffer)
+{
+  size_t size;
+  CCS_CHECK(ccs_object_serialize(
+	  tuner, CCS_SERIALIZE_FORMAT_BINARY, CCS_SERIALIZE_OPERATION_SIZE,
+	  &size, CCS_SERIALIZE_OPTION_END));
+  buffer.resize(size);
+  CCS_CHECK(ccs_object_serialize(
+	  tuner, CCS_SERIALIZE_FORMAT_BINARY, CCS_SERIALIZE_OPERATION_MEMORY,
+	  size, &buffer[0], CCS_SERIALIZE_OPTION_END));
+}
 
-#if CCS_DEBUG
-	  for (size_t i = 0; i < numTuningVariables; i++) {
-		  ccs_datum_t d;
-		  extract_value(tuningValues + i, &d);
+// Number of configurations of a configuration space, 0 if infinite or too
+// large to be exhausted.
+static size_t
+space_size(ccs_configuration_space_t cs)
+{
+  size_t num_parameters;
+  double size = 1.0;
+  CCS_CHECK(ccs_context_get_num_parameters(
+	  (ccs_context_t)cs, &num_parameters));
+  for (size_t i = 0; i < num_parameters; i++) {
+	  ccs_parameter_t      parameter;
+	  ccs_parameter_type_t type;
+	  size_t               num_values;
+	  ccs_numeric_type_t   data_type;
+	  ccs_numeric_t        lower, upper, q;
+	  CCS_CHECK(ccs_context_get_parameter(
+		  (ccs_context_t)cs, i, &parameter));
+	  CCS_CHECK(ccs_parameter_get_type(parameter, &type));
+	  switch (type) {
+	  case CCS_PARAMETER_TYPE_CATEGORICAL:
+		  CCS_CHECK(ccs_categorical_parameter_get_values(
+			  parameter, 0, NULL, &num_values));
+		  size *= num_values;
+		  break;
+	  case CCS_PARAMETER_TYPE_ORDINAL:
+		  CCS_CHECK(ccs_ordinal_parameter_get_values(
+			  parameter, 0, NULL, &num_values));
+		  size *= num_values;
+		  break;
+	  case CCS_PARAMETER_TYPE_DISCRETE:
+		  CCS_CHECK(ccs_discrete_parameter_get_values(
+			  parameter, 0, NULL, &num_values));
+		  size *= num_values;
+		  break;
+	  case CCS_PARAMETER_TYPE_NUMERICAL:
+		  CCS_CHECK(ccs_numerical_parameter_get_properties(
+			  parameter, &data_type, &lower, &upper, &q));
+		  if (data_type != CCS_NUMERIC_TYPE_INT)
+			  return 0;
+		  size *= ceil(
+			  ((double)upper.i - (double)lower.i) /
+			  (q.i ? (double)q.i : 1.0));
+		  break;
+	  default:
+		  return 0;
 	  }
-#endif
+  }
+  return size < 1e15 ? (size_t)size : 0;
+}
 
-	  CCS_CHECK(ccs_create_features_space(
-		  ("fs (region: " + std::to_string(regionCounter) + ")").c_str(),
-		  &fs));
-	  for (size_t i = 0; i < numContextVariables; i++)
-		  CCS_CHECK(ccs_features_space_add_parameter(
-			  fs, features[contextValues[i].type_id]));
-
-	  ccs_int_t lower = 0;
-	  ccs_int_t upper = CCS_INT_MAX;
-	  ccs_int_t step  = 0;
-	  CCS_CHECK(ccs_create_objective_space(
-		  ("os (region: " + std::to_string(regionCounter) + ")").c_str(),
-		  &os));
-	  CCS_CHECK(ccs_create_numerical_parameter(
-		  "time", CCS_NUMERIC_TYPE_INT, lower, upper, step, lower,
-		  &htime));
-	  CCS_CHECK(ccs_create_variable(htime, &expression));
-	  CCS_CHECK(ccs_objective_space_add_parameter(os, htime));
-	  CCS_CHECK(ccs_objective_space_add_objective(
-		  os, expression, CCS_OBJECTIVE_TYPE_MINIMIZE));
-	  CCS_CHECK(ccs_release_object(expression));
-	  CCS_CHECK(ccs_release_object(htime));
-
-	  CCS_CHECK(ccs_create_random_features_tuner(
-		  ("random tuner (region: " + std::to_string(regionCounter) +
-		   ")")
-			  .c_str(),
-		  cs, fs, os, &tuner));
-	  CCS_CHECK(ccs_release_object(cs));
-	  CCS_CHECK(ccs_release_object(fs));
-	  CCS_CHECK(ccs_release_object(os));
-
-	  converged        = false;
-	  tuners[regionId] = std::make_tuple(tuner, converged);
-	  regionCounter++;
-  } else {
-	  tuner     = std::get<0>(tun->second);
-	  converged = std::get<1>(tun->second);
+static inline double
+standard_error(const timing_stats_t &stats)
+{
+  return sqrt(stats.m2 / (double)(stats.count - 1) / (double)stats.count);
+}
+
+// Every configuration was timed confidence_samples times, and the confidence
+// interval of the best one is below the confidence interval of the others.
+static bool
+features_confident(const features_stats_t &group)
+{
+  const timing_stats_t *best = NULL;
+  if (group.configurations.size() < 2)
+	  return false;
+  for (auto const &x : group.configurations) {
+	  if (x.second.count < confidence_samples)
+		  return false;
+	  if (!best || x.second.mean < best->mean)
+		  best = &x.second;
   }
+  double upper = best->mean + confidence_z * standard_error(*best);
+  for (auto const &x : group.configurations)
+	  if (&x.second != best &&
+	      x.second.mean - confidence_z * standard_error(x.second) <= upper)
+		  return false;
+  return true;
+}
+
+static void
+record_timing(
+	region_t           *region,
+	ccs_features_t      feat,
+	ccs_configuration_t configuration,
+	double              elapsed)
+{
+  ccs_hash_t features_hash, configuration_hash;
+  CCS_CHECK(ccs_binding_hash((ccs_binding_t)feat, &features_hash));
+  CCS_CHECK(
+	  ccs_binding_hash((ccs_binding_t)configuration, &configuration_hash));
+  auto group = region->stats.find(features_hash);
+  if (group == region->stats.end()) {
+	  group = region->stats.emplace(features_hash, features_stats_t())
+			  .first;
+	  group->second.complete  = 0;
+	  group->second.confident = false;
+	  region->num_incomplete++;
+	  region->num_unconfident++;
+  }
+  timing_stats_t &stats =
+	  group->second.configurations[configuration_hash];
+  double delta = elapsed - stats.mean;
+  stats.count++;
+  stats.mean += delta / stats.count;
+  stats.m2 += delta * (elapsed - stats.mean);
+  if (stats.count == exhaustion_samples && region->space_size &&
+      ++group->second.complete == region->space_size)
+	  region->num_incomplete--;
+  bool confident = features_confident(group->second);
+  if (confident != group->second.confident) {
+	  group->second.confident = confident;
+	  if (confident)
+		  region->num_unconfident--;
+	  else
+		  region->num_unconfident++;
+  }
+}
 
-  // Test convergence using history size, could be done better
-  if (!converged) {
-	  size_t history_size;
+// Account for an evaluation told to the region tuner, and test convergence.
+// Called with the region mutex held.
+static void
+record_evaluation(
+	region_t           *region,
+	ccs_features_t      feat,
+	ccs_configuration_t configuration,
+	ccs_int_t           elapsed)
+{
+  bool converged = false;
+  region->history_size++;
+  if (elapsed < region->best_time * (1.0 - stall_tolerance)) {
+	  region->best_time   = elapsed;
+	  region->stall_count = 0;
+  } else
+	  region->stall_count++;
+  if (convergence_policies &
+      (CONVERGENCE_EXHAUSTION | CONVERGENCE_CONFIDENCE))
+	  record_timing(region, feat, configuration, elapsed);
+
+  if ((convergence_policies & CONVERGENCE_HISTORY) &&
+      region->history_size >= convergence_cutoff)
+	  converged = true;
+  if ((convergence_policies & CONVERGENCE_STALL) &&
+      region->stall_count >= stall_window)
+	  converged = true;
+  if ((convergence_policies & CONVERGENCE_EXHAUSTION) &&
+      !region->stats.empty() && !region->num_incomplete)
+	  converged = true;
+  if ((convergence_policies & CONVERGENCE_CONFIDENCE) &&
+      !region->stats.empty() && !region->num_unconfident)
+	  converged = true;
+  if (converged)
+	  region->converged = true;
+}
+
+// Use a new tuner for the region, and replay its history to restore the
+// convergence state. Called with the global mutex held.
+static void
+set_region_tuner(region_t *region, ccs_features_tuner_t tuner)
+{
+  size_t count;
+  if (region->tuner)
+	  CCS_CHECK(ccs_release_object(region->tuner));
+  region->tuner = tuner;
+  CCS_CHECK(ccs_features_tuner_get_features_space(
+	  tuner, &region->features_space));
+  CCS_CHECK(ccs_features_tuner_get_configuration_space(
+	  tuner, &region->configuration_space));
+  CCS_CHECK(ccs_features_tuner_get_objective_space(
+	  tuner, &region->objective_space));
+  // features and configurations are created and released at each launch
+  CCS_CHECK(ccs_context_set_binding_pool_capacity(
+	  (ccs_context_t)region->configuration_space, binding_pool_capacity));
+  CCS_CHECK(ccs_context_set_binding_pool_capacity(
+	  (ccs_context_t)region->features_space, binding_pool_capacity));
+  // not serialized, and unsupported with categorical context variables
+  if (nearest_features)
+	  ccs_features_tuner_set_nearest_features(tuner, nearest_features);
+
+  region->converged       = false;
+  region->history_size    = 0;
+  region->space_size      = space_size(region->configuration_space);
+  region->best_time       = INFINITY;
+  region->stall_count     = 0;
+  region->drift_count     = 0;
+  region->num_incomplete  = 0;
+  region->num_unconfident = 0;
+  region->stats.clear();
+
+  CCS_CHECK(ccs_features_tuner_get_history(tuner, NULL, 0, NULL, &count));
+  std::vector<ccs_features_evaluation_t> history(count);
+  if (count)
 	  CCS_CHECK(ccs_features_tuner_get_history(
-		  tuner, NULL, 0, NULL, &history_size));
-	  converged = (history_size >= convergence_cutoff);
-	  if (converged)
-		  tuners[regionId] = std::make_tuple(tuner, converged);
+		  tuner, NULL, count, history.data(), NULL));
+  for (size_t i = 0; i < count; i++) {
+	  ccs_configuration_t configuration;
+	  ccs_features_t      feat;
+	  ccs_datum_t         elapsed;
+	  CCS_CHECK(ccs_features_evaluation_get_configuration(
+		  history[i], &configuration));
+	  CCS_CHECK(ccs_features_evaluation_get_features(history[i], &feat));
+	  CCS_CHECK(ccs_features_evaluation_get_value(
+		  history[i], 0, &elapsed));
+	  record_evaluation(region, feat, configuration, elapsed.value.i);
   }
-  if (convergence_stack.top()) // if we are in a converged region,
-	  convergence_stack.push(converged);
-  else // else propagate unconverged status
-	  convergence_stack.push(false);
+  region->loaded_history_size = region->history_size;
+  region->generation++;
+}
 
-  CCS_CHECK(ccs_features_tuner_get_features_space(tuner, &features_space));
+static region_t *
+create_region(
+	size_t                                      numContextVariables,
+	Kokkos::Tools::Experimental::VariableValue *contextValues,
+	size_t                                      numTuningVariables,
+	Kokkos::Tools::Experimental::VariableValue *tuningValues)
+{
+  region_t            *region = new region_t();
+  ccs_features_tuner_t tuner  = NULL;
+
+  region->id = regionCounter++;
+  append_field(region->signature, std::to_string(numContextVariables));
+  append_field(region->signature, std::to_string(numTuningVariables));
+  canonical_order(
+	  numContextVariables, contextValues, feature_signatures,
+	  region->context_ids, region->context_indexes, region->signature);
+  canonical_order(
+	  numTuningVariables, tuningValues, parameter_signatures,
+	  region->tuning_ids, region->tuning_indexes, region->signature);
+
+#if CCS_DEBUG
+  for (size_t i = 0; i < numTuningVariables; i++) {
+	  ccs_datum_t d;
+	  extract_value(tuningValues + i, &d);
+  }
+#endif
+
+  auto entry = db_entries.find(region->signature);
+  if (entry != db_entries.end()) {
+	  tuner = load_tuner(
+		  entry->second, numContextVariables, numTuningVariables);
+	  db_entries.erase(entry);
+  }
+  if (!tuner)
+	  tuner = create_tuner(region);
+  region->tuner      = NULL;
+  region->generation = 0;
+  region->launches   = 0;
+  region->reset      = false;
+  region->next       = NULL;
+  set_region_tuner(region, tuner);
+  CCS_DEBUG_MSG_ARGS(
+	  "Region %d starts with %zu evaluations\n", region->id,
+	  region->history_size);
+  return region;
+}
+
+// Timings of a converged region have drifted, start exploring again with a
+// new tuner.
+static void
+reset_region(region_t *region, unsigned generation)
+{
+  std::lock_guard<std::mutex> global_lock(global_mutex);
+  std::lock_guard<std::mutex> lock(region->lock);
+  // another thread may have reset the region already
+  if (region->generation != generation)
+	  return;
+  CCS_DEBUG_MSG_ARGS("Region %d timings drifted\n", region->id);
+  set_region_tuner(region, create_tuner(region));
+  region->reset = true;
+}
+
+// Bindings of a replaced tuner may hold the last references to its spaces,
+// whose destruction releases parameters shared by all the regions.
+static void
+release_stale_context(const context_t &context)
+{
+  std::lock_guard<std::mutex> global_lock(global_mutex);
+  CCS_CHECK(ccs_release_object(context.features));
+  CCS_CHECK(ccs_release_object(context.configuration));
+}
+
+static region_t *
+find_region(
+	region_shard_t                             &shard,
+	uint64_t                                    hash,
+	size_t                                      numContextVariables,
+	Kokkos::Tools::Experimental::VariableValue *contextValues,
+	size_t                                      numTuningVariables,
+	Kokkos::Tools::Experimental::VariableValue *tuningValues)
+{
+  auto reg = shard.regions.find(hash);
+  if (reg == shard.regions.end())
+	  return NULL;
+  for (region_t *region = reg->second; region; region = region->next)
+	  if (region_match(
+		      region, numContextVariables, contextValues,
+		      numTuningVariables, tuningValues))
+		  return region;
+  return NULL;
+}
+
+static thread_region_t *
+get_region(
+	size_t                                      numContextVariables,
+	Kokkos::Tools::Experimental::VariableValue *contextValues,
+	size_t                                      numTuningVariables,
+	Kokkos::Tools::Experimental::VariableValue *tuningValues)
+{
+  uint64_t         hash = region_hash(
+          numContextVariables, contextValues, numTuningVariables,
+          tuningValues);
+  unsigned         epoch = regions_epoch.load();
+  thread_region_t &tr    = thread_regions[hash];
+  if (tr.region && tr.epoch == epoch &&
+      region_match(
+	      tr.region, numContextVariables, contextValues,
+	      numTuningVariables, tuningValues))
+	  return &tr;
+
+  region_shard_t &shard = region_shards[hash % num_region_shards];
+  region_t       *region;
   {
-	  ccs_datum_t *values = new ccs_datum_t[numContextVariables];
-	  for (size_t i = 0; i < numContextVariables; i++) {
-		  size_t indx;
-		  CCS_CHECK(ccs_features_space_get_parameter_index(
-			  features_space, features[contextValues[i].type_id],
-			  &indx));
-		  extract_value(contextValues + i, values + indx);
+	  std::shared_lock<std::shared_timed_mutex> lock(shard.lock);
+	  region = find_region(
+		  shard, hash, numContextVariables, contextValues,
+		  numTuningVariables, tuningValues);
+  }
+  if (!region) {
+	  std::lock_guard<std::mutex>               global_lock(global_mutex);
+	  std::unique_lock<std::shared_timed_mutex> lock(shard.lock);
+	  // the region may have been created by another thread meanwhile
+	  region = find_region(
+		  shard, hash, numContextVariables, contextValues,
+		  numTuningVariables, tuningValues);
+	  if (!region) {
+		  region = create_region(
+			  numContextVariables, contextValues,
+			  numTuningVariables, tuningValues);
+		  auto reg = shard.regions.find(hash);
+		  if (reg != shard.regions.end())
+			  region->next = reg->second;
+		  shard.regions[hash] = region;
 	  }
+  }
+  tr.region     = region;
+  tr.epoch      = epoch;
+  tr.generation = region->generation;
+  tr.num_cached = 0;
+  tr.next_slot  = 0;
+  tr.feature_values.resize(thread_cache_size * numContextVariables);
+  tr.configuration_values.resize(thread_cache_size * numTuningVariables);
+  return &tr;
+}
+
+static inline bool
+same_values(size_t num_values, const ccs_datum_t *a, const ccs_datum_t *b)
+{
+  for (size_t i = 0; i < num_values; i++) {
+	  if (a[i].type != b[i].type)
+		  return false;
+	  if (a[i].type == CCS_DATA_TYPE_STRING) {
+		  if (strcmp(a[i].value.s, b[i].value.s))
+			  return false;
+	  } else if (memcmp(&a[i].value, &b[i].value, sizeof(a[i].value)))
+		  return false;
+  }
+  return true;
+}
+
+// Tell the evaluations made during this run to a tuner of the same region
+// loaded from the database.
+static void
+merge_history(region_t *region, ccs_features_tuner_t tuner)
+{
+  ccs_configuration_space_t cs;
+  ccs_features_space_t      fs;
+  ccs_objective_space_t     os;
+  size_t                    count;
+  size_t                    num_features   = region->context_ids.size();
+  size_t                    num_parameters = region->tuning_ids.size();
+  std::vector<ccs_datum_t>  feature_values(num_features);
+  std::vector<ccs_datum_t>  configuration_values(num_parameters);
+
+  CCS_CHECK(ccs_features_tuner_get_features_space(tuner, &fs));
+  CCS_CHECK(ccs_features_tuner_get_configuration_space(tuner, &cs));
+  CCS_CHECK(ccs_features_tuner_get_objective_space(tuner, &os));
+  CCS_CHECK(ccs_features_tuner_get_history(
+	  region->tuner, NULL, 0, NULL, &count));
+  std::vector<ccs_features_evaluation_t> history(count);
+  CCS_CHECK(ccs_features_tuner_get_history(
+	  region->tuner, NULL, count, history.data(), NULL));
+  for (size_t i = region->loaded_history_size; i < count; i++) {
+	  ccs_configuration_t       configuration;
+	  ccs_features_t            feat;
+	  ccs_evaluation_result_t   result;
+	  ccs_datum_t               elapsed;
+	  ccs_features_evaluation_t evaluation;
+
+	  CCS_CHECK(ccs_features_evaluation_get_configuration(
+		  history[i], &configuration));
+	  CCS_CHECK(ccs_features_evaluation_get_features(history[i], &feat));
+	  CCS_CHECK(ccs_features_evaluation_get_result(history[i], &result));
+	  CCS_CHECK(ccs_features_evaluation_get_value(
+		  history[i], 0, &elapsed));
+	  CCS_CHECK(ccs_configuration_get_values(
+		  configuration, num_parameters, configuration_values.data(),
+		  NULL));
+	  if (num_features)
+		  CCS_CHECK(ccs_features_get_values(
+			  feat, num_features, feature_values.data(), NULL));
+
+	  CCS_CHECK(ccs_create_configuration(
+		  cs, num_parameters, configuration_values.data(),
+		  &configuration));
 	  CCS_CHECK(ccs_create_features(
-		  features_space, numContextVariables, values, &feat));
-	  delete[] values;
+		  fs, num_features, feature_values.data(), &feat));
+	  CCS_CHECK(ccs_create_features_evaluation(
+		  os, configuration, feat, result, 1, &elapsed, &evaluation));
+	  CCS_CHECK(ccs_features_tuner_tell(tuner, 1, &evaluation));
+	  CCS_CHECK(ccs_release_object(evaluation));
+	  CCS_CHECK(ccs_release_object(feat));
+	  CCS_CHECK(ccs_release_object(configuration));
   }
+}
+
+static void
+save_region(region_t *region, std::map<std::string, std::string> &entries)
+{
+  std::lock_guard<std::mutex> lock(region->lock);
+  // the timings of the stored tuner are obsolete
+  if (region->reset) {
+	  save_tuner(region->tuner, entries[region->signature]);
+	  return;
+  }
+  if (region->history_size == region->loaded_history_size)
+	  return;
+  auto entry = entries.find(region->signature);
+  if (entry == entries.end()) {
+	  save_tuner(region->tuner, entries[region->signature]);
+	  return;
+  }
+  ccs_features_tuner_t tuner = load_tuner(
+	  entry->second, region->context_ids.size(), region->tuning_ids.size());
+  if (!tuner) {
+	  save_tuner(region->tuner, entry->second);
+	  return;
+  }
+  merge_history(region, tuner);
+  save_tuner(tuner, entry->second);
+  CCS_CHECK(ccs_release_object(tuner));
+}
+
+// Merge the tuners into the database. Concurrent processes (e.g. MPI ranks)
+// are serialized through a lock file, and the database is read again under
+// the lock, so that the evaluations of every process are kept. Called with
+// the global mutex held.
+static void
+save_db()
+{
+  std::map<std::string, std::string> entries;
+  std::string                        lock_path = db_path + ".lock";
+  int fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+
+  if (fd == -1 || flock(fd, LOCK_EX)) {
+	  std::cerr << "CCS: could not lock tuning database " << db_path
+		    << std::endl;
+	  if (fd != -1)
+		  close(fd);
+	  return;
+  }
+  read_db(db_path, entries);
+  for (size_t i = 0; i < num_region_shards; i++) {
+	  for (auto const &x : region_shards[i].regions) {
+		  for (region_t *region = x.second; region;
+		       region           = region->next)
+			  save_region(region, entries);
+	  }
+  }
+  if (!write_db(db_path, entries))
+	  std::cerr << "CCS: could not write tuning database " << db_path
+		    << std::endl;
+  flock(fd, LOCK_UN);
+  close(fd);
+}
+
+static inline int64_t
+elapsed_ns(const struct timespec &start, const struct timespec &stop)
+{
+  return ((int64_t)(stop.tv_sec) - (int64_t)(start.tv_sec)) * 1000000000 +
+	 (int64_t)(stop.tv_nsec) - (int64_t)(start.tv_nsec);
+}
+
+static inline size_t
+overhead_bin(int64_t ns)
+{
+  if (ns < 4)
+	  return ns < 0 ? 0 : (size_t)ns;
+  int    e   = 63 - __builtin_clzll((unsigned long long)ns);
+  size_t bin = 4 * (e - 1) + ((ns >> (e - 2)) & 3);
+  return bin < overhead_bins ? bin : overhead_bins - 1;
+}
+
+// middle of the bin
+static inline double
+overhead_bin_value(size_t bin)
+{
+  if (bin < 4)
+	  return (double)bin;
+  int e = (int)(bin / 4) + 1;
+  return ldexp(4.0 + bin % 4 + 0.5, e - 2);
+}
 
-  if (!converged)
-	  CCS_CHECK(
-		  ccs_features_tuner_ask(tuner, feat, 1, &configuration, NULL));
+static void
+record_launch(const context_t &context, int64_t elapsed, int64_t overhead)
+{
+  launch_stats_t &stats = context.region->launch_stats;
+  if (!context.converged) {
+	  stats.explore_launches.fetch_add(1, std::memory_order_relaxed);
+	  stats.explore_time.fetch_add(elapsed, std::memory_order_relaxed);
+  } else {
+	  stats.exploit_launches.fetch_add(1, std::memory_order_relaxed);
+	  stats.exploit_time.fetch_add(elapsed, std::memory_order_relaxed);
+	  if (context.probe)
+		  stats.probe_launches.fetch_add(
+			  1, std::memory_order_relaxed);
+  }
+  stats.last_time.store(elapsed, std::memory_order_relaxed);
+  if (overhead < 0)
+	  return;
+  unsigned weight = context.converged && !context.probe
+			    ? overhead_sample_period
+			    : 1;
+  stats.overhead.fetch_add(weight * overhead, std::memory_order_relaxed);
+  stats.overhead_histogram[overhead_bin(overhead)].fetch_add(
+	  weight, std::memory_order_relaxed);
+  int64_t max = stats.max_overhead.load(std::memory_order_relaxed);
+  while (overhead > max &&
+	 !stats.max_overhead.compare_exchange_weak(
+		 max, overhead, std::memory_order_relaxed))
+	  ;
+}
+
+static void
+write_json_string(FILE *f, const char *str)
+{
+  fputc('"', f);
+  for (; *str; str++) {
+	  unsigned char c = (unsigned char)*str;
+	  if (c == '"' || c == '\\')
+		  fprintf(f, "\\%c", c);
+	  else if (c < 0x20)
+		  fprintf(f, "\\u%04x", c);
+	  else
+		  fputc(c, f);
+  }
+  fputc('"', f);
+}
+
+static void
+write_json_variables(
+	FILE                                   *f,
+	const std::vector<size_t>              &ids,
+	const std::map<size_t, ccs_parameter_t> &variables)
+{
+  fputc('[', f);
+  for (size_t i = 0; i < ids.size(); i++) {
+	  const char *name = "";
+	  auto        var  = variables.find(ids[i]);
+	  if (var != variables.end())
+		  CCS_CHECK(ccs_parameter_get_name(var->second, &name));
+	  if (i)
+		  fputs(", ", f);
+	  write_json_string(f, name);
+  }
+  fputc(']', f);
+}
+
+// null for missing values
+static void
+write_json_number(FILE *f, double value, bool valid)
+{
+  if (valid && isfinite(value))
+	  fprintf(f, "%.17g", value);
   else
-	  CCS_CHECK(ccs_features_tuner_suggest(tuner, feat, &configuration));
+	  fputs("null", f);
+}
 
-  CCS_CHECK(ccs_features_tuner_get_configuration_space(
-	  tuner, &configuration_space));
-  {
-	  ccs_datum_t *values = new ccs_datum_t[numTuningVariables];
+static void
+write_region_stats(FILE *f, region_t *region)
+{
+  std::lock_guard<std::mutex> lock(region->lock);
+  launch_stats_t             &stats    = region->launch_stats;
+  size_t                      explore  = stats.explore_launches;
+  size_t                      exploit  = stats.exploit_launches;
+  size_t                      launches = explore + exploit;
+  double explore_mean = explore ? (double)stats.explore_time / explore : 0.0;
+  double exploit_mean = exploit ? (double)stats.exploit_time / exploit : 0.0;
+  // exploit launches would have cost the average explored configuration
+  // without tuning
+  double saved = explore && exploit ? exploit * (explore_mean - exploit_mean)
+				    : 0.0;
+  double percentiles[3] = {0.5, 0.9, 0.99};
+  double values[3]      = {0.0, 0.0, 0.0};
+  size_t total = 0, count = 0, p = 0;
+  for (size_t bin = 0; bin < overhead_bins; bin++)
+	  total += stats.overhead_histogram[bin];
+  for (size_t bin = 0; bin < overhead_bins && p < 3; bin++) {
+	  count += stats.overhead_histogram[bin];
+	  while (p < 3 && count && count >= percentiles[p] * total)
+		  values[p++] = overhead_bin_value(bin);
+  }
+
+  fprintf(f, "    {\n      \"id\": %d,\n", region->id);
+  fputs("      \"context_variables\": ", f);
+  write_json_variables(f, region->context_ids, features);
+  fputs(",\n      \"tuning_variables\": ", f);
+  write_json_variables(f, region->tuning_ids, parameters);
+  fprintf(f,
+	  ",\n      \"converged\": %s,\n      \"history_size\": %zu,\n"
+	  "      \"resets\": %u,\n",
+	  region->converged ? "true" : "false", region->history_size,
+	  region->generation - 1);
+  fprintf(f,
+	  "      \"launches\": %zu,\n      \"explore_launches\": %zu,\n"
+	  "      \"exploit_launches\": %zu,\n"
+	  "      \"probe_launches\": %zu,\n",
+	  launches, explore, exploit, (size_t)stats.probe_launches);
+  fprintf(f,
+	  "      \"overhead_ns\": {\"total\": %" PRId64 ", \"mean\": ",
+	  (int64_t)stats.overhead);
+  write_json_number(f, (double)stats.overhead / launches, total);
+  for (size_t i = 0; i < 3; i++) {
+	  fprintf(f, ", \"p%g\": ", percentiles[i] * 100);
+	  write_json_number(f, values[i], total);
+  }
+  fputs(", \"max\": ", f);
+  write_json_number(f, (double)stats.max_overhead, total);
+  fputs("},\n      \"kernel_time_ns\": {\"best\": ", f);
+  write_json_number(f, region->best_time, true);
+  fputs(", \"last\": ", f);
+  write_json_number(f, (double)stats.last_time, launches);
+  fputs(", \"explore_mean\": ", f);
+  write_json_number(f, explore_mean, explore);
+  fputs(", \"exploit_mean\": ", f);
+  write_json_number(f, exploit_mean, exploit);
+  fputs("},\n      \"estimated_time_saved_ns\": ", f);
+  write_json_number(f, saved, true);
+  fputs(",\n      \"estimated_net_time_saved_ns\": ", f);
+  write_json_number(f, saved - stats.overhead, true);
+  fputs("\n    }", f);
+}
+
+// Write the launch statistics of every region, ordered by id. Called with
+// the global mutex held.
+static void
+write_stats()
+{
+  std::vector<region_t *> regions;
+  for (size_t i = 0; i < num_region_shards; i++)
+	  for (auto const &x : region_shards[i].regions)
+		  for (region_t *region = x.second; region;
+		       region           = region->next)
+			  regions.push_back(region);
+  std::sort(
+	  regions.begin(), regions.end(),
+	  [](region_t *a, region_t *b) { return a->id < b->id; });
+
+  FILE *f = fopen(stats_path.c_str(), "w");
+  if (!f) {
+	  std::cerr << "CCS: could not write statistics " << stats_path
+		    << std::endl;
+	  return;
+  }
+  fputs("{\n  \"regions\": [", f);
+  for (size_t i = 0; i < regions.size(); i++) {
+	  fputs(i ? ",\n" : "\n", f);
+	  write_region_stats(f, regions[i]);
+  }
+  fputs(regions.empty() ? "]\n}\n" : "\n  ]\n}\n", f);
+  fclose(f);
+}
+
+extern "C" void
+kokkosp_request_values(
+	size_t                                      contextId,
+	size_t                                      numContextVariables,
+	Kokkos::Tools::Experimental::VariableValue *contextValues,
+	size_t                                      numTuningVariables,
+	Kokkos::Tools::Experimental::VariableValue *tuningValues)
+{
+
+  thread_region_t    *tr;
+  region_t           *region;
+  ccs_features_t      feat          = NULL;
+  ccs_configuration_t configuration = NULL;
+  ccs_datum_t        *values;
+  struct timespec     entry, start;
+  bool                converged;
+  bool                probe      = false;
+  unsigned            generation = 0;
+  bool                timed =
+	  ++overhead_sample_count % overhead_sample_period == 0;
+
+  if (timed)
+	  clock_gettime(CLOCK_MONOTONIC, &entry);
+
+  CCS_DEBUG_MSG_ARGS(
+	  "Querying variables: %zu, numContextVariables: %zu, numTuningVariables: %zu\n",
+	  contextId, numContextVariables, numTuningVariables);
+
+#if CCS_PROFILE
+  struct timespec prof_start, prof_stop;
+  clock_gettime(CLOCK_MONOTONIC, &prof_start);
+#endif
+
+  tr     = get_region(
+      numContextVariables, contextValues, numTuningVariables, tuningValues);
+  region = tr->region;
+
+  converged = region->converged.load();
+  if (converged && reexplore_period)
+	  probe = (region->launches.fetch_add(1) + 1) % reexplore_period == 0;
+  if (!timed && (!converged || probe)) {
+	  timed = true;
+	  clock_gettime(CLOCK_MONOTONIC, &entry);
+  }
+  if (convergence_stack.empty() ||
+      convergence_stack.top()) // if we are in a converged region,
+	  convergence_stack.push(converged && !probe);
+  else // else propagate unconverged status
+	  convergence_stack.push(false);
+
+  feature_values.resize(numContextVariables);
+  configuration_values.resize(numTuningVariables);
+  for (size_t i = 0; i < numContextVariables; i++)
+	  extract_value(
+		  contextValues + i,
+		  feature_values.data() +
+			  region->context_indexes[find_variable(
+				  region->context_ids,
+				  contextValues[i].type_id, i)]);
+
+  if (!converged || probe) {
+	  std::lock_guard<std::mutex> lock(region->lock);
+	  generation = region->generation;
+	  // launches with the same context values share their features
+	  CCS_CHECK(ccs_features_space_intern_features(
+		  region->features_space, numContextVariables,
+		  feature_values.data(), &feat));
+	  if (probe)
+		  CCS_CHECK(ccs_features_tuner_suggest(
+			  region->tuner, feat, &configuration));
+	  else
+		  CCS_CHECK(ccs_features_tuner_ask(
+			  region->tuner, feat, 1, &configuration, NULL));
 	  CCS_CHECK(ccs_configuration_get_values(
-		  configuration, numTuningVariables, values, NULL));
-	  for (size_t i = 0; i < numTuningVariables; i++) {
-		  size_t indx;
-		  CCS_CHECK(ccs_configuration_space_get_parameter_index(
-			  configuration_space,
-			  parameters[tuningValues[i].type_id], &indx));
-		  set_value(tuningValues + i, values + indx);
+		  configuration, numTuningVariables,
+		  configuration_values.data(), NULL));
+	  values = configuration_values.data();
+  } else {
+	  // converged regions are not reported to, reuse the last
+	  // suggestions of the thread for the same features
+	  size_t slot = 0;
+	  if (tr->generation != region->generation) {
+		  tr->generation = region->generation;
+		  tr->num_cached = 0;
+		  tr->next_slot  = 0;
+	  }
+	  while (slot < tr->num_cached &&
+		 !same_values(
+			 numContextVariables, feature_values.data(),
+			 tr->feature_values.data() +
+				 slot * numContextVariables))
+		  slot++;
+	  if (slot == tr->num_cached) {
+		  std::lock_guard<std::mutex> lock(region->lock);
+		  if (tr->generation != region->generation) {
+			  tr->generation = region->generation;
+			  tr->num_cached = 0;
+			  tr->next_slot  = 0;
+		  }
+		  // the returned values are owned by the parameters, and
+		  // suggestions that follow from optima are also cached by
+		  // the tuner
+		  slot          = tr->next_slot;
+		  tr->next_slot = (slot + 1) % thread_cache_size;
+		  if (tr->num_cached < thread_cache_size)
+			  tr->num_cached++;
+		  CCS_CHECK(ccs_features_tuner_suggest_values(
+			  region->tuner, numContextVariables,
+			  feature_values.data(), numTuningVariables,
+			  tr->configuration_values.data() +
+				  slot * numTuningVariables,
+			  NULL));
+		  // transient strings are replaced by the ones memoized by
+		  // the features space
+		  for (size_t i = 0; i < numContextVariables; i++)
+			  if (feature_values[i].type == CCS_DATA_TYPE_STRING)
+				  CCS_CHECK(ccs_features_space_validate_value(
+					  region->features_space, i,
+					  feature_values[i],
+					  feature_values.data() + i));
+		  std::copy(
+			  feature_values.begin(), feature_values.end(),
+			  tr->feature_values.begin() +
+				  slot * numContextVariables);
 	  }
-	  delete[] values;
+	  values = tr->configuration_values.data() +
+		   slot * numTuningVariables;
   }
 
+  for (size_t i = 0; i < numTuningVariables; i++)
+	  set_value(
+		  tuningValues + i,
+		  values + region->tuning_indexes[find_variable(
+				   region->tuning_ids, tuningValues[i].type_id,
+				   i)]);
+
 #if CCS_PROFILE
   clock_gettime(CLOCK_MONOTONIC, &prof_stop);
   ccs_time += ((int64_t)(prof_stop.tv_sec) - (int64_t)(prof_start.tv_sec)) *
@@ -620,8 +1985,9 @@ kokkosp_request_values(
 #endif
 
   clock_gettime(CLOCK_MONOTONIC, &start);
-  contexts[contextId] =
-	  std::make_tuple(start, tuner, feat, configuration, converged);
+  contexts.push_back(
+	  {contextId, start, region, feat, configuration, converged, probe,
+	   generation, timed ? elapsed_ns(entry, start) : -1});
 }
 
 extern "C" void
@@ -633,18 +1999,16 @@ kokkosp_begin_context(size_t contextId)
 extern "C" void
 kokkosp_end_context(size_t contextId)
 {
-  struct timespec       start, stop;
-  ccs_features_tuner_t  tuner;
-  ccs_features_t        feat;
-  ccs_configuration_t   configuration;
-  ccs_objective_space_t objective_space;
-  bool                  converged;
+  struct timespec stop;
+  context_t       context;
 
   clock_gettime(CLOCK_MONOTONIC, &stop);
   CCS_DEBUG_MSG_ARGS("Leaving region: %zu\n", contextId);
 
-  auto ctx = contexts.find(contextId);
-  if (ctx == contexts.end())
+  auto ctx = contexts.rbegin();
+  while (ctx != contexts.rend() && ctx->id != contextId)
+	  ctx++;
+  if (ctx == contexts.rend())
 	  return;
 
 #if CCS_PROFILE
@@ -655,36 +2019,81 @@ kokkosp_end_context(size_t contextId)
   CCS_DEBUG_MSG("Found tuning context\n");
 
   convergence_stack.pop();
-  auto context  = ctx->second;
-  start         = std::get<0>(context);
-  tuner         = std::get<1>(context);
-  feat          = std::get<2>(context);
-  configuration = std::get<3>(context);
-  converged     = std::get<4>(context);
-  contexts.erase(contextId);
-
-  if (!converged) { // do not report if not fencing and already converged.
-	  ccs_features_evaluation_t evaluation;
-	  // elapsed time in nanosecond
-	  ccs_datum_t               elapsed = ccs_int(
-                  ((ccs_int_t)(stop.tv_sec) - (ccs_int_t)(start.tv_sec)) *
-                          1000000000 +
-                  (ccs_int_t)(stop.tv_nsec) - (ccs_int_t)(start.tv_nsec));
-	  CCS_DEBUG_MSG_ARGS(
-		  "elapsed time: %f ms\n", elapsed.value.i / 1000000.0);
-
-	  CCS_CHECK(ccs_features_tuner_get_objective_space(
-		  tuner, &objective_space));
-	  CCS_CHECK(ccs_create_features_evaluation(
-		  objective_space, configuration, feat, CCS_RESULT_SUCCESS, 1,
-		  &elapsed, &evaluation));
-
-	  CCS_CHECK(ccs_features_tuner_tell(tuner, 1, &evaluation));
-	  CCS_CHECK(ccs_release_object(evaluation));
+  context = *ctx;
+  contexts.erase(std::next(ctx).base());
+
+  // elapsed time in nanosecond
+  ccs_int_t elapsed =
+	  ((ccs_int_t)(stop.tv_sec) - (ccs_int_t)(context.start.tv_sec)) *
+		  1000000000 +
+	  (ccs_int_t)(stop.tv_nsec) - (ccs_int_t)(context.start.tv_nsec);
+  region_t *region = context.region;
+
+  if (!context.converged) { // do not report if not fencing and already
+			    // converged.
+	  CCS_DEBUG_MSG_ARGS("elapsed time: %f ms\n", elapsed / 1000000.0);
+
+	  std::unique_lock<std::mutex> lock(region->lock);
+	  // the tuner may have been replaced since the request
+	  if (context.generation != region->generation) {
+		  lock.unlock();
+		  release_stale_context(context);
+	  } else {
+		  ccs_features_evaluation_t evaluation;
+		  ccs_datum_t               value = ccs_int(elapsed);
+		  CCS_CHECK(ccs_create_features_evaluation(
+			  region->objective_space, context.configuration,
+			  context.features, CCS_RESULT_SUCCESS, 1, &value,
+			  &evaluation));
+		  CCS_CHECK(ccs_features_tuner_tell(
+			  region->tuner, 1, &evaluation));
+		  CCS_CHECK(ccs_release_object(evaluation));
+		  record_evaluation(
+			  region, context.features, context.configuration,
+			  elapsed);
+		  CCS_CHECK(ccs_release_object(context.features));
+		  CCS_CHECK(ccs_release_object(context.configuration));
+	  }
+  } else if (context.probe) {
+	  bool                         drift = false;
+	  std::unique_lock<std::mutex> lock(region->lock);
+	  if (context.generation != region->generation) {
+		  lock.unlock();
+		  release_stale_context(context);
+	  } else {
+		  size_t count = 0;
+		  CCS_CHECK(ccs_features_tuner_get_optima(
+			  region->tuner, context.features, 0, NULL, &count));
+		  if (count) {
+			  std::vector<ccs_features_evaluation_t> optima(count);
+			  ccs_datum_t                            best;
+			  CCS_CHECK(ccs_features_tuner_get_optima(
+				  region->tuner, context.features, count,
+				  optima.data(), NULL));
+			  CCS_CHECK(ccs_features_evaluation_get_value(
+				  optima[0], 0, &best));
+			  if (elapsed > (1.0 + reexplore_tolerance) *
+						best.value.i)
+				  drift = ++region->drift_count >=
+					  reexplore_probes;
+			  else
+				  region->drift_count = 0;
+		  }
+		  CCS_CHECK(ccs_release_object(context.features));
+		  CCS_CHECK(ccs_release_object(context.configuration));
+		  lock.unlock();
+	  }
+	  if (drift)
+		  reset_region(region, context.generation);
   }
 
-  CCS_CHECK(ccs_release_object(feat));
-  CCS_CHECK(ccs_release_object(configuration));
+  int64_t overhead = context.overhead;
+  if (overhead >= 0) {
+	  struct timespec done;
+	  clock_gettime(CLOCK_MONOTONIC, &done);
+	  overhead += elapsed_ns(stop, done);
+  }
+  record_launch(context, elapsed, overhead);
 
 #if CCS_PROFILE
   clock_gettime(CLOCK_MONOTONIC, &prof_stop);
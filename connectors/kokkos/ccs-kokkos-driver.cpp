@@ -0,0 +1,710 @@
+// Standalone driver for the CCS Kokkos connector.
+//
+// The connector is loaded the way Kokkos loads a tool library, and the
+// tuning callbacks of synthetic kernels are replayed against it: variables
+// are declared, and each launch goes through begin_context, request_values,
+// begin/end_parallel_for and end_context. Kernels are simulated by spinning
+// for the time given by a timing model, so the connector overhead and the
+// quality of its tuning can be measured without Kokkos.
+#include <impl/Kokkos_Profiling_Interface.hpp>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <dlfcn.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+using namespace Kokkos::Tools::Experimental;
+
+// The connector ignores the objective value Kokkos passes to end_context.
+typedef void (*endContextFunction)(size_t);
+
+struct connector_s {
+	void                                   *handle;
+	Kokkos::Tools::initFunction             init;
+	Kokkos::Tools::finalizeFunction         finalize;
+	Kokkos::Tools::parseArgsFunction        parse_args;
+	Kokkos::Tools::beginFunction            begin_parallel_for;
+	Kokkos::Tools::endFunction              end_parallel_for;
+	provideToolProgrammingInterfaceFunction provide_interface;
+	requestToolSettingsFunction             request_settings;
+	inputTypeDeclarationFunction            declare_input_type;
+	outputTypeDeclarationFunction           declare_output_type;
+	requestValueFunction                    request_values;
+	contextBeginFunction                    begin_context;
+	endContextFunction                      end_context;
+};
+typedef struct connector_s connector_t;
+
+enum timing_model_e { MODEL_BOWL, MODEL_RANDOM, MODEL_FLAT };
+static const char *model_names[] = {"bowl", "random", "flat"};
+
+struct settings_s {
+	std::string         library;
+	std::string         trace;
+	std::string         record;
+	size_t              regions;
+	size_t              features;
+	size_t              variables;
+	size_t              candidates;
+	size_t              launches;
+	size_t              threads;
+	size_t              shift;
+	enum timing_model_e model;
+	double              base;
+	double              spread;
+	double              noise;
+	uint64_t            seed;
+};
+typedef struct settings_s settings_t;
+
+// A launch of a region kernel with a given features value
+struct launch_s {
+	uint32_t region;
+	uint32_t feature;
+};
+typedef struct launch_s launch_t;
+
+// Modeled times of the best and of the average configuration, for a region,
+// a features value and an epoch of the optima
+struct reference_s {
+	double best;
+	double mean;
+};
+typedef struct reference_s reference_t;
+
+struct thread_stats_s {
+	std::vector<double> overheads;
+	std::vector<double> steady_overheads;
+	std::vector<size_t> steady_launches;
+	std::vector<double> steady_slowdowns;
+	double              tuned;
+	double              best;
+	double              mean;
+};
+typedef struct thread_stats_s thread_stats_t;
+
+static connector_t              connector;
+static settings_t               settings;
+static std::vector<launch_t>    launches;
+static std::vector<reference_t> references;
+static std::atomic<size_t>      context_counter(0);
+
+static void
+usage(const char *exe)
+{
+	printf("Usage: %s [options] [-- connector arguments]\n\n", exe);
+	printf(R"(Replays Kokkos tuning callbacks against the CCS Kokkos connector.
+
+--library=[path] : connector library, default: $KOKKOS_PROFILE_LIBRARY or
+                   .libs/ccs-kokkos-connector.so
+--regions=[int] : number of tuned kernels, default: 4
+--features=[int] : number of values of the context variable shared by the
+                   kernels, 0 disables it, default: 2
+--variables=[int] : tuning variables per kernel, default: 2
+--candidates=[int] : candidate values per tuning variable, default: 8
+--launches=[int] : number of kernel launches, default: 20000, or the trace
+                   length
+--threads=[int] : host threads launching kernels, default: 1
+--model=[string] : timing model, 'bowl' (a single optimum), 'random'
+                   (independent configurations) or 'flat', default: 'bowl'
+--base=[float] : time of the best configurations in ns, 0 does not spin,
+                 default: 10000
+--spread=[float] : relative slowdown of the worst configurations, default: 2
+--noise=[float] : relative amplitude of the timing noise, default: 0.02
+--shift=[int] : move the optima after this many launches, default: never
+--seed=[int] : seed of the launch sequence and of the timing model
+--trace=[path] : replay the launches of a trace, one 'region feature' pair
+                 per line
+--record=[path] : save the launch sequence as a trace
+)");
+}
+
+static bool
+parse_size(const char *str, size_t &value)
+{
+	char *end;
+	errno = 0;
+	unsigned long long v = strtoull(str, &end, 10);
+	if (errno || end == str || *end || *str == '-')
+		return false;
+	value = (size_t)v;
+	return true;
+}
+
+static bool
+parse_double(const char *str, double &value)
+{
+	char *end;
+	errno = 0;
+	double v = strtod(str, &end);
+	if (errno || end == str || *end || !(v >= 0.0))
+		return false;
+	value = v;
+	return true;
+}
+
+static bool
+parse_option(const char *arg)
+{
+	const char *eq = strchr(arg, '=');
+	if (strncmp(arg, "--", 2) || !eq)
+		return false;
+	std::string name(arg + 2, eq - arg - 2);
+	const char *value = eq + 1;
+	size_t      seed;
+	if (name == "library")
+		settings.library = value;
+	else if (name == "trace")
+		settings.trace = value;
+	else if (name == "record")
+		settings.record = value;
+	else if (name == "regions")
+		return parse_size(value, settings.regions) && settings.regions;
+	else if (name == "features")
+		return parse_size(value, settings.features);
+	else if (name == "variables")
+		return parse_size(value, settings.variables) &&
+		       settings.variables;
+	else if (name == "candidates")
+		return parse_size(value, settings.candidates) &&
+		       settings.candidates;
+	else if (name == "launches")
+		return parse_size(value, settings.launches);
+	else if (name == "threads")
+		return parse_size(value, settings.threads) && settings.threads;
+	else if (name == "shift")
+		return parse_size(value, settings.shift);
+	else if (name == "base")
+		return parse_double(value, settings.base);
+	else if (name == "spread")
+		return parse_double(value, settings.spread);
+	else if (name == "noise")
+		return parse_double(value, settings.noise) &&
+		       settings.noise < 1.0;
+	else if (name == "seed") {
+		if (!parse_size(value, seed))
+			return false;
+		settings.seed = seed;
+	} else if (name == "model") {
+		size_t m = 0;
+		while (m <= MODEL_FLAT && strcmp(value, model_names[m]))
+			m++;
+		if (m > MODEL_FLAT)
+			return false;
+		settings.model = (enum timing_model_e)m;
+	} else
+		return false;
+	return true;
+}
+
+static void *
+load_symbol(const char *name, bool required)
+{
+	void *sym = dlsym(connector.handle, name);
+	if (!sym && required) {
+		fprintf(stderr, "Could not find %s in %s\n", name,
+			settings.library.c_str());
+		exit(EXIT_FAILURE);
+	}
+	return sym;
+}
+
+static void
+load_connector()
+{
+	connector.handle =
+		dlopen(settings.library.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (!connector.handle) {
+		fprintf(stderr, "Could not load connector: %s\n", dlerror());
+		exit(EXIT_FAILURE);
+	}
+#define LOAD(field, name, required)                                            \
+	connector.field = (decltype(connector.field))load_symbol(             \
+		"kokkosp_" name, required)
+	LOAD(init, "init_library", true);
+	LOAD(finalize, "finalize_library", true);
+	LOAD(parse_args, "parse_args", false);
+	LOAD(begin_parallel_for, "begin_parallel_for", false);
+	LOAD(end_parallel_for, "end_parallel_for", false);
+	LOAD(provide_interface, "provide_tool_programming_interface", false);
+	LOAD(request_settings, "request_tool_settings", false);
+	LOAD(declare_input_type, "declare_input_type", true);
+	LOAD(declare_output_type, "declare_output_type", true);
+	LOAD(request_values, "request_values", true);
+	LOAD(begin_context, "begin_context", true);
+	LOAD(end_context, "end_context", true);
+#undef LOAD
+}
+
+static inline uint64_t
+mix(uint64_t x)
+{
+	x += 0x9e3779b97f4a7c15ULL;
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+// uniform in [0, 1)
+static inline double
+uniform(uint64_t x)
+{
+	return (mix(x) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline uint64_t
+model_key(size_t region, size_t feature, size_t epoch)
+{
+	return mix(mix(mix(settings.seed ^ region) ^ feature) ^ epoch);
+}
+
+// Modeled time of a configuration, given as candidate indexes
+static double
+model_time(uint64_t key, const size_t *config)
+{
+	double distance = 0.0;
+	switch (settings.model) {
+	case MODEL_BOWL:
+		if (settings.candidates < 2)
+			break;
+		for (size_t k = 0; k < settings.variables; k++) {
+			double optimum = mix(key + k) % settings.candidates;
+			double d       = (config[k] - optimum) /
+				   (settings.candidates - 1);
+			distance += d * d;
+		}
+		distance /= settings.variables;
+		break;
+	case MODEL_RANDOM:
+		for (size_t k = 0; k < settings.variables; k++)
+			key = mix(key ^ config[k]);
+		distance = uniform(key);
+		break;
+	case MODEL_FLAT:
+		break;
+	}
+	return settings.base * (1.0 + settings.spread * distance);
+}
+
+static inline size_t
+reference_index(size_t region, size_t feature, size_t epoch)
+{
+	size_t num_features = settings.features ? settings.features : 1;
+	return (epoch * settings.regions + region) * num_features + feature;
+}
+
+// Enumerate the configurations of a region to find the oracle and the
+// average times
+static void
+compute_reference(uint64_t key, reference_t &ref)
+{
+	std::vector<size_t> config(settings.variables, 0);
+	size_t              count = 0;
+	ref.best                  = INFINITY;
+	ref.mean                  = 0.0;
+	while (true) {
+		double t = model_time(key, config.data());
+		ref.best = std::min(ref.best, t);
+		ref.mean += t;
+		count++;
+		size_t k = 0;
+		while (k < settings.variables &&
+		       ++config[k] == settings.candidates)
+			config[k++] = 0;
+		if (k == settings.variables)
+			break;
+	}
+	ref.mean /= count;
+}
+
+static void
+compute_references()
+{
+	size_t num_features = settings.features ? settings.features : 1;
+	size_t num_epochs   = settings.shift ? 2 : 1;
+	double size = pow((double)settings.candidates, settings.variables);
+	if (size > (double)(1 << 20)) {
+		fprintf(stderr, "Too many configurations per region: %g\n",
+			size);
+		exit(EXIT_FAILURE);
+	}
+	references.resize(num_epochs * settings.regions * num_features);
+	for (size_t e = 0; e < num_epochs; e++)
+		for (size_t r = 0; r < settings.regions; r++)
+			for (size_t f = 0; f < num_features; f++)
+				compute_reference(
+					model_key(r, f, e),
+					references[reference_index(r, f, e)]);
+}
+
+static void
+read_trace()
+{
+	FILE *f = fopen(settings.trace.c_str(), "r");
+	if (!f) {
+		fprintf(stderr, "Could not open trace %s\n",
+			settings.trace.c_str());
+		exit(EXIT_FAILURE);
+	}
+	char   line[256];
+	size_t lineno = 0;
+	while (fgets(line, sizeof(line), f)) {
+		unsigned long region, feature = 0;
+		char         *p = line + strspn(line, " \t");
+		lineno++;
+		if (*p == '#' || *p == '\n' || !*p)
+			continue;
+		int n = sscanf(p, "%lu %lu", &region, &feature);
+		if (n < 1 || region >= settings.regions ||
+		    (settings.features ? feature >= settings.features
+				       : feature != 0)) {
+			fprintf(stderr, "Invalid launch in %s:%zu\n",
+				settings.trace.c_str(), lineno);
+			exit(EXIT_FAILURE);
+		}
+		launches.push_back({(uint32_t)region, (uint32_t)feature});
+	}
+	fclose(f);
+	if (launches.empty()) {
+		fprintf(stderr, "Empty trace %s\n", settings.trace.c_str());
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void
+generate_launches()
+{
+	std::vector<launch_t> trace;
+	if (!settings.trace.empty()) {
+		read_trace();
+		trace.swap(launches);
+		if (!settings.launches)
+			settings.launches = trace.size();
+	} else if (!settings.launches)
+		settings.launches = 20000;
+	launches.resize(settings.launches);
+	for (size_t i = 0; i < settings.launches; i++) {
+		if (!trace.empty()) {
+			launches[i] = trace[i % trace.size()];
+			continue;
+		}
+		uint64_t x = mix(settings.seed ^ mix(i));
+		launches[i].region = (uint32_t)(x % settings.regions);
+		launches[i].feature =
+			settings.features
+				? (uint32_t)((x >> 32) % settings.features)
+				: 0;
+	}
+	if (!settings.record.empty()) {
+		FILE *f = fopen(settings.record.c_str(), "w");
+		if (!f) {
+			fprintf(stderr, "Could not open %s\n",
+				settings.record.c_str());
+			exit(EXIT_FAILURE);
+		}
+		fprintf(f, "# region feature\n");
+		for (auto &l : launches)
+			fprintf(f, "%" PRIu32 " %" PRIu32 "\n", l.region,
+				l.feature);
+		fclose(f);
+	}
+}
+
+static void
+fence(const uint32_t devID)
+{
+	(void)devID;
+}
+
+// The driver owns the variable descriptions, as Kokkos does
+static std::vector<int64_t> feature_candidates;
+static std::vector<int64_t> tuning_candidates;
+static VariableInfo         feature_info;
+static VariableInfo         tuning_info;
+
+static inline size_t
+feature_id()
+{
+	return 0;
+}
+
+static inline size_t
+tuning_id(size_t region, size_t variable)
+{
+	return 1 + region * settings.variables + variable;
+}
+
+static void
+declare_variables()
+{
+	char name[64];
+	if (settings.features) {
+		for (size_t i = 0; i < settings.features; i++)
+			feature_candidates.push_back((int64_t)i);
+		feature_info.type          = kokkos_value_int64;
+		feature_info.category      = kokkos_value_categorical;
+		feature_info.valueQuantity = kokkos_value_set;
+		feature_info.candidates.set.size = settings.features;
+		feature_info.candidates.set.values.int_value =
+			feature_candidates.data();
+		connector.declare_input_type(
+			"ccs_driver_feature", feature_id(), &feature_info);
+	}
+	for (size_t i = 0; i < settings.candidates; i++)
+		tuning_candidates.push_back((int64_t)i + 1);
+	tuning_info.type                = kokkos_value_int64;
+	tuning_info.category            = kokkos_value_ordinal;
+	tuning_info.valueQuantity       = kokkos_value_set;
+	tuning_info.candidates.set.size = settings.candidates;
+	tuning_info.candidates.set.values.int_value = tuning_candidates.data();
+	for (size_t r = 0; r < settings.regions; r++)
+		for (size_t k = 0; k < settings.variables; k++) {
+			snprintf(
+				name, sizeof(name),
+				"ccs_driver_region%zu_var%zu", r, k);
+			connector.declare_output_type(
+				name, tuning_id(r, k), &tuning_info);
+		}
+}
+
+static inline double
+now()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+run_launches(size_t thread, thread_stats_t *stats)
+{
+	size_t        num_context = settings.features ? 1 : 0;
+	VariableValue context_value;
+	std::vector<VariableValue> tuning_values(settings.variables);
+	std::vector<size_t>        config(settings.variables);
+	std::vector<std::string>   kernel_names(settings.regions);
+	for (size_t r = 0; r < settings.regions; r++)
+		kernel_names[r] = "ccs_driver_kernel" + std::to_string(r);
+	size_t count = 0;
+	for (size_t i = thread; i < settings.launches; i += settings.threads)
+		count++;
+	size_t steady = count - count / 4;
+	stats->overheads.reserve(count);
+	stats->steady_launches.assign(settings.regions, 0);
+	stats->steady_slowdowns.assign(settings.regions, 0.0);
+	stats->tuned = stats->best = stats->mean = 0.0;
+
+	size_t n = 0;
+	for (size_t i = thread; i < settings.launches;
+	     i += settings.threads, n++) {
+		const launch_t &l     = launches[i];
+		size_t          epoch = settings.shift && i >= settings.shift;
+		size_t          id    = context_counter++;
+		uint64_t        kID   = 0;
+
+		context_value.type_id             = feature_id();
+		context_value.value.int_value     = l.feature;
+		context_value.metadata            = &feature_info;
+		for (size_t k = 0; k < settings.variables; k++) {
+			tuning_values[k].type_id = tuning_id(l.region, k);
+			tuning_values[k].value.int_value = tuning_candidates[0];
+			tuning_values[k].metadata        = &tuning_info;
+		}
+
+		double t0 = now();
+		connector.begin_context(id);
+		connector.request_values(
+			id, num_context, &context_value, settings.variables,
+			tuning_values.data());
+		if (connector.begin_parallel_for)
+			connector.begin_parallel_for(
+				kernel_names[l.region].c_str(), 0, &kID);
+		double t1 = now();
+
+		for (size_t k = 0; k < settings.variables; k++) {
+			auto it = std::find(
+				tuning_candidates.begin(),
+				tuning_candidates.end(),
+				tuning_values[k].value.int_value);
+			config[k] = it - tuning_candidates.begin();
+		}
+		uint64_t key  = model_key(l.region, l.feature, epoch);
+		double   time = model_time(key, config.data());
+		if (settings.base > 0.0) {
+			double noise = 2.0 * uniform(key ^ mix(i)) - 1.0;
+			double noisy = time * (1.0 + settings.noise * noise);
+			while (now() - t1 < noisy)
+				;
+		}
+
+		double t2 = now();
+		if (connector.end_parallel_for)
+			connector.end_parallel_for(kID);
+		connector.end_context(id);
+		double t3 = now();
+
+		double overhead = (t1 - t0) + (t3 - t2);
+		const reference_t &ref =
+			references[reference_index(l.region, l.feature, epoch)];
+		stats->overheads.push_back(overhead);
+		stats->tuned += time;
+		stats->best += ref.best;
+		stats->mean += ref.mean;
+		if (n >= steady) {
+			stats->steady_overheads.push_back(overhead);
+			stats->steady_launches[l.region]++;
+			stats->steady_slowdowns[l.region] += time / ref.best;
+		}
+	}
+}
+
+static double
+percentile(const std::vector<double> &sorted, double p)
+{
+	if (sorted.empty())
+		return 0.0;
+	size_t i = (size_t)ceil(p * sorted.size());
+	return sorted[i ? i - 1 : 0];
+}
+
+static void
+print_overheads(const char *title, std::vector<double> &overheads)
+{
+	double sum = 0.0;
+	for (double o : overheads)
+		sum += o;
+	std::sort(overheads.begin(), overheads.end());
+	printf("%s (ns): mean %.0f, p50 %.0f, p90 %.0f, p99 %.0f, max %.0f\n",
+	       title, overheads.empty() ? 0.0 : sum / overheads.size(),
+	       percentile(overheads, 0.5), percentile(overheads, 0.9),
+	       percentile(overheads, 0.99), percentile(overheads, 1.0));
+}
+
+static void
+report(std::vector<thread_stats_t> &stats)
+{
+	std::vector<double> overheads, steady_overheads;
+	std::vector<size_t> steady_launches(settings.regions, 0);
+	std::vector<double> steady_slowdowns(settings.regions, 0.0);
+	double              tuned = 0.0, best = 0.0, mean = 0.0;
+	for (auto &s : stats) {
+		overheads.insert(
+			overheads.end(), s.overheads.begin(),
+			s.overheads.end());
+		steady_overheads.insert(
+			steady_overheads.end(), s.steady_overheads.begin(),
+			s.steady_overheads.end());
+		for (size_t r = 0; r < settings.regions; r++) {
+			steady_launches[r] += s.steady_launches[r];
+			steady_slowdowns[r] += s.steady_slowdowns[r];
+		}
+		tuned += s.tuned;
+		best += s.best;
+		mean += s.mean;
+	}
+
+	print_overheads("connector overhead per launch", overheads);
+	print_overheads(
+		"steady state overhead, last 25% of launches",
+		steady_overheads);
+	printf("modeled kernel time (ms): tuned %.3f, oracle %.3f, average "
+	       "configuration %.3f\n",
+	       tuned * 1e-6, best * 1e-6, mean * 1e-6);
+	printf("tuning quality: %.3fx oracle time, %.3fx speedup over the "
+	       "average configuration\n",
+	       best > 0.0 ? tuned / best : 1.0,
+	       tuned > 0.0 ? mean / tuned : 1.0);
+	printf("region  launches  slowdown (last 25%%)\n");
+	for (size_t r = 0; r < settings.regions; r++)
+		printf("%6zu  %8zu  %.3f\n", r, steady_launches[r],
+		       steady_launches[r]
+			       ? steady_slowdowns[r] / steady_launches[r]
+			       : 0.0);
+}
+
+int
+main(int argc, char **argv)
+{
+	const char *env   = getenv("KOKKOS_PROFILE_LIBRARY");
+	settings.library  = env && *env ? env : ".libs/ccs-kokkos-connector.so";
+	settings.regions  = 4;
+	settings.features = 2;
+	settings.variables  = 2;
+	settings.candidates = 8;
+	settings.launches   = 0;
+	settings.threads    = 1;
+	settings.shift      = 0;
+	settings.model      = MODEL_BOWL;
+	settings.base       = 10000.0;
+	settings.spread     = 2.0;
+	settings.noise      = 0.02;
+	settings.seed       = 0;
+
+	int i = 1;
+	for (; i < argc && strcmp(argv[i], "--"); i++) {
+		if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h")) {
+			usage(argv[0]);
+			return EXIT_SUCCESS;
+		}
+		if (!parse_option(argv[i])) {
+			fprintf(stderr, "Invalid option: %s\n", argv[i]);
+			usage(argv[0]);
+			return EXIT_FAILURE;
+		}
+	}
+	compute_references();
+	generate_launches();
+	load_connector();
+
+	if (connector.parse_args) {
+		// the connector sees its arguments after the executable name
+		std::vector<char *> args;
+		args.push_back(argv[0]);
+		for (int j = i + 1; j < argc; j++)
+			args.push_back(argv[j]);
+		connector.parse_args((int)args.size(), args.data());
+	}
+	connector.init(0, KOKKOSP_INTERFACE_VERSION, 0, NULL);
+	if (connector.request_settings) {
+		ToolSettings tool_settings;
+		memset(&tool_settings, 0, sizeof(tool_settings));
+		connector.request_settings(1, &tool_settings);
+	}
+	if (connector.provide_interface) {
+		ToolProgrammingInterface actions;
+		memset(&actions, 0, sizeof(actions));
+		actions.fence = fence;
+		connector.provide_interface(1, actions);
+	}
+	declare_variables();
+
+	printf("CCS Kokkos driver: %zu regions, %zu features, %zu x %zu "
+	       "candidates, %s model, %zu launches, %zu threads\n",
+	       settings.regions, settings.features, settings.variables,
+	       settings.candidates, model_names[settings.model],
+	       settings.launches, settings.threads);
+
+	std::vector<thread_stats_t> stats(settings.threads);
+	if (settings.threads == 1)
+		run_launches(0, stats.data());
+	else {
+		std::vector<std::thread> workers;
+		for (size_t t = 0; t < settings.threads; t++)
+			workers.emplace_back(run_launches, t, &stats[t]);
+		for (auto &w : workers)
+			w.join();
+	}
+
+	connector.finalize();
+	report(stats);
+	dlclose(connector.handle);
+	return EXIT_SUCCESS;
+}
@@ -56,6 +56,8 @@ ccs_binding_get_value(
  * of parameters in the context
  * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory while
  * memoizing a string
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p binding was obtained
+ * from #ccs_features_space_intern_features
  */
 extern ccs_result_t
 ccs_binding_set_value(ccs_binding_t binding, size_t index, ccs_datum_t value);
@@ -98,6 +100,8 @@ ccs_binding_get_values(
  * of values in the binding
  * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory while
  * memoizing a string
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p binding was obtained
+ * from #ccs_features_space_intern_features
  */
 extern ccs_result_t
 ccs_binding_set_values(
@@ -133,6 +137,8 @@ ccs_binding_get_value_by_name(
  * object
  * @return #CCS_RESULT_ERROR_INVALID_NAME if no parameter with such \p name
  * exist in the \p binding context
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p binding was obtained
+ * from #ccs_features_space_intern_features
  */
 extern ccs_result_t
 ccs_binding_set_value_by_name(
@@ -167,6 +173,8 @@ ccs_binding_get_value_by_parameter(
  * object
  * @return #CCS_RESULT_ERROR_INVALID_PARAMETER if \p parameter does not exist in
  * the \p binding context
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p binding was obtained
+ * from #ccs_features_space_intern_features
  */
 extern ccs_result_t
 ccs_binding_set_value_by_parameter(
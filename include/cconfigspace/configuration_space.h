@@ -639,6 +639,50 @@ ccs_configuration_space_samples(
 	size_t                    num_configurations,
 	ccs_configuration_t      *configurations);
 
+/**
+ * Get a given number of neighbors of a configuration, for local search
+ * algorithms. Each neighbor is obtained by moving a single active parameter
+ * of the configuration: numerical parameters take a gaussian step scaled to
+ * their sampling interval (in log space if they are sampled on a logarithmic
+ * scale), ordinal and discrete parameters move to an adjacent value, and
+ * categorical parameters change to another value. String parameters are never
+ * moved. Parameters that become active are sampled according to their
+ * distribution, and parameters that become inactive get the #ccs_inactive
+ * value. Forbidden neighbors are rejected, so returned configurations are
+ * valid, and different from \p configuration, but may contain duplicates.
+ * @param[in] configuration_space
+ * @param[in] configuration the configuration to get the neighbors of
+ * @param[in] num_neighbors the number of requested neighbors
+ * @param[in] rng an optional random number generator to use, if NULL the rng
+ *                of \p configuration_space is used
+ * @param[out] neighbors an array of \p num_neighbors that will contain the
+ *                       requested neighbors
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p configuration_space is not a
+ * valid CCS configuration space; or if \p configuration is not a valid CCS
+ * configuration; or if \p rng is not NULL and is not a valid CCS random number
+ * generator
+ * @return #CCS_RESULT_ERROR_INVALID_CONFIGURATION if \p configuration is not
+ * associated to \p configuration_space; or if one of its categorical, ordinal
+ * or discrete values is not a possible value of its parameter
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p neighbors is NULL and \p
+ * num_neighbors is greater than 0
+ * @return #CCS_RESULT_ERROR_SAMPLING_UNSUCCESSFUL if no or not enough valid
+ * neighbors could be generated, for instance if no parameter of \p
+ * configuration can be moved. Neighbors that could be generated will be
+ * returned contiguously, and the rest will be NULL
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * allocate new configurations. Neighbors that could be allocated will be
+ * returned, and the rest will be NULL
+ */
+extern ccs_result_t
+ccs_configuration_space_get_neighbors(
+	ccs_configuration_space_t configuration_space,
+	ccs_configuration_t       configuration,
+	size_t                    num_neighbors,
+	ccs_rng_t                 rng,
+	ccs_configuration_t      *neighbors);
+
 #ifdef __cplusplus
 }
 #endif
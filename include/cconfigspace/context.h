@@ -197,6 +197,38 @@ ccs_context_validate_value(
 	ccs_datum_t   value,
 	ccs_datum_t  *value_ret);
 
+/**
+ * Set the capacity of the binding pool of a context. When the capacity is
+ * not 0, released bindings (configurations, evaluations or features) of the
+ * context are kept, up to \p capacity of them, to be reused by subsequent
+ * binding creations, avoiding allocator round-trips in tight
+ * sample/evaluate/release loops. Pooled memory is freed when the context is
+ * destroyed, or when the capacity is lowered.
+ * @param[in,out] context
+ * @param[in] capacity the maximum number of released bindings to keep, 0
+ *                     (the default) disables pooling
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p context is not a valid CCS
+ * object
+ */
+extern ccs_result_t
+ccs_context_set_binding_pool_capacity(ccs_context_t context, size_t capacity);
+
+/**
+ * Get the capacity of the binding pool of a context.
+ * @param[in] context
+ * @param[out] capacity_ret a pointer to the variable that will contain the
+ *                          capacity of the binding pool
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p context is not a valid CCS
+ * object
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p capacity_ret is NULL
+ */
+extern ccs_result_t
+ccs_context_get_binding_pool_capacity(
+	ccs_context_t context,
+	size_t       *capacity_ret);
+
 #ifdef __cplusplus
 }
 #endif
@@ -83,6 +83,8 @@ ccs_features_get_value(
  * of parameters in the features space
  * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory while
  * memoizing a string
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p features was obtained
+ * from #ccs_features_space_intern_features
  */
 extern ccs_result_t
 ccs_features_set_value(ccs_features_t features, size_t index, ccs_datum_t value);
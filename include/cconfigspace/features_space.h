@@ -303,6 +303,69 @@ ccs_features_space_check_features_values(
 	ccs_datum_t         *values,
 	ccs_bool_t          *is_valid_ret);
 
+/**
+ * Get the interned features of a features space for a set of values.
+ * Interned features are shared: every call with equal values returns the
+ * same object, with a new reference that must be released, and their hash
+ * is computed once. Values are only validated the first time they are
+ * interned. Interned features are immutable, and remain valid as long as a
+ * reference to them is held. Once released they are kept, up to the
+ * interned features capacity of the features space, to be returned again
+ * without allocation.
+ * @param[in] features_space
+ * @param[in] num_values the number of provided values
+ * @param[in] values an array of \p num_values values
+ * @param[out] features_ret a pointer to the variable that will hold the
+ *                          interned features
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_space is not a valid
+ * CCS features space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p features_ret is NULL; or if
+ * \p values is NULL and \p num_values is greater than 0; or if \p num_values
+ * is not equal to the number of parameters in \p features_space; or if a
+ * value is not a valid value for its parameter
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory to
+ * allocate the new features
+ */
+extern ccs_result_t
+ccs_features_space_intern_features(
+	ccs_features_space_t features_space,
+	size_t               num_values,
+	ccs_datum_t         *values,
+	ccs_features_t      *features_ret);
+
+/**
+ * Set the maximum number of released interned features a features space
+ * keeps for reuse. Lowering the capacity frees the extra ones.
+ * @param[in,out] features_space
+ * @param[in] capacity the maximum number of released interned features to
+ *                     keep, 0 frees interned features as soon as they are
+ *                     released, default: 64
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_space is not a valid
+ * CCS features space
+ */
+extern ccs_result_t
+ccs_features_space_set_interned_features_capacity(
+	ccs_features_space_t features_space,
+	size_t               capacity);
+
+/**
+ * Get the maximum number of released interned features a features space
+ * keeps for reuse.
+ * @param[in] features_space
+ * @param[out] capacity_ret a pointer to the variable that will contain the
+ *                          capacity
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_space is not a valid
+ * CCS features space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p capacity_ret is NULL
+ */
+extern ccs_result_t
+ccs_features_space_get_interned_features_capacity(
+	ccs_features_space_t features_space,
+	size_t              *capacity_ret);
+
 #ifdef __cplusplus
 }
 #endif
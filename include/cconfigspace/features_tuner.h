@@ -108,6 +108,79 @@ ccs_features_tuner_get_features_space(
 	ccs_features_tuner_t  features_tuner,
 	ccs_features_space_t *features_space_ret);
 
+/**
+ * Set the number of nearest seen features a features tuner relies on for
+ * features it has no evaluation for. When \p count is not 0, the random
+ * features tuner indexes the features of its history, and for unseen
+ * features: suggest returns the configuration that is optimal for the most
+ * of the \p count nearest seen features (ties going to the nearest ones),
+ * and ask returns these optimal configurations first before random samples.
+ * Distances are euclidean, each features parameter being scaled by the width
+ * of its range. This setting is not serialized.
+ * @param[in,out] features_tuner
+ * @param[in] count the number of nearest features to consider, 0 (the
+ *                  default) disables the fallback
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_tuner is not a valid
+ * CCS features tuner
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p count is not 0 and
+ * some parameters of the features space are neither numerical nor discrete
+ * with numeric values
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * check the features space
+ */
+extern ccs_result_t
+ccs_features_tuner_set_nearest_features(
+	ccs_features_tuner_t features_tuner,
+	size_t               count);
+
+/**
+ * Get the number of nearest seen features a features tuner relies on for
+ * features it has no evaluation for.
+ * @param[in] features_tuner
+ * @param[out] count_ret a pointer to the variable that will contain the
+ *                       number of nearest features
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_tuner is not a valid
+ * CCS features tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p count_ret is NULL
+ */
+extern ccs_result_t
+ccs_features_tuner_get_nearest_features(
+	ccs_features_tuner_t features_tuner,
+	size_t              *count_ret);
+
+/**
+ * Set the maximum number of suggestions a features tuner caches for
+ * #ccs_features_tuner_suggest_values. Lowering the capacity drops the least
+ * recently used suggestions. This setting is not serialized.
+ * @param[in,out] features_tuner
+ * @param[in] capacity the maximum number of cached suggestions, 0 disables
+ *                     the cache. The default is 1024
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_tuner is not a valid
+ * CCS features tuner
+ */
+extern ccs_result_t
+ccs_features_tuner_set_suggestion_cache_capacity(
+	ccs_features_tuner_t features_tuner,
+	size_t               capacity);
+
+/**
+ * Get the maximum number of suggestions a features tuner caches.
+ * @param[in] features_tuner
+ * @param[out] capacity_ret a pointer to the variable that will contain the
+ *                          capacity of the suggestion cache
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_tuner is not a valid
+ * CCS features tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p capacity_ret is NULL
+ */
+extern ccs_result_t
+ccs_features_tuner_get_suggestion_cache_capacity(
+	ccs_features_tuner_t features_tuner,
+	size_t              *capacity_ret);
+
 /**
  * Ask a features tuner for a set of configurations to evaluate given some
  * features. Configuration's ownership is transferred to the user who doesn't
@@ -194,6 +267,56 @@ ccs_features_tuner_suggest(
 	ccs_features_t       features,
 	ccs_configuration_t *configuration);
 
+/**
+ * Get the values of the configuration a features tuner suggests for some
+ * features values. Suggestions that follow from optima are cached by the
+ * features tuner, so subsequent calls with the same features values return
+ * the same values without querying the tuner nor creating any object, until
+ * an evaluation told to the features tuner becomes optimal for these
+ * features values. Suggestions made from the optima of nearest features
+ * (see #ccs_features_tuner_set_nearest_features) for features values
+ * without optima are dropped whenever the optima of any features values
+ * change. Suggestions for features values without optima are not cached
+ * otherwise, and the least recently used suggestions are dropped beyond the
+ * capacity of the cache (see
+ * #ccs_features_tuner_set_suggestion_cache_capacity). Values are owned by the
+ * parameters of the configuration space and remain valid as long as the
+ * configuration space is.
+ * @param[in,out] features_tuner
+ * @param[in] num_features_values the number of values in \p features_values
+ * @param[in] features_values an array of \p num_features_values values of the
+ *                            features to suggest a configuration for
+ * @param[in] num_values the number of values that \p values can contain
+ * @param[out] values an optional array of values that will contain the
+ *                    values of the suggested configuration. If the array is
+ *                    too big, extra values are set to #CCS_DATA_TYPE_NONE
+ * @param[out] num_values_ret an optional pointer that will contain the number
+ *                            of values of the suggested configuration
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p features_tuner is not a valid
+ * CCS features tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p features_values is NULL and
+ * \p num_features_values is greater than 0; or if \p values is NULL and \p
+ * num_values is greater than 0; or if \p values is NULL and \p
+ * num_values_ret is NULL; or if \p num_values is less than the number of
+ * values that would be returned; or if \p num_features_values is not the
+ * number of parameters of the features space
+ * @return #CCS_RESULT_ERROR_INVALID_FEATURES if \p features_values are not
+ * valid values for the features tuner features space
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if the features tuner does
+ * not support the suggest interface
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * cache a new suggestion
+ */
+extern ccs_result_t
+ccs_features_tuner_suggest_values(
+	ccs_features_tuner_t features_tuner,
+	size_t               num_features_values,
+	ccs_datum_t         *features_values,
+	size_t               num_values,
+	ccs_datum_t         *values,
+	size_t              *num_values_ret);
+
 /**
  * Ask a features tuner for the discovered Pareto front. For single objective
  * objective spaces this would be the best point found.
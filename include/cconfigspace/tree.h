@@ -17,7 +17,10 @@ extern "C" {
  */
 
 /**
- * Create new tree node.
+ * Create new tree node. Nodes of large arity index their children weights so
+ * that updating a weight or sampling the node takes a time logarithmic in the
+ * arity. Nodes of very large arity only allocate storage for the children that
+ * are set.
  * @param[in] arity the arity of the node
  * @param[in] value the value associated with the node
  * @param[out] tree_ret a pointer to the variable that will hold
@@ -67,6 +70,8 @@ ccs_tree_get_arity(ccs_tree_t tree, size_t *arity_ret);
  * index
  * @return #CCS_RESULT_ERROR_INVALID_TREE if \p child is already a child of
  * another node; or if child is the root of a tree space
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p tree belongs to a
+ * frozen static tree space
  */
 extern ccs_result_t
 ccs_tree_set_child(ccs_tree_t tree, size_t index, ccs_tree_t child);
@@ -260,6 +265,9 @@ ccs_tree_get_weight(ccs_tree_t tree, ccs_float_t *weight_ret);
  * @param[in] weight
  * @return #CCS_RESULT_SUCCESS on success
  * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree is not a valid CCS tree
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p weight is negative
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p tree belongs to a
+ * frozen static tree space
  */
 extern ccs_result_t
 ccs_tree_set_weight(ccs_tree_t tree, ccs_float_t weight);
@@ -282,6 +290,9 @@ ccs_tree_get_bias(ccs_tree_t tree, ccs_float_t *bias_ret);
  * @param[in] bias
  * @return #CCS_RESULT_SUCCESS on success
  * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree is not a valid CCS tree
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p bias is negative
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p tree belongs to a
+ * frozen static tree space
  */
 extern ccs_result_t
 ccs_tree_set_bias(ccs_tree_t tree, ccs_float_t bias);
@@ -54,6 +54,55 @@ ccs_create_static_tree_space(
 	ccs_tree_t        tree,
 	ccs_tree_space_t *tree_space_ret);
 
+/**
+ * Freeze a static tree space. The tree of the tree space is compiled into
+ * contiguous tables that are then used to sample the tree space, and to query
+ * positions, values and nodes in it. While the tree space is frozen, the
+ * weights, biases and children of its tree, and of the ancestors of its tree,
+ * cannot be modified. Freezing a frozen tree space has no effect. The frozen
+ * state is not serialized.
+ * @param[in,out] tree_space
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_TREE_SPACE if \p tree_space is not a
+ * static tree space
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory to
+ * allocate the tables
+ */
+extern ccs_result_t
+ccs_static_tree_space_freeze(ccs_tree_space_t tree_space);
+
+/**
+ * Thaw a frozen static tree space, releasing its tables so that its tree can
+ * be modified again. Thawing a tree space that is not frozen has no effect.
+ * @param[in,out] tree_space
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_TREE_SPACE if \p tree_space is not a
+ * static tree space
+ */
+extern ccs_result_t
+ccs_static_tree_space_thaw(ccs_tree_space_t tree_space);
+
+/**
+ * Query if a static tree space is frozen.
+ * @param[in] tree_space
+ * @param[out] is_frozen_ret a pointer to the variable that will contain the
+ *                           result
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_TREE_SPACE if \p tree_space is not a
+ * static tree space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p is_frozen_ret is NULL
+ */
+extern ccs_result_t
+ccs_static_tree_space_is_frozen(
+	ccs_tree_space_t tree_space,
+	ccs_bool_t      *is_frozen_ret);
+
 /**
  * A structure that define the callbacks the user must provide to create a
  * dynamic tree space.
@@ -330,6 +379,89 @@ ccs_tree_space_samples(
 	size_t                    num_configurations,
 	ccs_tree_configuration_t *configurations);
 
+/**
+ * The type of the callback computing the transposition key of a position in
+ * a tree space. Positions that reach equivalent states, e.g. different
+ * orderings of independent choices, must be given equal keys.
+ * @param[in] tree_space the tree space
+ * @param[in] num_values the number of values along the position, that is the
+ *                       position size plus one
+ * @param[in] values the values of the nodes along the position, from the root
+ *                   of the tree space
+ * @param[in] user_data the pointer provided when the callback was attached
+ * @param[out] key_ret a pointer to the variable that will contain the
+ *                     returned key. String keys are copied when they are
+ *                     stored, and object keys are retained.
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return an error code on error
+ */
+typedef ccs_result_t (*ccs_tree_space_transposition_key_callback_t)(
+	ccs_tree_space_t   tree_space,
+	size_t             num_values,
+	const ccs_datum_t *values,
+	void              *user_data,
+	ccs_datum_t       *key_ret);
+
+/**
+ * Attach a transposition table to a tree space. Tree tuners (see
+ * tree_tuner.h) working on the tree space record their successful
+ * evaluations in the table, under the key of their configuration. When a
+ * tree tuner would suggest a configuration whose key already has an
+ * evaluation with the same objective space, it is instead told a copy of
+ * this evaluation for the configuration, and suggests another configuration.
+ * The table holds at most \p capacity evaluations, the oldest ones being
+ * evicted first. Attaching a table discards the previous one, if any. The
+ * transposition table is not serialized.
+ * @param[in,out] tree_space
+ * @param[in] callback the callback computing the keys of positions. Can be
+ *                     NULL in which case the transposition table is removed
+ * @param[in] user_data an optional pointer that will be passed to the
+ *                      callback
+ * @param[in] capacity the maximum number of evaluations in the table
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p callback is not NULL and \p
+ * capacity is 0
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory to
+ * allocate the table
+ */
+extern ccs_result_t
+ccs_tree_space_set_transposition_table(
+	ccs_tree_space_t                            tree_space,
+	ccs_tree_space_transposition_key_callback_t callback,
+	void                                       *user_data,
+	size_t                                      capacity);
+
+/**
+ * Get an evaluation of a configuration built from the evaluation recorded in
+ * the transposition table of a tree space for the key of the configuration.
+ * The table does not hold recorded evaluations, only their objective space,
+ * result and values, so that it does not keep their configurations, and thus
+ * the tree space, alive.
+ * @param[in] tree_space
+ * @param[in] configuration a tree configuration of \p tree_space
+ * @param[out] evaluation_ret a pointer to the variable that will contain a
+ *                            new evaluation of \p configuration with the
+ *                            recorded result and values, or NULL if the key
+ *                            has no evaluation or the tree space has no
+ *                            transposition table
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space; or if \p configuration is not a valid CCS tree configuration
+ * @return #CCS_RESULT_ERROR_INVALID_CONFIGURATION if \p configuration is not
+ * a configuration of \p tree_space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p evaluation_ret is NULL
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory to
+ * compute the values of \p configuration or to allocate the new evaluation
+ * @return the error returned by the key callback, if any
+ */
+extern ccs_result_t
+ccs_tree_space_get_transposition(
+	ccs_tree_space_t         tree_space,
+	ccs_tree_configuration_t configuration,
+	ccs_tree_evaluation_t   *evaluation_ret);
+
 /**
  * Get the dynamic tree space internal data pointer.
  * @param[in] tree_space
@@ -346,6 +478,77 @@ ccs_dynamic_tree_space_get_tree_space_data(
 	ccs_tree_space_t tree_space,
 	void           **tree_space_data_ret);
 
+/**
+ * Set the prefetching policy of a dynamic tree space. When prefetching is
+ * enabled, each time a node is visited (i.e. it is the target of a node,
+ * values, or position check query), its missing children are generated ahead
+ * of time by a pool of worker threads using the tree space get_child
+ * callback. Generated children are installed in the tree by the thread
+ * querying the tree space, at its next query, and the missing children of
+ * installed nodes are themselves prefetched up to \p depth levels below the
+ * visited node. Querying a node whose generation is in progress waits for its
+ * completion instead of calling the callback again. When prefetching is
+ * enabled, the get_child callback must be thread-safe: it can be called
+ * concurrently, from worker threads, with other callbacks and with queries
+ * of the tree space. It may only rely on the position, value, and arity of
+ * the parent and of its ancestors, which are immutable once they are in the
+ * tree. As reference counting is not thread-safe, the callback must not
+ * retain or release CCS objects other than the child it creates, and must
+ * never release the last reference to a CCS object. Changing the prefetching
+ * policy discards the children that have been generated but not installed
+ * yet. The prefetching policy is not serialized.
+ * @param[in,out] tree_space
+ * @param[in] num_threads the number of worker threads to use. 0 disables
+ *                        prefetching.
+ * @param[in] depth the number of levels to prefetch below a visited node
+ * @param[in] max_pending the maximum number of children being generated, or
+ *                        generated but not yet installed, at any given time
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_TREE_SPACE if \p tree_space is not a
+ * dynamic tree space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p num_threads is not 0 and \p
+ * depth or \p max_pending is 0
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was a lack of memory to
+ * allocate the prefetching structures
+ * @return #CCS_RESULT_ERROR_SYSTEM if the worker threads could not be created
+ * @return #CCS_RESULT_ERROR_UNSUPPORTED_OPERATION if \p num_threads is not 0
+ * and the library was built without POSIX threads support
+ */
+extern ccs_result_t
+ccs_dynamic_tree_space_set_prefetch(
+	ccs_tree_space_t tree_space,
+	size_t           num_threads,
+	size_t           depth,
+	size_t           max_pending);
+
+/**
+ * Get the prefetching policy of a dynamic tree space.
+ * @param[in] tree_space
+ * @param[out] num_threads_ret a pointer to the variable that will contain the
+ *                             number of worker threads, 0 if prefetching is
+ *                             disabled. Can be NULL.
+ * @param[out] depth_ret a pointer to the variable that will contain the
+ *                       prefetch depth. Can be NULL.
+ * @param[out] max_pending_ret a pointer to the variable that will contain the
+ *                             maximum number of pending children. Can be
+ *                             NULL.
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space
+ * @return #CCS_RESULT_ERROR_INVALID_TREE_SPACE if \p tree_space is not a
+ * dynamic tree space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p num_threads_ret, \p
+ * depth_ret, and \p max_pending_ret are all NULL
+ */
+extern ccs_result_t
+ccs_dynamic_tree_space_get_prefetch(
+	ccs_tree_space_t tree_space,
+	size_t          *num_threads_ret,
+	size_t          *depth_ret,
+	size_t          *max_pending_ret);
+
 #ifdef __cplusplus
 }
 #endif
@@ -21,6 +21,8 @@ enum ccs_tree_tuner_type_e {
 	CCS_TREE_TUNER_TYPE_RANDOM,
 	/** A user defined tuner */
 	CCS_TREE_TUNER_TYPE_USER_DEFINED,
+	/** A Monte-Carlo tree search tuner */
+	CCS_TREE_TUNER_TYPE_MCTS,
 	/** Guard */
 	CCS_TREE_TUNER_TYPE_MAX,
 	/** Try forcing 32 bits value for bindings */
@@ -233,6 +235,57 @@ ccs_create_random_tree_tuner(
 	ccs_objective_space_t objective_space,
 	ccs_tree_tuner_t     *tuner_ret);
 
+/**
+ * Create a new Monte-Carlo tree search tree tuner. The tuner keeps statistics
+ * of the configurations reaching each node of the tree space, and descends
+ * the tree using the UCT selection policy on the first objective of the
+ * objective space. Actions are drawn from the weights and biases of the tree
+ * nodes, and new children are only considered as nodes gather evaluations
+ * (progressive widening). Configurations that were asked but not told yet
+ * count as failures (virtual loss), so batched asks are spread over the tree.
+ * Children of dynamic tree spaces are created through the tree space
+ * callbacks.
+ * @param[in] name the name of the tree tuner
+ * @param[in] tree_space the tree space to explore
+ * @param[in] objective_space the objective space to optimize
+ * @param[in] exploration the UCT exploration constant. If 0, 1/sqrt(2) is
+ *                        used
+ * @param[out] tuner_ret a pointer to the variable that will contain the
+ *                       newly created tree tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tree_space is not a valid CCS
+ * tree space; or if \p objective_space is not a valid CCS objective space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p name is NULL; or if \p
+ * tuner_ret is NULL; or if \p exploration is negative or not finite; or if \p
+ * objective_space has no objective
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * allocate the new tree tuner instance
+ */
+extern ccs_result_t
+ccs_create_mcts_tree_tuner(
+	const char           *name,
+	ccs_tree_space_t      tree_space,
+	ccs_objective_space_t objective_space,
+	ccs_float_t           exploration,
+	ccs_tree_tuner_t     *tuner_ret);
+
+/**
+ * Get the parameters of a Monte-Carlo tree search tree tuner.
+ * @param[in] tuner
+ * @param[out] exploration_ret a pointer to the variable that will contain the
+ *                             UCT exploration constant of the tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tuner is not a valid CCS tree
+ * tuner
+ * @return #CCS_RESULT_ERROR_INVALID_TUNER if \p tuner is not a Monte-Carlo
+ * tree search tree tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p exploration_ret is NULL
+ */
+extern ccs_result_t
+ccs_mcts_tree_tuner_get_properties(
+	ccs_tree_tuner_t tuner,
+	ccs_float_t     *exploration_ret);
+
 /**
  * A structure that define the callbacks the user must provide to create a user
  * defined tree tuner.
@@ -21,6 +21,12 @@ enum ccs_tuner_type_e {
 	CCS_TUNER_TYPE_RANDOM,
 	/** A user defined tuner */
 	CCS_TUNER_TYPE_USER_DEFINED,
+	/** A Tree-structured Parzen Estimator tuner */
+	CCS_TUNER_TYPE_TPE,
+	/** A Hyperband (successive halving) multi-fidelity tuner */
+	CCS_TUNER_TYPE_HYPERBAND,
+	/** A covariance matrix adaptation evolution strategy tuner */
+	CCS_TUNER_TYPE_CMA_ES,
 	/** Guard */
 	CCS_TUNER_TYPE_MAX,
 	/** Try forcing 32 bits value for bindings */
@@ -225,6 +231,177 @@ ccs_create_random_tuner(
 	ccs_objective_space_t     objective_space,
 	ccs_tuner_t              *tuner_ret);
 
+/**
+ * Create a new TPE (Tree-structured Parzen Estimator) tuner. Until 10
+ * successful evaluations have been reported, configurations are sampled from
+ * the configuration space. Afterwards, reported evaluations are ranked by
+ * Pareto dominance and split between the best quarter (at most 25 of them)
+ * and the others, which are used to build, for each parameter, the densities
+ * l(x) and g(x) of good and bad values. Each returned configuration is the
+ * valid configuration maximizing l(x)/g(x) among 24 candidates drawn from l(x).
+ * Numerical parameters with a logarithmic distribution in the configuration
+ * space are modeled on a logarithmic scale. The configuration space and the
+ * objective space should not be modified once the tuner is created.
+ * @param[in] name the name of the tuner
+ * @param[in] configuration_space the configuration space to explore
+ * @param[in] objective_space the objective space to optimize
+ * @param[out] tuner_ret a pointer to the variable that will contain the newly
+ *                       created tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p configuration_space is not a
+ * valid CCS configuration space; or if \p objective_space is not a valid CCS
+ * objective space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p name is NULL; or if \p
+ * tuner_ret is NULL
+ * @return #CCS_RESULT_ERROR_INVALID_PARAMETER if \p configuration_space
+ * contains string parameters
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * allocate the new tuner instance
+ */
+extern ccs_result_t
+ccs_create_tpe_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	ccs_tuner_t              *tuner_ret);
+
+/**
+ * Create a new Hyperband tuner. The Hyperband tuner allocates evaluation
+ * budgets through a numerical parameter of the configuration space, the
+ * fidelity parameter (e.g. a number of iterations or of repetitions), whose
+ * values range from the lower bound of the parameter to its largest valid
+ * value. The tuner cycles over successive halving brackets: a bracket samples
+ * configurations from the configuration space and evaluates them at a reduced
+ * budget, then promotes the best 1/\p eta of them to a budget \p eta times
+ * larger, until the maximum budget is reached. Configurations returned by
+ * #ccs_tuner_ask carry the budget they should be evaluated with. A rung is
+ * complete once all its configurations have been reported through
+ * #ccs_tuner_tell, and new brackets are started if configurations are asked
+ * while rungs are incomplete. The history contains every successful
+ * evaluation, and the optima only consider evaluations at the maximum budget.
+ * Brackets in progress are not serialized. Budgets are rounded to the
+ * quantization of the fidelity parameter, and configurations that are no
+ * longer valid at a larger budget are not promoted.
+ * @param[in] name the name of the tuner
+ * @param[in] configuration_space the configuration space to explore
+ * @param[in] objective_space the objective space to optimize
+ * @param[in] fidelity_index the index of the fidelity parameter in \p
+ *                           configuration_space
+ * @param[in] eta the reduction factor between successive rungs, usually 3
+ * @param[out] tuner_ret a pointer to the variable that will contain the newly
+ *                       created tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p configuration_space is not a
+ * valid CCS configuration space; or if \p objective_space is not a valid CCS
+ * objective space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p name is NULL; or if \p
+ * tuner_ret is NULL; or if \p eta is not greater than 1
+ * @return #CCS_RESULT_ERROR_OUT_OF_BOUNDS if \p fidelity_index is not a valid
+ * parameter index in \p configuration_space
+ * @return #CCS_RESULT_ERROR_INVALID_PARAMETER if the fidelity parameter is not
+ * numerical or can take non positive values; or if the fidelity parameter is
+ * conditional, or referenced by a condition or a forbidden clause of \p
+ * configuration_space
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * allocate the new tuner instance
+ */
+extern ccs_result_t
+ccs_create_hyperband_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	size_t                    fidelity_index,
+	ccs_float_t               eta,
+	ccs_tuner_t              *tuner_ret);
+
+/**
+ * Get the parameters of a Hyperband tuner.
+ * @param[in] tuner
+ * @param[out] fidelity_index_ret a pointer to the variable that will contain
+ *                                the index of the fidelity parameter
+ * @param[out] eta_ret a pointer to the variable that will contain the
+ *                     reduction factor of the tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tuner is not a valid CCS
+ * tuner
+ * @return #CCS_RESULT_ERROR_INVALID_TUNER if \p tuner is not a Hyperband
+ * tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if both \p fidelity_index_ret and
+ * \p eta_ret are NULL
+ */
+extern ccs_result_t
+ccs_hyperband_tuner_get_properties(
+	ccs_tuner_t  tuner,
+	size_t      *fidelity_index_ret,
+	ccs_float_t *eta_ret);
+
+/**
+ * Create a new CMA-ES tuner. The tuner evolves a population over the
+ * numerical parameters of the configuration space, normalized to the unit
+ * hypercube (in log space for parameters sampled on a logarithmic scale),
+ * using a covariance matrix adaptation evolution strategy. Categorical,
+ * ordinal and discrete parameters are inherited from the best configuration
+ * of the previous generation and randomly mutated. The search starts from the
+ * default values of the parameters. A generation is complete once \p
+ * population_size of its configurations have been successfully reported
+ * through #ccs_tuner_tell; configurations of a previous generation reported
+ * afterwards only contribute to the history and optima. #ccs_tuner_ask can
+ * return any number of configurations, and suggests the number of
+ * evaluations needed to complete the current generation. The state of the
+ * evolution strategy is not serialized. Configuration spaces with string
+ * parameters are not supported.
+ * @param[in] name the name of the tuner
+ * @param[in] configuration_space the configuration space to explore
+ * @param[in] objective_space the objective space to optimize
+ * @param[in] population_size the number of configurations evaluated per
+ *                            generation, usually the size of the evaluation
+ *                            pool. If 0, 4 + floor(3 * ln(n)) is used, where
+ *                            n is the number of numerical parameters
+ * @param[in] sigma the initial step size, relative to the width of the
+ *                  parameters' intervals. If 0, 0.3 is used
+ * @param[out] tuner_ret a pointer to the variable that will contain the newly
+ *                       created tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p configuration_space is not a
+ * valid CCS configuration space; or if \p objective_space is not a valid CCS
+ * objective space
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if \p name is NULL; or if \p
+ * tuner_ret is NULL; or if \p population_size is 1; or if \p sigma is not in
+ * the [0, 1] range
+ * @return #CCS_RESULT_ERROR_INVALID_PARAMETER if \p configuration_space
+ * contains string parameters
+ * @return #CCS_RESULT_ERROR_OUT_OF_MEMORY if there was not enough memory to
+ * allocate the new tuner instance
+ */
+extern ccs_result_t
+ccs_create_cma_es_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	size_t                    population_size,
+	ccs_float_t               sigma,
+	ccs_tuner_t              *tuner_ret);
+
+/**
+ * Get the parameters of a CMA-ES tuner.
+ * @param[in] tuner
+ * @param[out] population_size_ret a pointer to the variable that will contain
+ *                                 the population size of the tuner
+ * @param[out] sigma_ret a pointer to the variable that will contain the
+ *                       initial step size of the tuner
+ * @return #CCS_RESULT_SUCCESS on success
+ * @return #CCS_RESULT_ERROR_INVALID_OBJECT if \p tuner is not a valid CCS
+ * tuner
+ * @return #CCS_RESULT_ERROR_INVALID_TUNER if \p tuner is not a CMA-ES tuner
+ * @return #CCS_RESULT_ERROR_INVALID_VALUE if both \p population_size_ret and
+ * \p sigma_ret are NULL
+ */
+extern ccs_result_t
+ccs_cma_es_tuner_get_properties(
+	ccs_tuner_t  tuner,
+	size_t      *population_size_ret,
+	ccs_float_t *sigma_ret);
+
 /**
  * A structure that define the callbacks the user must provide to create a user
  * defined tuner.
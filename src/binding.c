@@ -1,5 +1,6 @@
 #include "cconfigspace_internal.h"
 #include "binding_internal.h"
+#include "features_internal.h"
 
 #define CCS_CHECK_BINDING(b)                                                   \
 	CCS_REFUTE_MSG(                                                        \
@@ -7,6 +8,14 @@
 		CCS_RESULT_ERROR_INVALID_OBJECT,                               \
 		"Invalid CCS binding '%s' == %p supplied", #b, b)
 
+/* interned features are shared between their users */
+#define CCS_CHECK_MUTABLE(b)                                                   \
+	CCS_REFUTE_MSG(                                                        \
+		(b)->obj.type == CCS_OBJECT_TYPE_FEATURES &&                   \
+			((ccs_features_t)(b))->data->interned,                 \
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION,                        \
+		"Interned features are immutable")
+
 static inline _ccs_binding_ops_t *
 ccs_binding_get_ops(ccs_binding_t binding)
 {
@@ -36,6 +45,7 @@ ccs_result_t
 ccs_binding_set_value(ccs_binding_t binding, size_t index, ccs_datum_t value)
 {
 	CCS_CHECK_BINDING(binding);
+	CCS_CHECK_MUTABLE(binding);
 	CCS_VALIDATE(_ccs_binding_set_value(binding, index, value));
 	return CCS_RESULT_SUCCESS;
 }
@@ -60,6 +70,7 @@ ccs_binding_set_values(
 	ccs_datum_t  *values)
 {
 	CCS_CHECK_BINDING(binding);
+	CCS_CHECK_MUTABLE(binding);
 	CCS_VALIDATE(_ccs_binding_set_values(binding, num_values, values));
 	return CCS_RESULT_SUCCESS;
 }
@@ -82,6 +93,7 @@ ccs_binding_set_value_by_name(
 	ccs_datum_t   value)
 {
 	CCS_CHECK_BINDING(binding);
+	CCS_CHECK_MUTABLE(binding);
 	CCS_VALIDATE(_ccs_binding_set_value_by_name(binding, name, value));
 	return CCS_RESULT_SUCCESS;
 }
@@ -105,6 +117,7 @@ ccs_binding_set_value_by_parameter(
 	ccs_datum_t     value)
 {
 	CCS_CHECK_BINDING(binding);
+	CCS_CHECK_MUTABLE(binding);
 	CCS_VALIDATE(
 		_ccs_binding_set_value_by_parameter(binding, parameter, value));
 	return CCS_RESULT_SUCCESS;
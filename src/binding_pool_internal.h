@@ -0,0 +1,78 @@
+#ifndef _BINDING_POOL_INTERNAL_H
+#define _BINDING_POOL_INTERNAL_H
+
+/* Per context cache of binding allocations (configurations, evaluations and
+ * features). Bindings of a given context all share the same allocation size,
+ * so released blocks can be reused as is by the next creation instead of
+ * going through the allocator. Cached blocks are chained through their
+ * user_data field, and have a NULL data pointer and a null refcount so stale
+ * handles are still rejected by CCS_CHECK_OBJ. The pool is disabled
+ * (capacity 0) by default and is released with its context. */
+struct _ccs_binding_pool_s {
+	size_t                  capacity;
+	size_t                  count;
+	size_t                  block_size;
+	_ccs_object_template_t *free_list;
+};
+typedef struct _ccs_binding_pool_s _ccs_binding_pool_t;
+
+static inline void
+_ccs_binding_pool_trim(_ccs_binding_pool_t *pool, size_t count)
+{
+	while (pool->count > count) {
+		_ccs_object_template_t *block = pool->free_list;
+		pool->free_list = (_ccs_object_template_t *)block->obj.user_data;
+		pool->count--;
+		free(block);
+	}
+}
+
+static inline void
+_ccs_binding_pool_fini(_ccs_binding_pool_t *pool)
+{
+	_ccs_binding_pool_trim(pool, 0);
+	pool->capacity = 0;
+}
+
+static inline void *
+_ccs_binding_pool_get(
+	_ccs_binding_pool_t *pool,
+	size_t               size,
+	ccs_bool_t          *pooled_ret)
+{
+	_ccs_object_template_t *block;
+	*pooled_ret = pool->capacity ? CCS_TRUE : CCS_FALSE;
+	if (!pool->capacity)
+		return calloc(1, size);
+	if (pool->block_size != size) {
+		/* the context was modified, cached blocks are obsolete */
+		_ccs_binding_pool_trim(pool, 0);
+		pool->block_size = size;
+	}
+	if (!pool->free_list)
+		return calloc(1, size);
+	block           = pool->free_list;
+	pool->free_list = (_ccs_object_template_t *)block->obj.user_data;
+	pool->count--;
+	memset(block, 0, size);
+	return block;
+}
+
+/* Called from the binding del function for pooled objects, as
+ * ccs_release_object does not free those, or on creation error paths. */
+static inline void
+_ccs_binding_pool_put(_ccs_binding_pool_t *pool, void *mem, size_t size)
+{
+	_ccs_object_template_t *block = (_ccs_object_template_t *)mem;
+	if (pool->count >= pool->capacity || pool->block_size != size) {
+		free(mem);
+		return;
+	}
+	block->data          = NULL;
+	block->obj.refcount  = 0;
+	block->obj.user_data = pool->free_list;
+	pool->free_list      = block;
+	pool->count++;
+}
+
+#endif //_BINDING_POOL_INTERNAL_H
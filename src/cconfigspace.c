@@ -57,6 +57,8 @@ ccs_release_object(ccs_object_t object)
 	CCS_REFUTE(!obj || obj->refcount <= 0, CCS_RESULT_ERROR_INVALID_OBJECT);
 	obj->refcount -= 1;
 	if (obj->refcount == 0) {
+		/* pooled objects are recycled by their del function */
+		ccs_bool_t pooled = obj->pooled;
 		if (obj->callbacks) {
 			_ccs_object_callback_t *cb = NULL;
 			while ((cb = (_ccs_object_callback_t *)utarray_prev(
@@ -66,7 +68,8 @@ ccs_release_object(ccs_object_t object)
 			utarray_free(obj->callbacks);
 		}
 		CCS_VALIDATE(obj->ops->del(object));
-		free(object);
+		if (!pooled)
+			free(object);
 	}
 	return CCS_RESULT_SUCCESS;
 }
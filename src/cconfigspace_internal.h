@@ -34,6 +34,26 @@ _ccs_interval_include(ccs_interval_t *interval, ccs_numeric_t value)
  */
 #define CCS_UNLIKELY(x) __builtin_expect(!!(x), 0)
 
+/**
+ * Batch kernels process values in blocks of CCS_SIMD_BLOCK elements with a
+ * scalar tail, so that compilers vectorize them even without a cost model
+ * accepting epilogues. On x86-64 glibc targets they are also cloned for AVX2
+ * and AVX-512, the variant being selected at load time for the running CPU.
+ * Kernels working on ccs_numeric_t access the relevant member of each element
+ * through a pointer to it, as GCC does not vectorize direct union member
+ * accesses.
+ */
+#define CCS_SIMD_BLOCK  8
+#if defined(__x86_64__) && defined(__GLIBC__) && defined(__has_attribute)
+#if __has_attribute(target_clones)
+#define CCS_SIMD_CLONES                                                        \
+	__attribute__((target_clones("avx512f", "avx2", "default")))
+#endif
+#endif
+#ifndef CCS_SIMD_CLONES
+#define CCS_SIMD_CLONES
+#endif
+
 #define CCS_RICH_ERRORS 1
 
 #if CCS_RICH_ERRORS
@@ -147,7 +167,7 @@ _ccs_interval_include(ccs_interval_t *interval, ccs_numeric_t value)
 	} while (0)
 
 #define CCS_SERIALIZATION_API_VERSION_TYPE          uint32_t
-#define CCS_SERIALIZATION_API_VERSION               ((CCS_SERIALIZATION_API_VERSION_TYPE)1)
+#define CCS_SERIALIZATION_API_VERSION               ((CCS_SERIALIZATION_API_VERSION_TYPE)2)
 #define CCS_SERIALIZATION_API_VERSION_SERIALIZE_BIN _ccs_serialize_bin_uint32
 #define CCS_SERIALIZATION_API_VERSION_SERIALIZE_SIZE_BIN                       \
 	_ccs_serialize_bin_size_uint32
@@ -242,6 +262,7 @@ struct _ccs_object_internal_s {
 	_ccs_object_ops_t              *ops;
 	ccs_object_serialize_callback_t serialize_callback;
 	void                           *serialize_user_data;
+	ccs_bool_t                      pooled;
 };
 
 typedef struct _ccs_object_internal_s _ccs_object_internal_t;
@@ -265,6 +286,7 @@ _ccs_object_init(
 	o->ops                 = ops;
 	o->serialize_callback  = NULL;
 	o->serialize_user_data = NULL;
+	o->pooled              = CCS_FALSE;
 }
 
 static inline int
@@ -1,5 +1,6 @@
 #include "cconfigspace_internal.h"
 #include "configuration_internal.h"
+#include "configuration_space_internal.h"
 #include <string.h>
 
 static inline _ccs_configuration_ops_t *
@@ -11,8 +12,17 @@ ccs_configuration_get_ops(ccs_configuration_t configuration)
 static ccs_result_t
 _ccs_configuration_del(ccs_object_t object)
 {
-	ccs_configuration_t configuration = (ccs_configuration_t)object;
-	ccs_release_object(configuration->data->configuration_space);
+	ccs_configuration_t       configuration = (ccs_configuration_t)object;
+	ccs_configuration_space_t configuration_space =
+		configuration->data->configuration_space;
+	if (configuration->obj.pooled)
+		_ccs_binding_pool_put(
+			&configuration_space->data->pool, configuration,
+			sizeof(struct _ccs_configuration_s) +
+				sizeof(struct _ccs_configuration_data_s) +
+				configuration->data->num_values *
+					sizeof(ccs_datum_t));
+	ccs_release_object(configuration_space);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -100,10 +110,12 @@ ccs_create_configuration(
 	CCS_REFUTE(
 		values && num_parameters != num_values,
 		CCS_RESULT_ERROR_INVALID_VALUE);
-	uintptr_t mem = (uintptr_t)calloc(
-		1, sizeof(struct _ccs_configuration_s) +
-			   sizeof(struct _ccs_configuration_data_s) +
-			   num_parameters * sizeof(ccs_datum_t));
+	ccs_bool_t pooled;
+	size_t     size = sizeof(struct _ccs_configuration_s) +
+		      sizeof(struct _ccs_configuration_data_s) +
+		      num_parameters * sizeof(ccs_datum_t);
+	uintptr_t mem = (uintptr_t)_ccs_binding_pool_get(
+		&configuration_space->data->pool, size, &pooled);
 	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
 	CCS_VALIDATE_ERR_GOTO(
 		err, ccs_retain_object(configuration_space), errmem);
@@ -112,6 +124,7 @@ ccs_create_configuration(
 	_ccs_object_init(
 		&(config->obj), CCS_OBJECT_TYPE_CONFIGURATION,
 		(_ccs_object_ops_t *)&_configuration_ops);
+	config->obj.pooled                = pooled;
 	config->data                      = (struct _ccs_configuration_data_s
                                 *)(mem + sizeof(struct _ccs_configuration_s));
 	config->data->num_values          = num_parameters;
@@ -135,7 +148,8 @@ ccs_create_configuration(
 	*configuration_ret = config;
 	return CCS_RESULT_SUCCESS;
 errmem:
-	free((void *)mem);
+	_ccs_binding_pool_put(
+		&configuration_space->data->pool, (void *)mem, size);
 	return err;
 }
 
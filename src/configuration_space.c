@@ -4,7 +4,11 @@
 #include "distribution_internal.h"
 #include "expression_internal.h"
 #include "rng_internal.h"
+#include "datum_hash.h"
 #include "utlist.h"
+#include <gsl/gsl_randist.h>
+#include <math.h>
+#include <string.h>
 
 static ccs_result_t
 _generate_constraints(ccs_configuration_space_t configuration_space);
@@ -51,6 +55,7 @@ _ccs_configuration_space_del(ccs_object_t object)
 		free(dw);
 	}
 	ccs_release_object(configuration_space->data->rng);
+	_ccs_binding_pool_fini(&configuration_space->data->pool);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -831,32 +836,6 @@ ccs_configuration_space_validate_value(
 	return CCS_RESULT_SUCCESS;
 }
 
-static ccs_result_t
-_set_actives(
-	ccs_configuration_space_t configuration_space,
-	ccs_configuration_t       configuration)
-{
-	size_t      *p_index = NULL;
-	UT_array    *indexes = configuration_space->data->sorted_indexes;
-	UT_array    *array   = configuration_space->data->parameters;
-	ccs_datum_t *values  = configuration->data->values;
-	while ((p_index = (size_t *)utarray_next(indexes, p_index))) {
-		_ccs_parameter_wrapper_cs_t *wrapper = NULL;
-		wrapper = (_ccs_parameter_wrapper_cs_t *)utarray_eltptr(
-			array, *p_index);
-		if (!wrapper->condition)
-			continue;
-		ccs_datum_t result;
-		CCS_VALIDATE(ccs_expression_eval(
-			wrapper->condition, (ccs_context_t)configuration_space,
-			values, &result));
-		if (!(result.type == CCS_DATA_TYPE_BOOL &&
-		      result.value.i == CCS_TRUE))
-			values[*p_index] = ccs_inactive;
-	}
-	return CCS_RESULT_SUCCESS;
-}
-
 ccs_result_t
 ccs_configuration_space_get_default_configuration(
 	ccs_configuration_space_t configuration_space,
@@ -879,7 +858,10 @@ ccs_configuration_space_get_default_configuration(
 				wrapper->parameter, values++),
 			errc);
 	CCS_VALIDATE_ERR_GOTO(
-		err, _set_actives(configuration_space, config), errc);
+		err,
+		_ccs_configuration_space_set_actives(
+			configuration_space, config->data->values),
+		errc);
 	*configuration_ret = config;
 	return CCS_RESULT_SUCCESS;
 errc:
@@ -887,31 +869,6 @@ errc:
 	return err;
 }
 
-static ccs_result_t
-_test_forbidden(
-	ccs_configuration_space_t configuration_space,
-	ccs_datum_t              *values,
-	ccs_bool_t               *is_valid)
-{
-	UT_array         *array = configuration_space->data->forbidden_clauses;
-	ccs_expression_t *p_expression = NULL;
-	*is_valid                      = CCS_FALSE;
-	while ((p_expression = (ccs_expression_t *)utarray_next(
-			array, p_expression))) {
-		ccs_datum_t result;
-		CCS_VALIDATE(ccs_expression_eval(
-			*p_expression, (ccs_context_t)configuration_space,
-			values, &result));
-		if (result.type == CCS_DATA_TYPE_INACTIVE)
-			continue;
-		if (result.type == CCS_DATA_TYPE_BOOL &&
-		    result.value.i == CCS_TRUE)
-			return CCS_RESULT_SUCCESS;
-	}
-	*is_valid = CCS_TRUE;
-	return CCS_RESULT_SUCCESS;
-}
-
 static inline ccs_result_t
 _check_configuration(
 	ccs_configuration_space_t configuration_space,
@@ -954,8 +911,8 @@ _check_configuration(
 				return CCS_RESULT_SUCCESS;
 		}
 	}
-	CCS_VALIDATE(
-		_test_forbidden(configuration_space, values, is_valid_ret));
+	CCS_VALIDATE(_ccs_configuration_space_test_forbidden(
+		configuration_space, values, is_valid_ret));
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -1037,10 +994,13 @@ _sample(ccs_configuration_space_t configuration_space,
 		}
 	}
 	CCS_VALIDATE_ERR_GOTO(
-		err, _set_actives(configuration_space, config), memory);
+		err,
+		_ccs_configuration_space_set_actives(
+			configuration_space, config->data->values),
+		memory);
 	CCS_VALIDATE_ERR_GOTO(
 		err,
-		_test_forbidden(
+		_ccs_configuration_space_test_forbidden(
 			configuration_space, config->data->values, found),
 		memory);
 memory:
@@ -1121,6 +1081,361 @@ errc:
 	return err;
 }
 
+/* Per call state of the parameters that can be moved when generating the
+ * neighborhood of a configuration. Categorical, ordinal and discrete
+ * parameters are handled through the index of their value, numerical
+ * parameters through their value. */
+struct _ccs_neighborhood_parameter_s {
+	ccs_parameter_t      parameter;
+	ccs_parameter_type_t type;
+	ccs_interval_t       interval;
+	ccs_numeric_t        quantization;
+	ccs_bool_t           log;
+	ccs_int_t            current;
+	ccs_datum_t         *values;
+};
+typedef struct _ccs_neighborhood_parameter_s _ccs_neighborhood_parameter_t;
+
+static ccs_result_t
+_ccs_neighborhood_parameter_init(
+	_ccs_parameter_wrapper_cs_t   *wrapper,
+	ccs_datum_t                    value,
+	_ccs_neighborhood_parameter_t *np,
+	ccs_bool_t                    *movable_ret)
+{
+	ccs_parameter_t parameter = wrapper->parameter;
+	ccs_interval_t *interval  = &np->interval;
+	np->parameter             = parameter;
+	*movable_ret              = CCS_FALSE;
+	CCS_VALIDATE(ccs_parameter_get_type(parameter, &np->type));
+	if (np->type == CCS_PARAMETER_TYPE_STRING)
+		return CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(ccs_parameter_sampling_interval(parameter, interval));
+	if (np->type != CCS_PARAMETER_TYPE_NUMERICAL) {
+		size_t         num_values = (size_t)interval->upper.i;
+		ccs_numeric_t *indexes;
+		ccs_result_t   err = CCS_RESULT_SUCCESS;
+		if (num_values < 2)
+			return CCS_RESULT_SUCCESS;
+		indexes = (ccs_numeric_t *)malloc(
+			num_values * sizeof(ccs_numeric_t));
+		CCS_REFUTE(!indexes, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		np->values = (ccs_datum_t *)malloc(
+			num_values * sizeof(ccs_datum_t));
+		CCS_REFUTE_ERR_GOTO(
+			err, !np->values, CCS_RESULT_ERROR_OUT_OF_MEMORY,
+			end);
+		for (size_t i = 0; i < num_values; i++)
+			indexes[i].i = (ccs_int_t)i;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_parameter_convert_samples(
+				parameter, CCS_FALSE, num_values, indexes,
+				np->values),
+			end);
+		np->current = -1;
+		for (size_t i = 0; i < num_values; i++)
+			if (!_datum_cmp(np->values + i, &value)) {
+				np->current = (ccs_int_t)i;
+				break;
+			}
+		CCS_REFUTE_ERR_GOTO(
+			err, np->current < 0,
+			CCS_RESULT_ERROR_INVALID_CONFIGURATION, end);
+		*movable_ret = CCS_TRUE;
+	end:
+		free(indexes);
+		return err;
+	}
+	CCS_VALIDATE(ccs_numerical_parameter_get_properties(
+		parameter, NULL, NULL, NULL, &np->quantization));
+	if (interval->type == CCS_NUMERIC_TYPE_INT) {
+		if (np->quantization.i < 1)
+			np->quantization.i = 1;
+		*movable_ret = interval->upper.i - interval->lower.i >
+					       np->quantization.i ?
+				       CCS_TRUE :
+				       CCS_FALSE;
+	} else
+		*movable_ret = interval->upper.f - interval->lower.f >
+					       np->quantization.f ?
+				       CCS_TRUE :
+				       CCS_FALSE;
+	/* Steps are taken in log space if the parameter is sampled that way */
+	if (wrapper->distribution->dimension == 1 &&
+	    (interval->type == CCS_NUMERIC_TYPE_INT ?
+		     interval->lower.i > 0 :
+		     interval->lower.f > 0.0)) {
+		ccs_distribution_t distribution =
+			wrapper->distribution->distribution;
+		ccs_distribution_type_t dtype;
+		ccs_scale_type_t        scale = CCS_SCALE_TYPE_LINEAR;
+		CCS_VALIDATE(ccs_distribution_get_type(distribution, &dtype));
+		if (dtype == CCS_DISTRIBUTION_TYPE_UNIFORM)
+			CCS_VALIDATE(ccs_uniform_distribution_get_properties(
+				distribution, NULL, NULL, &scale, NULL));
+		else if (dtype == CCS_DISTRIBUTION_TYPE_NORMAL)
+			CCS_VALIDATE(ccs_normal_distribution_get_properties(
+				distribution, NULL, NULL, &scale, NULL));
+		np->log = scale == CCS_SCALE_TYPE_LOGARITHMIC ? CCS_TRUE :
+								CCS_FALSE;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Gaussian step of a fifth of the (log) width of the sampling interval,
+ * quantized and redrawn if it falls outside of the interval or lands on the
+ * current value. */
+static inline ccs_bool_t
+_ccs_neighborhood_step_numerical(
+	_ccs_neighborhood_parameter_t *np,
+	gsl_rng                       *grng,
+	ccs_datum_t                    value,
+	ccs_datum_t                   *value_ret)
+{
+	ccs_interval_t *interval = &np->interval;
+	ccs_bool_t      is_int   = interval->type == CCS_NUMERIC_TYPE_INT;
+	ccs_float_t     lower, upper, x, sigma;
+	lower = is_int ? (ccs_float_t)interval->lower.i : interval->lower.f;
+	upper = is_int ? (ccs_float_t)interval->upper.i : interval->upper.f;
+	x     = is_int ? (ccs_float_t)value.value.i : value.value.f;
+	if (np->log) {
+		sigma = 0.2 * (log(upper) - log(lower));
+		/* integer steps must be able to reach the next value */
+		if (is_int)
+			sigma = fmax(sigma, log1p(1.0 / x));
+		x = log(x);
+	} else {
+		sigma = 0.2 * (upper - lower);
+		if (!isfinite(sigma))
+			sigma = 0.2 * fmax(1.0, fabs(x));
+		if (is_int)
+			sigma = fmax(sigma, 1.0);
+	}
+	for (int tries = 0; tries < 10; tries++) {
+		ccs_float_t y = x + gsl_ran_gaussian(grng, sigma);
+		if (np->log)
+			y = exp(y);
+		if (is_int) {
+			ccs_int_t q = np->quantization.i;
+			ccs_int_t v;
+			y = round((y - lower) / (ccs_float_t)q);
+			if (!(y >= 0.0 && y * q < upper - lower))
+				continue;
+			v = interval->lower.i + (ccs_int_t)y * q;
+			if (v == value.value.i)
+				continue;
+			*value_ret = ccs_int(v);
+			return CCS_TRUE;
+		} else {
+			ccs_float_t q = np->quantization.f;
+			if (q > 0.0)
+				y = lower + round((y - lower) / q) * q;
+			if (!(y >= lower && y < upper) || y == value.value.f)
+				continue;
+			*value_ret = ccs_float(y);
+			return CCS_TRUE;
+		}
+	}
+	return CCS_FALSE;
+}
+
+static inline ccs_datum_t
+_ccs_neighborhood_step_index(
+	_ccs_neighborhood_parameter_t *np,
+	gsl_rng                       *grng)
+{
+	ccs_int_t num_values = np->interval.upper.i;
+	ccs_int_t index;
+	if (np->type == CCS_PARAMETER_TYPE_CATEGORICAL) {
+		/* no order, any other value is a neighbor */
+		index = (ccs_int_t)gsl_rng_uniform_int(
+			grng, (unsigned long int)(num_values - 1));
+		if (index >= np->current)
+			index++;
+	} else {
+		/* ordinal and discrete values move to an adjacent value */
+		if (np->current == 0)
+			index = 1;
+		else if (np->current == num_values - 1)
+			index = num_values - 2;
+		else
+			index = np->current +
+				(gsl_rng_uniform_int(grng, 2) ? 1 : -1);
+	}
+	return np->values[index];
+}
+
+/* Fill the inactive parameters of the source configuration with fresh
+ * samples, so they get a value if the move activates them. */
+static ccs_result_t
+_ccs_neighborhood_fill_inactives(
+	ccs_configuration_space_t configuration_space,
+	ccs_rng_t                 rng,
+	ccs_datum_t              *source,
+	ccs_datum_t              *values,
+	ccs_datum_t              *p_values,
+	ccs_parameter_t          *hps)
+{
+	UT_array                    *array;
+	_ccs_distribution_wrapper_t *dwrapper = NULL;
+	array = configuration_space->data->parameters;
+	DL_FOREACH(configuration_space->data->distribution_list, dwrapper)
+	{
+		ccs_bool_t inactive = CCS_FALSE;
+		for (size_t i = 0; i < dwrapper->dimension; i++) {
+			size_t hindex = dwrapper->parameter_indexes[i];
+			if (source[hindex].type == CCS_DATA_TYPE_INACTIVE)
+				inactive = CCS_TRUE;
+			hps[i] = ((_ccs_parameter_wrapper_cs_t *)
+					  utarray_eltptr(array, hindex))
+					 ->parameter;
+		}
+		if (!inactive)
+			continue;
+		CCS_VALIDATE(ccs_distribution_parameters_sample(
+			dwrapper->distribution, rng, hps, p_values));
+		for (size_t i = 0; i < dwrapper->dimension; i++) {
+			size_t hindex = dwrapper->parameter_indexes[i];
+			if (source[hindex].type == CCS_DATA_TYPE_INACTIVE)
+				values[hindex] = p_values[i];
+		}
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_configuration_space_get_neighbors(
+	ccs_configuration_space_t configuration_space,
+	ccs_configuration_t       configuration,
+	size_t                    num_neighbors,
+	ccs_rng_t                 rng,
+	ccs_configuration_t      *neighbors)
+{
+	CCS_CHECK_OBJ(configuration_space, CCS_OBJECT_TYPE_CONFIGURATION_SPACE);
+	CCS_CHECK_OBJ(configuration, CCS_OBJECT_TYPE_CONFIGURATION);
+	CCS_REFUTE(
+		configuration->data->configuration_space != configuration_space,
+		CCS_RESULT_ERROR_INVALID_CONFIGURATION);
+	if (rng)
+		CCS_CHECK_OBJ(rng, CCS_OBJECT_TYPE_RNG);
+	else
+		rng = configuration_space->data->rng;
+	CCS_CHECK_ARY(num_neighbors, neighbors);
+	if (!num_neighbors)
+		return CCS_RESULT_SUCCESS;
+	for (size_t i = 0; i < num_neighbors; i++)
+		neighbors[i] = NULL;
+	if (!configuration_space->data->graph_ok)
+		CCS_VALIDATE(_generate_constraints(configuration_space));
+
+	ccs_result_t                   err = CCS_RESULT_SUCCESS;
+	ccs_bool_t                     has_inactives = CCS_FALSE;
+	size_t                         num_movables  = 0;
+	size_t                         counter       = 0;
+	size_t                         count         = 0;
+	ccs_configuration_t            config        = NULL;
+	UT_array                      *array;
+	size_t                         num_parameters;
+	ccs_datum_t                   *source;
+	gsl_rng                       *grng;
+	_ccs_neighborhood_parameter_t *nps;
+	size_t                        *movables;
+	ccs_datum_t                   *p_values;
+	ccs_parameter_t               *hps;
+	uintptr_t                      mem;
+
+	array          = configuration_space->data->parameters;
+	num_parameters = utarray_len(array);
+	source         = configuration->data->values;
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	mem = (uintptr_t)calloc(
+		num_parameters, sizeof(_ccs_neighborhood_parameter_t) +
+					sizeof(size_t) + sizeof(ccs_datum_t) +
+					sizeof(ccs_parameter_t));
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	nps      = (_ccs_neighborhood_parameter_t *)mem;
+	movables = (size_t *)(nps + num_parameters);
+	p_values = (ccs_datum_t *)(movables + num_parameters);
+	hps      = (ccs_parameter_t *)(p_values + num_parameters);
+
+	for (size_t i = 0; i < num_parameters; i++) {
+		ccs_bool_t movable;
+		if (source[i].type == CCS_DATA_TYPE_INACTIVE) {
+			has_inactives = CCS_TRUE;
+			continue;
+		}
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_neighborhood_parameter_init(
+				(_ccs_parameter_wrapper_cs_t *)utarray_eltptr(
+					array, i),
+				source[i], nps + i, &movable),
+			end);
+		if (movable)
+			movables[num_movables++] = i;
+	}
+
+	while (num_movables && count < num_neighbors &&
+	       counter < 100 * num_neighbors) {
+		size_t                         index;
+		_ccs_neighborhood_parameter_t *np;
+		ccs_datum_t                   *values;
+		ccs_bool_t                     found;
+		counter++;
+		if (!config)
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_create_configuration(
+					configuration_space, 0, NULL, &config),
+				end);
+		values = config->data->values;
+		memcpy(values, source, num_parameters * sizeof(ccs_datum_t));
+		if (has_inactives)
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_neighborhood_fill_inactives(
+					configuration_space, rng, source,
+					values, p_values, hps),
+				errc);
+		index = movables[gsl_rng_uniform_int(
+			grng, (unsigned long int)num_movables)];
+		np    = nps + index;
+		if (np->type == CCS_PARAMETER_TYPE_NUMERICAL) {
+			if (!_ccs_neighborhood_step_numerical(
+				    np, grng, source[index], values + index))
+				continue;
+		} else
+			values[index] = _ccs_neighborhood_step_index(np, grng);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_configuration_space_set_actives(
+				configuration_space, values),
+			errc);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_configuration_space_test_forbidden(
+				configuration_space, values, &found),
+			errc);
+		if (found) {
+			neighbors[count++] = config;
+			config             = NULL;
+		}
+	}
+	CCS_REFUTE_ERR_GOTO(
+		err, count < num_neighbors,
+		CCS_RESULT_ERROR_SAMPLING_UNSUCCESSFUL, errc);
+errc:
+	if (config)
+		ccs_release_object(config);
+end:
+	for (size_t i = 0; i < num_parameters; i++)
+		if (nps[i].values)
+			free(nps[i].values);
+	free((void *)mem);
+	return err;
+}
+
 static int
 _size_t_sort(const void *a, const void *b)
 {
@@ -41,6 +41,7 @@ struct _ccs_configuration_space_data_s {
 	UT_array                    *parameters;
 	_ccs_parameter_index_hash_t *name_hash;
 	_ccs_parameter_index_hash_t *handle_hash;
+	_ccs_binding_pool_t          pool;
 	ccs_rng_t                    rng;
 	_ccs_distribution_wrapper_t *distribution_list;
 	UT_array                    *forbidden_clauses;
@@ -48,4 +49,54 @@ struct _ccs_configuration_space_data_s {
 	UT_array                    *sorted_indexes;
 };
 
+static inline ccs_result_t
+_ccs_configuration_space_set_actives(
+	ccs_configuration_space_t configuration_space,
+	ccs_datum_t              *values)
+{
+	size_t   *p_index = NULL;
+	UT_array *indexes = configuration_space->data->sorted_indexes;
+	UT_array *array   = configuration_space->data->parameters;
+	while ((p_index = (size_t *)utarray_next(indexes, p_index))) {
+		_ccs_parameter_wrapper_cs_t *wrapper = NULL;
+		wrapper = (_ccs_parameter_wrapper_cs_t *)utarray_eltptr(
+			array, *p_index);
+		if (!wrapper->condition)
+			continue;
+		ccs_datum_t result;
+		CCS_VALIDATE(ccs_expression_eval(
+			wrapper->condition, (ccs_context_t)configuration_space,
+			values, &result));
+		if (!(result.type == CCS_DATA_TYPE_BOOL &&
+		      result.value.i == CCS_TRUE))
+			values[*p_index] = ccs_inactive;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_configuration_space_test_forbidden(
+	ccs_configuration_space_t configuration_space,
+	ccs_datum_t              *values,
+	ccs_bool_t               *is_valid)
+{
+	UT_array         *array = configuration_space->data->forbidden_clauses;
+	ccs_expression_t *p_expression = NULL;
+	*is_valid                      = CCS_FALSE;
+	while ((p_expression = (ccs_expression_t *)utarray_next(
+			array, p_expression))) {
+		ccs_datum_t result;
+		CCS_VALIDATE(ccs_expression_eval(
+			*p_expression, (ccs_context_t)configuration_space,
+			values, &result));
+		if (result.type == CCS_DATA_TYPE_INACTIVE)
+			continue;
+		if (result.type == CCS_DATA_TYPE_BOOL &&
+		    result.value.i == CCS_TRUE)
+			return CCS_RESULT_SUCCESS;
+	}
+	*is_valid = CCS_TRUE;
+	return CCS_RESULT_SUCCESS;
+}
+
 #endif //_CONFIGURATION_SPACE_INTERNAL_H
@@ -109,3 +109,24 @@ ccs_context_get_name(ccs_context_t context, const char **name_ret)
 	CCS_VALIDATE(_ccs_context_get_name(context, name_ret));
 	return CCS_RESULT_SUCCESS;
 }
+
+ccs_result_t
+ccs_context_set_binding_pool_capacity(ccs_context_t context, size_t capacity)
+{
+	CCS_CHECK_CONTEXT(context);
+	_ccs_binding_pool_t *pool = &context->data->pool;
+	_ccs_binding_pool_trim(pool, capacity);
+	pool->capacity = capacity;
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_context_get_binding_pool_capacity(
+	ccs_context_t context,
+	size_t       *capacity_ret)
+{
+	CCS_CHECK_CONTEXT(context);
+	CCS_CHECK_PTR(capacity_ret);
+	*capacity_ret = context->data->pool.capacity;
+	return CCS_RESULT_SUCCESS;
+}
@@ -7,6 +7,7 @@
 #define HASH_NONFATAL_OOM 1
 #include "uthash.h"
 #include "parameter_internal.h"
+#include "binding_pool_internal.h"
 
 typedef struct _ccs_context_data_s _ccs_context_data_t;
 
@@ -34,6 +35,7 @@ struct _ccs_context_data_s {
 	UT_array                    *parameters;
 	_ccs_parameter_index_hash_t *name_hash;
 	_ccs_parameter_index_hash_t *handle_hash;
+	_ccs_binding_pool_t          pool;
 };
 
 struct _ccs_context_s {
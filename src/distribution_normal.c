@@ -237,6 +237,55 @@ _ccs_distribution_normal_get_bounds(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* round() is not vectorized by compilers while trunc() is. The difference
+ * between a value and its truncation being exact, this rounds halfway cases
+ * away from zero exactly as round() does. */
+static inline ccs_float_t
+_ccs_distribution_normal_round(ccs_float_t x)
+{
+	ccs_float_t t = trunc(x);
+	return fabs(x - t) >= 0.5 ? t + copysign(1.0, x) : t;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_normal_quantize_float(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_float_t             quantization)
+{
+	ccs_float_t rquantization = 1.0 / quantization;
+	size_t      i             = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_float_t *v = &values[j].f;
+			ccs_float_t  r = _ccs_distribution_normal_round(
+                                *v * rquantization);
+			*v             = r * quantization;
+		}
+	for (; i < num_values; i++)
+		values[i].f = _ccs_distribution_normal_round(
+				      values[i].f * rquantization) *
+			      quantization;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_normal_round_float(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_float_t             rquantization)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_float_t *v = &values[j].f;
+			*v             = _ccs_distribution_normal_round(
+                                *v * rquantization);
+		}
+	for (; i < num_values; i++)
+		values[i].f = _ccs_distribution_normal_round(
+			values[i].f * rquantization);
+}
+
 static inline ccs_result_t
 _ccs_distribution_normal_samples_float(
 	gsl_rng               *grng,
@@ -246,7 +295,7 @@ _ccs_distribution_normal_samples_float(
 	const ccs_float_t      sigma,
 	const int              quantize,
 	size_t                 num_values,
-	ccs_float_t           *values)
+	ccs_numeric_t         *values)
 {
 	size_t i;
 	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC && quantize) {
@@ -255,28 +304,25 @@ _ccs_distribution_normal_samples_float(
 			// at least 50% chance to get a valid value
 			for (i = 0; i < num_values; i++)
 				do {
-					values[i] =
+					values[i].f =
 						gsl_ran_gaussian(grng, sigma) +
 						mu;
-				} while (values[i] < lq);
+				} while (values[i].f < lq);
 		else
 			// use tail distribution
 			for (i = 0; i < num_values; i++)
-				values[i] = gsl_ran_gaussian_tail(
-						    grng, lq - mu, sigma) +
-					    mu;
+				values[i].f = gsl_ran_gaussian_tail(
+						      grng, lq - mu, sigma) +
+					      mu;
 	} else
 		for (i = 0; i < num_values; i++)
-			values[i] = gsl_ran_gaussian(grng, sigma) + mu;
+			values[i].f = gsl_ran_gaussian(grng, sigma) + mu;
 	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC)
 		for (i = 0; i < num_values; i++)
-			values[i] = exp(values[i]);
-	if (quantize) {
-		ccs_float_t rquantization = 1.0 / quantization;
-		for (i = 0; i < num_values; i++)
-			values[i] =
-				round(values[i] * rquantization) * quantization;
-	}
+			values[i].f = exp(values[i].f);
+	if (quantize)
+		_ccs_distribution_normal_quantize_float(
+			num_values, values, quantization);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -331,15 +377,18 @@ _ccs_distribution_normal_samples_int(
 			} while (CCS_UNLIKELY(
 				values[i].f - q > (ccs_float_t)CCS_INT_MAX ||
 				values[i].f + q < (ccs_float_t)CCS_INT_MIN));
+	// round in place on the float view, then convert
 	if (quantize) {
-		ccs_float_t rquantization = 1.0 / quantization;
+		_ccs_distribution_normal_round_float(
+			num_values, values, 1.0 / quantization);
 		for (i = 0; i < num_values; i++)
-			values[i].i =
-				(ccs_int_t)round(values[i].f * rquantization) *
-				quantization;
-	} else
+			values[i].i = (ccs_int_t)values[i].f * quantization;
+	} else {
+		_ccs_distribution_normal_round_float(
+			num_values, values, 1.0);
 		for (i = 0; i < num_values; i++)
-			values[i].i = round(values[i].f);
+			values[i].i = values[i].f;
+	}
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -363,7 +412,7 @@ _ccs_distribution_normal_samples(
 	if (data_type == CCS_NUMERIC_TYPE_FLOAT)
 		CCS_VALIDATE(_ccs_distribution_normal_samples_float(
 			grng, scale_type, quantization.f, mu, sigma, quantize,
-			num_values, (ccs_float_t *)values));
+			num_values, values));
 	else
 		CCS_VALIDATE(_ccs_distribution_normal_samples_int(
 			grng, scale_type, quantization.i, mu, sigma, quantize,
@@ -381,7 +430,7 @@ _ccs_distribution_normal_strided_samples_float(
 	const int              quantize,
 	size_t                 num_values,
 	size_t                 stride,
-	ccs_float_t           *values)
+	ccs_numeric_t         *values)
 {
 	size_t i;
 	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC && quantize) {
@@ -390,28 +439,29 @@ _ccs_distribution_normal_strided_samples_float(
 			// at least 50% chance to get a valid value
 			for (i = 0; i < num_values; i++)
 				do {
-					values[i * stride] =
+					values[i * stride].f =
 						gsl_ran_gaussian(grng, sigma) +
 						mu;
-				} while (values[i * stride] < lq);
+				} while (values[i * stride].f < lq);
 		else
 			// use tail distribution
 			for (i = 0; i < num_values; i++)
-				values[i * stride] =
+				values[i * stride].f =
 					gsl_ran_gaussian_tail(
 						grng, lq - mu, sigma) +
 					mu;
 	} else
 		for (i = 0; i < num_values; i++)
-			values[i * stride] = gsl_ran_gaussian(grng, sigma) + mu;
+			values[i * stride].f =
+				gsl_ran_gaussian(grng, sigma) + mu;
 	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC)
 		for (i = 0; i < num_values; i++)
-			values[i * stride] = exp(values[i * stride]);
+			values[i * stride].f = exp(values[i * stride].f);
 	if (quantize) {
 		ccs_float_t rquantization = 1.0 / quantization;
 		for (i = 0; i < num_values; i++)
-			values[i * stride] =
-				round(values[i * stride] * rquantization) *
+			values[i * stride].f =
+				round(values[i * stride].f * rquantization) *
 				quantization;
 	}
 	return CCS_RESULT_SUCCESS;
@@ -503,11 +553,14 @@ _ccs_distribution_normal_strided_samples(
 	const ccs_float_t        sigma        = d->sigma;
 	const int                quantize     = d->quantize;
 	gsl_rng                 *grng;
+	if (stride == 1)
+		return _ccs_distribution_normal_samples(
+			data, rng, num_values, values);
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 	if (data_type == CCS_NUMERIC_TYPE_FLOAT)
 		CCS_VALIDATE(_ccs_distribution_normal_strided_samples_float(
 			grng, scale_type, quantization.f, mu, sigma, quantize,
-			num_values, stride, (ccs_float_t *)values));
+			num_values, stride, values));
 	else
 		CCS_VALIDATE(_ccs_distribution_normal_strided_samples_int(
 			grng, scale_type, quantization.i, mu, sigma, quantize,
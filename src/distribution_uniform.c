@@ -224,6 +224,9 @@ _ccs_distribution_uniform_strided_samples(
 	const ccs_numeric_t      internal_upper = d->internal_upper;
 	const int                quantize       = d->quantize;
 	gsl_rng                 *grng;
+	if (stride == 1)
+		return _ccs_distribution_uniform_samples(
+			data, rng, num_values, values);
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 
 	if (data_type == CCS_NUMERIC_TYPE_FLOAT) {
@@ -286,6 +289,95 @@ _ccs_distribution_uniform_strided_samples(
 	return CCS_RESULT_SUCCESS;
 }
 
+static CCS_SIMD_CLONES void
+_ccs_distribution_uniform_shift_float(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_float_t             lower)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_float_t *v = &values[j].f;
+			*v += lower;
+		}
+	for (; i < num_values; i++)
+		values[i].f += lower;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_uniform_quantize_float(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_float_t             quantization,
+	ccs_float_t             lower)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_float_t *v = &values[j].f;
+			*v             = floor(*v) * quantization + lower;
+		}
+	for (; i < num_values; i++)
+		values[i].f = floor(values[i].f) * quantization + lower;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_uniform_quantize_log_float(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_float_t             quantization,
+	ccs_float_t             lower)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_float_t *v = &values[j].f;
+			ccs_float_t  k = floor((*v - lower) / quantization);
+			*v             = k * quantization + lower;
+		}
+	for (; i < num_values; i++)
+		values[i].f = floor((values[i].f - lower) / quantization) *
+				      quantization +
+			      lower;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_uniform_shift_int(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_int_t               lower)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_int_t *v = &values[j].i;
+			*v += lower;
+		}
+	for (; i < num_values; i++)
+		values[i].i += lower;
+}
+
+static CCS_SIMD_CLONES void
+_ccs_distribution_uniform_quantize_int(
+	size_t                  num_values,
+	ccs_numeric_t *restrict values,
+	ccs_int_t               quantization,
+	ccs_int_t               lower)
+{
+	size_t i = 0;
+	for (; i + CCS_SIMD_BLOCK <= num_values; i += CCS_SIMD_BLOCK)
+		for (size_t j = i; j < i + CCS_SIMD_BLOCK; j++) {
+			ccs_int_t *v = &values[j].i;
+			*v           = *v * quantization + lower;
+		}
+	for (; i < num_values; i++)
+		values[i].i = values[i].i * quantization + lower;
+}
+
+/* Contiguous samples are drawn, and mapped through the logarithmic scale, in
+ * a first scalar pass. Quantization and offsetting are then applied to their
+ * float or integer member by the kernels above. */
 static ccs_result_t
 _ccs_distribution_uniform_samples(
 	_ccs_distribution_data_t *data,
@@ -307,35 +399,34 @@ _ccs_distribution_uniform_samples(
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 
 	if (data_type == CCS_NUMERIC_TYPE_FLOAT) {
-		for (i = 0; i < num_values; i++) {
-			values[i].f = gsl_ran_flat(
-				grng, internal_lower.f, internal_upper.f);
-		}
 		if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC) {
 			for (i = 0; i < num_values; i++)
-				values[i].f = exp(values[i].f);
+				values[i].f = exp(gsl_ran_flat(
+					grng, internal_lower.f,
+					internal_upper.f));
 			if (quantize)
-				for (i = 0; i < num_values; i++)
-					values[i].f =
-						floor((values[i].f - lower.f) /
-						      quantization.f) *
-							quantization.f +
-						lower.f;
-		} else if (quantize)
-			for (i = 0; i < num_values; i++)
-				values[i].f =
-					floor(values[i].f) * quantization.f +
-					lower.f;
-		else
+				_ccs_distribution_uniform_quantize_log_float(
+					num_values, values, quantization.f,
+					lower.f);
+		} else {
 			for (i = 0; i < num_values; i++)
-				values[i].f += lower.f;
+				values[i].f = gsl_ran_flat(
+					grng, internal_lower.f,
+					internal_upper.f);
+			if (quantize)
+				_ccs_distribution_uniform_quantize_float(
+					num_values, values, quantization.f,
+					lower.f);
+			else
+				_ccs_distribution_uniform_shift_float(
+					num_values, values, lower.f);
+		}
 	} else {
 		if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC) {
-			for (i = 0; i < num_values; i++) {
+			for (i = 0; i < num_values; i++)
 				values[i].i = floor(exp(gsl_ran_flat(
 					grng, internal_lower.f,
 					internal_upper.f)));
-			}
 			if (quantize)
 				for (i = 0; i < num_values; i++)
 					values[i].i = ((values[i].i - lower.i) /
@@ -343,18 +434,16 @@ _ccs_distribution_uniform_samples(
 							      quantization.i +
 						      lower.i;
 		} else {
-			for (i = 0; i < num_values; i++) {
+			for (i = 0; i < num_values; i++)
 				values[i].i = gsl_rng_uniform_int(
 					grng, internal_upper.i);
-			}
 			if (quantize)
-				for (i = 0; i < num_values; i++)
-					values[i].i =
-						values[i].i * quantization.i +
-						lower.i;
+				_ccs_distribution_uniform_quantize_int(
+					num_values, values, quantization.i,
+					lower.i);
 			else
-				for (i = 0; i < num_values; i++)
-					values[i].i += lower.i;
+				_ccs_distribution_uniform_shift_int(
+					num_values, values, lower.i);
 		}
 	}
 	return CCS_RESULT_SUCCESS;
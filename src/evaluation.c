@@ -1,6 +1,7 @@
 #include "cconfigspace_internal.h"
 #include "evaluation_internal.h"
 #include "configuration_internal.h"
+#include "objective_space_internal.h"
 #include <string.h>
 
 static inline _ccs_evaluation_ops_t *
@@ -12,9 +13,19 @@ ccs_evaluation_get_ops(ccs_evaluation_t evaluation)
 static ccs_result_t
 _ccs_evaluation_del(ccs_object_t object)
 {
-	ccs_evaluation_t evaluation = (ccs_evaluation_t)object;
-	ccs_release_object(evaluation->data->objective_space);
-	ccs_release_object(evaluation->data->configuration);
+	ccs_evaluation_t      evaluation = (ccs_evaluation_t)object;
+	ccs_objective_space_t objective_space =
+		evaluation->data->objective_space;
+	ccs_configuration_t configuration = evaluation->data->configuration;
+	if (evaluation->obj.pooled)
+		_ccs_binding_pool_put(
+			&objective_space->data->pool, evaluation,
+			sizeof(struct _ccs_evaluation_s) +
+				sizeof(struct _ccs_evaluation_data_s) +
+				evaluation->data->num_values *
+					sizeof(ccs_datum_t));
+	ccs_release_object(objective_space);
+	ccs_release_object(configuration);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -181,10 +192,12 @@ ccs_create_evaluation(
 	CCS_VALIDATE(
 		ccs_objective_space_get_num_parameters(objective_space, &num));
 	CCS_REFUTE(values && num != num_values, CCS_RESULT_ERROR_INVALID_VALUE);
-	uintptr_t mem = (uintptr_t)calloc(
-		1, sizeof(struct _ccs_evaluation_s) +
-			   sizeof(struct _ccs_evaluation_data_s) +
-			   num * sizeof(ccs_datum_t));
+	ccs_bool_t pooled;
+	size_t     size = sizeof(struct _ccs_evaluation_s) +
+		      sizeof(struct _ccs_evaluation_data_s) +
+		      num * sizeof(ccs_datum_t);
+	uintptr_t mem = (uintptr_t)_ccs_binding_pool_get(
+		&objective_space->data->pool, size, &pooled);
 	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
 	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(objective_space), errmem);
 	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(configuration), erros);
@@ -193,6 +206,7 @@ ccs_create_evaluation(
 	_ccs_object_init(
 		&(eval->obj), CCS_OBJECT_TYPE_EVALUATION,
 		(_ccs_object_ops_t *)&_evaluation_ops);
+	eval->obj.pooled            = pooled;
 	eval->data                  = (struct _ccs_evaluation_data_s
                               *)(mem + sizeof(struct _ccs_evaluation_s));
 	eval->data->num_values      = num;
@@ -220,7 +234,7 @@ errc:
 erros:
 	ccs_release_object(objective_space);
 errmem:
-	free((void *)mem);
+	_ccs_binding_pool_put(&objective_space->data->pool, (void *)mem, size);
 	return err;
 }
 
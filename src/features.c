@@ -1,5 +1,6 @@
 #include "cconfigspace_internal.h"
 #include "features_internal.h"
+#include "features_space_internal.h"
 #include "datum_hash.h"
 #include <string.h>
 
@@ -12,8 +13,19 @@ ccs_features_get_ops(ccs_features_t features)
 static ccs_result_t
 _ccs_features_del(ccs_object_t object)
 {
-	ccs_features_t features = (ccs_features_t)object;
-	ccs_release_object(features->data->features_space);
+	ccs_features_t       features       = (ccs_features_t)object;
+	ccs_features_space_t features_space = features->data->features_space;
+	if (features->data->interned)
+		_ccs_features_intern_put(
+			&features_space->data->intern, features);
+	else if (features->obj.pooled)
+		_ccs_binding_pool_put(
+			&features_space->data->pool, features,
+			sizeof(struct _ccs_features_s) +
+				sizeof(struct _ccs_features_data_s) +
+				features->data->num_values *
+					sizeof(ccs_datum_t));
+	ccs_release_object(features_space);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -65,6 +77,10 @@ _ccs_features_serialize(
 static ccs_result_t
 _ccs_features_hash(_ccs_features_data_t *data, ccs_hash_t *hash_ret)
 {
+	if (data->interned) {
+		*hash_ret = data->hash;
+		return CCS_RESULT_SUCCESS;
+	}
 	CCS_VALIDATE(_ccs_binding_hash((_ccs_binding_data_t *)data, hash_ret));
 	return CCS_RESULT_SUCCESS;
 }
@@ -100,10 +116,12 @@ ccs_create_features(
 	CCS_REFUTE(
 		values && num_parameters != num_values,
 		CCS_RESULT_ERROR_INVALID_VALUE);
-	uintptr_t mem = (uintptr_t)calloc(
-		1, sizeof(struct _ccs_features_s) +
-			   sizeof(struct _ccs_features_data_s) +
-			   num_parameters * sizeof(ccs_datum_t));
+	ccs_bool_t pooled;
+	size_t     size = sizeof(struct _ccs_features_s) +
+		      sizeof(struct _ccs_features_data_s) +
+		      num_parameters * sizeof(ccs_datum_t);
+	uintptr_t mem = (uintptr_t)_ccs_binding_pool_get(
+		&features_space->data->pool, size, &pooled);
 	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
 	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(features_space), errmem);
 	ccs_features_t feat;
@@ -111,6 +129,7 @@ ccs_create_features(
 	_ccs_object_init(
 		&(feat->obj), CCS_OBJECT_TYPE_FEATURES,
 		(_ccs_object_ops_t *)&_features_ops);
+	feat->obj.pooled           = pooled;
 	feat->data                 = (struct _ccs_features_data_s
                               *)(mem + sizeof(struct _ccs_features_s));
 	feat->data->num_values     = num_parameters;
@@ -134,11 +153,113 @@ ccs_create_features(
 	return CCS_RESULT_SUCCESS;
 errfs:
 	ccs_release_object(features_space);
+errmem:
+	_ccs_binding_pool_put(&features_space->data->pool, (void *)mem, size);
+	return err;
+}
+
+ccs_result_t
+ccs_features_space_intern_features(
+	ccs_features_space_t features_space,
+	size_t               num_values,
+	ccs_datum_t         *values,
+	ccs_features_t      *features_ret)
+{
+	CCS_CHECK_OBJ(features_space, CCS_OBJECT_TYPE_FEATURES_SPACE);
+	CCS_CHECK_PTR(features_ret);
+	CCS_CHECK_ARY(num_values, values);
+	ccs_result_t err;
+	size_t       num_parameters;
+	CCS_VALIDATE(ccs_features_space_get_num_parameters(
+		features_space, &num_parameters));
+	CCS_REFUTE(
+		num_parameters != num_values, CCS_RESULT_ERROR_INVALID_VALUE);
+	_ccs_features_intern_t *intern = &features_space->data->intern;
+	ccs_hash_t              hash =
+		_ccs_features_intern_hash(features_space, num_values, values);
+	ccs_features_t feat = NULL;
+	if (intern->count)
+		feat = *_ccs_features_intern_find(
+			intern, hash, num_values, values);
+	if (feat) {
+		if (feat->obj.refcount) {
+			feat->obj.refcount++;
+		} else {
+			/* revive dormant features */
+			CCS_VALIDATE(ccs_retain_object(features_space));
+			_ccs_object_init(
+				&(feat->obj), CCS_OBJECT_TYPE_FEATURES,
+				(_ccs_object_ops_t *)&_features_ops);
+			feat->obj.pooled = CCS_TRUE;
+			intern->num_dormant--;
+		}
+		*features_ret = feat;
+		return CCS_RESULT_SUCCESS;
+	}
+
+	uintptr_t mem = (uintptr_t)calloc(
+		1, sizeof(struct _ccs_features_s) +
+			   sizeof(struct _ccs_features_data_s) +
+			   num_parameters * sizeof(ccs_datum_t));
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	feat = (ccs_features_t)mem;
+	_ccs_object_init(
+		&(feat->obj), CCS_OBJECT_TYPE_FEATURES,
+		(_ccs_object_ops_t *)&_features_ops);
+	/* interned features are freed by the intern table */
+	feat->obj.pooled           = CCS_TRUE;
+	feat->data                 = (struct _ccs_features_data_s
+                              *)(mem + sizeof(struct _ccs_features_s));
+	feat->data->num_values     = num_parameters;
+	feat->data->features_space = features_space;
+	feat->data->values =
+		(ccs_datum_t
+			 *)(mem + sizeof(struct _ccs_features_s) + sizeof(struct _ccs_features_data_s));
+	feat->data->interned = CCS_TRUE;
+	feat->data->hash     = hash;
+	for (size_t i = 0; i < num_values; i++)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_features_space_validate_value(
+				features_space, i, values[i],
+				feat->data->values + i),
+			errmem);
+	CCS_VALIDATE_ERR_GOTO(
+		err, _ccs_features_intern_insert(intern, feat), errmem);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(features_space), errintern);
+	*features_ret = feat;
+	return CCS_RESULT_SUCCESS;
+errintern:
+	_ccs_features_intern_remove(intern, feat);
 errmem:
 	free((void *)mem);
 	return err;
 }
 
+ccs_result_t
+ccs_features_space_set_interned_features_capacity(
+	ccs_features_space_t features_space,
+	size_t               capacity)
+{
+	CCS_CHECK_OBJ(features_space, CCS_OBJECT_TYPE_FEATURES_SPACE);
+	_ccs_features_intern_t *intern = &features_space->data->intern;
+	_ccs_features_intern_trim(intern, capacity);
+	intern->capacity = capacity;
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_features_space_get_interned_features_capacity(
+	ccs_features_space_t features_space,
+	size_t              *capacity_ret)
+{
+	CCS_CHECK_OBJ(features_space, CCS_OBJECT_TYPE_FEATURES_SPACE);
+	CCS_CHECK_PTR(capacity_ret);
+	*capacity_ret = features_space->data->intern.capacity;
+	return CCS_RESULT_SUCCESS;
+}
+
 ccs_result_t
 ccs_features_get_features_space(
 	ccs_features_t        features,
@@ -166,6 +287,10 @@ ccs_result_t
 ccs_features_set_value(ccs_features_t features, size_t index, ccs_datum_t value)
 {
 	CCS_CHECK_OBJ(features, CCS_OBJECT_TYPE_FEATURES);
+	CCS_REFUTE_MSG(
+		features->data->interned,
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION,
+		"Interned features are immutable");
 	CCS_VALIDATE(
 		_ccs_binding_set_value((ccs_binding_t)features, index, value));
 	return CCS_RESULT_SUCCESS;
@@ -26,6 +26,10 @@ struct _ccs_features_data_s {
 	ccs_features_space_t features_space;
 	size_t               num_values;
 	ccs_datum_t         *values;
+	/* interned features are immutable and keep their hash */
+	ccs_bool_t           interned;
+	ccs_hash_t           hash;
+	ccs_features_t       intern_next;
 };
 
 #endif //_FEATURES_INTERNAL_H
@@ -21,6 +21,8 @@ _ccs_features_space_del(ccs_object_t object)
 		free(elem);
 	}
 	utarray_free(features_space->data->parameters);
+	_ccs_binding_pool_fini(&features_space->data->pool);
+	_ccs_features_intern_fini(&features_space->data->intern);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -113,6 +115,8 @@ ccs_create_features_space(
 			 *)(mem + sizeof(struct _ccs_features_space_s) + sizeof(struct _ccs_features_space_data_s));
 	utarray_new(feat_space->data->parameters, &_parameter_wrapper_icd);
 	strcpy((char *)(feat_space->data->name), name);
+	feat_space->data->intern.capacity =
+		_CCS_FEATURES_INTERN_DEFAULT_CAPACITY;
 	*features_space_ret = feat_space;
 	return CCS_RESULT_SUCCESS;
 arrays:
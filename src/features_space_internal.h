@@ -1,6 +1,23 @@
 #ifndef _FEATURES_SPACE_INTERNAL_H
 #define _FEATURES_SPACE_INTERNAL_H
 #include "context_internal.h"
+#include "features_internal.h"
+
+/* Interned features of a features space (see
+ * ccs_features_space_intern_features), chained by hash. Live features are
+ * only weakly referenced by the table. Once released they stay dormant, with
+ * a null refcount and no reference to their space, up to capacity, and are
+ * revived by the next lookup of the same values. */
+#define _CCS_FEATURES_INTERN_DEFAULT_CAPACITY 64
+
+struct _ccs_features_intern_s {
+	size_t          capacity;
+	size_t          count;
+	size_t          num_dormant;
+	size_t          num_buckets;
+	ccs_features_t *buckets;
+};
+typedef struct _ccs_features_intern_s _ccs_features_intern_t;
 
 struct _ccs_features_space_data_s;
 typedef struct _ccs_features_space_data_s _ccs_features_space_data_t;
@@ -20,6 +37,222 @@ struct _ccs_features_space_data_s {
 	UT_array                    *parameters;
 	_ccs_parameter_index_hash_t *name_hash;
 	_ccs_parameter_index_hash_t *handle_hash;
+	_ccs_binding_pool_t          pool;
+	_ccs_features_intern_t       intern;
 };
 
+static inline ccs_hash_t
+_ccs_features_intern_hash(
+	ccs_features_space_t features_space,
+	size_t               num_values,
+	ccs_datum_t         *values)
+{
+	_ccs_binding_data_t data = {
+		(ccs_context_t)features_space, num_values, values};
+	ccs_hash_t hash;
+	_ccs_binding_hash(&data, &hash);
+	return hash;
+}
+
+/* Returns the link pointing to the features with the given values, or to
+ * the NULL terminating their bucket. */
+static inline ccs_features_t *
+_ccs_features_intern_find(
+	_ccs_features_intern_t *intern,
+	ccs_hash_t              hash,
+	size_t                  num_values,
+	ccs_datum_t            *values)
+{
+	ccs_features_t *link = intern->buckets + hash % intern->num_buckets;
+	for (; *link; link = &(*link)->data->intern_next) {
+		_ccs_features_data_t *data = (*link)->data;
+		size_t                i    = 0;
+		if (data->hash != hash || data->num_values != num_values)
+			continue;
+		while (i < num_values &&
+		       !_datum_cmp(data->values + i, values + i))
+			i++;
+		if (i == num_values)
+			break;
+	}
+	return link;
+}
+
+static inline ccs_result_t
+_ccs_features_intern_insert(
+	_ccs_features_intern_t *intern,
+	ccs_features_t          features)
+{
+	if (intern->count >= intern->num_buckets) {
+		size_t num_buckets =
+			intern->num_buckets ? 2 * intern->num_buckets : 16;
+		ccs_features_t *buckets = (ccs_features_t *)calloc(
+			num_buckets, sizeof(ccs_features_t));
+		CCS_REFUTE(!buckets, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		for (size_t i = 0; i < intern->num_buckets; i++) {
+			ccs_features_t feat = intern->buckets[i];
+			while (feat) {
+				ccs_features_t  next = feat->data->intern_next;
+				ccs_features_t *link =
+					buckets +
+					feat->data->hash % num_buckets;
+				feat->data->intern_next = *link;
+				*link                   = feat;
+				feat                    = next;
+			}
+		}
+		free(intern->buckets);
+		intern->buckets     = buckets;
+		intern->num_buckets = num_buckets;
+	}
+	ccs_features_t *link =
+		intern->buckets + features->data->hash % intern->num_buckets;
+	features->data->intern_next = *link;
+	*link                       = features;
+	intern->count++;
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline void
+_ccs_features_intern_remove(
+	_ccs_features_intern_t *intern,
+	ccs_features_t          features)
+{
+	ccs_features_t *link =
+		intern->buckets + features->data->hash % intern->num_buckets;
+	while (*link != features)
+		link = &(*link)->data->intern_next;
+	*link = features->data->intern_next;
+	intern->count--;
+}
+
+/* Called from the features del function: keep the features dormant if
+ * capacity allows, else forget and free them. */
+static inline void
+_ccs_features_intern_put(
+	_ccs_features_intern_t *intern,
+	ccs_features_t          features)
+{
+	if (intern->num_dormant < intern->capacity) {
+		intern->num_dormant++;
+		return;
+	}
+	_ccs_features_intern_remove(intern, features);
+	free(features);
+}
+
+/* Free dormant features until at most count remain. */
+static inline void
+_ccs_features_intern_trim(_ccs_features_intern_t *intern, size_t count)
+{
+	for (size_t i = 0;
+	     i < intern->num_buckets && intern->num_dormant > count; i++) {
+		ccs_features_t *link = intern->buckets + i;
+		while (*link && intern->num_dormant > count) {
+			ccs_features_t feat = *link;
+			if (feat->obj.refcount) {
+				link = &feat->data->intern_next;
+				continue;
+			}
+			*link = feat->data->intern_next;
+			intern->count--;
+			intern->num_dormant--;
+			free(feat);
+		}
+	}
+}
+
+static inline void
+_ccs_features_intern_fini(_ccs_features_intern_t *intern)
+{
+	_ccs_features_intern_trim(intern, 0);
+	free(intern->buckets);
+	memset(intern, 0, sizeof(*intern));
+}
+
+static inline ccs_result_t
+_ccs_discrete_parameter_get_numeric_bounds(
+	ccs_parameter_t parameter,
+	double         *lower,
+	double         *upper)
+{
+	size_t       num_values;
+	ccs_datum_t *values;
+	ccs_result_t err = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(ccs_discrete_parameter_get_values(
+		parameter, 0, NULL, &num_values));
+	values = (ccs_datum_t *)malloc(num_values * sizeof(ccs_datum_t));
+	CCS_REFUTE(!values, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_discrete_parameter_get_values(
+			parameter, num_values, values, NULL),
+		end);
+	for (size_t i = 0; i < num_values; i++) {
+		double v;
+		if (values[i].type == CCS_DATA_TYPE_INT)
+			v = values[i].value.i;
+		else if (values[i].type == CCS_DATA_TYPE_FLOAT)
+			v = values[i].value.f;
+		else
+			CCS_RAISE_ERR_GOTO(
+				err, CCS_RESULT_ERROR_UNSUPPORTED_OPERATION,
+				end, "Parameter has non numeric values");
+		if (i == 0 || v < *lower)
+			*lower = v;
+		if (i == 0 || v > *upper)
+			*upper = v;
+	}
+end:
+	free(values);
+	return err;
+}
+
+/* Map each parameter of a features space onto [0, 1] through an offset and a
+ * scale, so that distances between features can be computed. Only numerical
+ * parameters and discrete parameters with numeric values support this, other
+ * parameters raise CCS_RESULT_ERROR_UNSUPPORTED_OPERATION. offsets and scales
+ * can be NULL, in which case the features space is only checked. */
+static inline ccs_result_t
+_ccs_features_space_get_numeric_bounds(
+	ccs_features_space_t features_space,
+	double              *offsets,
+	double              *scales)
+{
+	UT_array                 *array   = features_space->data->parameters;
+	_ccs_parameter_wrapper_t *wrapper = NULL;
+	size_t                    i       = 0;
+	while ((wrapper = (_ccs_parameter_wrapper_t *)utarray_next(
+			array, wrapper))) {
+		ccs_parameter_type_t type;
+		double               lower = 0.0, upper = 0.0;
+		CCS_VALIDATE(ccs_parameter_get_type(wrapper->parameter, &type));
+		if (type == CCS_PARAMETER_TYPE_NUMERICAL) {
+			ccs_numeric_type_t data_type;
+			ccs_numeric_t      l, u;
+			CCS_VALIDATE(ccs_numerical_parameter_get_properties(
+				wrapper->parameter, &data_type, &l, &u, NULL));
+			if (data_type == CCS_NUMERIC_TYPE_INT) {
+				lower = l.i;
+				upper = u.i;
+			} else {
+				lower = l.f;
+				upper = u.f;
+			}
+		} else if (type == CCS_PARAMETER_TYPE_DISCRETE) {
+			CCS_VALIDATE(_ccs_discrete_parameter_get_numeric_bounds(
+				wrapper->parameter, &lower, &upper));
+		} else
+			CCS_RAISE(
+				CCS_RESULT_ERROR_UNSUPPORTED_OPERATION,
+				"Features parameter is not numeric");
+		if (offsets)
+			offsets[i] = lower;
+		if (scales)
+			scales[i] = upper > lower ? 1.0 / (upper - lower) : 1.0;
+		i++;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
 #endif //_FEATURES_SPACE_INTERNAL_H
@@ -1,5 +1,7 @@
 #include "cconfigspace_internal.h"
 #include "features_tuner_internal.h"
+#include "features_internal.h"
+#include "datum_hash.h"
 
 static inline _ccs_features_tuner_ops_t *
 ccs_features_tuner_get_ops(ccs_features_tuner_t tuner)
@@ -7,6 +9,267 @@ ccs_features_tuner_get_ops(ccs_features_tuner_t tuner)
 	return (_ccs_features_tuner_ops_t *)tuner->obj.ops;
 }
 
+static inline ccs_hash_t
+_ccs_suggestion_cache_hash(size_t num_values, ccs_datum_t *values)
+{
+	ccs_hash_t h = 0;
+	for (size_t i = 0; i < num_values; i++)
+		h = _hash_combine(h, _hash_datum(values + i));
+	return h;
+}
+
+/* Returns the link to the entry of the given features values, or to the end
+ * of its bucket. */
+static inline _ccs_suggestion_cache_entry_t **
+_ccs_suggestion_cache_find(
+	_ccs_suggestion_cache_t *cache,
+	ccs_hash_t               hash,
+	size_t                   num_values,
+	ccs_datum_t             *values)
+{
+	_ccs_suggestion_cache_entry_t **link =
+		cache->buckets + hash % cache->num_buckets;
+	for (; *link; link = &(*link)->next) {
+		_ccs_features_data_t *data = (*link)->features->data;
+		size_t                i    = 0;
+		if ((*link)->hash != hash || data->num_values != num_values)
+			continue;
+		while (i < num_values &&
+		       !_datum_cmp(values + i, data->values + i))
+			i++;
+		if (i == num_values)
+			break;
+	}
+	return link;
+}
+
+static inline void
+_ccs_suggestion_cache_remove(
+	_ccs_suggestion_cache_t        *cache,
+	_ccs_suggestion_cache_entry_t **link)
+{
+	_ccs_suggestion_cache_entry_t *entry = *link;
+	*link                                = entry->next;
+	_ccs_suggestion_cache_free_entry(cache, entry);
+}
+
+/* Drops the least recently used entries until at most capacity remain */
+static inline void
+_ccs_suggestion_cache_shrink(_ccs_suggestion_cache_t *cache, size_t capacity)
+{
+	while (cache->count > capacity) {
+		_ccs_suggestion_cache_entry_t  *entry = cache->lru;
+		_ccs_suggestion_cache_entry_t **link =
+			cache->buckets + entry->hash % cache->num_buckets;
+		while (*link != entry)
+			link = &(*link)->next;
+		_ccs_suggestion_cache_remove(cache, link);
+	}
+}
+
+static ccs_result_t
+_ccs_suggestion_cache_insert(
+	_ccs_suggestion_cache_t       *cache,
+	_ccs_suggestion_cache_entry_t *entry)
+{
+	if (cache->count >= cache->num_buckets) {
+		size_t num_buckets = cache->num_buckets ? 2 * cache->num_buckets
+							: 16;
+		_ccs_suggestion_cache_entry_t **buckets =
+			(_ccs_suggestion_cache_entry_t **)calloc(
+				num_buckets,
+				sizeof(_ccs_suggestion_cache_entry_t *));
+		CCS_REFUTE(!buckets, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		for (size_t i = 0; i < cache->num_buckets; i++) {
+			_ccs_suggestion_cache_entry_t *e = cache->buckets[i];
+			while (e) {
+				_ccs_suggestion_cache_entry_t *next = e->next;
+				size_t b = e->hash % num_buckets;
+				e->next  = buckets[b];
+				buckets[b] = e;
+				e          = next;
+			}
+		}
+		free(cache->buckets);
+		cache->buckets     = buckets;
+		cache->num_buckets = num_buckets;
+	}
+	size_t b                = entry->hash % cache->num_buckets;
+	entry->next             = cache->buckets[b];
+	cache->buckets[b]       = entry;
+	DL_APPEND2(cache->lru, entry, lru_prev, lru_next);
+	cache->count++;
+	if (entry->derived)
+		cache->num_derived++;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_features_tuner_is_optimum(
+	ccs_features_tuner_t      tuner,
+	ccs_features_t            features,
+	ccs_features_evaluation_t evaluation,
+	ccs_bool_t               *optimum_ret)
+{
+	_ccs_features_tuner_ops_t *ops = ccs_features_tuner_get_ops(tuner);
+	ccs_features_evaluation_t *optima;
+	size_t                     num_optima;
+	ccs_result_t               err = CCS_RESULT_SUCCESS;
+	*optimum_ret                   = CCS_FALSE;
+	CCS_VALIDATE(ops->get_optima(tuner, features, 0, NULL, &num_optima));
+	if (!num_optima)
+		return CCS_RESULT_SUCCESS;
+	optima = (ccs_features_evaluation_t *)malloc(
+		num_optima * sizeof(ccs_features_evaluation_t));
+	CCS_REFUTE(!optima, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ops->get_optima(tuner, features, num_optima, optima, NULL),
+		end);
+	for (size_t i = 0; i < num_optima && !*optimum_ret; i++)
+		if (optima[i] == evaluation)
+			*optimum_ret = CCS_TRUE;
+end:
+	free(optima);
+	return err;
+}
+
+/* Drop the cached suggestions whose features got new optima */
+static ccs_result_t
+_ccs_features_tuner_invalidate_suggestions(
+	ccs_features_tuner_t       tuner,
+	size_t                     num_evaluations,
+	ccs_features_evaluation_t *evaluations)
+{
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	_ccs_suggestion_cache_t *cache          = d->suggestion_cache;
+	ccs_bool_t               optima_changed = CCS_FALSE;
+	for (size_t i = 0; i < num_evaluations && cache->count; i++) {
+		ccs_evaluation_result_t         result;
+		ccs_features_t                  features;
+		ccs_bool_t                      optimum;
+		_ccs_suggestion_cache_entry_t **link;
+		CCS_VALIDATE(ccs_features_evaluation_get_result(
+			evaluations[i], &result));
+		if (result != CCS_RESULT_SUCCESS)
+			continue;
+		CCS_VALIDATE(ccs_features_evaluation_get_features(
+			evaluations[i], &features));
+		link = _ccs_suggestion_cache_find(
+			cache,
+			_ccs_suggestion_cache_hash(
+				features->data->num_values,
+				features->data->values),
+			features->data->num_values, features->data->values);
+		if (!*link && !cache->num_derived)
+			continue;
+		CCS_VALIDATE(_ccs_features_tuner_is_optimum(
+			tuner, features, evaluations[i], &optimum));
+		if (!optimum)
+			continue;
+		optima_changed = CCS_TRUE;
+		if (*link)
+			_ccs_suggestion_cache_remove(cache, link);
+	}
+	if (optima_changed && cache->num_derived)
+		_ccs_suggestion_cache_clear(cache, CCS_TRUE);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Suggest a configuration for new features values, and cache its values.
+ * Suggestions are only cached if they follow from optima, either of the
+ * features or, through nearest features, of other features: features
+ * tuners otherwise return a new random configuration at each call, that
+ * would be pinned by the cache until optima change. */
+static ccs_result_t
+_ccs_features_tuner_cache_suggestion(
+	ccs_features_tuner_t tuner,
+	ccs_hash_t           hash,
+	size_t               num_features_values,
+	ccs_datum_t         *features_values,
+	size_t               num_values,
+	ccs_datum_t         *values)
+{
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	_ccs_features_tuner_ops_t    *ops = ccs_features_tuner_get_ops(tuner);
+	_ccs_suggestion_cache_entry_t *entry         = NULL;
+	ccs_features_t                 features      = NULL;
+	ccs_configuration_t            configuration = NULL;
+	size_t                         num_optima;
+	ccs_bool_t                     derived = CCS_FALSE;
+	ccs_bool_t                     valid;
+	ccs_result_t                   err;
+
+	CCS_VALIDATE(ccs_create_features(
+		d->features_space, num_features_values, features_values,
+		&features));
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_features_space_check_features(
+			d->features_space, features, &valid),
+		errfeat);
+	CCS_REFUTE_ERR_GOTO(
+		err, !valid, CCS_RESULT_ERROR_INVALID_FEATURES, errfeat);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ops->suggest(tuner, features, &configuration), errfeat);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ops->get_optima(tuner, features, 0, NULL, &num_optima),
+		errconf);
+	if (!num_optima && d->nearest_features) {
+		derived = CCS_TRUE;
+		CCS_VALIDATE_ERR_GOTO(
+			err, ops->get_optima(tuner, NULL, 0, NULL, &num_optima),
+			errconf);
+	}
+	if (!num_optima || !d->suggestion_cache_capacity) {
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_configuration_get_values(
+				configuration, num_values, values, NULL),
+			errconf);
+		ccs_release_object(configuration);
+		ccs_release_object(features);
+		return CCS_RESULT_SUCCESS;
+	}
+	if (!d->suggestion_cache) {
+		d->suggestion_cache = (_ccs_suggestion_cache_t *)calloc(
+			1, sizeof(_ccs_suggestion_cache_t));
+		CCS_REFUTE_ERR_GOTO(
+			err, !d->suggestion_cache,
+			CCS_RESULT_ERROR_OUT_OF_MEMORY, errconf);
+	}
+	entry = (_ccs_suggestion_cache_entry_t *)malloc(
+		sizeof(_ccs_suggestion_cache_entry_t) +
+		num_values * sizeof(ccs_datum_t));
+	CCS_REFUTE_ERR_GOTO(
+		err, !entry, CCS_RESULT_ERROR_OUT_OF_MEMORY, errconf);
+	entry->hash     = hash;
+	entry->features = features;
+	entry->derived  = derived;
+	entry->values   = (ccs_datum_t *)(entry + 1);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_configuration_get_values(
+			configuration, num_values, entry->values, NULL),
+		errentry);
+	_ccs_suggestion_cache_shrink(
+		d->suggestion_cache, d->suggestion_cache_capacity - 1);
+	CCS_VALIDATE_ERR_GOTO(
+		err, _ccs_suggestion_cache_insert(d->suggestion_cache, entry),
+		errentry);
+	ccs_release_object(configuration);
+	memcpy(values, entry->values, num_values * sizeof(ccs_datum_t));
+	return CCS_RESULT_SUCCESS;
+errentry:
+	free(entry);
+errconf:
+	ccs_release_object(configuration);
+errfeat:
+	ccs_release_object(features);
+	return err;
+}
+
 ccs_result_t
 ccs_features_tuner_get_type(
 	ccs_features_tuner_t       tuner,
@@ -70,6 +333,63 @@ ccs_features_tuner_get_features_space(
 	return CCS_RESULT_SUCCESS;
 }
 
+ccs_result_t
+ccs_features_tuner_set_nearest_features(
+	ccs_features_tuner_t tuner,
+	size_t               count)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	if (count)
+		CCS_VALIDATE(_ccs_features_space_get_numeric_bounds(
+			d->features_space, NULL, NULL));
+	d->nearest_features = count;
+	if (d->suggestion_cache)
+		_ccs_suggestion_cache_clear(d->suggestion_cache, CCS_TRUE);
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_features_tuner_get_nearest_features(
+	ccs_features_tuner_t tuner,
+	size_t              *count_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
+	CCS_CHECK_PTR(count_ret);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	*count_ret = d->nearest_features;
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_features_tuner_set_suggestion_cache_capacity(
+	ccs_features_tuner_t tuner,
+	size_t               capacity)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	d->suggestion_cache_capacity = capacity;
+	if (d->suggestion_cache)
+		_ccs_suggestion_cache_shrink(d->suggestion_cache, capacity);
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_features_tuner_get_suggestion_cache_capacity(
+	ccs_features_tuner_t tuner,
+	size_t              *capacity_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
+	CCS_CHECK_PTR(capacity_ret);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	*capacity_ret = d->suggestion_cache_capacity;
+	return CCS_RESULT_SUCCESS;
+}
+
 ccs_result_t
 ccs_features_tuner_ask(
 	ccs_features_tuner_t tuner,
@@ -106,7 +426,12 @@ ccs_features_tuner_tell(
 	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
 	CCS_CHECK_ARY(num_evaluations, evaluations);
 	_ccs_features_tuner_ops_t *ops = ccs_features_tuner_get_ops(tuner);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
 	CCS_VALIDATE(ops->tell(tuner, num_evaluations, evaluations));
+	if (d->suggestion_cache && d->suggestion_cache->count)
+		CCS_VALIDATE(_ccs_features_tuner_invalidate_suggestions(
+			tuner, num_evaluations, evaluations));
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -174,3 +499,52 @@ ccs_features_tuner_suggest(
 	CCS_VALIDATE(ops->suggest(tuner, features, configuration));
 	return CCS_RESULT_SUCCESS;
 }
+
+ccs_result_t
+ccs_features_tuner_suggest_values(
+	ccs_features_tuner_t tuner,
+	size_t               num_features_values,
+	ccs_datum_t         *features_values,
+	size_t               num_values,
+	ccs_datum_t         *values,
+	size_t              *num_values_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_FEATURES_TUNER);
+	_ccs_features_tuner_ops_t *ops = ccs_features_tuner_get_ops(tuner);
+	CCS_REFUTE(!ops->suggest, CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+	CCS_CHECK_ARY(num_features_values, features_values);
+	CCS_CHECK_ARY(num_values, values);
+	CCS_REFUTE(!values && !num_values_ret, CCS_RESULT_ERROR_INVALID_VALUE);
+	_ccs_features_tuner_common_data_t *d =
+		(_ccs_features_tuner_common_data_t *)tuner->data;
+	size_t num;
+	CCS_VALIDATE(_ccs_context_get_num_parameters(
+		(ccs_context_t)d->configuration_space, &num));
+	if (values) {
+		CCS_REFUTE(num_values < num, CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_hash_t hash = _ccs_suggestion_cache_hash(
+			num_features_values, features_values);
+		_ccs_suggestion_cache_entry_t *entry = NULL;
+		if (d->suggestion_cache && d->suggestion_cache->count)
+			entry = *_ccs_suggestion_cache_find(
+				d->suggestion_cache, hash, num_features_values,
+				features_values);
+		if (entry) {
+			_ccs_suggestion_cache_t *cache = d->suggestion_cache;
+			DL_DELETE2(cache->lru, entry, lru_prev, lru_next);
+			DL_APPEND2(cache->lru, entry, lru_prev, lru_next);
+			memcpy(values, entry->values,
+			       num * sizeof(ccs_datum_t));
+		} else
+			CCS_VALIDATE(_ccs_features_tuner_cache_suggestion(
+				tuner, hash, num_features_values,
+				features_values, num, values));
+		for (size_t i = num; i < num_values; i++) {
+			values[i].type    = CCS_DATA_TYPE_NONE;
+			values[i].value.i = 0;
+		}
+	}
+	if (num_values_ret)
+		*num_values_ret = num;
+	return CCS_RESULT_SUCCESS;
+}
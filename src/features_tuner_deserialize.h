@@ -114,7 +114,8 @@ _ccs_deserialize_bin_random_features_tuner(
 	_ccs_object_deserialize_options_t *opts)
 {
 	_ccs_random_features_tuner_data_mock_t data = {
-		{(ccs_features_tuner_type_t)0, NULL, NULL, NULL, NULL},
+		{(ccs_features_tuner_type_t)0, NULL, NULL, NULL, NULL, 0, 0,
+		 NULL},
 		0,
 		0,
 		NULL,
@@ -192,7 +193,8 @@ _ccs_deserialize_bin_user_defined_features_tuner(
 	_ccs_object_deserialize_options_t *opts)
 {
 	_ccs_user_defined_features_tuner_data_mock_t data = {
-		{{(ccs_features_tuner_type_t)0, NULL, NULL, NULL, NULL},
+		{{(ccs_features_tuner_type_t)0, NULL, NULL, NULL, NULL, 0, 0,
+		  NULL},
 		 0,
 		 0,
 		 NULL,
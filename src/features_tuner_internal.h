@@ -4,6 +4,7 @@
 #include "configuration_space_internal.h"
 #include "objective_space_internal.h"
 #include "features_space_internal.h"
+#include "utlist.h"
 
 struct _ccs_features_tuner_data_s;
 typedef struct _ccs_features_tuner_data_s _ccs_features_tuner_data_t;
@@ -49,16 +50,95 @@ struct _ccs_features_tuner_s {
 	_ccs_features_tuner_data_t *data;
 };
 
+/* Cache of the suggestions of a features tuner, indexed by features values
+ * and holding the values of the suggested configurations. An entry is
+ * dropped when an evaluation told to the tuner becomes optimal for its
+ * features. Derived entries, suggested from the optima of nearest features
+ * for features without optima, are dropped whenever the optima of any
+ * features change. Entries are also chained from least to most recently
+ * used, and the least recently used ones are dropped to stay within
+ * capacity. */
+#define _CCS_SUGGESTION_CACHE_DEFAULT_CAPACITY 1024
+
+struct _ccs_suggestion_cache_entry_s;
+typedef struct _ccs_suggestion_cache_entry_s _ccs_suggestion_cache_entry_t;
+
+struct _ccs_suggestion_cache_entry_s {
+	_ccs_suggestion_cache_entry_t *next;
+	_ccs_suggestion_cache_entry_t *lru_prev;
+	_ccs_suggestion_cache_entry_t *lru_next;
+	ccs_hash_t                     hash;
+	ccs_features_t                 features;
+	ccs_bool_t                     derived;
+	ccs_datum_t                   *values;
+};
+
+struct _ccs_suggestion_cache_s {
+	size_t                          num_buckets;
+	size_t                          count;
+	size_t                          num_derived;
+	_ccs_suggestion_cache_entry_t **buckets;
+	_ccs_suggestion_cache_entry_t  *lru;
+};
+typedef struct _ccs_suggestion_cache_s _ccs_suggestion_cache_t;
+
 struct _ccs_features_tuner_common_data_s {
 	ccs_features_tuner_type_t type;
 	const char               *name;
 	ccs_configuration_space_t configuration_space;
 	ccs_objective_space_t     objective_space;
 	ccs_features_space_t      features_space;
+	size_t                    nearest_features;
+	size_t                    suggestion_cache_capacity;
+	_ccs_suggestion_cache_t  *suggestion_cache;
 };
 typedef struct _ccs_features_tuner_common_data_s
 	_ccs_features_tuner_common_data_t;
 
+/* Frees an entry that was unlinked from its bucket */
+static inline void
+_ccs_suggestion_cache_free_entry(
+	_ccs_suggestion_cache_t       *cache,
+	_ccs_suggestion_cache_entry_t *entry)
+{
+	DL_DELETE2(cache->lru, entry, lru_prev, lru_next);
+	if (entry->derived)
+		cache->num_derived--;
+	cache->count--;
+	ccs_release_object(entry->features);
+	free(entry);
+}
+
+static inline void
+_ccs_suggestion_cache_clear(
+	_ccs_suggestion_cache_t *cache,
+	ccs_bool_t               derived_only)
+{
+	for (size_t i = 0; i < cache->num_buckets; i++) {
+		_ccs_suggestion_cache_entry_t **link = cache->buckets + i;
+		while (*link) {
+			_ccs_suggestion_cache_entry_t *entry = *link;
+			if (derived_only && !entry->derived) {
+				link = &entry->next;
+				continue;
+			}
+			*link = entry->next;
+			_ccs_suggestion_cache_free_entry(cache, entry);
+		}
+	}
+}
+
+static inline void
+_ccs_features_tuner_common_data_fini(_ccs_features_tuner_common_data_t *data)
+{
+	if (data->suggestion_cache) {
+		_ccs_suggestion_cache_clear(data->suggestion_cache, CCS_FALSE);
+		free(data->suggestion_cache->buckets);
+		free(data->suggestion_cache);
+		data->suggestion_cache = NULL;
+	}
+}
+
 static inline ccs_result_t
 _ccs_serialize_bin_size_ccs_features_tuner_common_data(
 	_ccs_features_tuner_common_data_t *data,
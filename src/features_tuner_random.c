@@ -1,6 +1,8 @@
 #include "cconfigspace_internal.h"
 #include "features_tuner_internal.h"
 #include "features_evaluation_internal.h"
+#include "features_internal.h"
+#include "kdtree_internal.h"
 
 #include "utarray.h"
 
@@ -9,6 +11,13 @@ struct _ccs_random_features_tuner_data_s {
 	UT_array                         *history;
 	UT_array                         *optima;
 	UT_array                         *old_optima;
+	/* Index of the distinct features of history, built lazily when
+	 * nearest features are enabled. */
+	_ccs_kdtree_t                     features_index;
+	size_t                            num_indexed;
+	double                           *features_offsets;
+	double                           *features_scales;
+	double                           *features_point;
 };
 typedef struct _ccs_random_features_tuner_data_s
 	_ccs_random_features_tuner_data_t;
@@ -19,6 +28,7 @@ _ccs_features_tuner_random_del(ccs_object_t o)
 	_ccs_random_features_tuner_data_t *d =
 		(_ccs_random_features_tuner_data_t *)((ccs_features_tuner_t)o)
 			->data;
+	_ccs_features_tuner_common_data_fini(&d->common_data);
 	ccs_release_object(d->common_data.configuration_space);
 	ccs_release_object(d->common_data.objective_space);
 	ccs_release_object(d->common_data.features_space);
@@ -29,6 +39,8 @@ _ccs_features_tuner_random_del(ccs_object_t o)
 	utarray_free(d->history);
 	utarray_free(d->optima);
 	utarray_free(d->old_optima);
+	_ccs_kdtree_fini(&d->features_index);
+	free(d->features_offsets);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -154,6 +166,216 @@ _ccs_random_features_tuner_serialize(
 	return CCS_RESULT_SUCCESS;
 }
 
+static inline void
+_ccs_features_tuner_random_features_point(
+	_ccs_random_features_tuner_data_t *d,
+	ccs_features_t                     features,
+	double                            *point)
+{
+	_ccs_features_data_t *data = features->data;
+	for (size_t i = 0; i < data->num_values; i++) {
+		double v = data->values[i].type == CCS_DATA_TYPE_INT
+				   ? data->values[i].value.i
+				   : data->values[i].value.f;
+		point[i] = (v - d->features_offsets[i]) * d->features_scales[i];
+	}
+}
+
+static ccs_result_t
+_ccs_features_tuner_random_is_indexed(
+	_ccs_random_features_tuner_data_t *d,
+	ccs_features_t                     features,
+	const double                      *point,
+	ccs_bool_t                        *indexed_ret)
+{
+	void  *nearest;
+	double distance;
+	int    cmp;
+	*indexed_ret = CCS_FALSE;
+	if (_ccs_kdtree_nearest(
+		    &d->features_index, point, 1, &nearest, &distance) &&
+	    distance == 0.0) {
+		CCS_VALIDATE(ccs_features_cmp(
+			features, (ccs_features_t)nearest, &cmp));
+		*indexed_ret = cmp == 0 ? CCS_TRUE : CCS_FALSE;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_features_tuner_random_index_history(
+	_ccs_random_features_tuner_data_t *d)
+{
+	size_t num_history = utarray_len(d->history);
+	if (!d->features_offsets) {
+		size_t dimension = utarray_len(
+			d->common_data.features_space->data->parameters);
+		size_t width = dimension ? dimension : 1;
+		d->features_offsets =
+			(double *)malloc(3 * width * sizeof(double));
+		CCS_REFUTE(
+			!d->features_offsets, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		d->features_scales = d->features_offsets + width;
+		d->features_point  = d->features_scales + width;
+		_ccs_kdtree_init(&d->features_index, dimension);
+		CCS_VALIDATE(_ccs_features_space_get_numeric_bounds(
+			d->common_data.features_space, d->features_offsets,
+			d->features_scales));
+	}
+	while (d->num_indexed < num_history) {
+		ccs_features_evaluation_t *e =
+			(ccs_features_evaluation_t *)utarray_eltptr(
+				d->history, d->num_indexed);
+		ccs_features_t features;
+		ccs_bool_t     indexed;
+		CCS_VALIDATE(
+			ccs_features_evaluation_get_features(*e, &features));
+		_ccs_features_tuner_random_features_point(
+			d, features, d->features_point);
+		CCS_VALIDATE(_ccs_features_tuner_random_is_indexed(
+			d, features, d->features_point, &indexed));
+		if (!indexed)
+			CCS_VALIDATE(_ccs_kdtree_insert(
+				&d->features_index, d->features_point,
+				features));
+		d->num_indexed++;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+struct _ccs_nearest_optimum_s {
+	ccs_configuration_t configuration;
+	size_t              votes;
+	size_t              rank;
+	size_t              order;
+};
+typedef struct _ccs_nearest_optimum_s _ccs_nearest_optimum_t;
+
+static int
+_ccs_nearest_optimum_cmp(const void *a, const void *b)
+{
+	const _ccs_nearest_optimum_t *o1 = (const _ccs_nearest_optimum_t *)a;
+	const _ccs_nearest_optimum_t *o2 = (const _ccs_nearest_optimum_t *)b;
+	if (o1->votes != o2->votes)
+		return o1->votes > o2->votes ? -1 : 1;
+	if (o1->rank != o2->rank)
+		return o1->rank < o2->rank ? -1 : 1;
+	return o1->order < o2->order ? -1 : o1->order > o2->order;
+}
+
+/* Collect the optimal configurations of the nearest seen features of unseen
+ * features, ordered by decreasing number of neighbors they are optimal for,
+ * then by distance of the nearest of these neighbors. No configuration is
+ * returned for seen features, or if nearest features are disabled. The
+ * returned array must be freed. */
+static ccs_result_t
+_ccs_features_tuner_random_nearest_optima(
+	_ccs_random_features_tuner_data_t *d,
+	ccs_features_t                     features,
+	size_t                            *num_optima_ret,
+	_ccs_nearest_optimum_t           **optima_ret)
+{
+	size_t                     k          = d->common_data.nearest_features;
+	size_t                     num_optima = 0;
+	size_t                     max_optima = utarray_len(d->optima);
+	size_t                     num_neighbors;
+	_ccs_nearest_optimum_t    *optima;
+	void                     **neighbors;
+	double                    *distances;
+	ccs_features_evaluation_t *eval = NULL;
+	ccs_result_t               err  = CCS_RESULT_SUCCESS;
+	int                        cmp;
+
+	*num_optima_ret = 0;
+	*optima_ret     = NULL;
+	if (!k || !max_optima)
+		return CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(_ccs_features_tuner_random_index_history(d));
+	if (k > d->features_index.num_points)
+		k = d->features_index.num_points;
+	_ccs_features_tuner_random_features_point(
+		d, features, d->features_point);
+
+	optima = (_ccs_nearest_optimum_t *)malloc(
+		max_optima * sizeof(_ccs_nearest_optimum_t) +
+		k * (sizeof(void *) + sizeof(double)));
+	CCS_REFUTE(!optima, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	neighbors     = (void **)(optima + max_optima);
+	distances     = (double *)(neighbors + k);
+	num_neighbors = _ccs_kdtree_nearest(
+		&d->features_index, d->features_point, k, neighbors,
+		distances);
+	if (num_neighbors && distances[0] == 0.0) {
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_features_cmp(
+				features, (ccs_features_t)neighbors[0], &cmp),
+			end);
+		if (!cmp)
+			goto end;
+	}
+
+	while ((eval = (ccs_features_evaluation_t *)utarray_next(
+			d->optima, eval))) {
+		ccs_features_t      feat;
+		ccs_configuration_t configuration;
+		size_t              rank, i;
+		CCS_VALIDATE_ERR_GOTO(
+			err, ccs_features_evaluation_get_features(*eval, &feat),
+			end);
+		for (rank = 0; rank < num_neighbors; rank++) {
+			if (feat == (ccs_features_t)neighbors[rank])
+				break;
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_features_cmp(
+					feat, (ccs_features_t)neighbors[rank],
+					&cmp),
+				end);
+			if (!cmp)
+				break;
+		}
+		if (rank == num_neighbors)
+			continue;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_features_evaluation_get_configuration(
+				*eval, &configuration),
+			end);
+		for (i = 0; i < num_optima; i++) {
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_configuration_cmp(
+					configuration, optima[i].configuration,
+					&cmp),
+				end);
+			if (!cmp)
+				break;
+		}
+		if (i < num_optima) {
+			optima[i].votes++;
+			if (rank < optima[i].rank)
+				optima[i].rank = rank;
+		} else {
+			optima[num_optima].configuration = configuration;
+			optima[num_optima].votes         = 1;
+			optima[num_optima].rank          = rank;
+			optima[num_optima].order         = num_optima;
+			num_optima++;
+		}
+	}
+	qsort(optima, num_optima, sizeof(_ccs_nearest_optimum_t),
+	      &_ccs_nearest_optimum_cmp);
+end:
+	if (err || !num_optima) {
+		free(optima);
+		return err;
+	}
+	*num_optima_ret = num_optima;
+	*optima_ret     = optima;
+	return CCS_RESULT_SUCCESS;
+}
+
 static ccs_result_t
 _ccs_features_tuner_random_ask(
 	ccs_features_tuner_t tuner,
@@ -162,28 +384,131 @@ _ccs_features_tuner_random_ask(
 	ccs_configuration_t *configurations,
 	size_t              *num_configurations_ret)
 {
-	(void)features;
 	_ccs_random_features_tuner_data_t *d =
 		(_ccs_random_features_tuner_data_t *)tuner->data;
+	_ccs_nearest_optimum_t *optima;
+	size_t                  num_optima;
+	ccs_result_t            err;
 	if (!configurations) {
 		*num_configurations_ret = 1;
 		return CCS_RESULT_SUCCESS;
 	}
-	CCS_VALIDATE(ccs_configuration_space_samples(
-		d->common_data.configuration_space, num_configurations,
-		configurations));
+	CCS_VALIDATE(_ccs_features_tuner_random_nearest_optima(
+		d, features, &num_optima, &optima));
+	if (num_optima > num_configurations)
+		num_optima = num_configurations;
+	for (size_t i = 0; i < num_optima; i++) {
+		configurations[i] = optima[i].configuration;
+		ccs_retain_object(configurations[i]);
+	}
+	free(optima);
+	if (num_configurations > num_optima)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_configuration_space_samples(
+				d->common_data.configuration_space,
+				num_configurations - num_optima,
+				configurations + num_optima),
+			errc);
 	if (num_configurations_ret)
 		*num_configurations_ret = num_configurations;
 	return CCS_RESULT_SUCCESS;
+errc:
+	for (size_t i = 0; i < num_optima; i++) {
+		ccs_release_object(configurations[i]);
+		configurations[i] = NULL;
+	}
+	return err;
 }
+/* Insert an evaluation in a Pareto front stored in an array, in place:
+ * members it dominates are removed, and it is discarded if a member is
+ * equivalent or better. */
+static void
+_ccs_features_tuner_random_front_insert(
+	ccs_features_evaluation_t *front,
+	size_t                    *count,
+	ccs_features_evaluation_t  evaluation)
+{
+	size_t kept    = 0;
+	int    discard = 0;
+	for (size_t j = 0; j < *count; j++) {
+		ccs_comparison_t cmp;
+		if (!discard) {
+			if (ccs_features_evaluation_compare(
+				    evaluation, front[j], &cmp))
+				discard = 1;
+			else if (
+				cmp == CCS_COMPARISON_EQUIVALENT ||
+				cmp == CCS_COMPARISON_WORSE)
+				discard = 1;
+			else if (cmp == CCS_COMPARISON_BETTER)
+				continue;
+		}
+		front[kept++] = front[j];
+	}
+	if (!discard)
+		front[kept++] = evaluation;
+	*count = kept;
+}
+
 #undef utarray_oom
 #define utarray_oom()                                                          \
 	{                                                                      \
-		ccs_release_object(evaluations[i]);                            \
+		tmp           = d->optima;                                     \
+		d->optima     = d->old_optima;                                 \
+		d->old_optima = tmp;                                           \
 		CCS_RAISE(                                                     \
 			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
 			"Not enough memory to allocate new array");            \
 	}
+/* Merge the front of a batch of evaluations into the optima in one pass.
+ * Optima dominated by the batch are dropped, and batch evaluations that an
+ * optimum is equivalent or better than are discarded. */
+static ccs_result_t
+_ccs_features_tuner_random_merge_optima(
+	_ccs_random_features_tuner_data_t *d,
+	ccs_features_evaluation_t         *batch,
+	size_t                             num_batch)
+{
+	UT_array                  *tmp  = d->old_optima;
+	ccs_features_evaluation_t *eval = NULL;
+	d->old_optima                   = d->optima;
+	d->optima                       = tmp;
+	utarray_clear(d->optima);
+	while ((eval = (ccs_features_evaluation_t *)utarray_next(
+			d->old_optima, eval))) {
+		int dominated = 0;
+		for (size_t j = 0; j < num_batch; j++) {
+			ccs_comparison_t cmp;
+			if (!batch[j])
+				continue;
+			if (ccs_features_evaluation_compare(
+				    batch[j], *eval, &cmp))
+				batch[j] = NULL;
+			else if (
+				cmp == CCS_COMPARISON_EQUIVALENT ||
+				cmp == CCS_COMPARISON_WORSE)
+				batch[j] = NULL;
+			else if (cmp == CCS_COMPARISON_BETTER)
+				dominated = 1;
+		}
+		if (!dominated)
+			utarray_push_back(d->optima, eval);
+	}
+	for (size_t j = 0; j < num_batch; j++)
+		if (batch[j])
+			utarray_push_back(d->optima, batch + j);
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, merge,            \
+			"Not enough memory to allocate new array");            \
+	}
 static ccs_result_t
 _ccs_features_tuner_random_tell(
 	ccs_features_tuner_t       tuner,
@@ -192,65 +517,41 @@ _ccs_features_tuner_random_tell(
 {
 	_ccs_random_features_tuner_data_t *d =
 		(_ccs_random_features_tuner_data_t *)tuner->data;
-	UT_array    *history = d->history;
-	ccs_result_t err;
+	UT_array                  *history   = d->history;
+	ccs_features_evaluation_t *batch     = NULL;
+	size_t                     num_batch = 0;
+	ccs_result_t               err       = CCS_RESULT_SUCCESS;
+	if (!num_evaluations)
+		return CCS_RESULT_SUCCESS;
+	batch = (ccs_features_evaluation_t *)malloc(
+		num_evaluations * sizeof(ccs_features_evaluation_t));
+	CCS_REFUTE(!batch, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	/* the batch is reduced to its own front first, so that the optima are
+	 * only rebuilt once */
 	for (size_t i = 0; i < num_evaluations; i++) {
 		ccs_evaluation_result_t result;
-		CCS_VALIDATE(ccs_features_evaluation_get_result(
-			evaluations[i], &result));
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_features_evaluation_get_result(
+				evaluations[i], &result),
+			merge);
 		if (result == CCS_RESULT_SUCCESS) {
-			int       discard = 0;
-			UT_array *tmp;
 			ccs_retain_object(evaluations[i]);
 			utarray_push_back(history, evaluations + i);
-			tmp           = d->old_optima;
-			d->old_optima = d->optima;
-			d->optima     = tmp;
-			utarray_clear(d->optima);
-			ccs_features_evaluation_t *eval = NULL;
-#undef utarray_oom
-#define utarray_oom()                                                          \
-	{                                                                      \
-		d->optima = d->old_optima;                                     \
-		CCS_RAISE(                                                     \
-			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
-			"Not enough memory to allocate new array");            \
-	}
-			while ((eval = (ccs_features_evaluation_t *)
-					utarray_next(d->old_optima, eval))) {
-				if (!discard) {
-					ccs_comparison_t cmp;
-					err = ccs_features_evaluation_compare(
-						evaluations[i], *eval, &cmp);
-					if (err)
-						discard = 1;
-					else
-						switch (cmp) {
-						case CCS_COMPARISON_EQUIVALENT:
-						case CCS_COMPARISON_WORSE:
-							discard = 1;
-							utarray_push_back(
-								d->optima,
-								eval);
-							break;
-						case CCS_COMPARISON_BETTER:
-							break;
-						case CCS_COMPARISON_NOT_COMPARABLE:
-						default:
-							utarray_push_back(
-								d->optima,
-								eval);
-							break;
-						}
-				} else {
-					utarray_push_back(d->optima, eval);
-				}
-			}
-			if (!discard)
-				utarray_push_back(d->optima, evaluations + i);
+			_ccs_features_tuner_random_front_insert(
+				batch, &num_batch, evaluations[i]);
 		}
 	}
-	return CCS_RESULT_SUCCESS;
+merge:
+	if (num_batch) {
+		ccs_result_t merge_err =
+			_ccs_features_tuner_random_merge_optima(
+				d, batch, num_batch);
+		if (!err)
+			err = merge_err;
+	}
+	free(batch);
+	return err;
 }
 
 static ccs_result_t
@@ -491,6 +792,8 @@ ccs_create_random_features_tuner(
 	data->common_data.configuration_space = configuration_space;
 	data->common_data.objective_space     = objective_space;
 	data->common_data.features_space      = features_space;
+	data->common_data.suggestion_cache_capacity =
+		_CCS_SUGGESTION_CACHE_DEFAULT_CAPACITY;
 	utarray_new(data->history, &_evaluation_icd);
 	utarray_new(data->optima, &_evaluation_icd);
 	utarray_new(data->old_optima, &_evaluation_icd);
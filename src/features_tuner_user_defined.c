@@ -20,6 +20,7 @@ _ccs_features_tuner_user_defined_del(ccs_object_t o)
 			->data;
 	ccs_result_t err;
 	err = d->vector.del((ccs_features_tuner_t)o);
+	_ccs_features_tuner_common_data_fini(&d->common_data);
 	ccs_release_object(d->common_data.configuration_space);
 	ccs_release_object(d->common_data.objective_space);
 	ccs_release_object(d->common_data.features_space);
@@ -371,6 +372,8 @@ ccs_create_user_defined_features_tuner(
 	data->common_data.configuration_space = configuration_space;
 	data->common_data.objective_space     = objective_space;
 	data->common_data.features_space      = features_space;
+	data->common_data.suggestion_cache_capacity =
+		_CCS_SUGGESTION_CACHE_DEFAULT_CAPACITY;
 	data->vector                          = *vector;
 	data->tuner_data                      = tuner_data;
 	strcpy((char *)data->common_data.name, name);
@@ -0,0 +1,287 @@
+#ifndef _KDTREE_INTERNAL_H
+#define _KDTREE_INTERNAL_H
+
+/* k-d tree over points of a fixed dimension, each carrying an opaque payload.
+ * Points are stored in insertion order, and the first num_indexed entries of
+ * the index array form an implicit balanced tree: the node of a range
+ * [lo, hi) is its median (lo + hi) / 2, splitting along split[median], with
+ * children [lo, median) and [median + 1, hi). Points inserted since the last
+ * build are kept in the tail of the index array and scanned linearly. The
+ * tree is rebuilt once the tail outgrows max(_CCS_KDTREE_MIN_TAIL,
+ * num_indexed / 8), which keeps insertions amortized O(log n) while queries
+ * stay close to O(log n). */
+#define _CCS_KDTREE_MIN_TAIL 32
+
+struct _ccs_kdtree_s {
+	size_t   dimension;
+	size_t   num_points;
+	size_t   num_indexed;
+	size_t   capacity;
+	double  *coordinates;
+	void   **payloads;
+	size_t  *index;
+	size_t  *split;
+};
+typedef struct _ccs_kdtree_s _ccs_kdtree_t;
+
+/* Bounded list of the nearest points found so far, sorted by increasing
+ * distance. */
+struct _ccs_kdtree_neighbors_s {
+	size_t  count;
+	size_t  k;
+	double *distances;
+	void  **payloads;
+};
+typedef struct _ccs_kdtree_neighbors_s _ccs_kdtree_neighbors_t;
+
+static inline void
+_ccs_kdtree_init(_ccs_kdtree_t *tree, size_t dimension)
+{
+	memset(tree, 0, sizeof(*tree));
+	tree->dimension = dimension;
+}
+
+static inline void
+_ccs_kdtree_fini(_ccs_kdtree_t *tree)
+{
+	free(tree->coordinates);
+	free(tree->payloads);
+	free(tree->index);
+	free(tree->split);
+	memset(tree, 0, sizeof(*tree));
+}
+
+static inline double
+_ccs_kdtree_coordinate(_ccs_kdtree_t *tree, size_t id, size_t dim)
+{
+	return tree->coordinates[id * tree->dimension + dim];
+}
+
+static inline double
+_ccs_kdtree_distance(_ccs_kdtree_t *tree, size_t id, const double *point)
+{
+	const double *coords   = tree->coordinates + id * tree->dimension;
+	double        distance = 0.0;
+	for (size_t i = 0; i < tree->dimension; i++) {
+		double diff = coords[i] - point[i];
+		distance += diff * diff;
+	}
+	return distance;
+}
+
+static inline size_t
+_ccs_kdtree_widest_dimension(_ccs_kdtree_t *tree, size_t lo, size_t hi)
+{
+	size_t best       = 0;
+	double best_width = -1.0;
+	for (size_t dim = 0; dim < tree->dimension; dim++) {
+		double min = _ccs_kdtree_coordinate(tree, tree->index[lo], dim);
+		double max = min;
+		for (size_t i = lo + 1; i < hi; i++) {
+			double c = _ccs_kdtree_coordinate(
+				tree, tree->index[i], dim);
+			if (c < min)
+				min = c;
+			if (c > max)
+				max = c;
+		}
+		if (max - min > best_width) {
+			best_width = max - min;
+			best       = dim;
+		}
+	}
+	return best;
+}
+
+/* Partially sort index[lo, hi) along dim so that index[nth] holds the
+ * median, smaller coordinates before it and larger ones after it. */
+static inline void
+_ccs_kdtree_select(
+	_ccs_kdtree_t *tree,
+	size_t         lo,
+	size_t         hi,
+	size_t         nth,
+	size_t         dim)
+{
+	size_t *index = tree->index;
+	while (hi - lo > 1) {
+		size_t mid   = lo + (hi - lo) / 2;
+		double pivot = _ccs_kdtree_coordinate(tree, index[mid], dim);
+		size_t tmp   = index[mid];
+		index[mid]   = index[hi - 1];
+		index[hi - 1] = tmp;
+		size_t store  = lo;
+		for (size_t i = lo; i < hi - 1; i++) {
+			if (_ccs_kdtree_coordinate(tree, index[i], dim) <
+			    pivot) {
+				tmp          = index[i];
+				index[i]     = index[store];
+				index[store] = tmp;
+				store++;
+			}
+		}
+		tmp           = index[store];
+		index[store]  = index[hi - 1];
+		index[hi - 1] = tmp;
+		if (nth == store)
+			return;
+		else if (nth < store)
+			hi = store;
+		else
+			lo = store + 1;
+	}
+}
+
+static inline void
+_ccs_kdtree_build_range(_ccs_kdtree_t *tree, size_t lo, size_t hi)
+{
+	while (hi - lo > 1) {
+		size_t mid = lo + (hi - lo) / 2;
+		size_t dim = _ccs_kdtree_widest_dimension(tree, lo, hi);
+		_ccs_kdtree_select(tree, lo, hi, mid, dim);
+		tree->split[mid] = dim;
+		_ccs_kdtree_build_range(tree, lo, mid);
+		lo = mid + 1;
+	}
+	if (hi - lo == 1)
+		tree->split[lo] = 0;
+}
+
+static inline void
+_ccs_kdtree_build(_ccs_kdtree_t *tree)
+{
+	if (tree->dimension > 0)
+		_ccs_kdtree_build_range(tree, 0, tree->num_points);
+	tree->num_indexed = tree->num_points;
+}
+
+static inline ccs_result_t
+_ccs_kdtree_insert(_ccs_kdtree_t *tree, const double *point, void *payload)
+{
+	if (tree->num_points == tree->capacity) {
+		size_t capacity = tree->capacity ? 2 * tree->capacity : 16;
+		size_t width    = tree->dimension ? tree->dimension : 1;
+		void  *p;
+		p = realloc(
+			tree->coordinates, capacity * width * sizeof(double));
+		CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		tree->coordinates = (double *)p;
+		p = realloc(tree->payloads, capacity * sizeof(void *));
+		CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		tree->payloads = (void **)p;
+		p = realloc(tree->index, capacity * sizeof(size_t));
+		CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		tree->index = (size_t *)p;
+		p = realloc(tree->split, capacity * sizeof(size_t));
+		CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		tree->split = (size_t *)p;
+		tree->capacity = capacity;
+	}
+	size_t id = tree->num_points++;
+	memcpy(tree->coordinates + id * tree->dimension, point,
+	       tree->dimension * sizeof(double));
+	tree->payloads[id] = payload;
+	tree->index[id]    = id;
+	size_t tail        = tree->num_points - tree->num_indexed;
+	if (tail > _CCS_KDTREE_MIN_TAIL && tail > tree->num_indexed / 8)
+		_ccs_kdtree_build(tree);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline double
+_ccs_kdtree_neighbors_bound(_ccs_kdtree_neighbors_t *neighbors)
+{
+	if (neighbors->count < neighbors->k)
+		return HUGE_VAL;
+	return neighbors->distances[neighbors->count - 1];
+}
+
+static inline void
+_ccs_kdtree_neighbors_offer(
+	_ccs_kdtree_neighbors_t *neighbors,
+	double                   distance,
+	void                    *payload)
+{
+	size_t i;
+	if (distance >= _ccs_kdtree_neighbors_bound(neighbors))
+		return;
+	if (neighbors->count < neighbors->k)
+		neighbors->count++;
+	for (i = neighbors->count - 1;
+	     i > 0 && neighbors->distances[i - 1] > distance; i--) {
+		neighbors->distances[i] = neighbors->distances[i - 1];
+		neighbors->payloads[i]  = neighbors->payloads[i - 1];
+	}
+	neighbors->distances[i] = distance;
+	neighbors->payloads[i]  = payload;
+}
+
+static inline void
+_ccs_kdtree_search(
+	_ccs_kdtree_t           *tree,
+	size_t                   lo,
+	size_t                   hi,
+	const double            *point,
+	_ccs_kdtree_neighbors_t *neighbors)
+{
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+		size_t id  = tree->index[mid];
+		_ccs_kdtree_neighbors_offer(
+			neighbors, _ccs_kdtree_distance(tree, id, point),
+			tree->payloads[id]);
+		size_t dim  = tree->split[mid];
+		double diff = point[dim] -
+			      _ccs_kdtree_coordinate(tree, id, dim);
+		size_t near_lo, near_hi, far_lo, far_hi;
+		if (diff < 0.0) {
+			near_lo = lo;
+			near_hi = mid;
+			far_lo  = mid + 1;
+			far_hi  = hi;
+		} else {
+			near_lo = mid + 1;
+			near_hi = hi;
+			far_lo  = lo;
+			far_hi  = mid;
+		}
+		_ccs_kdtree_search(tree, near_lo, near_hi, point, neighbors);
+		if (diff * diff >= _ccs_kdtree_neighbors_bound(neighbors))
+			return;
+		lo = far_lo;
+		hi = far_hi;
+	}
+}
+
+/* Find the (at most) k points nearest to point. Payloads and squared
+ * distances are returned by increasing distance, and the number of points
+ * found is returned. */
+static inline size_t
+_ccs_kdtree_nearest(
+	_ccs_kdtree_t *tree,
+	const double  *point,
+	size_t         k,
+	void         **payloads,
+	double        *distances)
+{
+	_ccs_kdtree_neighbors_t neighbors = {0, k, distances, payloads};
+	if (!k)
+		return 0;
+	if (tree->dimension > 0)
+		_ccs_kdtree_search(tree, 0, tree->num_indexed, point,
+				   &neighbors);
+	else
+		for (size_t i = 0; i < tree->num_indexed; i++)
+			_ccs_kdtree_neighbors_offer(
+				&neighbors, 0.0,
+				tree->payloads[tree->index[i]]);
+	for (size_t i = tree->num_indexed; i < tree->num_points; i++) {
+		size_t id = tree->index[i];
+		_ccs_kdtree_neighbors_offer(
+			&neighbors, _ccs_kdtree_distance(tree, id, point),
+			tree->payloads[id]);
+	}
+	return neighbors.count;
+}
+
+#endif //_KDTREE_INTERNAL_H
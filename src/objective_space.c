@@ -28,6 +28,7 @@ _ccs_objective_space_del(ccs_object_t object)
 	}
 	utarray_free(objective_space->data->parameters);
 	utarray_free(objective_space->data->objectives);
+	_ccs_binding_pool_fini(&objective_space->data->pool);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -27,6 +27,7 @@ struct _ccs_objective_space_data_s {
 	UT_array                    *parameters;
 	_ccs_parameter_index_hash_t *name_hash;
 	_ccs_parameter_index_hash_t *handle_hash;
+	_ccs_binding_pool_t          pool;
 	UT_array                    *objectives;
 };
 
@@ -223,6 +223,88 @@ _ccs_parameter_numerical_get_default_distribution(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* Packing of contiguous typed samples into data. Mixing 64 bit values and 32
+ * bit tags, data stores are not vectorized. The checked variants select
+ * between the sample and ccs_inactive using masks instead of branches, as
+ * values on either side of the interval bounds are drawn in random order. */
+#define CCS_NUMERICAL_INCLUDE(v, l, li, u, ui)                                 \
+	((((v) > (l)) | ((li) & ((v) == (l)))) &                               \
+	 (((v) < (u)) | ((ui) & ((v) == (u)))))
+#define CCS_NUMERICAL_SELECT_TYPE(type, mask)                                  \
+	((ccs_data_type_t)(CCS_DATA_TYPE_INACTIVE ^                            \
+			   ((CCS_DATA_TYPE_INACTIVE ^ (type)) & (mask))))
+
+static inline void
+_ccs_parameter_numerical_convert_float(
+	size_t                        num_values,
+	const ccs_numeric_t *restrict values,
+	ccs_datum_t *restrict         results)
+{
+	for (size_t i = 0; i < num_values; i++) {
+		results[i].value.f = values[i].f;
+		results[i].type    = CCS_DATA_TYPE_FLOAT;
+		results[i].flags   = CCS_DATUM_FLAG_DEFAULT;
+	}
+}
+
+static inline void
+_ccs_parameter_numerical_convert_int(
+	size_t                        num_values,
+	const ccs_numeric_t *restrict values,
+	ccs_datum_t *restrict         results)
+{
+	for (size_t i = 0; i < num_values; i++) {
+		results[i].value.i = values[i].i;
+		results[i].type    = CCS_DATA_TYPE_INT;
+		results[i].flags   = CCS_DATUM_FLAG_DEFAULT;
+	}
+}
+
+static inline void
+_ccs_parameter_numerical_convert_checked_float(
+	size_t                        num_values,
+	const ccs_numeric_t *restrict values,
+	const ccs_interval_t         *interval,
+	ccs_datum_t *restrict         results)
+{
+	const ccs_float_t l  = interval->lower.f;
+	const ccs_float_t u  = interval->upper.f;
+	const int         li = interval->lower_included ? 1 : 0;
+	const int         ui = interval->upper_included ? 1 : 0;
+	for (size_t i = 0; i < num_values; i++) {
+		ccs_int_t mask = -(ccs_int_t)CCS_NUMERICAL_INCLUDE(
+			values[i].f, l, li, u, ui);
+		results[i].value.i = values[i].i & mask;
+		results[i].type =
+			CCS_NUMERICAL_SELECT_TYPE(CCS_DATA_TYPE_FLOAT, mask);
+		results[i].flags = CCS_DATUM_FLAG_DEFAULT;
+	}
+}
+
+static inline void
+_ccs_parameter_numerical_convert_checked_int(
+	size_t                        num_values,
+	const ccs_numeric_t *restrict values,
+	const ccs_interval_t         *interval,
+	ccs_datum_t *restrict         results)
+{
+	const ccs_int_t l  = interval->lower.i;
+	const ccs_int_t u  = interval->upper.i;
+	const int       li = interval->lower_included ? 1 : 0;
+	const int       ui = interval->upper_included ? 1 : 0;
+	for (size_t i = 0; i < num_values; i++) {
+		ccs_int_t mask = -(ccs_int_t)CCS_NUMERICAL_INCLUDE(
+			values[i].i, l, li, u, ui);
+		results[i].value.i = values[i].i & mask;
+		results[i].type =
+			CCS_NUMERICAL_SELECT_TYPE(CCS_DATA_TYPE_INT, mask);
+		results[i].flags = CCS_DATUM_FLAG_DEFAULT;
+	}
+}
+
+#undef CCS_NUMERICAL_SELECT_TYPE
+#undef CCS_NUMERICAL_INCLUDE
+
 static ccs_result_t
 _ccs_parameter_numerical_convert_samples(
 	_ccs_parameter_data_t *data,
@@ -237,27 +319,19 @@ _ccs_parameter_numerical_convert_samples(
 	ccs_interval_t    *interval = &(d->common_data.interval);
 
 	if (!oversampling) {
-		if (type == CCS_NUMERIC_TYPE_FLOAT) {
-			for (size_t i = 0; i < num_values; i++)
-				results[i] = ccs_float(values[i].f);
-		} else {
-			for (size_t i = 0; i < num_values; i++)
-				results[i] = ccs_int(values[i].i);
-		}
+		if (type == CCS_NUMERIC_TYPE_FLOAT)
+			_ccs_parameter_numerical_convert_float(
+				num_values, values, results);
+		else
+			_ccs_parameter_numerical_convert_int(
+				num_values, values, results);
 	} else {
-		if (type == CCS_NUMERIC_TYPE_FLOAT) {
-			for (size_t i = 0; i < num_values; i++)
-				if (_ccs_interval_include(interval, values[i]))
-					results[i] = ccs_float(values[i].f);
-				else
-					results[i] = ccs_inactive;
-		} else {
-			for (size_t i = 0; i < num_values; i++)
-				if (_ccs_interval_include(interval, values[i]))
-					results[i] = ccs_int(values[i].i);
-				else
-					results[i] = ccs_inactive;
-		}
+		if (type == CCS_NUMERIC_TYPE_FLOAT)
+			_ccs_parameter_numerical_convert_checked_float(
+				num_values, values, interval, results);
+		else
+			_ccs_parameter_numerical_convert_checked_int(
+				num_values, values, interval, results);
 	}
 	return CCS_RESULT_SUCCESS;
 }
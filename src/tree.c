@@ -1,65 +1,279 @@
 #include "cconfigspace_internal.h"
 #include "tree_internal.h"
 
+/* Detach the children of a node. Children that are only referenced by the
+ * node and have no destruction callbacks are chained through their parent
+ * field into *dying instead of being released, so that their own children
+ * can be detached before they are. Deep trees are thus freed without
+ * recursing. */
+static inline void
+_ccs_tree_detach_children(struct _ccs_tree_data_s *data, ccs_tree_t *dying)
+{
+	size_t num_slots = data->sparse ? data->num_children + 1 : data->arity;
+	for (size_t i = 0; i < num_slots; i++) {
+		ccs_tree_t child = data->children[i];
+		if (!child)
+			continue;
+		data->children[i]           = NULL;
+		struct _ccs_tree_data_s *cd = child->data;
+		cd->parent                  = NULL;
+		cd->index                   = 0;
+		if (child->obj.refcount == 1 && !child->obj.callbacks) {
+			cd->parent = *dying;
+			*dying     = child;
+		} else
+			ccs_release_object(child);
+	}
+	if (data->sparse)
+		data->num_children = 0;
+}
+
 static ccs_result_t
 _ccs_tree_del(ccs_object_t o)
 {
-	struct _ccs_tree_data_s *data = ((ccs_tree_t)o)->data;
-	for (size_t i = 0; i < data->arity; i++)
-		if (data->children[i]) {
-			struct _ccs_tree_data_s *cd = data->children[i]->data;
-			cd->parent                  = NULL;
-			cd->index                   = 0;
-			ccs_release_object(data->children[i]);
+	struct _ccs_tree_data_s *data  = ((ccs_tree_t)o)->data;
+	ccs_tree_t               dying = NULL;
+	_ccs_tree_detach_children(data, &dying);
+	while (dying) {
+		ccs_tree_t child    = dying;
+		dying               = child->data->parent;
+		child->data->parent = NULL;
+		_ccs_tree_detach_children(child->data, &dying);
+		ccs_release_object(child);
+	}
+	if (data->sparse) {
+		free(data->weights);
+		free(data->sums);
+		free(data->children);
+		free(data->entries);
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_tree_sparse_resize(_ccs_tree_data_t *data, size_t capacity)
+{
+	void *p;
+	p = realloc(data->weights, capacity * sizeof(ccs_float_t));
+	CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	data->weights = (ccs_float_t *)p;
+	p = realloc(data->children, capacity * sizeof(ccs_tree_t));
+	CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	data->children = (ccs_tree_t *)p;
+	p = realloc(data->entries, capacity * sizeof(_ccs_tree_sparse_entry_t));
+	CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	data->entries = (_ccs_tree_sparse_entry_t *)p;
+	p = realloc(data->sums, 2 * capacity * sizeof(ccs_float_t));
+	CCS_REFUTE(!p, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	data->sums = (ccs_float_t *)p;
+	for (size_t i = data->num_leaves; i < capacity; i++) {
+		data->weights[i]  = 0.0;
+		data->children[i] = NULL;
+	}
+	data->num_leaves = capacity;
+	_ccs_tree_sum_tree_build(data, data->num_children + 1);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_tree_sparse_insert(
+	_ccs_tree_data_t *data,
+	size_t            index,
+	ccs_tree_t        child)
+{
+	if (data->num_children + 1 == data->num_leaves)
+		CCS_VALIDATE(
+			_ccs_tree_sparse_resize(data, 2 * data->num_leaves));
+	size_t pos  = _ccs_tree_sparse_lower_bound(data, index);
+	size_t slot = data->num_children + 1;
+	memmove(data->entries + pos + 1, data->entries + pos,
+		(data->num_children - pos) * sizeof(_ccs_tree_sparse_entry_t));
+	data->entries[pos].index = index;
+	data->entries[pos].slot  = slot;
+	data->children[slot]     = child;
+	data->weights[slot]      = 1.0;
+	data->num_children++;
+	_ccs_tree_sum_tree_update(data, slot);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Undo the last insertion. */
+static inline void
+_ccs_tree_sparse_remove_last(_ccs_tree_data_t *data, size_t index)
+{
+	size_t pos  = _ccs_tree_sparse_lower_bound(data, index);
+	size_t slot = data->num_children;
+	memmove(data->entries + pos, data->entries + pos + 1,
+		(data->num_children - pos - 1) *
+			sizeof(_ccs_tree_sparse_entry_t));
+	data->children[slot] = NULL;
+	data->weights[slot]  = 0.0;
+	data->num_children--;
+	_ccs_tree_sum_tree_update(data, slot);
+}
+
+/* Trees are serialized as a table of nodes in pre-order, the root first.
+ * Each node lists the indices of its set children, stored as the gaps between
+ * consecutive indices, and the records of these children follow, by
+ * increasing index. The table is walked with an explicit stack, so the depth
+ * of the tree does not weigh on the call stack. The root user data is
+ * serialized after the table, as for any object, the user data of other nodes
+ * closes their records. */
+struct _ccs_tree_serialize_frame_s {
+	ccs_tree_t tree;
+	size_t     index;
+};
+typedef struct _ccs_tree_serialize_frame_s _ccs_tree_serialize_frame_t;
+
+static const UT_icd _ccs_tree_serialize_frame_icd = {
+	sizeof(_ccs_tree_serialize_frame_t), NULL, NULL, NULL};
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+/* Returns the next node of the pre-order walk, or NULL once it is over. */
+static inline ccs_result_t
+_ccs_tree_walk_next(UT_array *stack, ccs_tree_t *node_ret)
+{
+	_ccs_tree_serialize_frame_t *frame;
+	while ((frame = (_ccs_tree_serialize_frame_t *)utarray_back(stack))) {
+		ccs_tree_t child =
+			_ccs_tree_next_child(frame->tree->data, &frame->index);
+		if (child) {
+			_ccs_tree_serialize_frame_t f = {child, 0};
+			frame->index++;
+			utarray_push_back(stack, &f);
+			*node_ret = child;
+			return CCS_RESULT_SUCCESS;
 		}
+		utarray_pop_back(stack);
+	}
+	*node_ret = NULL;
 	return CCS_RESULT_SUCCESS;
 }
 
+static inline size_t
+_ccs_serialize_bin_size_ccs_tree_node(_ccs_tree_data_t *data)
+{
+	size_t     cum_size, index = 0, next = 0;
+	ccs_tree_t child;
+	cum_size = _ccs_serialize_bin_size_size(data->arity) +
+		   _ccs_serialize_bin_size_ccs_float(
+			   _ccs_tree_get_own_weight(data)) +
+		   _ccs_serialize_bin_size_ccs_float(data->bias) +
+		   _ccs_serialize_bin_size_ccs_datum(data->value) +
+		   _ccs_serialize_bin_size_size(_ccs_tree_count_children(data));
+	while ((child = _ccs_tree_next_child(data, &index))) {
+		cum_size += _ccs_serialize_bin_size_size(index - next);
+		next = ++index;
+	}
+	return cum_size;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_tree_node(
+	_ccs_tree_data_t *data,
+	size_t           *buffer_size,
+	char            **buffer)
+{
+	size_t     index = 0, next = 0;
+	ccs_tree_t child;
+	CCS_VALIDATE(_ccs_serialize_bin_size(data->arity, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_float(
+		_ccs_tree_get_own_weight(data), buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_serialize_bin_ccs_float(data->bias, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_serialize_bin_ccs_datum(data->value, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		_ccs_tree_count_children(data), buffer_size, buffer));
+	while ((child = _ccs_tree_next_child(data, &index))) {
+		CCS_VALIDATE(_ccs_serialize_bin_size(
+			index - next, buffer_size, buffer));
+		next = ++index;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, end,              \
+			"Out of memory to allocate array");                    \
+	}
 static inline ccs_result_t
 _ccs_serialize_bin_size_ccs_tree_data(
-	_ccs_tree_data_t                *data,
+	ccs_tree_t                       tree,
 	size_t                          *cum_size,
 	_ccs_object_serialize_options_t *opts)
 {
-	*cum_size +=
-		_ccs_serialize_bin_size_size(data->arity) +
-		_ccs_serialize_bin_size_ccs_float(data->weights[data->arity]);
-	for (size_t i = 0; i < data->arity; i++) {
-		*cum_size += _ccs_serialize_bin_size_ccs_bool(
-			data->children[i] != NULL);
-		if (data->children[i])
-			CCS_VALIDATE(data->children[i]->obj.ops->serialize_size(
-				data->children[i], CCS_SERIALIZE_FORMAT_BINARY,
-				cum_size, opts));
+	ccs_result_t                err   = CCS_RESULT_SUCCESS;
+	UT_array                   *stack = NULL;
+	_ccs_tree_serialize_frame_t frame = {tree, 0};
+	ccs_tree_t                  node;
+	*cum_size += _ccs_serialize_bin_size_ccs_tree_node(tree->data);
+	utarray_new(stack, &_ccs_tree_serialize_frame_icd);
+	utarray_push_back(stack, &frame);
+	while (1) {
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_tree_walk_next(stack, &node), end);
+		if (!node)
+			break;
+		*cum_size += _ccs_serialize_bin_size_ccs_tree_node(node->data);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_object_serialize_user_data_size(
+				node, CCS_SERIALIZE_FORMAT_BINARY, cum_size,
+				opts),
+			end);
 	}
-	*cum_size += _ccs_serialize_bin_size_ccs_float(data->bias) +
-		     _ccs_serialize_bin_size_ccs_datum(data->value);
-	return CCS_RESULT_SUCCESS;
+end:
+	if (stack)
+		utarray_free(stack);
+	return err;
 }
 
 static inline ccs_result_t
 _ccs_serialize_bin_ccs_tree_data(
-	_ccs_tree_data_t                *data,
+	ccs_tree_t                       tree,
 	size_t                          *buffer_size,
 	char                           **buffer,
 	_ccs_object_serialize_options_t *opts)
 {
-	CCS_VALIDATE(_ccs_serialize_bin_size(data->arity, buffer_size, buffer));
-	CCS_VALIDATE(_ccs_serialize_bin_ccs_float(
-		data->weights[data->arity], buffer_size, buffer));
-	for (size_t i = 0; i < data->arity; i++) {
-		CCS_VALIDATE(_ccs_serialize_bin_ccs_bool(
-			data->children[i] != NULL, buffer_size, buffer));
-		if (data->children[i])
-			CCS_VALIDATE(data->children[i]->obj.ops->serialize(
-				data->children[i], CCS_SERIALIZE_FORMAT_BINARY,
-				buffer_size, buffer, opts));
+	ccs_result_t                err   = CCS_RESULT_SUCCESS;
+	UT_array                   *stack = NULL;
+	_ccs_tree_serialize_frame_t frame = {tree, 0};
+	ccs_tree_t                  node;
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tree_node(
+		tree->data, buffer_size, buffer));
+	utarray_new(stack, &_ccs_tree_serialize_frame_icd);
+	utarray_push_back(stack, &frame);
+	while (1) {
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_tree_walk_next(stack, &node), end);
+		if (!node)
+			break;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_serialize_bin_ccs_tree_node(
+				node->data, buffer_size, buffer),
+			end);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_object_serialize_user_data(
+				node, CCS_SERIALIZE_FORMAT_BINARY, buffer_size,
+				buffer, opts),
+			end);
 	}
-	CCS_VALIDATE(
-		_ccs_serialize_bin_ccs_float(data->bias, buffer_size, buffer));
-	CCS_VALIDATE(
-		_ccs_serialize_bin_ccs_datum(data->value, buffer_size, buffer));
-	return CCS_RESULT_SUCCESS;
+end:
+	if (stack)
+		utarray_free(stack);
+	return err;
 }
 
 static inline ccs_result_t
@@ -70,8 +284,8 @@ _ccs_serialize_bin_size_ccs_tree(
 {
 	*cum_size += _ccs_serialize_bin_size_ccs_object_internal(
 		(_ccs_object_internal_t *)tree);
-	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tree_data(
-		tree->data, cum_size, opts));
+	CCS_VALIDATE(
+		_ccs_serialize_bin_size_ccs_tree_data(tree, cum_size, opts));
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -85,7 +299,7 @@ _ccs_serialize_bin_ccs_tree(
 	CCS_VALIDATE(_ccs_serialize_bin_ccs_object_internal(
 		(_ccs_object_internal_t *)tree, buffer_size, buffer));
 	CCS_VALIDATE(_ccs_serialize_bin_ccs_tree_data(
-		tree->data, buffer_size, buffer, opts));
+		tree, buffer_size, buffer, opts));
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -151,41 +365,71 @@ ccs_create_tree(size_t arity, ccs_datum_t value, ccs_tree_t *tree_ret)
 		size_strs += strlen(value.value.s) + 1;
 	}
 
+	ccs_bool_t sparse       = arity >= _CCS_TREE_SPARSE_MIN_ARITY;
+	size_t     num_weights  = arity + 1;
+	size_t     num_leaves   = 0;
+	size_t     num_areas    = arity + 2;
+	size_t     num_children = arity;
+	if (sparse) {
+		num_weights  = 0;
+		num_areas    = 0;
+		num_children = 0;
+	} else if (arity >= _CCS_TREE_SUM_TREE_MIN_ARITY) {
+		num_leaves = _ccs_tree_sum_tree_num_leaves(arity);
+		num_areas  = 2 * num_leaves;
+	}
+
 	uintptr_t mem = (uintptr_t)calloc(
 		1, sizeof(struct _ccs_tree_s) + sizeof(_ccs_tree_data_t) +
-			   (arity + 1) * sizeof(ccs_float_t) +
-			   (arity + 2) * sizeof(ccs_float_t) +
-			   arity * sizeof(ccs_tree_t) + size_strs);
+			   num_weights * sizeof(ccs_float_t) +
+			   num_areas * sizeof(ccs_float_t) +
+			   num_children * sizeof(ccs_tree_t) + size_strs);
 	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	uintptr_t    mem_cur = mem;
+	ccs_result_t err;
 
-	ccs_tree_t tree = (ccs_tree_t)mem;
+	ccs_tree_t tree = (ccs_tree_t)mem_cur;
+	mem_cur += sizeof(struct _ccs_tree_s);
+	_ccs_tree_data_t *data = (_ccs_tree_data_t *)mem_cur;
+	mem_cur += sizeof(_ccs_tree_data_t);
+	data->arity  = arity;
+	data->bias   = 1.0;
+	data->parent = NULL;
+	data->sparse = sparse;
+	if (sparse) {
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_tree_sparse_resize(
+				data, _CCS_TREE_SPARSE_MIN_CAPACITY),
+			err_sparse);
+		data->weights[0] = 1.0;
+		_ccs_tree_sum_tree_update(data, 0);
+	} else {
+		data->weights = (ccs_float_t *)mem_cur;
+		mem_cur += num_weights * sizeof(ccs_float_t);
+		for (size_t j = 0; j < arity + 1; j++)
+			data->weights[j] = 1.0;
+		data->sum_weights = arity + 1;
+		if (num_leaves) {
+			data->sums       = (ccs_float_t *)mem_cur;
+			data->num_leaves = num_leaves;
+			_ccs_tree_sum_tree_build(data, arity + 1);
+		} else {
+			data->areas = (ccs_float_t *)mem_cur;
+			_ccs_distribution_roulette_normalize_areas(
+				arity + 1, data->weights,
+				1.0 / (data->sum_weights), data->areas);
+		}
+		mem_cur += num_areas * sizeof(ccs_float_t);
+		data->children = (ccs_tree_t *)mem_cur;
+		mem_cur += num_children * sizeof(ccs_tree_t);
+	}
 	_ccs_object_init(
 		&(tree->obj), CCS_OBJECT_TYPE_TREE,
 		(_ccs_object_ops_t *)&_ccs_tree_ops);
-	_ccs_tree_data_t *data =
-		(_ccs_tree_data_t *)(mem + sizeof(struct _ccs_tree_s));
-	data->arity = arity;
-	data->weights =
-		(ccs_float_t
-			 *)(mem + sizeof(struct _ccs_tree_s) + sizeof(_ccs_tree_data_t));
-	for (size_t j = 0; j < arity + 1; j++)
-		data->weights[j] = 1.0;
-	data->sum_weights = arity + 1;
-	data->areas =
-		(ccs_float_t
-			 *)(mem + sizeof(struct _ccs_tree_s) + sizeof(_ccs_tree_data_t) + (arity + 1) * sizeof(ccs_float_t));
-	_ccs_distribution_roulette_normalize_areas(
-		arity + 1, data->weights, 1.0 / (data->sum_weights),
-		data->areas);
-	data->bias   = 1.0;
-	data->parent = NULL;
-	data->children =
-		(ccs_tree_t
-			 *)(mem + sizeof(struct _ccs_tree_s) + sizeof(_ccs_tree_data_t) + (arity + 1) * sizeof(ccs_float_t) + (arity + 2) * sizeof(ccs_float_t));
 	if (value.type == CCS_DATA_TYPE_STRING) {
-		char *str_pool =
-			(char *)(mem + sizeof(struct _ccs_tree_s) + sizeof(_ccs_tree_data_t) + (arity + 1) * sizeof(ccs_float_t) + (arity + 2) * sizeof(ccs_float_t) + arity * sizeof(ccs_tree_t));
-		data->value = ccs_string(str_pool);
+		char *str_pool = (char *)mem_cur;
+		data->value    = ccs_string(str_pool);
 		strcpy(str_pool, value.value.s);
 	} else {
 		data->value       = value;
@@ -194,6 +438,13 @@ ccs_create_tree(size_t arity, ccs_datum_t value, ccs_tree_t *tree_ret)
 	tree->data = (_ccs_tree_data_t *)data;
 	*tree_ret  = tree;
 	return CCS_RESULT_SUCCESS;
+err_sparse:
+	free(data->weights);
+	free(data->sums);
+	free(data->children);
+	free(data->entries);
+	free((void *)mem);
+	return err;
 }
 
 ccs_result_t
@@ -219,24 +470,31 @@ _ccs_tree_update_weight(ccs_tree_t tree, size_t index, ccs_float_t weight)
 {
 	_ccs_tree_data_t *tree_data = tree->data;
 	CCS_REFUTE(index > tree_data->arity, CCS_RESULT_ERROR_OUT_OF_BOUNDS);
-	if (weight == tree_data->weights[index])
+	size_t slot = _ccs_tree_weight_slot(tree_data, index);
+	if (weight == tree_data->weights[slot])
 		return CCS_RESULT_SUCCESS;
 	do {
-		size_t      n             = tree_data->arity + 1;
-		ccs_float_t sum_weights   = 0.0;
-		tree_data->weights[index] = weight;
-		for (size_t i = 0; i < n; i++)
-			sum_weights += tree_data->weights[i];
-		tree_data->sum_weights = sum_weights;
-		if (sum_weights > 0)
-			_ccs_distribution_roulette_normalize_areas(
-				tree_data->arity + 1, tree_data->weights,
-				1.0 / (tree_data->sum_weights),
-				tree_data->areas);
+		tree_data->weights[slot] = weight;
+		if (tree_data->sums)
+			_ccs_tree_sum_tree_update(tree_data, slot);
+		else {
+			size_t      n           = tree_data->arity + 1;
+			ccs_float_t sum_weights = 0.0;
+			for (size_t i = 0; i < n; i++)
+				sum_weights += tree_data->weights[i];
+			tree_data->sum_weights = sum_weights;
+			if (sum_weights > 0)
+				_ccs_distribution_roulette_normalize_areas(
+					tree_data->arity + 1,
+					tree_data->weights,
+					1.0 / (tree_data->sum_weights),
+					tree_data->areas);
+		}
 		if (tree_data->parent) {
-			weight    = sum_weights * tree_data->bias;
+			weight    = tree_data->sum_weights * tree_data->bias;
 			index     = tree_data->index;
 			tree_data = tree_data->parent->data;
+			slot      = _ccs_tree_weight_slot(tree_data, index);
 		} else
 			tree_data = NULL;
 	} while (tree_data);
@@ -266,28 +524,42 @@ ccs_tree_set_child(ccs_tree_t tree, size_t index, ccs_tree_t child)
 	_ccs_tree_data_t *tree_data = tree->data;
 
 	CCS_REFUTE(index >= tree_data->arity, CCS_RESULT_ERROR_OUT_OF_BOUNDS);
-	CCS_REFUTE(tree_data->children[index], CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_REFUTE(
+		_ccs_tree_get_child(tree_data, index),
+		CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_REFUTE(
+		_ccs_tree_is_frozen(tree_data),
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
 	_ccs_tree_data_t *child_data = child->data;
 	CCS_REFUTE(
 		child_data->parent || child_data->index,
 		CCS_RESULT_ERROR_INVALID_TREE);
 	CCS_VALIDATE(ccs_retain_object(child));
 
-	child_data->parent         = tree;
-	child_data->index          = index;
-	tree_data->children[index] = child;
-
 	ccs_result_t err;
-	ccs_float_t  weight = child_data->sum_weights * child_data->bias;
+	if (tree_data->sparse)
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_tree_sparse_insert(tree_data, index, child),
+			err_retain);
+	else
+		tree_data->children[index] = child;
+	child_data->parent = tree;
+	child_data->index  = index;
+
+	ccs_float_t weight = child_data->sum_weights * child_data->bias;
 	CCS_VALIDATE_ERR_GOTO(
 		err, _ccs_tree_update_weight(tree, index, weight), err_distrib);
 	return CCS_RESULT_SUCCESS;
 err_distrib:
-	ccs_release_object(child);
-	child_data->parent         = NULL;
-	child_data->index          = 0;
-	tree_data->children[index] = NULL;
 	_ccs_tree_update_weight(tree, index, 1.0);
+	child_data->parent = NULL;
+	child_data->index  = 0;
+	if (tree_data->sparse)
+		_ccs_tree_sparse_remove_last(tree_data, index);
+	else
+		tree_data->children[index] = NULL;
+err_retain:
+	ccs_release_object(child);
 	return err;
 }
 
@@ -298,7 +570,7 @@ ccs_tree_get_child(ccs_tree_t tree, size_t index, ccs_tree_t *child_ret)
 	CCS_CHECK_PTR(child_ret);
 	_ccs_tree_data_t *tree_data = tree->data;
 	CCS_REFUTE(index >= tree_data->arity, CCS_RESULT_ERROR_OUT_OF_BOUNDS);
-	*child_ret = tree_data->children[index];
+	*child_ret = _ccs_tree_get_child(tree_data, index);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -318,10 +590,18 @@ ccs_tree_get_children(
 	if (children) {
 		CCS_REFUTE(
 			num_children < arity, CCS_RESULT_ERROR_INVALID_VALUE);
-		for (size_t i = 0; i < arity; i++)
-			children[i] = data->children[i];
-		for (size_t i = arity; i < num_children; i++)
-			children[i] = NULL;
+		if (data->sparse) {
+			for (size_t i = 0; i < num_children; i++)
+				children[i] = NULL;
+			for (size_t i = 0; i < data->num_children; i++)
+				children[data->entries[i].index] =
+					data->children[data->entries[i].slot];
+		} else {
+			for (size_t i = 0; i < arity; i++)
+				children[i] = data->children[i];
+			for (size_t i = arity; i < num_children; i++)
+				children[i] = NULL;
+		}
 	}
 	if (num_children_ret)
 		*num_children_ret = arity;
@@ -333,8 +613,7 @@ ccs_tree_get_weight(ccs_tree_t tree, ccs_float_t *weight_ret)
 {
 	CCS_CHECK_OBJ(tree, CCS_OBJECT_TYPE_TREE);
 	CCS_CHECK_PTR(weight_ret);
-	_ccs_tree_data_t *tree_data = tree->data;
-	*weight_ret                 = tree_data->weights[tree_data->arity];
+	*weight_ret = _ccs_tree_get_own_weight(tree->data);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -343,9 +622,12 @@ ccs_tree_set_weight(ccs_tree_t tree, ccs_float_t weight)
 {
 	CCS_CHECK_OBJ(tree, CCS_OBJECT_TYPE_TREE);
 	CCS_REFUTE(weight < 0.0, CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_REFUTE(
+		_ccs_tree_is_frozen(tree->data),
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
 	_ccs_tree_data_t *tree_data  = tree->data;
 	size_t            index      = tree_data->arity;
-	ccs_float_t       old_weight = tree_data->weights[index];
+	ccs_float_t       old_weight = _ccs_tree_get_own_weight(tree_data);
 	ccs_result_t      err        = CCS_RESULT_SUCCESS;
 	CCS_VALIDATE_ERR_GOTO(
 		err, _ccs_tree_update_weight(tree, index, weight), err_distrib);
@@ -369,6 +651,9 @@ ccs_tree_set_bias(ccs_tree_t tree, ccs_float_t bias)
 {
 	CCS_CHECK_OBJ(tree, CCS_OBJECT_TYPE_TREE);
 	CCS_REFUTE(bias < 0.0, CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_REFUTE(
+		_ccs_tree_is_frozen(tree->data),
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
 	_ccs_tree_data_t *tree_data = tree->data;
 	ccs_float_t       old_bias  = tree_data->bias;
 	ccs_result_t      err       = CCS_RESULT_SUCCESS;
@@ -473,7 +758,7 @@ ccs_tree_position_is_valid(
 			*is_valid_ret = CCS_FALSE;
 			return CCS_RESULT_SUCCESS;
 		}
-		tree = tree->data->children[position[i]];
+		tree = _ccs_tree_get_child(tree->data, position[i]);
 	}
 	*is_valid_ret = CCS_TRUE;
 	return CCS_RESULT_SUCCESS;
@@ -8,6 +8,8 @@ _ccs_tree_configuration_del(ccs_object_t object)
 	ccs_tree_configuration_t tree_configuration =
 		(ccs_tree_configuration_t)object;
 	ccs_release_object(tree_configuration->data->tree_space);
+	if (tree_configuration->data->values)
+		free(tree_configuration->data->values);
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -194,13 +196,19 @@ ccs_tree_configuration_get_values(
 	size_t                  *num_values_ret)
 {
 	CCS_CHECK_OBJ(configuration, CCS_OBJECT_TYPE_TREE_CONFIGURATION);
+	CCS_CHECK_ARY(num_values, values);
 	CCS_REFUTE(!values && !num_values_ret, CCS_RESULT_ERROR_INVALID_VALUE);
-	size_t num = configuration->data->position_size + 1;
-	if (values)
-		CCS_VALIDATE(ccs_tree_space_get_values_at_position(
-			configuration->data->tree_space,
-			configuration->data->position_size,
-			configuration->data->position, num_values, values));
+	_ccs_tree_configuration_data_t *data = configuration->data;
+	size_t                          num  = data->position_size + 1;
+	if (values) {
+		CCS_REFUTE(num_values < num, CCS_RESULT_ERROR_INVALID_VALUE);
+		if (!data->values)
+			CCS_VALIDATE(
+				_ccs_tree_configuration_resolve_values(data));
+		memcpy(values, data->values, num * sizeof(ccs_datum_t));
+		for (size_t i = num; i < num_values; i++)
+			values[i] = ccs_none;
+	}
 	if (num_values_ret)
 		*num_values_ret = num;
 	return CCS_RESULT_SUCCESS;
@@ -212,10 +220,16 @@ ccs_tree_configuration_get_node(
 	ccs_tree_t              *tree_ret)
 {
 	CCS_CHECK_OBJ(configuration, CCS_OBJECT_TYPE_TREE_CONFIGURATION);
-	CCS_VALIDATE(ccs_tree_space_get_node_at_position(
-		configuration->data->tree_space,
-		configuration->data->position_size,
-		configuration->data->position, tree_ret));
+	CCS_CHECK_PTR(tree_ret);
+	_ccs_tree_configuration_data_t *data = configuration->data;
+	if (!data->node) {
+		ccs_tree_t node;
+		CCS_VALIDATE(ccs_tree_space_get_node_at_position(
+			data->tree_space, data->position_size, data->position,
+			&node));
+		data->node = node;
+	}
+	*tree_ret = data->node;
 	return CCS_RESULT_SUCCESS;
 }
 
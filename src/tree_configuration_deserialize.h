@@ -45,7 +45,7 @@ _ccs_deserialize_bin_tree_configuration(
 	CCS_REFUTE(
 		obj.type != CCS_OBJECT_TYPE_TREE_CONFIGURATION,
 		CCS_RESULT_ERROR_INVALID_TYPE);
-	_ccs_tree_configuration_data_t data = {NULL, 0, NULL};
+	_ccs_tree_configuration_data_t data = {NULL, 0, NULL, NULL, NULL};
 	ccs_result_t                   res  = CCS_RESULT_SUCCESS;
 	CCS_VALIDATE_ERR_GOTO(
 		res,
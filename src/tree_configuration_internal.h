@@ -14,10 +14,38 @@ struct _ccs_tree_configuration_s {
 	_ccs_tree_configuration_data_t *data;
 };
 
+/* Nodes are never detached from a tree and their values never change, so the
+ * node at the position and the values along it can be cached once resolved,
+ * without invalidation: the configuration retains the tree space, which
+ * retains the tree. */
 struct _ccs_tree_configuration_data_s {
 	ccs_tree_space_t tree_space;
 	size_t           position_size;
 	size_t          *position;
+	ccs_tree_t       node;   // NULL until resolved
+	ccs_datum_t     *values; // NULL until resolved, else position_size + 1
+				 // values
 };
 
+static inline ccs_result_t
+_ccs_tree_configuration_resolve_values(_ccs_tree_configuration_data_t *data)
+{
+	ccs_result_t err;
+	size_t       num = data->position_size + 1;
+	ccs_datum_t *values =
+		(ccs_datum_t *)malloc(num * sizeof(ccs_datum_t));
+	CCS_REFUTE(!values, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_tree_space_get_values_at_position(
+			data->tree_space, data->position_size, data->position,
+			num, values),
+		err_values);
+	data->values = values;
+	return CCS_RESULT_SUCCESS;
+err_values:
+	free(values);
+	return err;
+}
+
 #endif //_TREE_CONFIGURATION_INTERNAL_H
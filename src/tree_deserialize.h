@@ -3,6 +3,8 @@
 #include "cconfigspace_internal.h"
 #include "tree_internal.h"
 
+/* Nested encoding of the serialization API version 1, where every node is
+ * serialized as a tree object. */
 struct _ccs_tree_data_mock_s {
 	size_t      arity;
 	ccs_float_t weight;
@@ -57,6 +59,153 @@ _ccs_deserialize_bin_ccs_tree_data(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* Node table of the serialization API version 2 and later, see tree.c. */
+struct _ccs_tree_deserialize_frame_s {
+	ccs_tree_t tree;
+	size_t     offset;
+	size_t     num_children;
+	size_t     num_done;
+};
+typedef struct _ccs_tree_deserialize_frame_s _ccs_tree_deserialize_frame_t;
+
+static const UT_icd _ccs_tree_deserialize_frame_icd = {
+	sizeof(_ccs_tree_deserialize_frame_t), NULL, NULL, NULL};
+
+static const UT_icd _ccs_tree_deserialize_index_icd = {
+	sizeof(size_t), NULL, NULL, NULL};
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+/* Deserializes a node record and pushes the indices of its children. */
+static inline ccs_result_t
+_ccs_deserialize_bin_ccs_tree_node(
+	_ccs_tree_deserialize_frame_t *frame,
+	UT_array                      *indices,
+	size_t                        *buffer_size,
+	const char                   **buffer)
+{
+	size_t      arity, num_children, index = 0, gap;
+	ccs_float_t weight, bias;
+	ccs_datum_t value;
+	ccs_tree_t  tree;
+	ccs_result_t err;
+	CCS_VALIDATE(_ccs_deserialize_bin_size(&arity, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_deserialize_bin_ccs_float(&weight, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_deserialize_bin_ccs_float(&bias, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_deserialize_bin_ccs_datum(&value, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_deserialize_bin_size(&num_children, buffer_size, buffer));
+	CCS_REFUTE(num_children > arity, CCS_RESULT_ERROR_INVALID_VALUE);
+	frame->offset       = utarray_len(indices);
+	frame->num_children = num_children;
+	frame->num_done     = 0;
+	for (size_t i = 0; i < num_children; i++) {
+		CCS_VALIDATE(
+			_ccs_deserialize_bin_size(&gap, buffer_size, buffer));
+		CCS_REFUTE(
+			gap >= arity - index, CCS_RESULT_ERROR_INVALID_VALUE);
+		index += gap;
+		utarray_push_back(indices, &index);
+		index++;
+	}
+	CCS_VALIDATE(ccs_create_tree(arity, value, &tree));
+	CCS_VALIDATE_ERR_GOTO(err, ccs_tree_set_weight(tree, weight), err_tree);
+	CCS_VALIDATE_ERR_GOTO(err, ccs_tree_set_bias(tree, bias), err_tree);
+	frame->tree = tree;
+	return CCS_RESULT_SUCCESS;
+err_tree:
+	ccs_release_object(tree);
+	return err;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			res, CCS_RESULT_ERROR_OUT_OF_MEMORY, end,              \
+			"Out of memory to allocate array");                    \
+	}
+/* Nodes are created in pre-order, and attached to their parent once their
+ * own subtree is complete, so that weight updates never propagate further
+ * than the parent. */
+static inline ccs_result_t
+_ccs_deserialize_bin_ccs_tree_nodes(
+	ccs_tree_t                        *tree_ret,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	ccs_result_t                   res     = CCS_RESULT_SUCCESS;
+	UT_array                      *stack   = NULL;
+	UT_array                      *indices = NULL;
+	_ccs_tree_deserialize_frame_t  frame, *parent;
+	utarray_new(stack, &_ccs_tree_deserialize_frame_icd);
+	utarray_new(indices, &_ccs_tree_deserialize_index_icd);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		_ccs_deserialize_bin_ccs_tree_node(
+			&frame, indices, buffer_size, buffer),
+		end);
+	utarray_push_back(stack, &frame);
+	while (1) {
+		parent = (_ccs_tree_deserialize_frame_t *)utarray_back(stack);
+		if (parent->num_done < parent->num_children) {
+			CCS_VALIDATE_ERR_GOTO(
+				res,
+				_ccs_deserialize_bin_ccs_tree_node(
+					&frame, indices, buffer_size, buffer),
+				end);
+			utarray_push_back(stack, &frame);
+			CCS_VALIDATE_ERR_GOTO(
+				res,
+				_ccs_object_deserialize_user_data(
+					(ccs_object_t)frame.tree,
+					CCS_SERIALIZE_FORMAT_BINARY, version,
+					buffer_size, buffer, opts),
+				end);
+			continue;
+		}
+		frame = *parent;
+		utarray_pop_back(stack);
+		utarray_resize(indices, frame.offset);
+		parent = (_ccs_tree_deserialize_frame_t *)utarray_back(stack);
+		if (!parent) {
+			*tree_ret = frame.tree;
+			break;
+		}
+		res = ccs_tree_set_child(
+			parent->tree,
+			*(size_t *)utarray_eltptr(
+				indices, parent->offset + parent->num_done),
+			frame.tree);
+		ccs_release_object(frame.tree);
+		CCS_VALIDATE_ERR_GOTO(res, res, end);
+		parent->num_done++;
+	}
+end:
+	if (stack) {
+		_ccs_tree_deserialize_frame_t *f = NULL;
+		if (res)
+			while ((f = (_ccs_tree_deserialize_frame_t *)
+					utarray_next(stack, f)))
+				ccs_release_object(f->tree);
+		utarray_free(stack);
+	}
+	if (indices)
+		utarray_free(indices);
+	return res;
+}
+#undef utarray_oom
+
 static inline ccs_result_t
 _ccs_deserialize_bin_tree(
 	ccs_tree_t                        *tree_ret,
@@ -77,6 +226,11 @@ _ccs_deserialize_bin_tree(
 	ccs_tree_t            tree;
 	_ccs_tree_data_mock_t data;
 	data.children = NULL;
+	if (version >= 2) {
+		CCS_VALIDATE(_ccs_deserialize_bin_ccs_tree_nodes(
+			&tree, version, buffer_size, buffer, opts));
+		goto handle;
+	}
 	CCS_VALIDATE_ERR_GOTO(
 		res,
 		_ccs_deserialize_bin_ccs_tree_data(
@@ -94,6 +248,7 @@ _ccs_deserialize_bin_tree(
 				res,
 				ccs_tree_set_child(tree, i, data.children[i]),
 				err_tree);
+handle:
 	if (opts && opts->handle_map)
 		CCS_VALIDATE_ERR_GOTO(
 			res,
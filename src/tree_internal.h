@@ -15,19 +15,245 @@ struct _ccs_tree_s {
 	_ccs_tree_data_t      *data;
 };
 
+/* Nodes whose arity reaches _CCS_TREE_SUM_TREE_MIN_ARITY keep their
+ * arity + 1 weights in an implicit sum-segment tree instead of a normalized
+ * roulette: sums[num_leaves + i] holds weights[i], num_leaves being the
+ * smallest power of two greater than arity, and every internal node sums[i]
+ * holds sums[2 * i] + sums[2 * i + 1]. Weight updates and draws then cost
+ * O(log arity) instead of O(arity). Parents are recomputed from their children
+ * rather than shifted by differences, so the sums do not drift and a node whose
+ * weights are all zero sums to exactly 0. */
+#define _CCS_TREE_SUM_TREE_MIN_ARITY 64
+
+/* Nodes whose arity reaches _CCS_TREE_SPARSE_MIN_ARITY only store the
+ * children that were set. weights, children and the sum tree are then
+ * indexed by slot rather than by child index: slot 0 holds the node own
+ * weight and slots 1 to num_children the children in the order they were
+ * set. entries maps child indices to slots and is sorted by index. A child
+ * that was never set always weighs 1.0, so the mass of the
+ * arity - num_children untouched children is added to sum_weights, and a draw
+ * falling into it is mapped back to an untouched index without storing
+ * anything. Setting children by increasing index is O(log num_children),
+ * setting them out of order is O(num_children). */
+#define _CCS_TREE_SPARSE_MIN_ARITY 4096
+#define _CCS_TREE_SPARSE_MIN_CAPACITY 16
+
+struct _ccs_tree_sparse_entry_s {
+	size_t index;
+	size_t slot;
+};
+typedef struct _ccs_tree_sparse_entry_s _ccs_tree_sparse_entry_t;
+
 struct _ccs_tree_data_s {
-	size_t       arity;
-	ccs_float_t *weights; // Storage for children sum_weights * children
-			      // bias and own weight at weights[arity]
-	ccs_float_t *areas; // Storage for roulette sampling size arity+2
-	ccs_tree_t  *children;
-	ccs_float_t  bias;
-	ccs_datum_t  value;
-	ccs_float_t  sum_weights;
-	ccs_tree_t   parent;
-	size_t index; // if parent == NULL index contains tree_space handle
+	size_t                    arity;
+	ccs_float_t              *weights; // Storage for children sum_weights *
+					   // children bias and own weight at
+					   // weights[arity]
+	ccs_float_t              *areas;   // Storage for roulette sampling size
+					   // arity+2
+	ccs_float_t              *sums;    // Or storage for the sum tree size
+					   // 2*num_leaves
+	size_t                    num_leaves;
+	ccs_tree_t               *children;
+	ccs_float_t               bias;
+	ccs_datum_t               value;
+	ccs_float_t               sum_weights;
+	ccs_tree_t                parent;
+	size_t                    index; // if parent == NULL index contains
+					 // tree_space handle
+	ccs_bool_t                sparse;
+	size_t                    num_children; // sparse nodes only
+	_ccs_tree_sparse_entry_t *entries;      // sparse nodes only
+	size_t                    num_freezes;  // number of frozen tree spaces
+						// over this subtree
 };
 
+/* A node is frozen if a static tree space over it or over one of its
+ * ancestors is frozen: changing its weights or children would invalidate the
+ * tables of the tree space. */
+static inline ccs_bool_t
+_ccs_tree_is_frozen(_ccs_tree_data_t *data)
+{
+	while (!data->num_freezes) {
+		if (!data->parent)
+			return CCS_FALSE;
+		data = data->parent->data;
+	}
+	return CCS_TRUE;
+}
+
+static inline size_t
+_ccs_tree_sum_tree_num_leaves(size_t arity)
+{
+	size_t num_leaves = 1;
+	while (num_leaves < arity + 1)
+		num_leaves <<= 1;
+	return num_leaves;
+}
+
+static inline void
+_ccs_tree_sum_tree_total(_ccs_tree_data_t *data)
+{
+	data->sum_weights = data->sums[1];
+	if (data->sparse)
+		data->sum_weights +=
+			(ccs_float_t)(data->arity - data->num_children);
+}
+
+static inline void
+_ccs_tree_sum_tree_build(_ccs_tree_data_t *data, size_t num_weights)
+{
+	ccs_float_t *sums       = data->sums;
+	size_t       num_leaves = data->num_leaves;
+	for (size_t i = 0; i < num_weights; i++)
+		sums[num_leaves + i] = data->weights[i];
+	for (size_t i = num_leaves + num_weights; i < 2 * num_leaves; i++)
+		sums[i] = 0.0;
+	for (size_t i = num_leaves - 1; i > 0; i--)
+		sums[i] = sums[2 * i] + sums[2 * i + 1];
+	_ccs_tree_sum_tree_total(data);
+}
+
+static inline void
+_ccs_tree_sum_tree_update(_ccs_tree_data_t *data, size_t slot)
+{
+	ccs_float_t *sums = data->sums;
+	size_t       i    = data->num_leaves + slot;
+	sums[i]           = data->weights[slot];
+	for (i >>= 1; i > 0; i >>= 1)
+		sums[i] = sums[2 * i] + sums[2 * i + 1];
+	_ccs_tree_sum_tree_total(data);
+}
+
+/* Returns the position of the first entry whose index is not lower than
+ * index. */
+static inline size_t
+_ccs_tree_sparse_lower_bound(_ccs_tree_data_t *data, size_t index)
+{
+	size_t lower = 0;
+	size_t upper = data->num_children;
+	while (lower < upper) {
+		size_t mid = lower + (upper - lower) / 2;
+		if (data->entries[mid].index < index)
+			lower = mid + 1;
+		else
+			upper = mid;
+	}
+	return lower;
+}
+
+/* Returns the slot of the child at index, or 0 if it was never set. */
+static inline size_t
+_ccs_tree_sparse_find(_ccs_tree_data_t *data, size_t index)
+{
+	size_t pos = _ccs_tree_sparse_lower_bound(data, index);
+	if (pos < data->num_children && data->entries[pos].index == index)
+		return data->entries[pos].slot;
+	return 0;
+}
+
+static inline ccs_tree_t
+_ccs_tree_get_child(_ccs_tree_data_t *data, size_t index)
+{
+	if (!data->sparse)
+		return data->children[index];
+	return data->children[_ccs_tree_sparse_find(data, index)];
+}
+
+/* Returns the set child with the smallest index not lower than *index, and
+ * stores its index in *index, or returns NULL if there is none. */
+static inline ccs_tree_t
+_ccs_tree_next_child(_ccs_tree_data_t *data, size_t *index)
+{
+	if (data->sparse) {
+		size_t pos = _ccs_tree_sparse_lower_bound(data, *index);
+		if (pos == data->num_children)
+			return NULL;
+		*index = data->entries[pos].index;
+		return data->children[data->entries[pos].slot];
+	}
+	for (size_t i = *index; i < data->arity; i++)
+		if (data->children[i]) {
+			*index = i;
+			return data->children[i];
+		}
+	return NULL;
+}
+
+static inline size_t
+_ccs_tree_count_children(_ccs_tree_data_t *data)
+{
+	size_t count = 0;
+	if (data->sparse)
+		return data->num_children;
+	for (size_t i = 0; i < data->arity; i++)
+		if (data->children[i])
+			count++;
+	return count;
+}
+
+/* index must be arity or the index of a child that was set. */
+static inline size_t
+_ccs_tree_weight_slot(_ccs_tree_data_t *data, size_t index)
+{
+	if (!data->sparse)
+		return index;
+	if (index == data->arity)
+		return 0;
+	return _ccs_tree_sparse_find(data, index);
+}
+
+static inline ccs_float_t
+_ccs_tree_get_own_weight(_ccs_tree_data_t *data)
+{
+	return data->weights[_ccs_tree_weight_slot(data, data->arity)];
+}
+
+/* target must be in [0, sum_weights). A subtree summing to 0 is never
+ * entered, so rounding in the descent cannot select a null weight. */
+static inline size_t
+_ccs_tree_sum_tree_search(_ccs_tree_data_t *data, ccs_float_t target)
+{
+	ccs_float_t *sums = data->sums;
+	size_t       i    = 1;
+	while (i < data->num_leaves) {
+		ccs_float_t left = sums[2 * i];
+		if (target < left || sums[2 * i + 1] == 0.0)
+			i = 2 * i;
+		else {
+			target -= left;
+			i = 2 * i + 1;
+		}
+	}
+	return i - data->num_leaves;
+}
+
+/* The k-th untouched index is k plus the number of children set before it.
+ * entries[j].index - j counts the untouched indices below entries[j].index, and
+ * does not decrease with j. */
+static inline size_t
+_ccs_tree_sparse_search(_ccs_tree_data_t *data, ccs_float_t target)
+{
+	size_t num_untouched = data->arity - data->num_children;
+	if (target >= data->sums[1] && num_untouched) {
+		size_t k = (size_t)(target - data->sums[1]);
+		if (k >= num_untouched)
+			k = num_untouched - 1;
+		size_t lower = 0;
+		size_t upper = data->num_children;
+		while (lower < upper) {
+			size_t mid = lower + (upper - lower) / 2;
+			if (data->entries[mid].index - mid <= k)
+				lower = mid + 1;
+			else
+				upper = mid;
+		}
+		return k + lower;
+	}
+	size_t slot = _ccs_tree_sum_tree_search(data, target);
+	return slot ? data->children[slot]->data->index : data->arity;
+}
+
 static inline ccs_result_t
 _ccs_tree_samples(
 	_ccs_tree_data_t *data,
@@ -41,10 +267,16 @@ _ccs_tree_samples(
 	gsl_rng *grng;
 	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
 	for (size_t i = 0; i < num_indices; i++) {
-		ccs_float_t rnd   = gsl_rng_uniform(grng);
-		ccs_int_t   index = _ccs_dichotomic_search(
-                        data->arity + 1, data->areas, rnd);
-		indices[i] = (size_t)index;
+		ccs_float_t rnd = gsl_rng_uniform(grng);
+		if (data->sparse)
+			indices[i] = _ccs_tree_sparse_search(
+				data, rnd * data->sum_weights);
+		else if (data->sums)
+			indices[i] = _ccs_tree_sum_tree_search(
+				data, rnd * data->sum_weights);
+		else
+			indices[i] = (size_t)_ccs_dichotomic_search(
+				data->arity + 1, data->areas, rnd);
 	}
 	return CCS_RESULT_SUCCESS;
 }
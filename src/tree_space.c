@@ -1,8 +1,10 @@
 #include "cconfigspace_internal.h"
 #include "tree_space_internal.h"
+#include "tree_space_transposition_internal.h"
 #include "tree_configuration_internal.h"
 #include "tree_internal.h"
 #include "utarray.h"
+#include <gsl/gsl_randist.h>
 
 static inline _ccs_tree_space_ops_t *
 _ccs_tree_space_get_ops(ccs_tree_space_t tree_space)
@@ -131,6 +133,50 @@ ccs_tree_space_check_configuration(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* A subtree reached by count samples, through index of its parent at depth
+ * - 1. Frozen tree spaces identify the subtree by node rather than tree. */
+struct _ccs_tree_space_sample_frame_s {
+	ccs_tree_t tree;
+	size_t     depth;
+	size_t     index;
+	size_t     count;
+	size_t     node;
+};
+typedef struct _ccs_tree_space_sample_frame_s _ccs_tree_space_sample_frame_t;
+
+static UT_icd _frame_icd = {
+	sizeof(_ccs_tree_space_sample_frame_t), NULL, NULL, NULL};
+
+static int
+_ccs_size_t_cmp(const void *a, const void *b)
+{
+	size_t va = *(const size_t *)a;
+	size_t vb = *(const size_t *)b;
+	return va < vb ? -1 : va > vb ? 1 : 0;
+}
+
+/* node is the node at position if the traversal reached it, or NULL if the
+ * position ends on a child that is not set. It seeds the node cache of the
+ * configurations. */
+static inline ccs_result_t
+_ccs_tree_space_emit_samples(
+	ccs_tree_space_t          tree_space,
+	UT_array                 *position,
+	ccs_tree_t                node,
+	size_t                    count,
+	ccs_tree_configuration_t *configurations,
+	size_t                   *num_done)
+{
+	for (size_t i = 0; i < count; i++, (*num_done)++) {
+		CCS_VALIDATE(ccs_create_tree_configuration(
+			tree_space, utarray_len(position),
+			(size_t *)utarray_front(position),
+			configurations + *num_done));
+		configurations[*num_done]->data->node = node;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
 #undef utarray_oom
 #define utarray_oom()                                                          \
 	{                                                                      \
@@ -139,50 +185,228 @@ ccs_tree_space_check_configuration(
 			"Out of memory to allocate array");                    \
 	}
 
+/* Sorts the count outcomes drawn at a node with num_children set children.
+ * When there are more draws than children, the outcomes selecting the node or
+ * a set child are counted rather than compared, and only the outcomes
+ * selecting untouched children still need to be sorted. */
+static inline void
+_ccs_tree_space_frozen_sort_draws(
+	size_t  num_children,
+	size_t  count,
+	size_t *draws,
+	size_t *counts)
+{
+	if (count <= num_children) {
+		qsort(draws, count, sizeof(size_t), &_ccs_size_t_cmp);
+		return;
+	}
+	size_t num_untouched = 0;
+	memset(counts, 0, (num_children + 1) * sizeof(size_t));
+	for (size_t i = 0; i < count; i++) {
+		if (draws[i] <= num_children)
+			counts[draws[i]]++;
+		else
+			draws[num_untouched++] = draws[i];
+	}
+	qsort(draws, num_untouched, sizeof(size_t), &_ccs_size_t_cmp);
+	memmove(draws + count - num_untouched, draws,
+		num_untouched * sizeof(size_t));
+	for (size_t slot = 0, i = 0; slot <= num_children; slot++)
+		for (size_t j = 0; j < counts[slot]; j++)
+			draws[i++] = slot;
+}
+
+/* Same traversal as _ccs_tree_space_samples, over the tables of a frozen
+ * static tree space. Draws are grouped by outcome rather than by child
+ * index, see _ccs_tree_space_frozen_draw. */
 static inline ccs_result_t
-_ccs_tree_space_samples(
+_ccs_tree_space_frozen_samples(
 	ccs_tree_space_t          tree_space,
 	size_t                    num_configurations,
 	ccs_tree_configuration_t *configurations)
 {
 	_ccs_tree_space_common_data_t *data =
 		(_ccs_tree_space_common_data_t *)(tree_space->data);
-	ccs_rng_t    rng = data->rng;
-	ccs_result_t err = CCS_RESULT_SUCCESS;
-	UT_array    *arr = NULL;
-	utarray_new(arr, &_size_t_icd);
-	for (size_t i = 0; i < num_configurations; i++) {
-		size_t     index;
-		ccs_tree_t tree = data->tree;
-		if (tree) {
+	_ccs_tree_space_frozen_t *frozen   = data->frozen;
+	ccs_result_t              err      = CCS_RESULT_SUCCESS;
+	UT_array                 *position = NULL;
+	UT_array                 *stack    = NULL;
+	size_t                   *draws    = NULL;
+	size_t                   *counts   = NULL;
+	size_t                    num_done = 0;
+	gsl_rng                  *grng;
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(data->rng, &grng));
+	utarray_new(position, &_size_t_icd);
+	utarray_new(stack, &_frame_icd);
+	draws = (size_t *)malloc(num_configurations * sizeof(size_t));
+	CCS_REFUTE_ERR_GOTO(
+		err, !draws, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_arr);
+	counts = (size_t *)malloc(
+		(frozen->max_children + 1) * sizeof(size_t));
+	CCS_REFUTE_ERR_GOTO(
+		err, !counts, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_arr);
+	_ccs_tree_space_sample_frame_t frame = {
+		NULL, 0, 0, num_configurations, 0};
+	utarray_push_back(stack, &frame);
+	while (utarray_len(stack)) {
+		frame = *(_ccs_tree_space_sample_frame_t *)utarray_back(stack);
+		utarray_pop_back(stack);
+		utarray_resize(position, frame.depth);
+		if (frame.depth)
+			*(size_t *)utarray_back(position) = frame.index;
+		size_t first = frozen->offsets[frame.node];
+		size_t num_children =
+			frozen->offsets[frame.node + 1] - first;
+		for (size_t i = 0; i < frame.count; i++) {
+			draws[i] = _ccs_tree_space_frozen_draw(
+				frozen, frame.node, gsl_rng_uniform(grng));
+			CCS_REFUTE_ERR_GOTO(
+				err, draws[i] == SIZE_MAX,
+				CCS_RESULT_ERROR_INVALID_DISTRIBUTION, err_arr);
+		}
+		_ccs_tree_space_frozen_sort_draws(
+			num_children, frame.count, draws, counts);
+		for (size_t i = 0, j; i < frame.count; i = j) {
+			size_t slot = draws[i];
+			for (j = i + 1; j < frame.count && draws[j] == slot;
+			     j++)
+				;
+			if (slot && slot <= num_children) {
+				_ccs_tree_space_sample_frame_t f = {
+					NULL, frame.depth + 1,
+					frozen->indices[first + slot - 1],
+					j - i, first + slot};
+				utarray_push_back(stack, &f);
+				continue;
+			}
+			size_t index = slot - num_children - 1;
+			if (slot)
+				utarray_push_back(position, &index);
 			CCS_VALIDATE_ERR_GOTO(
 				err,
-				_ccs_tree_samples(tree->data, rng, 1, &index),
+				_ccs_tree_space_emit_samples(
+					tree_space, position,
+					slot ? NULL : frozen->nodes[frame.node],
+					j - i, configurations, &num_done),
 				err_arr);
-			while (index != tree->data->arity) {
-				utarray_push_back(arr, &index);
-				tree = tree->data->children[index];
-				if (!tree)
-					break;
-				CCS_VALIDATE_ERR_GOTO(
-					err,
-					_ccs_tree_samples(
-						tree->data, rng, 1, &index),
-					err_arr);
-			}
+			if (slot)
+				utarray_pop_back(position);
+		}
+	}
+	gsl_ran_shuffle(
+		grng, configurations, num_configurations,
+		sizeof(ccs_tree_configuration_t));
+err_arr:
+	if (err)
+		for (size_t i = 0; i < num_done; i++) {
+			ccs_release_object(configurations[i]);
+			configurations[i] = NULL;
 		}
+	if (counts)
+		free(counts);
+	if (draws)
+		free(draws);
+	if (stack)
+		utarray_free(stack);
+	if (position)
+		utarray_free(position);
+	return err;
+}
+
+/* Samples are drawn for a whole subtree at once: the draws of all the samples
+ * reaching a node are sorted, and each child is then visited once with the
+ * number of samples that selected it. Shared prefixes are thus walked once,
+ * and the traversal only touches the part of the tree that was selected. The
+ * configurations are shuffled at the end, so their order does not depend on
+ * the traversal. */
+static inline ccs_result_t
+_ccs_tree_space_samples(
+	ccs_tree_space_t          tree_space,
+	size_t                    num_configurations,
+	ccs_tree_configuration_t *configurations)
+{
+	_ccs_tree_space_common_data_t *data =
+		(_ccs_tree_space_common_data_t *)(tree_space->data);
+	ccs_rng_t    rng      = data->rng;
+	ccs_result_t err      = CCS_RESULT_SUCCESS;
+	UT_array    *position = NULL;
+	UT_array    *stack    = NULL;
+	size_t      *draws    = NULL;
+	size_t       num_done = 0;
+	gsl_rng     *grng;
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	utarray_new(position, &_size_t_icd);
+	utarray_new(stack, &_frame_icd);
+	if (!data->tree) {
 		CCS_VALIDATE_ERR_GOTO(
 			err,
-			ccs_create_tree_configuration(
-				tree_space, utarray_len(arr),
-				(size_t *)utarray_eltptr(arr, 0),
-				configurations + i),
+			_ccs_tree_space_emit_samples(
+				tree_space, position, NULL, num_configurations,
+				configurations, &num_done),
+			err_arr);
+		goto err_arr;
+	}
+	draws = (size_t *)malloc(num_configurations * sizeof(size_t));
+	CCS_REFUTE_ERR_GOTO(
+		err, !draws, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_arr);
+	_ccs_tree_space_sample_frame_t frame = {
+		data->tree, 0, 0, num_configurations, 0};
+	utarray_push_back(stack, &frame);
+	while (utarray_len(stack)) {
+		frame = *(_ccs_tree_space_sample_frame_t *)utarray_back(stack);
+		utarray_pop_back(stack);
+		utarray_resize(position, frame.depth);
+		if (frame.depth)
+			*(size_t *)utarray_back(position) = frame.index;
+		_ccs_tree_data_t *tdata = frame.tree->data;
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_tree_samples(tdata, rng, frame.count, draws),
 			err_arr);
-		utarray_clear(arr);
+		qsort(draws, frame.count, sizeof(size_t), &_ccs_size_t_cmp);
+		for (size_t i = 0, j; i < frame.count; i = j) {
+			size_t index = draws[i];
+			for (j = i + 1; j < frame.count && draws[j] == index;
+			     j++)
+				;
+			ccs_tree_t child = NULL;
+			if (index != tdata->arity)
+				child = _ccs_tree_get_child(tdata, index);
+			if (child) {
+				_ccs_tree_space_sample_frame_t f = {
+					child, frame.depth + 1, index, j - i,
+					0};
+				utarray_push_back(stack, &f);
+				continue;
+			}
+			if (index != tdata->arity)
+				utarray_push_back(position, &index);
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_tree_space_emit_samples(
+					tree_space, position,
+					index != tdata->arity ? NULL
+							      : frame.tree,
+					j - i, configurations, &num_done),
+				err_arr);
+			if (index != tdata->arity)
+				utarray_pop_back(position);
+		}
 	}
+	gsl_ran_shuffle(
+		grng, configurations, num_configurations,
+		sizeof(ccs_tree_configuration_t));
 err_arr:
-	if (arr)
-		utarray_free(arr);
+	if (err)
+		for (size_t i = 0; i < num_done; i++) {
+			ccs_release_object(configurations[i]);
+			configurations[i] = NULL;
+		}
+	if (draws)
+		free(draws);
+	if (stack)
+		utarray_free(stack);
+	if (position)
+		utarray_free(position);
 	return err;
 }
 
@@ -193,7 +417,12 @@ ccs_tree_space_sample(
 {
 	CCS_CHECK_OBJ(tree_space, CCS_OBJECT_TYPE_TREE_SPACE);
 	CCS_CHECK_PTR(configuration_ret);
-	CCS_VALIDATE(_ccs_tree_space_samples(tree_space, 1, configuration_ret));
+	if (((_ccs_tree_space_common_data_t *)(tree_space->data))->frozen)
+		CCS_VALIDATE(_ccs_tree_space_frozen_samples(
+			tree_space, 1, configuration_ret));
+	else
+		CCS_VALIDATE(_ccs_tree_space_samples(
+			tree_space, 1, configuration_ret));
 	return CCS_RESULT_SUCCESS;
 }
 
@@ -207,7 +436,59 @@ ccs_tree_space_samples(
 	CCS_CHECK_ARY(num_configurations, configurations);
 	if (num_configurations == 0)
 		return CCS_RESULT_SUCCESS;
-	CCS_VALIDATE(_ccs_tree_space_samples(
-		tree_space, num_configurations, configurations));
+	if (((_ccs_tree_space_common_data_t *)(tree_space->data))->frozen)
+		CCS_VALIDATE(_ccs_tree_space_frozen_samples(
+			tree_space, num_configurations, configurations));
+	else
+		CCS_VALIDATE(_ccs_tree_space_samples(
+			tree_space, num_configurations, configurations));
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_tree_space_set_transposition_table(
+	ccs_tree_space_t                            tree_space,
+	ccs_tree_space_transposition_key_callback_t callback,
+	void                                       *user_data,
+	size_t                                      capacity)
+{
+	CCS_CHECK_OBJ(tree_space, CCS_OBJECT_TYPE_TREE_SPACE);
+	CCS_REFUTE(callback && !capacity, CCS_RESULT_ERROR_INVALID_VALUE);
+	_ccs_tree_space_common_data_t *d =
+		(_ccs_tree_space_common_data_t *)tree_space->data;
+	_ccs_tree_space_transpositions_t *transpositions = NULL;
+	if (callback) {
+		transpositions = (_ccs_tree_space_transpositions_t *)calloc(
+			1, sizeof(_ccs_tree_space_transpositions_t));
+		CCS_REFUTE(!transpositions, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+		transpositions->callback  = callback;
+		transpositions->user_data = user_data;
+		transpositions->capacity  = capacity;
+	}
+	if (d->transpositions)
+		_ccs_tree_space_transpositions_del(d->transpositions);
+	d->transpositions = transpositions;
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_tree_space_get_transposition(
+	ccs_tree_space_t         tree_space,
+	ccs_tree_configuration_t configuration,
+	ccs_tree_evaluation_t   *evaluation_ret)
+{
+	CCS_CHECK_OBJ(tree_space, CCS_OBJECT_TYPE_TREE_SPACE);
+	CCS_CHECK_OBJ(configuration, CCS_OBJECT_TYPE_TREE_CONFIGURATION);
+	CCS_CHECK_PTR(evaluation_ret);
+	CCS_REFUTE(
+		configuration->data->tree_space != tree_space,
+		CCS_RESULT_ERROR_INVALID_CONFIGURATION);
+	_ccs_tree_space_transposition_t *entry;
+	CCS_VALIDATE(_ccs_tree_space_transposition_lookup(
+		tree_space, configuration, &entry));
+	*evaluation_ret = NULL;
+	if (entry)
+		CCS_VALIDATE(_ccs_tree_space_transposition_create_evaluation(
+			entry, configuration, evaluation_ret));
 	return CCS_RESULT_SUCCESS;
 }
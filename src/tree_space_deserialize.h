@@ -38,7 +38,7 @@ _ccs_deserialize_bin_tree_space_static(
 {
 	ccs_result_t                  res  = CCS_RESULT_SUCCESS;
 	_ccs_tree_space_common_data_t data = {
-		CCS_TREE_SPACE_TYPE_STATIC, NULL, NULL, NULL};
+		CCS_TREE_SPACE_TYPE_STATIC, NULL, NULL, NULL, NULL, NULL};
 	CCS_VALIDATE_ERR_GOTO(
 		res,
 		_ccs_deserialize_bin_ccs_tree_space_common_data(
@@ -73,7 +73,8 @@ _ccs_deserialize_bin_tree_space_dynamic(
 	_ccs_object_deserialize_options_t *opts)
 {
 	_ccs_tree_space_dynamic_data_mock_t data = {
-		{CCS_TREE_SPACE_TYPE_DYNAMIC, NULL, NULL, NULL}, {0, NULL}};
+		{CCS_TREE_SPACE_TYPE_DYNAMIC, NULL, NULL, NULL, NULL, NULL},
+		{0, NULL}};
 	ccs_dynamic_tree_space_vector_t *vector =
 		(ccs_dynamic_tree_space_vector_t *)opts->vector;
 	ccs_result_t res = CCS_RESULT_SUCCESS;
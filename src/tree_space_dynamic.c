@@ -1,14 +1,389 @@
 #include "cconfigspace_internal.h"
 #include "tree_space_internal.h"
 #include "tree_internal.h"
+#include "tree_space_transposition_internal.h"
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+/* Prefetching: when a node is visited, its missing children are generated
+ * ahead of time by a pool of worker threads. Workers only ever call the user
+ * get_child callback; every modification of the tree (installing a child,
+ * retaining and releasing nodes) is done by the thread querying the tree
+ * space, when it drains the ready jobs at the beginning of a query. A job is
+ * queued, then running, then ready, and stays in the pending hash until it is
+ * consumed, so that a child is never requested twice. max_pending bounds the
+ * number of jobs in the hash, and thus the number of children generated but
+ * not yet installed. Without POSIX threads, prefetching cannot be enabled. */
+#ifdef HAVE_PTHREAD
+enum _ccs_tree_space_prefetch_state_e {
+	_CCS_TREE_SPACE_PREFETCH_QUEUED,
+	_CCS_TREE_SPACE_PREFETCH_RUNNING,
+	_CCS_TREE_SPACE_PREFETCH_READY
+};
+typedef enum _ccs_tree_space_prefetch_state_e _ccs_tree_space_prefetch_state_t;
+
+struct _ccs_tree_space_prefetch_key_s {
+	ccs_tree_t parent;
+	size_t     index;
+};
+typedef struct _ccs_tree_space_prefetch_key_s _ccs_tree_space_prefetch_key_t;
+
+struct _ccs_tree_space_prefetch_job_s {
+	_ccs_tree_space_prefetch_key_t        key;
+	size_t                                level;
+	_ccs_tree_space_prefetch_state_t      state;
+	ccs_result_t                          result;
+	ccs_tree_t                            child;
+	struct _ccs_tree_space_prefetch_job_s *prev;
+	struct _ccs_tree_space_prefetch_job_s *next;
+	UT_hash_handle                        hh;
+};
+typedef struct _ccs_tree_space_prefetch_job_s _ccs_tree_space_prefetch_job_t;
+
+struct _ccs_tree_space_prefetch_s {
+	ccs_tree_space_t                tree_space;
+	ccs_result_t (*get_child)(
+		ccs_tree_space_t tree_space,
+		ccs_tree_t       parent,
+		size_t           child_index,
+		ccs_tree_t      *child_ret);
+	size_t                          num_threads;
+	size_t                          depth;
+	size_t                          max_pending;
+	size_t                          num_pending;
+	int                             stop;
+	pthread_mutex_t                 lock;
+	pthread_cond_t                  work_cond;
+	pthread_cond_t                  done_cond;
+	_ccs_tree_space_prefetch_job_t *jobs;
+	_ccs_tree_space_prefetch_job_t *queue;
+	_ccs_tree_space_prefetch_job_t *ready;
+	pthread_t                      *threads;
+};
+#else
+struct _ccs_tree_space_prefetch_s {
+	size_t num_threads;
+	size_t depth;
+	size_t max_pending;
+};
+#endif
+typedef struct _ccs_tree_space_prefetch_s _ccs_tree_space_prefetch_t;
 
 struct _ccs_tree_space_dynamic_data_s {
 	_ccs_tree_space_common_data_t   common_data;
 	ccs_dynamic_tree_space_vector_t vector;
 	void                           *tree_space_data;
+	_ccs_tree_space_prefetch_t     *prefetch;
 };
 typedef struct _ccs_tree_space_dynamic_data_s _ccs_tree_space_dynamic_data_t;
 
+#ifdef HAVE_PTHREAD
+static void *
+_ccs_tree_space_prefetch_worker(void *arg)
+{
+	_ccs_tree_space_prefetch_t *prefetch =
+		(_ccs_tree_space_prefetch_t *)arg;
+	_ccs_tree_space_prefetch_job_t *job;
+	pthread_mutex_lock(&prefetch->lock);
+	while (1) {
+		while (!prefetch->stop && !prefetch->queue)
+			pthread_cond_wait(
+				&prefetch->work_cond, &prefetch->lock);
+		if (prefetch->stop)
+			break;
+		job = prefetch->queue;
+		DL_DELETE(prefetch->queue, job);
+		job->state = _CCS_TREE_SPACE_PREFETCH_RUNNING;
+		pthread_mutex_unlock(&prefetch->lock);
+
+		ccs_tree_t   child = NULL;
+		ccs_result_t res;
+		res = prefetch->get_child(
+			prefetch->tree_space, job->key.parent, job->key.index,
+			&child);
+		/* the error will be raised again, if needed, by the querying
+		 * thread */
+		if (res != CCS_RESULT_SUCCESS)
+			ccs_clear_thread_error();
+
+		pthread_mutex_lock(&prefetch->lock);
+		job->result = res;
+		job->child  = child;
+		job->state  = _CCS_TREE_SPACE_PREFETCH_READY;
+		DL_APPEND(prefetch->ready, job);
+		pthread_cond_broadcast(&prefetch->done_cond);
+	}
+	pthread_mutex_unlock(&prefetch->lock);
+	return NULL;
+}
+
+static inline void
+_ccs_tree_space_prefetch_discard(_ccs_tree_space_prefetch_job_t *job)
+{
+	if (job->state == _CCS_TREE_SPACE_PREFETCH_READY &&
+	    job->result == CCS_RESULT_SUCCESS && job->child)
+		ccs_release_object(job->child);
+	ccs_release_object(job->key.parent);
+	free(job);
+}
+
+static void
+_ccs_tree_space_prefetch_fini(_ccs_tree_space_prefetch_t *prefetch)
+{
+	_ccs_tree_space_prefetch_job_t *job, *tmp;
+	pthread_mutex_lock(&prefetch->lock);
+	prefetch->stop = 1;
+	pthread_cond_broadcast(&prefetch->work_cond);
+	pthread_mutex_unlock(&prefetch->lock);
+	for (size_t i = 0; i < prefetch->num_threads; i++)
+		pthread_join(prefetch->threads[i], NULL);
+	HASH_ITER(hh, prefetch->jobs, job, tmp)
+	{
+		HASH_DEL(prefetch->jobs, job);
+		_ccs_tree_space_prefetch_discard(job);
+	}
+	pthread_cond_destroy(&prefetch->done_cond);
+	pthread_cond_destroy(&prefetch->work_cond);
+	pthread_mutex_destroy(&prefetch->lock);
+	free(prefetch);
+}
+
+static ccs_result_t
+_ccs_tree_space_prefetch_init(
+	ccs_tree_space_t             tree_space,
+	size_t                       num_threads,
+	size_t                       depth,
+	size_t                       max_pending,
+	_ccs_tree_space_prefetch_t **prefetch_ret)
+{
+	_ccs_tree_space_dynamic_data_t *data =
+		(_ccs_tree_space_dynamic_data_t *)tree_space->data;
+	_ccs_tree_space_prefetch_t *prefetch;
+	uintptr_t                   mem = (uintptr_t)calloc(
+                1, sizeof(_ccs_tree_space_prefetch_t) +
+                           num_threads * sizeof(pthread_t));
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	prefetch              = (_ccs_tree_space_prefetch_t *)mem;
+	prefetch->tree_space  = tree_space;
+	prefetch->get_child   = data->vector.get_child;
+	prefetch->depth       = depth;
+	prefetch->max_pending = max_pending;
+	prefetch->threads =
+		(pthread_t *)(mem + sizeof(_ccs_tree_space_prefetch_t));
+	pthread_mutex_init(&prefetch->lock, NULL);
+	pthread_cond_init(&prefetch->work_cond, NULL);
+	pthread_cond_init(&prefetch->done_cond, NULL);
+	for (size_t i = 0; i < num_threads; i++) {
+		if (pthread_create(
+			    prefetch->threads + i, NULL,
+			    &_ccs_tree_space_prefetch_worker, prefetch)) {
+			_ccs_tree_space_prefetch_fini(prefetch);
+			CCS_RAISE(
+				CCS_RESULT_ERROR_SYSTEM,
+				"Could not create prefetch thread");
+		}
+		prefetch->num_threads++;
+	}
+	*prefetch_ret = prefetch;
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef uthash_nonfatal_oom
+#define uthash_nonfatal_oom(elt)                                               \
+	{                                                                      \
+		free(elt);                                                     \
+		goto end;                                                      \
+	}
+/* Queue the missing children of node that are not already pending, in index
+ * order, while the pending budget allows. Missing children all have the same
+ * weight, so the index order is as good as any. Must be called with the lock
+ * held. */
+static void
+_ccs_tree_space_prefetch_schedule(
+	_ccs_tree_space_prefetch_t *prefetch,
+	ccs_tree_t                  node,
+	size_t                      level)
+{
+	_ccs_tree_data_t *node_data = node->data;
+	size_t            queued    = 0;
+	for (size_t i = 0; i < node_data->arity &&
+			   prefetch->num_pending < prefetch->max_pending;
+	     i++) {
+		_ccs_tree_space_prefetch_key_t  key = {node, i};
+		_ccs_tree_space_prefetch_job_t *job;
+		if (_ccs_tree_get_child(node_data, i))
+			continue;
+		HASH_FIND(hh, prefetch->jobs, &key, sizeof(key), job);
+		if (job)
+			continue;
+		job = (_ccs_tree_space_prefetch_job_t *)calloc(
+			1, sizeof(_ccs_tree_space_prefetch_job_t));
+		if (!job)
+			break;
+		job->key   = key;
+		job->level = level;
+		job->state = _CCS_TREE_SPACE_PREFETCH_QUEUED;
+		HASH_ADD(hh, prefetch->jobs, key, sizeof(key), job);
+		ccs_retain_object(node);
+		DL_APPEND(prefetch->queue, job);
+		prefetch->num_pending++;
+		queued++;
+	}
+end:
+	if (queued)
+		pthread_cond_broadcast(&prefetch->work_cond);
+}
+
+static inline void
+_ccs_tree_space_prefetch_visit(
+	_ccs_tree_space_prefetch_t *prefetch,
+	ccs_tree_t                  node)
+{
+	pthread_mutex_lock(&prefetch->lock);
+	_ccs_tree_space_prefetch_schedule(prefetch, node, 1);
+	pthread_mutex_unlock(&prefetch->lock);
+}
+
+/* Install the child generated by a ready job that was removed from the
+ * pending hash, unless the slot was filled in the meantime, and schedule the
+ * children of the new node if the prefetch depth allows. */
+static ccs_result_t
+_ccs_tree_space_prefetch_install(
+	_ccs_tree_space_prefetch_t     *prefetch,
+	_ccs_tree_space_prefetch_job_t *job)
+{
+	ccs_result_t err    = CCS_RESULT_SUCCESS;
+	ccs_tree_t   parent = job->key.parent;
+	if (job->result != CCS_RESULT_SUCCESS || !job->child ||
+	    _ccs_tree_get_child(parent->data, job->key.index))
+		goto end;
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_tree_set_child(parent, job->key.index, job->child),
+		end);
+	if (job->level < prefetch->depth) {
+		pthread_mutex_lock(&prefetch->lock);
+		_ccs_tree_space_prefetch_schedule(
+			prefetch, job->child, job->level + 1);
+		pthread_mutex_unlock(&prefetch->lock);
+	}
+end:
+	_ccs_tree_space_prefetch_discard(job);
+	return err;
+}
+
+static ccs_result_t
+_ccs_tree_space_prefetch_drain(_ccs_tree_space_prefetch_t *prefetch)
+{
+	ccs_result_t                    err = CCS_RESULT_SUCCESS;
+	_ccs_tree_space_prefetch_job_t *ready, *job, *tmp;
+	pthread_mutex_lock(&prefetch->lock);
+	ready           = prefetch->ready;
+	prefetch->ready = NULL;
+	DL_FOREACH(ready, job)
+	{
+		HASH_DEL(prefetch->jobs, job);
+		prefetch->num_pending--;
+	}
+	pthread_mutex_unlock(&prefetch->lock);
+	DL_FOREACH_SAFE(ready, job, tmp)
+	{
+		if (err == CCS_RESULT_SUCCESS)
+			err = _ccs_tree_space_prefetch_install(prefetch, job);
+		else
+			_ccs_tree_space_prefetch_discard(job);
+	}
+	return err;
+}
+
+/* Resolve the pending job for the given slot, if any: a queued job is
+ * cancelled, as the querying thread is going to generate the child itself,
+ * while a running job is waited for and its child installed. */
+static ccs_result_t
+_ccs_tree_space_prefetch_take(
+	_ccs_tree_space_prefetch_t *prefetch,
+	ccs_tree_t                  parent,
+	size_t                      index)
+{
+	_ccs_tree_space_prefetch_key_t  key = {parent, index};
+	_ccs_tree_space_prefetch_job_t *job;
+	pthread_mutex_lock(&prefetch->lock);
+	HASH_FIND(hh, prefetch->jobs, &key, sizeof(key), job);
+	if (!job) {
+		pthread_mutex_unlock(&prefetch->lock);
+		return CCS_RESULT_SUCCESS;
+	}
+	if (job->state == _CCS_TREE_SPACE_PREFETCH_QUEUED)
+		DL_DELETE(prefetch->queue, job);
+	else {
+		while (job->state != _CCS_TREE_SPACE_PREFETCH_READY)
+			pthread_cond_wait(
+				&prefetch->done_cond, &prefetch->lock);
+		DL_DELETE(prefetch->ready, job);
+	}
+	HASH_DEL(prefetch->jobs, job);
+	prefetch->num_pending--;
+	pthread_mutex_unlock(&prefetch->lock);
+	if (job->state == _CCS_TREE_SPACE_PREFETCH_QUEUED)
+		_ccs_tree_space_prefetch_discard(job);
+	else
+		CCS_VALIDATE(_ccs_tree_space_prefetch_install(prefetch, job));
+	return CCS_RESULT_SUCCESS;
+}
+#else
+static inline void
+_ccs_tree_space_prefetch_fini(_ccs_tree_space_prefetch_t *prefetch)
+{
+	(void)prefetch;
+}
+
+static inline ccs_result_t
+_ccs_tree_space_prefetch_init(
+	ccs_tree_space_t             tree_space,
+	size_t                       num_threads,
+	size_t                       depth,
+	size_t                       max_pending,
+	_ccs_tree_space_prefetch_t **prefetch_ret)
+{
+	(void)tree_space;
+	(void)num_threads;
+	(void)depth;
+	(void)max_pending;
+	(void)prefetch_ret;
+	CCS_RAISE(
+		CCS_RESULT_ERROR_UNSUPPORTED_OPERATION,
+		"Prefetching requires POSIX threads");
+}
+
+static inline ccs_result_t
+_ccs_tree_space_prefetch_drain(_ccs_tree_space_prefetch_t *prefetch)
+{
+	(void)prefetch;
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline void
+_ccs_tree_space_prefetch_visit(
+	_ccs_tree_space_prefetch_t *prefetch,
+	ccs_tree_t                  node)
+{
+	(void)prefetch;
+	(void)node;
+}
+
+static inline ccs_result_t
+_ccs_tree_space_prefetch_take(
+	_ccs_tree_space_prefetch_t *prefetch,
+	ccs_tree_t                  parent,
+	size_t                      index)
+{
+	(void)prefetch;
+	(void)parent;
+	(void)index;
+	return CCS_RESULT_SUCCESS;
+}
+#endif
+
 static ccs_result_t
 _ccs_tree_space_dynamic_del(ccs_object_t o)
 {
@@ -16,7 +391,12 @@ _ccs_tree_space_dynamic_del(ccs_object_t o)
 		(struct _ccs_tree_space_dynamic_data_s *)(((ccs_tree_space_t)o)
 								  ->data);
 	ccs_result_t err;
+	if (data->prefetch)
+		_ccs_tree_space_prefetch_fini(data->prefetch);
 	err = data->vector.del((ccs_tree_space_t)o);
+	if (data->common_data.transpositions)
+		_ccs_tree_space_transpositions_del(
+			data->common_data.transpositions);
 	ccs_release_object(data->common_data.rng);
 	ccs_release_object(data->common_data.tree);
 	return err;
@@ -151,9 +531,15 @@ _ccs_tree_space_tree_get_child(
 		ccs_tree_space_t tree_space,
 		ccs_tree_t       parent,
 		size_t           child_index,
-		ccs_tree_t      *child_ret))
+		ccs_tree_t      *child_ret),
+	_ccs_tree_space_prefetch_t *prefetch)
 {
 	CCS_VALIDATE(ccs_tree_get_child(parent, index, child));
+	if (!*child && prefetch) {
+		CCS_VALIDATE(
+			_ccs_tree_space_prefetch_take(prefetch, parent, index));
+		CCS_VALIDATE(ccs_tree_get_child(parent, index, child));
+	}
 	if (!*child) {
 		CCS_VALIDATE(child_cb(tree_space, parent, index, child));
 		CCS_VALIDATE(ccs_tree_set_child(parent, index, *child));
@@ -173,12 +559,16 @@ _ccs_tree_space_dynamic_get_node_at_position(
 		(_ccs_tree_space_dynamic_data_t *)tree_space->data;
 	ccs_tree_t child  = data->common_data.tree;
 	ccs_tree_t parent = child;
+	if (data->prefetch)
+		CCS_VALIDATE(_ccs_tree_space_prefetch_drain(data->prefetch));
 	for (size_t i = 0; i < position_size; i++) {
 		CCS_VALIDATE(_ccs_tree_space_tree_get_child(
 			tree_space, parent, position[i], &child,
-			data->vector.get_child));
+			data->vector.get_child, data->prefetch));
 		parent = child;
 	}
+	if (data->prefetch)
+		_ccs_tree_space_prefetch_visit(data->prefetch, child);
 	*tree_ret = child;
 	return CCS_RESULT_SUCCESS;
 }
@@ -199,14 +589,18 @@ _ccs_tree_space_dynamic_get_values_at_position(
 		(_ccs_tree_space_dynamic_data_t *)tree_space->data;
 	ccs_tree_t parent = data->common_data.tree;
 	ccs_tree_t child  = NULL;
-	*values++         = parent->data->value;
+	if (data->prefetch)
+		CCS_VALIDATE(_ccs_tree_space_prefetch_drain(data->prefetch));
+	*values++ = parent->data->value;
 	for (size_t i = 0; i < position_size; i++) {
 		CCS_VALIDATE(_ccs_tree_space_tree_get_child(
 			tree_space, parent, position[i], &child,
-			data->vector.get_child));
+			data->vector.get_child, data->prefetch));
 		*values++ = child->data->value;
 		parent    = child;
 	}
+	if (data->prefetch)
+		_ccs_tree_space_prefetch_visit(data->prefetch, parent);
 	for (size_t i = position_size + 1; i < num_values; i++)
 		*values++ = ccs_none;
 	return CCS_RESULT_SUCCESS;
@@ -226,6 +620,8 @@ _ccs_tree_space_dynamic_check_position(
 	ccs_tree_t parent = data->common_data.tree;
 	ccs_tree_t child  = NULL;
 	*is_valid_ret     = CCS_FALSE;
+	if (data->prefetch)
+		CCS_VALIDATE(_ccs_tree_space_prefetch_drain(data->prefetch));
 	for (size_t i = 0; i < position_size; i++) {
 		if (position[i] >= parent->data->arity) {
 			*is_valid_ret = CCS_FALSE;
@@ -233,9 +629,11 @@ _ccs_tree_space_dynamic_check_position(
 		}
 		CCS_VALIDATE(_ccs_tree_space_tree_get_child(
 			tree_space, parent, position[i], &child,
-			data->vector.get_child));
+			data->vector.get_child, data->prefetch));
 		parent = child;
 	}
+	if (data->prefetch)
+		_ccs_tree_space_prefetch_visit(data->prefetch, parent);
 	*is_valid_ret = CCS_TRUE;
 	return CCS_RESULT_SUCCESS;
 }
@@ -310,3 +708,50 @@ ccs_dynamic_tree_space_get_tree_space_data(
 	*tree_space_data_ret = data->tree_space_data;
 	return CCS_RESULT_SUCCESS;
 }
+
+ccs_result_t
+ccs_dynamic_tree_space_set_prefetch(
+	ccs_tree_space_t tree_space,
+	size_t           num_threads,
+	size_t           depth,
+	size_t           max_pending)
+{
+	CCS_CHECK_TREE_SPACE(tree_space, CCS_TREE_SPACE_TYPE_DYNAMIC);
+	CCS_REFUTE(
+		num_threads && (!depth || !max_pending),
+		CCS_RESULT_ERROR_INVALID_VALUE);
+	_ccs_tree_space_dynamic_data_t *data =
+		(_ccs_tree_space_dynamic_data_t *)tree_space->data;
+	_ccs_tree_space_prefetch_t *prefetch = NULL;
+	if (num_threads)
+		CCS_VALIDATE(_ccs_tree_space_prefetch_init(
+			tree_space, num_threads, depth, max_pending,
+			&prefetch));
+	if (data->prefetch)
+		_ccs_tree_space_prefetch_fini(data->prefetch);
+	data->prefetch = prefetch;
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_dynamic_tree_space_get_prefetch(
+	ccs_tree_space_t tree_space,
+	size_t          *num_threads_ret,
+	size_t          *depth_ret,
+	size_t          *max_pending_ret)
+{
+	CCS_CHECK_TREE_SPACE(tree_space, CCS_TREE_SPACE_TYPE_DYNAMIC);
+	CCS_REFUTE(
+		!num_threads_ret && !depth_ret && !max_pending_ret,
+		CCS_RESULT_ERROR_INVALID_VALUE);
+	_ccs_tree_space_dynamic_data_t *data =
+		(_ccs_tree_space_dynamic_data_t *)tree_space->data;
+	_ccs_tree_space_prefetch_t *prefetch = data->prefetch;
+	if (num_threads_ret)
+		*num_threads_ret = prefetch ? prefetch->num_threads : 0;
+	if (depth_ret)
+		*depth_ret = prefetch ? prefetch->depth : 0;
+	if (max_pending_ret)
+		*max_pending_ret = prefetch ? prefetch->max_pending : 0;
+	return CCS_RESULT_SUCCESS;
+}
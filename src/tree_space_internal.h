@@ -44,14 +44,118 @@ struct _ccs_tree_space_s {
 	_ccs_tree_space_data_t *data;
 };
 
+/* A frozen static tree space compiles its tree into flat arrays, so that
+ * walking a position is a sequence of array lookups rather than dependent
+ * loads through scattered nodes. Nodes are numbered in breadth-first order,
+ * the root being 0. The set children of node n are the edges offsets[n] to
+ * offsets[n + 1] - 1, sorted by index, and since children are numbered in the
+ * order their edges are listed, edge e leads to node e + 1. The cumulative
+ * weights of node n are stored at areas[n + offsets[n]]: its own weight, then
+ * one entry per set child. Children that were never set each weigh 1.0, and
+ * are sampled as in sparse tree nodes. */
+struct _ccs_tree_space_frozen_s {
+	size_t       num_nodes;
+	size_t       max_children;
+	ccs_tree_t  *nodes;
+	ccs_datum_t *values;
+	size_t      *arities;
+	size_t      *offsets;
+	size_t      *indices;
+	ccs_float_t *areas;
+};
+typedef struct _ccs_tree_space_frozen_s _ccs_tree_space_frozen_t;
+
+struct _ccs_tree_space_transpositions_s;
+typedef struct _ccs_tree_space_transpositions_s
+	_ccs_tree_space_transpositions_t;
+
 struct _ccs_tree_space_common_data_s {
-	ccs_tree_space_type_t type;
-	const char           *name;
-	ccs_rng_t             rng;
-	ccs_tree_t            tree;
+	ccs_tree_space_type_t     type;
+	const char               *name;
+	ccs_rng_t                 rng;
+	ccs_tree_t                tree;
+	_ccs_tree_space_frozen_t *frozen; // static tree spaces only
+	_ccs_tree_space_transpositions_t *transpositions;
 };
 typedef struct _ccs_tree_space_common_data_s _ccs_tree_space_common_data_t;
 
+/* Returns the edge of the child at index of node, or SIZE_MAX if it is
+ * not set. */
+static inline size_t
+_ccs_tree_space_frozen_find(
+	_ccs_tree_space_frozen_t *frozen,
+	size_t                    node,
+	size_t                    index)
+{
+	size_t lower = frozen->offsets[node];
+	size_t upper = frozen->offsets[node + 1];
+	while (lower < upper) {
+		size_t mid = lower + (upper - lower) / 2;
+		if (frozen->indices[mid] < index)
+			lower = mid + 1;
+		else
+			upper = mid;
+	}
+	if (lower < frozen->offsets[node + 1] &&
+	    frozen->indices[lower] == index)
+		return lower;
+	return SIZE_MAX;
+}
+
+/* Draws an outcome of node from rnd in [0, 1). Outcomes are numbered by
+ * slot: 0 selects the node itself, 1 to num_children its set children, and
+ * num_children + 1 + i the child at index i, which was never set. Returns
+ * SIZE_MAX if the weights of the node are all 0. */
+static inline size_t
+_ccs_tree_space_frozen_draw(
+	_ccs_tree_space_frozen_t *frozen,
+	size_t                    node,
+	ccs_float_t               rnd)
+{
+	size_t             first         = frozen->offsets[node];
+	size_t             num_children  = frozen->offsets[node + 1] - first;
+	size_t             num_untouched = frozen->arities[node] - num_children;
+	const ccs_float_t *areas         = frozen->areas + node + first;
+	ccs_float_t        set_weights   = areas[num_children];
+	ccs_float_t        sum_weights   = set_weights + num_untouched;
+	if (sum_weights == 0.0)
+		return SIZE_MAX;
+	ccs_float_t target = rnd * sum_weights;
+	if (target >= set_weights && num_untouched) {
+		const size_t *indices = frozen->indices + first;
+		size_t        k       = (size_t)(target - set_weights);
+		if (k >= num_untouched)
+			k = num_untouched - 1;
+		size_t lower = 0;
+		size_t upper = num_children;
+		while (lower < upper) {
+			size_t mid = lower + (upper - lower) / 2;
+			if (indices[mid] - mid <= k)
+				lower = mid + 1;
+			else
+				upper = mid;
+		}
+		return num_children + 1 + k + lower;
+	}
+	/* First slot whose cumulative weight exceeds target, null weights
+	 * are thus never selected. Rounding can leave target at the total,
+	 * in which case the last slot with a positive weight is kept. */
+	size_t lower = 0;
+	size_t upper = num_children + 1;
+	while (lower < upper) {
+		size_t mid = lower + (upper - lower) / 2;
+		if (areas[mid] <= target)
+			lower = mid + 1;
+		else
+			upper = mid;
+	}
+	if (lower > num_children)
+		for (lower = num_children; lower > 0; lower--)
+			if (areas[lower] > areas[lower - 1])
+				break;
+	return lower;
+}
+
 static inline ccs_result_t
 _ccs_serialize_bin_size_ccs_tree_space_common_data(
 	_ccs_tree_space_common_data_t   *data,
@@ -1,5 +1,6 @@
 #include "cconfigspace_internal.h"
 #include "tree_space_internal.h"
+#include "tree_space_transposition_internal.h"
 #include "tree_internal.h"
 
 struct _ccs_tree_space_static_data_s {
@@ -7,12 +8,26 @@ struct _ccs_tree_space_static_data_s {
 };
 typedef struct _ccs_tree_space_static_data_s _ccs_tree_space_static_data_t;
 
+static inline void
+_ccs_tree_space_static_thaw(_ccs_tree_space_static_data_t *data)
+{
+	if (!data->common_data.frozen)
+		return;
+	free(data->common_data.frozen);
+	data->common_data.frozen = NULL;
+	data->common_data.tree->data->num_freezes--;
+}
+
 static ccs_result_t
 _ccs_tree_space_static_del(ccs_object_t o)
 {
 	struct _ccs_tree_space_static_data_s *data =
 		(struct _ccs_tree_space_static_data_s *)(((ccs_tree_space_t)o)
 								 ->data);
+	_ccs_tree_space_static_thaw(data);
+	if (data->common_data.transpositions)
+		_ccs_tree_space_transpositions_del(
+			data->common_data.transpositions);
 	ccs_release_object(data->common_data.rng);
 	ccs_release_object(data->common_data.tree);
 	return CCS_RESULT_SUCCESS;
@@ -117,6 +132,29 @@ _ccs_tree_space_static_serialize(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* Returns the node at position in the frozen tables, with the same errors as
+ * ccs_tree_get_node_at_position. */
+static inline ccs_result_t
+_ccs_tree_space_frozen_get_node(
+	_ccs_tree_space_frozen_t *frozen,
+	size_t                    position_size,
+	const size_t             *position,
+	size_t                   *node_ret)
+{
+	size_t node = 0;
+	for (size_t i = 0; i < position_size; i++) {
+		CCS_REFUTE(
+			position[i] >= frozen->arities[node],
+			CCS_RESULT_ERROR_OUT_OF_BOUNDS);
+		size_t edge =
+			_ccs_tree_space_frozen_find(frozen, node, position[i]);
+		CCS_REFUTE(edge == SIZE_MAX, CCS_RESULT_ERROR_INVALID_TREE);
+		node = edge + 1;
+	}
+	*node_ret = node;
+	return CCS_RESULT_SUCCESS;
+}
+
 static ccs_result_t
 _ccs_tree_space_static_get_node_at_position(
 	ccs_tree_space_t tree_space,
@@ -126,6 +164,14 @@ _ccs_tree_space_static_get_node_at_position(
 {
 	_ccs_tree_space_static_data_t *data =
 		(_ccs_tree_space_static_data_t *)tree_space->data;
+	_ccs_tree_space_frozen_t *frozen = data->common_data.frozen;
+	if (frozen) {
+		size_t node;
+		CCS_VALIDATE(_ccs_tree_space_frozen_get_node(
+			frozen, position_size, position, &node));
+		*tree_ret = frozen->nodes[node];
+		return CCS_RESULT_SUCCESS;
+	}
 	CCS_VALIDATE(ccs_tree_get_node_at_position(
 		data->common_data.tree, position_size, position, tree_ret));
 	return CCS_RESULT_SUCCESS;
@@ -141,6 +187,29 @@ _ccs_tree_space_static_get_values_at_position(
 {
 	_ccs_tree_space_static_data_t *data =
 		(_ccs_tree_space_static_data_t *)tree_space->data;
+	_ccs_tree_space_frozen_t *frozen = data->common_data.frozen;
+	if (frozen) {
+		CCS_REFUTE(
+			num_values < position_size + 1,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		size_t node = 0;
+		*values++   = frozen->values[0];
+		for (size_t i = 0; i < position_size; i++) {
+			CCS_REFUTE(
+				position[i] >= frozen->arities[node],
+				CCS_RESULT_ERROR_OUT_OF_BOUNDS);
+			size_t edge = _ccs_tree_space_frozen_find(
+				frozen, node, position[i]);
+			CCS_REFUTE(
+				edge == SIZE_MAX,
+				CCS_RESULT_ERROR_INVALID_TREE);
+			node      = edge + 1;
+			*values++ = frozen->values[node];
+		}
+		for (size_t i = position_size + 1; i < num_values; i++)
+			*values++ = ccs_none;
+		return CCS_RESULT_SUCCESS;
+	}
 	CCS_VALIDATE(ccs_tree_get_values_at_position(
 		data->common_data.tree, position_size, position, num_values,
 		values));
@@ -156,6 +225,22 @@ _ccs_tree_space_static_check_position(
 {
 	_ccs_tree_space_static_data_t *data =
 		(_ccs_tree_space_static_data_t *)tree_space->data;
+	_ccs_tree_space_frozen_t *frozen = data->common_data.frozen;
+	if (frozen) {
+		size_t node = 0;
+		for (size_t i = 0; i < position_size; i++) {
+			if (node == SIZE_MAX ||
+			    position[i] >= frozen->arities[node]) {
+				*is_valid_ret = CCS_FALSE;
+				return CCS_RESULT_SUCCESS;
+			}
+			size_t edge = _ccs_tree_space_frozen_find(
+				frozen, node, position[i]);
+			node = edge == SIZE_MAX ? SIZE_MAX : edge + 1;
+		}
+		*is_valid_ret = CCS_TRUE;
+		return CCS_RESULT_SUCCESS;
+	}
 	CCS_VALIDATE(ccs_tree_position_is_valid(
 		data->common_data.tree, position_size, position, is_valid_ret));
 	return CCS_RESULT_SUCCESS;
@@ -211,3 +296,113 @@ errmem:
 	free((void *)mem);
 	return err;
 }
+
+static const UT_icd _ccs_tree_icd = {sizeof(ccs_tree_t), NULL, NULL, NULL};
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, end,              \
+			"Out of memory to allocate array");                    \
+	}
+
+ccs_result_t
+ccs_static_tree_space_freeze(ccs_tree_space_t tree_space)
+{
+	CCS_CHECK_TREE_SPACE(tree_space, CCS_TREE_SPACE_TYPE_STATIC);
+	_ccs_tree_space_static_data_t *data =
+		(_ccs_tree_space_static_data_t *)tree_space->data;
+	if (data->common_data.frozen)
+		return CCS_RESULT_SUCCESS;
+	ccs_result_t err   = CCS_RESULT_SUCCESS;
+	UT_array    *queue = NULL;
+	ccs_tree_t   tree  = data->common_data.tree;
+	utarray_new(queue, &_ccs_tree_icd);
+	utarray_push_back(queue, &tree);
+	for (size_t n = 0; n < utarray_len(queue); n++) {
+		_ccs_tree_data_t *tdata =
+			(*(ccs_tree_t *)utarray_eltptr(queue, n))->data;
+		size_t     index = 0;
+		ccs_tree_t child;
+		while ((child = _ccs_tree_next_child(tdata, &index))) {
+			utarray_push_back(queue, &child);
+			index++;
+		}
+	}
+
+	size_t    num_nodes = utarray_len(queue);
+	uintptr_t mem       = (uintptr_t)malloc(
+                sizeof(_ccs_tree_space_frozen_t) +
+                num_nodes * (sizeof(ccs_tree_t) + sizeof(ccs_datum_t) +
+                             3 * sizeof(size_t) + 2 * sizeof(ccs_float_t)) +
+                sizeof(size_t));
+	CCS_REFUTE_ERR_GOTO(err, !mem, CCS_RESULT_ERROR_OUT_OF_MEMORY, end);
+	_ccs_tree_space_frozen_t *frozen = (_ccs_tree_space_frozen_t *)mem;
+	mem += sizeof(_ccs_tree_space_frozen_t);
+	frozen->num_nodes    = num_nodes;
+	frozen->max_children = 0;
+	frozen->nodes        = (ccs_tree_t *)mem;
+	mem += num_nodes * sizeof(ccs_tree_t);
+	frozen->values = (ccs_datum_t *)mem;
+	mem += num_nodes * sizeof(ccs_datum_t);
+	frozen->arities = (size_t *)mem;
+	mem += num_nodes * sizeof(size_t);
+	frozen->offsets = (size_t *)mem;
+	mem += (num_nodes + 1) * sizeof(size_t);
+	frozen->indices = (size_t *)mem;
+	mem += num_nodes * sizeof(size_t);
+	frozen->areas = (ccs_float_t *)mem;
+	memcpy(frozen->nodes, queue->d, num_nodes * sizeof(ccs_tree_t));
+
+	/* Children were queued by increasing index, so the edges of the nodes
+	 * are listed in the order of their destination nodes. */
+	size_t edge = 0;
+	for (size_t n = 0; n < num_nodes; n++) {
+		_ccs_tree_data_t *tdata = frozen->nodes[n]->data;
+		ccs_float_t      *areas = frozen->areas + n + edge;
+		ccs_float_t       sum   = _ccs_tree_get_own_weight(tdata);
+		size_t            index = 0;
+		frozen->values[n]       = tdata->value;
+		frozen->arities[n]      = tdata->arity;
+		frozen->offsets[n]      = edge;
+		*areas++                = sum;
+		while (_ccs_tree_next_child(tdata, &index)) {
+			sum += tdata->weights[_ccs_tree_weight_slot(
+				tdata, index)];
+			*areas++                = sum;
+			frozen->indices[edge++] = index++;
+		}
+		if (edge - frozen->offsets[n] > frozen->max_children)
+			frozen->max_children = edge - frozen->offsets[n];
+	}
+	frozen->offsets[num_nodes] = edge;
+	tree->data->num_freezes++;
+	data->common_data.frozen = frozen;
+end:
+	if (queue)
+		utarray_free(queue);
+	return err;
+}
+
+ccs_result_t
+ccs_static_tree_space_thaw(ccs_tree_space_t tree_space)
+{
+	CCS_CHECK_TREE_SPACE(tree_space, CCS_TREE_SPACE_TYPE_STATIC);
+	_ccs_tree_space_static_thaw(
+		(_ccs_tree_space_static_data_t *)tree_space->data);
+	return CCS_RESULT_SUCCESS;
+}
+
+ccs_result_t
+ccs_static_tree_space_is_frozen(
+	ccs_tree_space_t tree_space,
+	ccs_bool_t      *is_frozen_ret)
+{
+	CCS_CHECK_TREE_SPACE(tree_space, CCS_TREE_SPACE_TYPE_STATIC);
+	CCS_CHECK_PTR(is_frozen_ret);
+	_ccs_tree_space_static_data_t *data =
+		(_ccs_tree_space_static_data_t *)tree_space->data;
+	*is_frozen_ret = data->common_data.frozen ? CCS_TRUE : CCS_FALSE;
+	return CCS_RESULT_SUCCESS;
+}
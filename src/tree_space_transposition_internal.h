@@ -0,0 +1,240 @@
+#ifndef _TREE_SPACE_TRANSPOSITION_INTERNAL_H
+#define _TREE_SPACE_TRANSPOSITION_INTERNAL_H
+#ifdef HASH_NONFATAL_OOM
+#undef HASH_NONFATAL_OOM
+#endif
+#define HASH_NONFATAL_OOM 1
+#include "uthash.h"
+#include "datum_hash.h"
+#include "tree_space_internal.h"
+#include "tree_configuration_internal.h"
+#include "tree_evaluation_internal.h"
+#include "utlist.h"
+
+/* Transposition table of a tree space: the objective values of successful
+ * evaluations indexed by the user key of their configuration. Entries do not
+ * retain the evaluation, whose configuration retains the tree space, but its
+ * objective space, result and values, from which evaluations of other
+ * configurations are built. Keys are hashed on their type and payload, i.e.
+ * the characters of strings and the raw value of other types, and compared on
+ * their payload, their type being checked on lookup. Since the table is a
+ * cache, keys of different types whose hash collide only miss the table.
+ * Entries own their key: strings are copied after the values of the entry,
+ * and objects are retained. Entries are also listed in insertion order, the
+ * oldest one being evicted when the table is full. */
+struct _ccs_tree_space_transposition_s {
+	ccs_datum_t                             key;
+	ccs_objective_space_t                   objective_space;
+	ccs_evaluation_result_t                 result;
+	size_t                                  num_values;
+	ccs_datum_t                            *values;
+	struct _ccs_tree_space_transposition_s *prev;
+	struct _ccs_tree_space_transposition_s *next;
+	UT_hash_handle                          hh;
+};
+typedef struct _ccs_tree_space_transposition_s _ccs_tree_space_transposition_t;
+
+struct _ccs_tree_space_transpositions_s {
+	ccs_tree_space_transposition_key_callback_t callback;
+	void                                       *user_data;
+	size_t                                      capacity;
+	_ccs_tree_space_transposition_t            *table;
+	_ccs_tree_space_transposition_t            *entries;
+};
+
+static inline void
+_ccs_tree_space_transposition_key_bytes(
+	ccs_datum_t *key,
+	const void **bytes,
+	size_t      *size,
+	unsigned    *hashv)
+{
+	unsigned h1, h2;
+	if (key->type == CCS_DATA_TYPE_STRING) {
+		*bytes = key->value.s ? key->value.s : "";
+		*size  = strlen((const char *)*bytes);
+	} else {
+		*bytes = &key->value;
+		*size  = sizeof(key->value);
+	}
+	HASH_JEN(&(key->type), sizeof(key->type), h1);
+	HASH_JEN(*bytes, *size, h2);
+	*hashv = _hash_combine(h1, h2);
+}
+
+static inline void
+_ccs_tree_space_transposition_remove(
+	_ccs_tree_space_transpositions_t *transpositions,
+	_ccs_tree_space_transposition_t  *entry)
+{
+	HASH_DEL(transpositions->table, entry);
+	DL_DELETE(transpositions->entries, entry);
+	if (entry->key.type == CCS_DATA_TYPE_OBJECT &&
+	    !(entry->key.flags & CCS_DATUM_FLAG_ID))
+		ccs_release_object(entry->key.value.o);
+	ccs_release_object(entry->objective_space);
+	free(entry);
+}
+
+static inline void
+_ccs_tree_space_transpositions_del(
+	_ccs_tree_space_transpositions_t *transpositions)
+{
+	while (transpositions->entries)
+		_ccs_tree_space_transposition_remove(
+			transpositions, transpositions->entries);
+	free(transpositions);
+}
+
+static inline ccs_result_t
+_ccs_tree_space_transposition_key(
+	ccs_tree_space_t                  tree_space,
+	_ccs_tree_space_transpositions_t *transpositions,
+	ccs_tree_configuration_t          configuration,
+	ccs_datum_t                      *key_ret)
+{
+	_ccs_tree_configuration_data_t *data = configuration->data;
+	if (!data->values)
+		CCS_VALIDATE(_ccs_tree_configuration_resolve_values(data));
+	CCS_VALIDATE(transpositions->callback(
+		tree_space, data->position_size + 1, data->values,
+		transpositions->user_data, key_ret));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline _ccs_tree_space_transposition_t *
+_ccs_tree_space_transposition_find(
+	_ccs_tree_space_transpositions_t *transpositions,
+	ccs_datum_t                      *key)
+{
+	_ccs_tree_space_transposition_t *entry;
+	const void                      *bytes;
+	size_t                           size;
+	unsigned                         hashv;
+	_ccs_tree_space_transposition_key_bytes(key, &bytes, &size, &hashv);
+	HASH_FIND_BYHASHVALUE(
+		hh, transpositions->table, bytes, size, hashv, entry);
+	if (entry && entry->key.type != key->type)
+		return NULL;
+	return entry;
+}
+
+/* Returns the entry recorded for the key of configuration, or NULL. The
+ * entry is owned by the table. */
+static inline ccs_result_t
+_ccs_tree_space_transposition_lookup(
+	ccs_tree_space_t                  tree_space,
+	ccs_tree_configuration_t          configuration,
+	_ccs_tree_space_transposition_t **entry_ret)
+{
+	_ccs_tree_space_transpositions_t *transpositions =
+		((_ccs_tree_space_common_data_t *)tree_space->data)
+			->transpositions;
+	ccs_datum_t                      key;
+	*entry_ret = NULL;
+	if (!transpositions)
+		return CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(_ccs_tree_space_transposition_key(
+		tree_space, transpositions, configuration, &key));
+	*entry_ret = _ccs_tree_space_transposition_find(transpositions, &key);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Create an evaluation of configuration with the objective space, result and
+ * values of entry. */
+static inline ccs_result_t
+_ccs_tree_space_transposition_create_evaluation(
+	_ccs_tree_space_transposition_t *entry,
+	ccs_tree_configuration_t         configuration,
+	ccs_tree_evaluation_t           *evaluation_ret)
+{
+	CCS_VALIDATE(ccs_create_tree_evaluation(
+		entry->objective_space, configuration, entry->result,
+		entry->num_values, entry->values, evaluation_ret));
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef uthash_nonfatal_oom
+#define uthash_nonfatal_oom(elt)                                               \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_entry,        \
+			"Not enough memory to allocate hash");                 \
+	}
+
+/* Record a successful evaluation under the key of its configuration, unless
+ * the key already has an evaluation. */
+static inline ccs_result_t
+_ccs_tree_space_transposition_record(
+	ccs_tree_space_t      tree_space,
+	ccs_tree_evaluation_t evaluation)
+{
+	_ccs_tree_space_transpositions_t *transpositions =
+		((_ccs_tree_space_common_data_t *)tree_space->data)
+			->transpositions;
+	_ccs_tree_evaluation_data_t     *data = evaluation->data;
+	_ccs_tree_space_transposition_t *entry;
+	ccs_datum_t                      key;
+	const void                      *bytes;
+	size_t                           size;
+	unsigned                         hashv;
+	ccs_result_t                     err;
+	uintptr_t                        mem;
+	if (!transpositions || data->result != CCS_RESULT_SUCCESS ||
+	    data->configuration->data->tree_space != tree_space)
+		return CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(_ccs_tree_space_transposition_key(
+		tree_space, transpositions, data->configuration, &key));
+	if (_ccs_tree_space_transposition_find(transpositions, &key))
+		return CCS_RESULT_SUCCESS;
+	_ccs_tree_space_transposition_key_bytes(&key, &bytes, &size, &hashv);
+
+	if (key.type == CCS_DATA_TYPE_OBJECT &&
+	    !(key.flags & CCS_DATUM_FLAG_ID))
+		CCS_VALIDATE(ccs_retain_object(key.value.o));
+	mem = (uintptr_t)malloc(
+		sizeof(_ccs_tree_space_transposition_t) +
+		data->num_values * sizeof(ccs_datum_t) +
+		(key.type == CCS_DATA_TYPE_STRING ? size + 1 : 0));
+	CCS_REFUTE_ERR_GOTO(err, !mem, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_key);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(data->objective_space), err_mem);
+	entry                  = (_ccs_tree_space_transposition_t *)mem;
+	entry->key             = key;
+	entry->objective_space = data->objective_space;
+	entry->result          = data->result;
+	entry->num_values      = data->num_values;
+	entry->values          = (ccs_datum_t *)(entry + 1);
+	memcpy(
+		entry->values, data->values,
+		data->num_values * sizeof(ccs_datum_t));
+	if (key.type == CCS_DATA_TYPE_STRING) {
+		char *s = (char *)(entry->values + entry->num_values);
+		memcpy(s, bytes, size);
+		s[size]            = '\0';
+		entry->key.value.s = s;
+	}
+	entry->key.flags = key.type == CCS_DATA_TYPE_OBJECT
+				   ? key.flags & CCS_DATUM_FLAG_ID
+				   : CCS_DATUM_FLAG_DEFAULT;
+	_ccs_tree_space_transposition_key_bytes(
+		&entry->key, &bytes, &size, &hashv);
+	HASH_ADD_KEYPTR_BYHASHVALUE(
+		hh, transpositions->table, bytes, size, hashv, entry);
+	DL_APPEND(transpositions->entries, entry);
+	if (HASH_COUNT(transpositions->table) > transpositions->capacity)
+		_ccs_tree_space_transposition_remove(
+			transpositions, transpositions->entries);
+	return CCS_RESULT_SUCCESS;
+err_entry:
+	ccs_release_object(entry->objective_space);
+err_mem:
+	free((void *)mem);
+err_key:
+	if (key.type == CCS_DATA_TYPE_OBJECT &&
+	    !(key.flags & CCS_DATUM_FLAG_ID))
+		ccs_release_object(key.value.o);
+	return err;
+}
+
+#endif //_TREE_SPACE_TRANSPOSITION_INTERNAL_H
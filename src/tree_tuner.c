@@ -1,5 +1,10 @@
 #include "cconfigspace_internal.h"
 #include "tree_tuner_internal.h"
+#include "tree_space_transposition_internal.h"
+
+/* Number of times a suggested configuration can be replaced because its
+ * state was already evaluated, before it is kept anyway. */
+#define _CCS_TREE_TUNER_MAX_TRANSPOSITIONS 16
 
 static inline _ccs_tree_tuner_ops_t *
 ccs_tree_tuner_get_ops(ccs_tree_tuner_t tuner)
@@ -55,6 +60,49 @@ ccs_tree_tuner_get_objective_space(
 	return CCS_RESULT_SUCCESS;
 }
 
+/* Replace the configurations whose key already has an evaluation in the
+ * transposition table of the tree space. The tuner is told a copy of the
+ * recorded evaluation for the replaced configuration instead, so that it
+ * accounts for it as if it had been evaluated. On error, configurations still
+ * holds num_configurations retained configurations. */
+static ccs_result_t
+_ccs_tree_tuner_skip_transpositions(
+	ccs_tree_tuner_t          tuner,
+	size_t                    num_configurations,
+	ccs_tree_configuration_t *configurations)
+{
+	_ccs_tree_tuner_common_data_t *d =
+		(_ccs_tree_tuner_common_data_t *)tuner->data;
+	_ccs_tree_tuner_ops_t *ops = ccs_tree_tuner_get_ops(tuner);
+	for (size_t i = 0; i < num_configurations; i++) {
+		for (size_t j = 0; j < _CCS_TREE_TUNER_MAX_TRANSPOSITIONS;
+		     j++) {
+			_ccs_tree_space_transposition_t *known;
+			ccs_tree_evaluation_t            shared;
+			ccs_tree_configuration_t         replacement;
+			size_t                           count;
+			ccs_result_t                     err;
+			CCS_VALIDATE(_ccs_tree_space_transposition_lookup(
+				d->tree_space, configurations[i], &known));
+			if (!known ||
+			    known->objective_space != d->objective_space)
+				break;
+			CCS_VALIDATE(
+				_ccs_tree_space_transposition_create_evaluation(
+					known, configurations[i], &shared));
+			err = ops->tell(tuner, 1, &shared);
+			ccs_release_object(shared);
+			CCS_VALIDATE(err);
+			CCS_VALIDATE(ops->ask(tuner, 1, &replacement, &count));
+			if (!count)
+				break;
+			ccs_release_object(configurations[i]);
+			configurations[i] = replacement;
+		}
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
 ccs_result_t
 ccs_tree_tuner_ask(
 	ccs_tree_tuner_t          tuner,
@@ -67,11 +115,35 @@ ccs_tree_tuner_ask(
 	CCS_REFUTE(
 		!configurations && !num_configurations_ret,
 		CCS_RESULT_ERROR_INVALID_VALUE);
-	_ccs_tree_tuner_ops_t *ops = ccs_tree_tuner_get_ops(tuner);
-	CCS_VALIDATE(ops->ask(
-		tuner, num_configurations, configurations,
-		num_configurations_ret));
+	_ccs_tree_tuner_common_data_t *d =
+		(_ccs_tree_tuner_common_data_t *)tuner->data;
+	_ccs_tree_tuner_ops_t *ops   = ccs_tree_tuner_get_ops(tuner);
+	size_t                 count = num_configurations;
+	ccs_result_t           err;
+	if (!configurations ||
+	    !((_ccs_tree_space_common_data_t *)d->tree_space->data)
+		     ->transpositions) {
+		CCS_VALIDATE(ops->ask(
+			tuner, num_configurations, configurations,
+			num_configurations_ret));
+		return CCS_RESULT_SUCCESS;
+	}
+	CCS_VALIDATE(
+		ops->ask(tuner, num_configurations, configurations, &count));
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		_ccs_tree_tuner_skip_transpositions(
+			tuner, count, configurations),
+		errc);
+	if (num_configurations_ret)
+		*num_configurations_ret = count;
 	return CCS_RESULT_SUCCESS;
+errc:
+	for (size_t i = 0; i < count; i++) {
+		ccs_release_object(configurations[i]);
+		configurations[i] = NULL;
+	}
+	return err;
 }
 
 ccs_result_t
@@ -84,7 +156,16 @@ ccs_tree_tuner_tell(
 	CCS_CHECK_ARY(num_evaluations, evaluations);
 	/* TODO: check that evaluations have the same objective and
 	 * configuration sapce than the tuner */
+	_ccs_tree_tuner_common_data_t *d =
+		(_ccs_tree_tuner_common_data_t *)tuner->data;
 	_ccs_tree_tuner_ops_t *ops = ccs_tree_tuner_get_ops(tuner);
+	/* recorded first, so that a transposition table failure does not leave
+	 * the tuner told of evaluations the call reports as failed */
+	for (size_t i = 0; i < num_evaluations; i++) {
+		CCS_CHECK_OBJ(evaluations[i], CCS_OBJECT_TYPE_TREE_EVALUATION);
+		CCS_VALIDATE(_ccs_tree_space_transposition_record(
+			d->tree_space, evaluations[i]));
+	}
 	CCS_VALIDATE(ops->tell(tuner, num_evaluations, evaluations));
 	return CCS_RESULT_SUCCESS;
 }
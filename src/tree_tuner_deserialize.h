@@ -150,6 +150,79 @@ end:
 
 #undef utarray_oom
 
+struct _ccs_mcts_tree_tuner_data_mock_s {
+	_ccs_random_tree_tuner_data_mock_t base_data;
+	ccs_float_t                        exploration;
+};
+typedef struct _ccs_mcts_tree_tuner_data_mock_s
+	_ccs_mcts_tree_tuner_data_mock_t;
+
+static inline ccs_result_t
+_ccs_deserialize_bin_ccs_mcts_tree_tuner_data(
+	_ccs_mcts_tree_tuner_data_mock_t  *data,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_random_tree_tuner_data(
+		&data->base_data, version, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_float(
+		&data->exploration, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+/* The search statistics are not serialized, the history is reported to the
+ * new tuner to rebuild them and the optima. */
+static inline ccs_result_t
+_ccs_deserialize_bin_mcts_tree_tuner(
+	ccs_tree_tuner_t                  *tuner_ret,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	_ccs_mcts_tree_tuner_data_mock_t data = {
+		{{(ccs_tree_tuner_type_t)0, NULL, NULL, NULL}, 0, 0, NULL, NULL},
+		0.0};
+	ccs_result_t res = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		_ccs_deserialize_bin_ccs_mcts_tree_tuner_data(
+			&data, version, buffer_size, buffer, opts),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_create_mcts_tree_tuner(
+			data.base_data.common_data.name,
+			data.base_data.common_data.tree_space,
+			data.base_data.common_data.objective_space,
+			data.exploration, tuner_ret),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_tree_tuner_tell(
+			*tuner_ret, data.base_data.size_history,
+			data.base_data.history),
+		tuner);
+	goto end;
+tuner:
+	ccs_release_object(*tuner_ret);
+	*tuner_ret = NULL;
+end:
+	if (data.base_data.common_data.tree_space)
+		ccs_release_object(data.base_data.common_data.tree_space);
+	if (data.base_data.common_data.objective_space)
+		ccs_release_object(data.base_data.common_data.objective_space);
+	if (data.base_data.history) {
+		for (size_t i = 0; i < data.base_data.size_history; i++)
+			if (data.base_data.history[i])
+				ccs_release_object(data.base_data.history[i]);
+		free(data.base_data.history);
+	}
+	return res;
+}
+
 struct _ccs_user_defined_tree_tuner_data_mock_s {
 	_ccs_random_tree_tuner_data_mock_t base_data;
 	_ccs_blob_t                        blob;
@@ -270,6 +343,14 @@ _ccs_deserialize_bin_tree_tuner(
 				&new_opts),
 			end);
 		break;
+	case CCS_TREE_TUNER_TYPE_MCTS:
+		CCS_VALIDATE_ERR_GOTO(
+			res,
+			_ccs_deserialize_bin_mcts_tree_tuner(
+				tuner_ret, version, buffer_size, buffer,
+				&new_opts),
+			end);
+		break;
 	case CCS_TREE_TUNER_TYPE_USER_DEFINED:
 		CCS_VALIDATE_ERR_GOTO(
 			res,
@@ -0,0 +1,874 @@
+#include "cconfigspace_internal.h"
+#include "tree_tuner_internal.h"
+#include "tree_evaluation_internal.h"
+#include "tree_configuration_internal.h"
+#include "tree_internal.h"
+#include <math.h>
+
+#include "utarray.h"
+#include "uthash.h"
+
+/* UCT over the nodes of the tree space. Every node of the search tree
+ * corresponds to an action taken from its parent: selecting child index of
+ * the parent tree node, or stopping at the parent node (index equals the
+ * parent arity). Configurations reaching a search node are counted in its
+ * statistics. The search descends by maximizing
+ *   Q + exploration * sqrt(ln(N) / n)
+ * where Q is the mean reward of a node, and N and n the number of
+ * configurations that reached the parent and the node. Rewards are the
+ * values of the first objective, oriented so that higher is better, and
+ * normalized to [0, 1] using the extrema seen so far. Failed evaluations have
+ * a reward of 0. Configurations that were asked but not yet told are counted
+ * as failures (virtual loss), which spreads batched asks.
+ * Actions are drawn from the weights of the tree nodes: a node that reached n
+ * configurations can have at most ceil(sqrt(n)) expanded children
+ * (progressive widening), and while under this limit, an action drawn from
+ * the tree node weights is expanded if it was not already. Below a newly
+ * expanded node the configuration is completed by sampling the tree
+ * according to its weights. Children of dynamic tree spaces are created
+ * through the tree space callbacks. */
+#define MCTS_DEFAULT_EXPLORATION 0.7071067811865476
+
+struct _ccs_mcts_node_s {
+	size_t                   index;
+	ccs_tree_t               tree;
+	ccs_bool_t               terminal;
+	size_t                   num_successes;
+	size_t                   num_failures;
+	size_t                   num_pending;
+	ccs_float_t              sum;
+	struct _ccs_mcts_node_s *children;
+	UT_hash_handle           hh;
+};
+typedef struct _ccs_mcts_node_s _ccs_mcts_node_t;
+
+/* Configurations returned by ask and not yet told, keyed by position.
+ * num_nodes is the number of search nodes their virtual loss was added to. */
+struct _ccs_mcts_pending_s {
+	ccs_tree_configuration_t configuration;
+	size_t                   num_nodes;
+	UT_hash_handle           hh;
+};
+typedef struct _ccs_mcts_pending_s _ccs_mcts_pending_t;
+
+struct _ccs_mcts_tree_tuner_data_s {
+	_ccs_tree_tuner_common_data_t common_data;
+	UT_array                     *history;
+	UT_array                     *optima;
+	UT_array                     *old_optima;
+	ccs_float_t                   exploration;
+	ccs_objective_type_t          objective_type;
+	ccs_bool_t                    dynamic;
+	ccs_float_t                   min_reward;
+	ccs_float_t                   max_reward;
+	_ccs_mcts_node_t             *root;
+	_ccs_mcts_pending_t          *pending;
+	UT_array                     *position;
+};
+typedef struct _ccs_mcts_tree_tuner_data_s _ccs_mcts_tree_tuner_data_t;
+
+static void
+_ccs_mcts_node_free(_ccs_mcts_node_t *node)
+{
+	_ccs_mcts_node_t *child, *tmp;
+	HASH_ITER(hh, node->children, child, tmp)
+	{
+		HASH_DEL(node->children, child);
+		_ccs_mcts_node_free(child);
+	}
+	free(node);
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_del(ccs_object_t o)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)((ccs_tree_tuner_t)o)->data;
+	_ccs_mcts_pending_t *p, *tmp;
+	HASH_ITER(hh, d->pending, p, tmp)
+	{
+		HASH_DEL(d->pending, p);
+		ccs_release_object(p->configuration);
+		free(p);
+	}
+	if (d->root)
+		_ccs_mcts_node_free(d->root);
+	ccs_release_object(d->common_data.tree_space);
+	ccs_release_object(d->common_data.objective_space);
+	ccs_tree_evaluation_t *e = NULL;
+	while ((e = (ccs_tree_evaluation_t *)utarray_next(d->history, e)))
+		ccs_release_object(*e);
+	utarray_free(d->history);
+	utarray_free(d->optima);
+	utarray_free(d->old_optima);
+	utarray_free(d->position);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_mcts_tree_tuner_data(
+	_ccs_mcts_tree_tuner_data_t     *data,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_tree_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tree_tuner_common_data(
+		&data->common_data, cum_size, opts));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->history));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->optima));
+	while ((e = (ccs_tree_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize_size(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, cum_size, opts));
+	e = NULL;
+	while ((e = (ccs_tree_evaluation_t *)utarray_next(data->optima, e)))
+		*cum_size += _ccs_serialize_bin_size_ccs_object(*e);
+	*cum_size += _ccs_serialize_bin_size_ccs_float(data->exploration);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_mcts_tree_tuner_data(
+	_ccs_mcts_tree_tuner_data_t     *data,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_tree_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tree_tuner_common_data(
+		&data->common_data, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->history), buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->optima), buffer_size, buffer));
+	while ((e = (ccs_tree_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, buffer_size, buffer,
+			opts));
+	e = NULL;
+	while ((e = (ccs_tree_evaluation_t *)utarray_next(data->optima, e)))
+		CCS_VALIDATE(
+			_ccs_serialize_bin_ccs_object(*e, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_float(
+		data->exploration, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_mcts_tree_tuner(
+	ccs_tree_tuner_t                 tuner,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_mcts_tree_tuner_data_t *data =
+		(_ccs_mcts_tree_tuner_data_t *)(tuner->data);
+	*cum_size += _ccs_serialize_bin_size_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner);
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_mcts_tree_tuner_data(
+		data, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_mcts_tree_tuner(
+	ccs_tree_tuner_t                 tuner,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_mcts_tree_tuner_data_t *data =
+		(_ccs_mcts_tree_tuner_data_t *)(tuner->data);
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_mcts_tree_tuner_data(
+		data, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_serialize_size(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_size_ccs_mcts_tree_tuner(
+			(ccs_tree_tuner_t)object, cum_size, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data_size(
+		object, format, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_serialize(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_ccs_mcts_tree_tuner(
+			(ccs_tree_tuner_t)object, buffer_size, buffer, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data(
+		object, format, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline size_t
+_ccs_mcts_node_count(_ccs_mcts_node_t *node)
+{
+	return node->num_successes + node->num_failures + node->num_pending;
+}
+
+/* Weight of an action in the tree node, children that were never set weigh
+ * 1.0. */
+static inline ccs_float_t
+_ccs_mcts_action_weight(ccs_tree_t tree, size_t index)
+{
+	_ccs_tree_data_t *data = tree->data;
+	if (index == data->arity)
+		return _ccs_tree_get_own_weight(data);
+	ccs_tree_t child = _ccs_tree_get_child(data, index);
+	if (!child)
+		return 1.0;
+	return child->data->sum_weights * child->data->bias;
+}
+
+static inline ccs_float_t
+_ccs_mcts_score(
+	_ccs_mcts_tree_tuner_data_t *d,
+	_ccs_mcts_node_t            *node,
+	ccs_float_t                  log_parent)
+{
+	size_t      count = _ccs_mcts_node_count(node);
+	ccs_float_t q     = 0.0;
+	if (!count)
+		return HUGE_VAL;
+	if (node->num_successes) {
+		ccs_float_t mean = node->sum / node->num_successes;
+		if (d->max_reward > d->min_reward)
+			q = (mean - d->min_reward) /
+			    (d->max_reward - d->min_reward);
+		else
+			q = 0.5;
+		q *= (ccs_float_t)node->num_successes / count;
+	}
+	return q + d->exploration * sqrt(log_parent / count);
+}
+
+static inline ccs_result_t
+_ccs_mcts_create_node(
+	_ccs_mcts_tree_tuner_data_t *d,
+	_ccs_mcts_node_t            *parent,
+	size_t                       index,
+	_ccs_mcts_node_t           **node_ret)
+{
+	_ccs_mcts_node_t *node;
+	ccs_tree_t        tree = NULL;
+	ccs_bool_t        terminal;
+	if (parent) {
+		terminal = index == parent->tree->data->arity;
+		if (!terminal) {
+			tree = _ccs_tree_get_child(parent->tree->data, index);
+			if (!tree && d->dynamic)
+				CCS_VALIDATE(
+					ccs_tree_space_get_node_at_position(
+						d->common_data.tree_space,
+						utarray_len(d->position),
+						(size_t *)utarray_front(
+							d->position),
+						&tree));
+			terminal = !tree;
+		}
+	} else {
+		CCS_VALIDATE(ccs_tree_space_get_tree(
+			d->common_data.tree_space, &tree));
+		terminal = CCS_FALSE;
+	}
+	node = (_ccs_mcts_node_t *)calloc(1, sizeof(_ccs_mcts_node_t));
+	CCS_REFUTE(!node, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	node->index    = index;
+	node->tree     = tree;
+	node->terminal = terminal;
+	if (parent)
+		HASH_ADD(hh, parent->children, index, sizeof(size_t), node);
+	*node_ret = node;
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+/* Descend the search tree from the root, expanding at most one node, and
+ * count the search nodes the virtual loss is added to in *num_nodes. The
+ * position of the selected configuration is left in d->position, and the
+ * last node in *node_ret. */
+static ccs_result_t
+_ccs_mcts_select(
+	_ccs_mcts_tree_tuner_data_t *d,
+	ccs_rng_t                    rng,
+	size_t                      *num_nodes,
+	_ccs_mcts_node_t           **node_ret)
+{
+	_ccs_mcts_node_t *node     = d->root;
+	ccs_bool_t        expanded = CCS_FALSE;
+	node->num_pending++;
+	*num_nodes = 1;
+	while (!node->terminal && !expanded) {
+		_ccs_mcts_node_t *child = NULL;
+		size_t            count = _ccs_mcts_node_count(node);
+		size_t            index;
+		if (HASH_COUNT(node->children) < ceil(sqrt((double)count))) {
+			CCS_VALIDATE(_ccs_tree_samples(
+				node->tree->data, rng, 1, &index));
+			HASH_FIND(hh, node->children, &index, sizeof(size_t),
+				  child);
+			if (child)
+				child = NULL;
+			else
+				expanded = CCS_TRUE;
+		}
+		if (!expanded) {
+			ccs_float_t       log_parent = log((double)count);
+			ccs_float_t       best       = -HUGE_VAL;
+			_ccs_mcts_node_t *c, *tmp;
+			HASH_ITER(hh, node->children, c, tmp)
+			{
+				if (_ccs_mcts_action_weight(
+					    node->tree, c->index) == 0.0)
+					continue;
+				ccs_float_t score =
+					_ccs_mcts_score(d, c, log_parent);
+				if (score > best) {
+					best  = score;
+					child = c;
+				}
+			}
+			if (!child) {
+				CCS_VALIDATE(_ccs_tree_samples(
+					node->tree->data, rng, 1, &index));
+				HASH_FIND(
+					hh, node->children, &index,
+					sizeof(size_t), child);
+				expanded = !child;
+			} else
+				index = child->index;
+		}
+		if (index != node->tree->data->arity)
+			utarray_push_back(d->position, &index);
+		if (expanded)
+			CCS_VALIDATE(
+				_ccs_mcts_create_node(d, node, index, &child));
+		node = child;
+		node->num_pending++;
+		(*num_nodes)++;
+	}
+	*node_ret = node;
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Complete the configuration below a newly expanded node by sampling the
+ * tree according to its weights. */
+static ccs_result_t
+_ccs_mcts_rollout(
+	_ccs_mcts_tree_tuner_data_t *d,
+	ccs_rng_t                    rng,
+	ccs_tree_t                   tree)
+{
+	size_t index;
+	while (tree) {
+		CCS_VALIDATE(_ccs_tree_samples(tree->data, rng, 1, &index));
+		if (index == tree->data->arity)
+			break;
+		utarray_push_back(d->position, &index);
+		ccs_tree_t child = _ccs_tree_get_child(tree->data, index);
+		if (!child && d->dynamic)
+			CCS_VALIDATE(ccs_tree_space_get_node_at_position(
+				d->common_data.tree_space,
+				utarray_len(d->position),
+				(size_t *)utarray_front(d->position), &child));
+		tree = child;
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Walk the search nodes reached by a position: the nodes along the position,
+ * then the node stopping at its end. Returns NULL past the last expanded
+ * node. */
+static inline _ccs_mcts_node_t *
+_ccs_mcts_next_node(
+	_ccs_mcts_node_t *node,
+	size_t            depth,
+	size_t            position_size,
+	const size_t     *position)
+{
+	_ccs_mcts_node_t *child = NULL;
+	size_t            index;
+	if (node->terminal)
+		return NULL;
+	if (depth < position_size)
+		index = position[depth];
+	else if (depth == position_size)
+		index = node->tree->data->arity;
+	else
+		return NULL;
+	HASH_FIND(hh, node->children, &index, sizeof(size_t), child);
+	return child;
+}
+
+static void
+_ccs_mcts_remove_virtual_loss(
+	_ccs_mcts_tree_tuner_data_t *d,
+	size_t                       num_nodes,
+	size_t                       position_size,
+	const size_t                *position)
+{
+	_ccs_mcts_node_t *node = d->root;
+	for (size_t i = 0; i < num_nodes && node; i++) {
+		node->num_pending--;
+		node = _ccs_mcts_next_node(node, i, position_size, position);
+	}
+}
+
+static ccs_result_t
+_ccs_mcts_ask_one(
+	_ccs_mcts_tree_tuner_data_t *d,
+	ccs_rng_t                    rng,
+	ccs_tree_configuration_t    *configuration)
+{
+	_ccs_mcts_pending_t *p;
+	_ccs_mcts_node_t    *node      = NULL;
+	size_t               num_nodes = 0;
+	ccs_result_t         err;
+	utarray_clear(d->position);
+	CCS_VALIDATE_ERR_GOTO(
+		err, _ccs_mcts_select(d, rng, &num_nodes, &node), err_select);
+	if (!node->terminal)
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_mcts_rollout(d, rng, node->tree), err_select);
+	p = (_ccs_mcts_pending_t *)malloc(sizeof(_ccs_mcts_pending_t));
+	CCS_REFUTE_ERR_GOTO(
+		err, !p, CCS_RESULT_ERROR_OUT_OF_MEMORY, err_select);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_create_tree_configuration(
+			d->common_data.tree_space, utarray_len(d->position),
+			(size_t *)utarray_front(d->position), configuration),
+		err_pending);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(*configuration), err_configuration);
+	p->configuration = *configuration;
+	p->num_nodes     = num_nodes;
+	HASH_ADD_KEYPTR(
+		hh, d->pending, (*configuration)->data->position,
+		(*configuration)->data->position_size * sizeof(size_t), p);
+	return CCS_RESULT_SUCCESS;
+err_configuration:
+	ccs_release_object(*configuration);
+	*configuration = NULL;
+err_pending:
+	free(p);
+err_select:
+	_ccs_mcts_remove_virtual_loss(
+		d, num_nodes, utarray_len(d->position),
+		(size_t *)utarray_front(d->position));
+	return err;
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_ask(
+	ccs_tree_tuner_t          tuner,
+	size_t                    num_configurations,
+	ccs_tree_configuration_t *configurations,
+	size_t                   *num_configurations_ret)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	if (!configurations) {
+		*num_configurations_ret = 1;
+		return CCS_RESULT_SUCCESS;
+	}
+	ccs_rng_t    rng;
+	ccs_result_t err = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE(ccs_tree_space_get_rng(d->common_data.tree_space, &rng));
+	if (!d->root)
+		CCS_VALIDATE(_ccs_mcts_create_node(d, NULL, 0, &d->root));
+	for (size_t i = 0; i < num_configurations; i++)
+		configurations[i] = NULL;
+	for (size_t i = 0; i < num_configurations; i++)
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_mcts_ask_one(d, rng, configurations + i),
+			end);
+end:
+	if (num_configurations_ret) {
+		size_t count = 0;
+		while (count < num_configurations && configurations[count])
+			count++;
+		*num_configurations_ret = count;
+	}
+	return err;
+}
+
+/* Clear the virtual loss of an asked configuration, and account the
+ * evaluation in the search nodes it reaches. Evaluations of other tree spaces
+ * are ignored. */
+static ccs_result_t
+_ccs_mcts_backpropagate(
+	_ccs_mcts_tree_tuner_data_t *d,
+	ccs_tree_evaluation_t        evaluation)
+{
+	ccs_tree_configuration_t configuration =
+		evaluation->data->configuration;
+	size_t               position_size = configuration->data->position_size;
+	const size_t        *position      = configuration->data->position;
+	_ccs_mcts_pending_t *p             = NULL;
+	_ccs_mcts_node_t    *node      = NULL;
+	ccs_bool_t           success = CCS_FALSE;
+	ccs_float_t          reward  = 0.0;
+	if (configuration->data->tree_space != d->common_data.tree_space)
+		return CCS_RESULT_SUCCESS;
+	if (!d->root)
+		CCS_VALIDATE(_ccs_mcts_create_node(d, NULL, 0, &d->root));
+	HASH_FIND(
+		hh, d->pending, position, position_size * sizeof(size_t), p);
+	if (p) {
+		HASH_DEL(d->pending, p);
+		_ccs_mcts_remove_virtual_loss(
+			d, p->num_nodes, position_size, position);
+		ccs_release_object(p->configuration);
+		free(p);
+	}
+	if (evaluation->data->result == CCS_RESULT_SUCCESS) {
+		ccs_datum_t v;
+		CCS_VALIDATE(ccs_tree_evaluation_get_objective_value(
+			evaluation, 0, &v));
+		if (v.type == CCS_DATA_TYPE_INT) {
+			reward  = (ccs_float_t)v.value.i;
+			success = CCS_TRUE;
+		} else if (v.type == CCS_DATA_TYPE_FLOAT && !isnan(v.value.f)) {
+			reward  = v.value.f;
+			success = CCS_TRUE;
+		}
+		if (d->objective_type == CCS_OBJECTIVE_TYPE_MINIMIZE)
+			reward = -reward;
+	}
+	if (success) {
+		if (reward < d->min_reward)
+			d->min_reward = reward;
+		if (reward > d->max_reward)
+			d->max_reward = reward;
+	}
+	node = d->root;
+	for (size_t i = 0; node; i++) {
+		if (success) {
+			node->num_successes++;
+			node->sum += reward;
+		} else
+			node->num_failures++;
+		node = _ccs_mcts_next_node(node, i, position_size, position);
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+static ccs_result_t
+_ccs_tree_tuner_mcts_tell(
+	ccs_tree_tuner_t       tuner,
+	size_t                 num_evaluations,
+	ccs_tree_evaluation_t *evaluations)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	UT_array    *history = d->history;
+	ccs_result_t err;
+	for (size_t i = 0; i < num_evaluations; i++) {
+		ccs_evaluation_result_t result;
+		CCS_VALIDATE(ccs_tree_evaluation_get_result(
+			evaluations[i], &result));
+		CCS_VALIDATE(_ccs_mcts_backpropagate(d, evaluations[i]));
+		if (!result) {
+			int       discard = 0;
+			UT_array *tmp;
+			ccs_retain_object(evaluations[i]);
+			utarray_push_back(history, evaluations + i);
+			tmp           = d->old_optima;
+			d->old_optima = d->optima;
+			d->optima     = tmp;
+			utarray_clear(d->optima);
+			ccs_tree_evaluation_t *eval = NULL;
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		d->optima = d->old_optima;                                     \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+			while ((eval = (ccs_tree_evaluation_t *)utarray_next(
+					d->old_optima, eval))) {
+				if (!discard) {
+					ccs_comparison_t cmp;
+					err = ccs_tree_evaluation_compare(
+						evaluations[i], *eval, &cmp);
+					if (err)
+						discard = 1;
+					else
+						switch (cmp) {
+						case CCS_COMPARISON_EQUIVALENT:
+						case CCS_COMPARISON_WORSE:
+							discard = 1;
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						case CCS_COMPARISON_BETTER:
+							break;
+						case CCS_COMPARISON_NOT_COMPARABLE:
+						default:
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						}
+				} else {
+					utarray_push_back(d->optima, eval);
+				}
+			}
+			if (!discard)
+				utarray_push_back(d->optima, evaluations + i);
+		}
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_get_optima(
+	ccs_tree_tuner_t       tuner,
+	size_t                 num_evaluations,
+	ccs_tree_evaluation_t *evaluations,
+	size_t                *num_evaluations_ret)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->optima);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_tree_evaluation_t *eval  = NULL;
+		size_t                 index = 0;
+		while ((eval = (ccs_tree_evaluation_t *)utarray_next(
+				d->optima, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tree_tuner_mcts_get_history(
+	ccs_tree_tuner_t       tuner,
+	size_t                 num_evaluations,
+	ccs_tree_evaluation_t *evaluations,
+	size_t                *num_evaluations_ret)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->history);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_tree_evaluation_t *eval  = NULL;
+		size_t                 index = 0;
+		while ((eval = (ccs_tree_evaluation_t *)utarray_next(
+				d->history, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Without optima, the configuration is sampled from the tree space, as
+ * suggestions do not take part in the search. */
+static ccs_result_t
+_ccs_tree_tuner_mcts_suggest(
+	ccs_tree_tuner_t          tuner,
+	ccs_tree_configuration_t *configuration)
+{
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->optima);
+	if (count > 0) {
+		ccs_rng_t         rng;
+		unsigned long int indx;
+		CCS_VALIDATE(ccs_tree_space_get_rng(
+			d->common_data.tree_space, &rng));
+		CCS_VALIDATE(ccs_rng_get(rng, &indx));
+		indx = indx % count;
+		ccs_tree_evaluation_t *eval =
+			(ccs_tree_evaluation_t *)utarray_eltptr(
+				d->optima, indx);
+		CCS_VALIDATE(ccs_tree_evaluation_get_configuration(
+			*eval, configuration));
+		CCS_VALIDATE(ccs_retain_object(*configuration));
+	} else
+		CCS_VALIDATE(ccs_tree_space_sample(
+			d->common_data.tree_space, configuration));
+	return CCS_RESULT_SUCCESS;
+}
+
+static _ccs_tree_tuner_ops_t _ccs_tree_tuner_mcts_ops = {
+	{&_ccs_tree_tuner_mcts_del, &_ccs_tree_tuner_mcts_serialize_size,
+	 &_ccs_tree_tuner_mcts_serialize},
+	&_ccs_tree_tuner_mcts_ask,
+	&_ccs_tree_tuner_mcts_tell,
+	&_ccs_tree_tuner_mcts_get_optima,
+	&_ccs_tree_tuner_mcts_get_history,
+	&_ccs_tree_tuner_mcts_suggest};
+
+static const UT_icd _evaluation_icd = {
+	sizeof(ccs_tree_evaluation_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static const UT_icd _size_t_icd = {sizeof(size_t), NULL, NULL, NULL};
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, arrays,           \
+			"Out of memory to allocate array");                    \
+	}
+ccs_result_t
+ccs_create_mcts_tree_tuner(
+	const char           *name,
+	ccs_tree_space_t      tree_space,
+	ccs_objective_space_t objective_space,
+	ccs_float_t           exploration,
+	ccs_tree_tuner_t     *tuner_ret)
+{
+	CCS_CHECK_PTR(name);
+	CCS_CHECK_OBJ(tree_space, CCS_OBJECT_TYPE_TREE_SPACE);
+	CCS_CHECK_OBJ(objective_space, CCS_OBJECT_TYPE_OBJECTIVE_SPACE);
+	CCS_CHECK_PTR(tuner_ret);
+	CCS_REFUTE(
+		!(exploration >= 0.0) || isinf(exploration),
+		CCS_RESULT_ERROR_INVALID_VALUE);
+
+	size_t                num_objectives;
+	ccs_objective_type_t  objective_type;
+	ccs_expression_t      expression;
+	ccs_tree_space_type_t tree_space_type;
+	CCS_VALIDATE(ccs_objective_space_get_objectives(
+		objective_space, 0, NULL, NULL, &num_objectives));
+	CCS_REFUTE(num_objectives == 0, CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_VALIDATE(ccs_objective_space_get_objective(
+		objective_space, 0, &expression, &objective_type));
+	CCS_VALIDATE(ccs_tree_space_get_type(tree_space, &tree_space_type));
+
+	uintptr_t mem = (uintptr_t)calloc(
+		1, sizeof(struct _ccs_tree_tuner_s) +
+			   sizeof(struct _ccs_mcts_tree_tuner_data_s) +
+			   strlen(name) + 1);
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	ccs_tree_tuner_t             tun;
+	_ccs_mcts_tree_tuner_data_t *data;
+	ccs_result_t                 err;
+	CCS_VALIDATE_ERR_GOTO(err, ccs_retain_object(tree_space), errmemory);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(objective_space), errconfigs);
+	tun = (ccs_tree_tuner_t)mem;
+	_ccs_object_init(
+		&(tun->obj), CCS_OBJECT_TYPE_TREE_TUNER,
+		(_ccs_object_ops_t *)&_ccs_tree_tuner_mcts_ops);
+	tun->data              = (struct _ccs_tree_tuner_data_s
+                             *)(mem + sizeof(struct _ccs_tree_tuner_s));
+	data                   = (_ccs_mcts_tree_tuner_data_t *)tun->data;
+	data->common_data.type = CCS_TREE_TUNER_TYPE_MCTS;
+	data->common_data.name =
+		(const char
+			 *)(mem + sizeof(struct _ccs_tree_tuner_s) + sizeof(struct _ccs_mcts_tree_tuner_data_s));
+	data->common_data.tree_space      = tree_space;
+	data->common_data.objective_space = objective_space;
+	data->exploration =
+		exploration > 0.0 ? exploration : MCTS_DEFAULT_EXPLORATION;
+	data->objective_type = objective_type;
+	data->dynamic    = tree_space_type == CCS_TREE_SPACE_TYPE_DYNAMIC;
+	data->min_reward = HUGE_VAL;
+	data->max_reward = -HUGE_VAL;
+	utarray_new(data->history, &_evaluation_icd);
+	utarray_new(data->optima, &_evaluation_icd);
+	utarray_new(data->old_optima, &_evaluation_icd);
+	utarray_new(data->position, &_size_t_icd);
+	strcpy((char *)data->common_data.name, name);
+	*tuner_ret = tun;
+	return CCS_RESULT_SUCCESS;
+
+arrays:
+	if (data->history)
+		utarray_free(data->history);
+	if (data->optima)
+		utarray_free(data->optima);
+	if (data->old_optima)
+		utarray_free(data->old_optima);
+	if (data->position)
+		utarray_free(data->position);
+	ccs_release_object(objective_space);
+errconfigs:
+	ccs_release_object(tree_space);
+errmemory:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_mcts_tree_tuner_get_properties(
+	ccs_tree_tuner_t tuner,
+	ccs_float_t     *exploration_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_TREE_TUNER);
+	CCS_CHECK_PTR(exploration_ret);
+	_ccs_mcts_tree_tuner_data_t *d =
+		(_ccs_mcts_tree_tuner_data_t *)tuner->data;
+	CCS_REFUTE(
+		d->common_data.type != CCS_TREE_TUNER_TYPE_MCTS,
+		CCS_RESULT_ERROR_INVALID_TUNER);
+	*exploration_ret = d->exploration;
+	return CCS_RESULT_SUCCESS;
+}
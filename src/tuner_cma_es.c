@@ -0,0 +1,1236 @@
+#include "cconfigspace_internal.h"
+#include "tuner_internal.h"
+#include "evaluation_internal.h"
+#include "configuration_internal.h"
+#include "configuration_space_internal.h"
+#include "datum_hash.h"
+#include <gsl/gsl_rng.h>
+#include <math.h>
+#include <string.h>
+
+#include "utarray.h"
+
+/* (mu/mu_w, lambda) CMA-ES over the numerical parameters, normalized to the
+ * unit hypercube (in log space for parameters sampled logarithmically).
+ * Offspring are drawn as mean + sigma * A * z, where A is the Cholesky factor
+ * of the covariance matrix and z is sampled from a multivariate distribution
+ * of standard normals. Categorical, ordinal and discrete parameters are
+ * inherited from the best individual of the previous generation, each being
+ * mutated to another value with probability 1/num_discretes. The step size
+ * is capped as the normalized search space has unit width. */
+#define CMA_ES_DEFAULT_SIGMA 0.3
+#define CMA_ES_MAX_SIGMA 1.0
+#define CMA_ES_MAX_TRIES 100
+
+struct _ccs_cma_es_parameter_s {
+	ccs_parameter_t      parameter;
+	ccs_parameter_type_t type;
+	/* numerical parameters, bounds are in the modeling space */
+	ccs_numeric_type_t   data_type;
+	ccs_numeric_t        value_lower;
+	ccs_numeric_t        value_upper;
+	ccs_numeric_t        quantization;
+	ccs_bool_t           log;
+	ccs_float_t          lower;
+	ccs_float_t          upper;
+	size_t               dimension;
+	/* categorical, ordinal and discrete parameters */
+	size_t               num_values;
+	size_t               current;
+	ccs_datum_t         *values;
+};
+typedef struct _ccs_cma_es_parameter_s _ccs_cma_es_parameter_t;
+
+/* An offspring and the standard normal sample it was generated from. Samples
+ * are stored inline so the multivariate distribution can fill them in place
+ * using a stride. */
+struct _ccs_cma_es_individual_s {
+	ccs_configuration_t configuration;
+	ccs_evaluation_t    evaluation;
+	size_t              generation;
+	size_t              rank;
+	ccs_numeric_t       z[];
+};
+typedef struct _ccs_cma_es_individual_s _ccs_cma_es_individual_t;
+
+struct _ccs_cma_es_tuner_data_s {
+	_ccs_tuner_common_data_t   common_data;
+	UT_array                  *history;
+	UT_array                  *optima;
+	UT_array                  *old_optima;
+	size_t                     population_size;
+	ccs_float_t                initial_sigma;
+	size_t                     num_parameters;
+	_ccs_cma_es_parameter_t   *parameters;
+	size_t                     num_discretes;
+	/* strategy parameters */
+	size_t                     dimension;
+	size_t                     num_parents;
+	ccs_float_t               *weights;
+	ccs_float_t                mueff;
+	ccs_float_t                cc;
+	ccs_float_t                cs;
+	ccs_float_t                c1;
+	ccs_float_t                cmu;
+	ccs_float_t                damps;
+	ccs_float_t                chi_n;
+	/* strategy state */
+	size_t                     generation;
+	ccs_float_t                sigma;
+	ccs_float_t               *mean;
+	ccs_float_t               *path_sigma;
+	ccs_float_t               *path_c;
+	ccs_float_t               *covariance;
+	ccs_float_t               *cholesky;
+	ccs_float_t               *work;
+	ccs_distribution_t         normal;
+	/* offspring waiting for evaluation, and evaluated offspring of the
+	 * current generation */
+	size_t                     individual_size;
+	UT_array                  *pending;
+	size_t                     num_selected;
+	char                      *selected;
+	_ccs_cma_es_individual_t **order;
+};
+typedef struct _ccs_cma_es_tuner_data_s _ccs_cma_es_tuner_data_t;
+
+#define CMA_ES_SELECTED(d, i)                                                  \
+	((_ccs_cma_es_individual_t *)((d)->selected +                          \
+				      (i) * (d)->individual_size))
+
+static void
+_ccs_cma_es_parameters_fini(
+	size_t                   num_parameters,
+	_ccs_cma_es_parameter_t *params)
+{
+	for (size_t i = 0; i < num_parameters; i++)
+		if (params[i].values)
+			free(params[i].values);
+}
+
+static ccs_result_t
+_ccs_tuner_cma_es_del(ccs_object_t o)
+{
+	_ccs_cma_es_tuner_data_t *d =
+		(_ccs_cma_es_tuner_data_t *)((ccs_tuner_t)o)->data;
+	_ccs_cma_es_individual_t *ind = NULL;
+	while ((ind = (_ccs_cma_es_individual_t *)utarray_next(
+			d->pending, ind)))
+		ccs_release_object(ind->configuration);
+	utarray_free(d->pending);
+	for (size_t i = 0; i < d->num_selected; i++) {
+		ccs_release_object(CMA_ES_SELECTED(d, i)->configuration);
+		ccs_release_object(CMA_ES_SELECTED(d, i)->evaluation);
+	}
+	if (d->normal)
+		ccs_release_object(d->normal);
+	_ccs_cma_es_parameters_fini(d->num_parameters, d->parameters);
+	ccs_release_object(d->common_data.configuration_space);
+	ccs_release_object(d->common_data.objective_space);
+	ccs_evaluation_t *e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(d->history, e)))
+		ccs_release_object(*e);
+	utarray_free(d->history);
+	utarray_free(d->optima);
+	utarray_free(d->old_optima);
+	return CCS_RESULT_SUCCESS;
+}
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_cma_es_tuner_data(
+	_ccs_cma_es_tuner_data_t        *data,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tuner_common_data(
+		&data->common_data, cum_size, opts));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->history));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->optima));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize_size(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, cum_size, opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		*cum_size += _ccs_serialize_bin_size_ccs_object(*e);
+	*cum_size += _ccs_serialize_bin_size_size(data->population_size);
+	*cum_size += _ccs_serialize_bin_size_ccs_float(data->initial_sigma);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_cma_es_tuner_data(
+	_ccs_cma_es_tuner_data_t        *data,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tuner_common_data(
+		&data->common_data, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->history), buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->optima), buffer_size, buffer));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, buffer_size, buffer,
+			opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		CCS_VALIDATE(
+			_ccs_serialize_bin_ccs_object(*e, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		data->population_size, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_float(
+		data->initial_sigma, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_cma_es_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_cma_es_tuner_data_t *data =
+		(_ccs_cma_es_tuner_data_t *)(tuner->data);
+	*cum_size += _ccs_serialize_bin_size_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner);
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_cma_es_tuner_data(
+		data, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_cma_es_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_cma_es_tuner_data_t *data =
+		(_ccs_cma_es_tuner_data_t *)(tuner->data);
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_cma_es_tuner_data(
+		data, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_cma_es_serialize_size(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_size_ccs_cma_es_tuner(
+			(ccs_tuner_t)object, cum_size, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data_size(
+		object, format, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_cma_es_serialize(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_ccs_cma_es_tuner(
+			(ccs_tuner_t)object, buffer_size, buffer, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data(
+		object, format, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Lower triangular factor of the covariance, returns CCS_FALSE if the
+ * covariance is not positive definite anymore. */
+static ccs_bool_t
+_ccs_cma_es_cholesky(size_t n, const ccs_float_t *c, ccs_float_t *a)
+{
+	for (size_t j = 0; j < n; j++) {
+		ccs_float_t s = c[j * n + j];
+		for (size_t k = 0; k < j; k++)
+			s -= a[j * n + k] * a[j * n + k];
+		if (!(s > 0.0) || !isfinite(s))
+			return CCS_FALSE;
+		a[j * n + j] = sqrt(s);
+		for (size_t i = j + 1; i < n; i++) {
+			s = c[i * n + j];
+			for (size_t k = 0; k < j; k++)
+				s -= a[i * n + k] * a[j * n + k];
+			a[i * n + j] = s / a[j * n + j];
+		}
+		for (size_t k = j + 1; k < n; k++)
+			a[j * n + k] = 0.0;
+	}
+	return CCS_TRUE;
+}
+
+static void
+_ccs_cma_es_reset_covariance(_ccs_cma_es_tuner_data_t *d)
+{
+	size_t n = d->dimension;
+	for (size_t i = 0; i < n * n; i++) {
+		d->covariance[i] = 0.0;
+		d->cholesky[i]   = 0.0;
+	}
+	for (size_t i = 0; i < n; i++) {
+		d->covariance[i * n + i] = 1.0;
+		d->cholesky[i * n + i]   = 1.0;
+		d->path_c[i]             = 0.0;
+	}
+}
+
+/* y = A * z */
+static inline void
+_ccs_cma_es_transform(
+	_ccs_cma_es_tuner_data_t *d,
+	const ccs_numeric_t      *z,
+	ccs_float_t              *y)
+{
+	size_t n = d->dimension;
+	for (size_t i = 0; i < n; i++) {
+		y[i] = 0.0;
+		for (size_t k = 0; k <= i; k++)
+			y[i] += d->cholesky[i * n + k] * z[k].f;
+	}
+}
+
+static inline ccs_datum_t
+_ccs_cma_es_from_model(_ccs_cma_es_parameter_t *p, ccs_float_t u)
+{
+	ccs_float_t v = p->lower + u * (p->upper - p->lower);
+	if (p->log)
+		v = exp(v);
+	if (p->data_type == CCS_NUMERIC_TYPE_INT) {
+		ccs_int_t   lower = p->value_lower.i;
+		ccs_int_t   q     = p->quantization.i ? p->quantization.i : 1;
+		ccs_int_t   kmax  = (p->value_upper.i - 1 - lower) / q;
+		ccs_float_t k     = floor((v - (ccs_float_t)lower) / q);
+		k                 = k < 0.0 ? 0.0 : k > kmax ? kmax : k;
+		return ccs_int(lower + (ccs_int_t)k * q);
+	}
+	if (p->quantization.f > 0.0) {
+		ccs_float_t q    = p->quantization.f;
+		ccs_float_t kmax = ceil(
+			(p->value_upper.f - p->value_lower.f) / q - 1.0);
+		ccs_float_t k = round((v - p->value_lower.f) / q);
+		k             = k < 0.0 ? 0.0 : k > kmax ? kmax : k;
+		v             = p->value_lower.f + k * q;
+	}
+	if (v < p->value_lower.f)
+		v = p->value_lower.f;
+	else if (v >= p->value_upper.f)
+		v = nextafter(p->value_upper.f, p->value_lower.f);
+	return ccs_float(v);
+}
+
+/* Fills every value of a configuration from a normal sample, or from the
+ * mean if z is NULL, before conditions are applied. */
+static void
+_ccs_cma_es_fill(
+	_ccs_cma_es_tuner_data_t *d,
+	gsl_rng                  *grng,
+	const ccs_numeric_t      *z,
+	ccs_datum_t              *values)
+{
+	ccs_float_t *y = d->work + d->dimension;
+	if (z)
+		_ccs_cma_es_transform(d, z, y);
+	for (size_t i = 0; i < d->num_parameters; i++) {
+		_ccs_cma_es_parameter_t *p = d->parameters + i;
+		if (p->type == CCS_PARAMETER_TYPE_NUMERICAL) {
+			ccs_float_t u = d->mean[p->dimension];
+			if (z)
+				u += d->sigma * y[p->dimension];
+			u         = u < 0.0 ? 0.0 : u > 1.0 ? 1.0 : u;
+			values[i] = _ccs_cma_es_from_model(p, u);
+		} else {
+			size_t index = p->current;
+			if (z && p->num_values > 1 &&
+			    gsl_rng_uniform(grng) * d->num_discretes < 1.0) {
+				index = gsl_rng_uniform_int(
+					grng, p->num_values - 1);
+				if (index >= p->current)
+					index++;
+			}
+			values[i] = p->values[index];
+		}
+	}
+}
+
+static ccs_result_t
+_ccs_cma_es_individual_init(
+	_ccs_cma_es_tuner_data_t *d,
+	ccs_rng_t                 rng,
+	gsl_rng                  *grng,
+	size_t                    index)
+{
+	ccs_configuration_space_t configuration_space;
+	ccs_configuration_t       config = NULL;
+	ccs_result_t              err;
+	ccs_bool_t                found;
+	size_t                    stride;
+	_ccs_cma_es_individual_t *ind;
+	configuration_space = d->common_data.configuration_space;
+	stride              = d->individual_size / sizeof(ccs_numeric_t);
+	CCS_VALIDATE(ccs_create_configuration(
+		configuration_space, 0, NULL, &config));
+	ind = (_ccs_cma_es_individual_t *)utarray_eltptr(d->pending, index);
+	for (size_t tries = 0; tries < CMA_ES_MAX_TRIES; tries++) {
+		if (tries && d->normal)
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_distribution_strided_samples(
+					d->normal, rng, 1, stride, ind->z),
+				errc);
+		_ccs_cma_es_fill(d, grng, ind->z, config->data->values);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_configuration_space_set_actives(
+				configuration_space, config->data->values),
+			errc);
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_configuration_space_test_forbidden(
+				configuration_space, config->data->values,
+				&found),
+			errc);
+		if (found) {
+			ind->configuration = config;
+			ind->generation    = d->generation;
+			return CCS_RESULT_SUCCESS;
+		}
+	}
+	err = CCS_RESULT_ERROR_SAMPLING_UNSUCCESSFUL;
+errc:
+	ccs_release_object(config);
+	return err;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+static ccs_result_t
+_ccs_tuner_cma_es_ask(
+	ccs_tuner_t          tuner,
+	size_t               num_configurations,
+	ccs_configuration_t *configurations,
+	size_t              *num_configurations_ret)
+{
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	ccs_result_t              err   = CCS_RESULT_SUCCESS;
+	size_t                    start = utarray_len(d->pending);
+	size_t                    count = 0;
+	size_t                    stride;
+	ccs_rng_t                 rng;
+	gsl_rng                  *grng;
+	stride = d->individual_size / sizeof(ccs_numeric_t);
+	if (!configurations) {
+		*num_configurations_ret =
+			d->population_size - d->num_selected;
+		return CCS_RESULT_SUCCESS;
+	}
+	CCS_VALIDATE(ccs_configuration_space_get_rng(
+		d->common_data.configuration_space, &rng));
+	CCS_VALIDATE(ccs_rng_get_gsl_rng(rng, &grng));
+	/* samples of the whole batch are drawn at once */
+	utarray_resize(d->pending, start + num_configurations);
+	if (d->normal && num_configurations)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_distribution_strided_samples(
+				d->normal, rng, num_configurations, stride,
+				((_ccs_cma_es_individual_t *)utarray_eltptr(
+					 d->pending, start))
+					->z),
+			errc);
+	for (; count < num_configurations; count++) {
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_cma_es_individual_init(
+				d, rng, grng, start + count),
+			errc);
+		configurations[count] =
+			((_ccs_cma_es_individual_t *)utarray_eltptr(
+				 d->pending, start + count))
+				->configuration;
+		ccs_retain_object(configurations[count]);
+	}
+	if (num_configurations_ret)
+		*num_configurations_ret = num_configurations;
+	return CCS_RESULT_SUCCESS;
+errc:
+	for (size_t i = 0; i < count; i++) {
+		_ccs_cma_es_individual_t *ind =
+			(_ccs_cma_es_individual_t *)utarray_eltptr(
+				d->pending, start + i);
+		ccs_release_object(ind->configuration);
+		ccs_release_object(configurations[i]);
+	}
+	utarray_resize(d->pending, start);
+	for (size_t i = 0; i < num_configurations; i++)
+		configurations[i] = NULL;
+	return err;
+}
+
+static int
+_ccs_cma_es_individual_sort(const void *a, const void *b)
+{
+	const _ccs_cma_es_individual_t *ia =
+		*(const _ccs_cma_es_individual_t **)a;
+	const _ccs_cma_es_individual_t *ib =
+		*(const _ccs_cma_es_individual_t **)b;
+	if (ia->rank != ib->rank)
+		return ia->rank < ib->rank ? -1 : 1;
+	return ia < ib ? -1 : ia > ib ? 1 : 0;
+}
+
+/* Individuals are ranked by the number of individuals of the generation that
+ * are better than them. */
+static ccs_result_t
+_ccs_cma_es_rank(_ccs_cma_es_tuner_data_t *d)
+{
+	size_t lambda = d->population_size;
+	for (size_t i = 0; i < lambda; i++) {
+		_ccs_cma_es_individual_t *ind = CMA_ES_SELECTED(d, i);
+		ind->rank                     = 0;
+		for (size_t j = 0; j < lambda; j++) {
+			ccs_comparison_t cmp;
+			if (i == j)
+				continue;
+			CCS_VALIDATE(ccs_evaluation_compare(
+				CMA_ES_SELECTED(d, j)->evaluation,
+				ind->evaluation, &cmp));
+			if (cmp == CCS_COMPARISON_BETTER)
+				ind->rank++;
+		}
+		d->order[i] = ind;
+	}
+	qsort(d->order, lambda, sizeof(_ccs_cma_es_individual_t *),
+	      &_ccs_cma_es_individual_sort);
+	return CCS_RESULT_SUCCESS;
+}
+
+static void
+_ccs_cma_es_update_discretes(
+	_ccs_cma_es_tuner_data_t *d,
+	ccs_configuration_t       best)
+{
+	ccs_datum_t *values = best->data->values;
+	for (size_t i = 0; i < d->num_parameters; i++) {
+		_ccs_cma_es_parameter_t *p = d->parameters + i;
+		if (p->type == CCS_PARAMETER_TYPE_NUMERICAL ||
+		    values[i].type == CCS_DATA_TYPE_INACTIVE)
+			continue;
+		for (size_t j = 0; j < p->num_values; j++)
+			if (!_datum_cmp(p->values + j, values + i)) {
+				p->current = j;
+				break;
+			}
+	}
+}
+
+static void
+_ccs_cma_es_update_strategy(_ccs_cma_es_tuner_data_t *d)
+{
+	size_t       n  = d->dimension;
+	ccs_float_t *zw = d->work;
+	ccs_float_t *y  = d->work + n;
+	ccs_float_t *yw = d->work + 2 * n;
+	ccs_float_t  norm, hsig, c1a;
+
+	for (size_t k = 0; k < n; k++)
+		zw[k] = 0.0;
+	for (size_t i = 0; i < d->num_parents; i++)
+		for (size_t k = 0; k < n; k++)
+			zw[k] += d->weights[i] * d->order[i]->z[k].f;
+	for (size_t i = 0; i < n; i++) {
+		yw[i] = 0.0;
+		for (size_t k = 0; k <= i; k++)
+			yw[i] += d->cholesky[i * n + k] * zw[k];
+	}
+	for (size_t k = 0; k < n; k++) {
+		d->mean[k] += d->sigma * yw[k];
+		d->mean[k] = d->mean[k] < 0.0 ? 0.0 :
+			     d->mean[k] > 1.0 ? 1.0 :
+						d->mean[k];
+	}
+
+	/* evolution paths */
+	norm = 0.0;
+	for (size_t k = 0; k < n; k++) {
+		d->path_sigma[k] = (1.0 - d->cs) * d->path_sigma[k] +
+				   sqrt(d->cs * (2.0 - d->cs) * d->mueff) *
+					   zw[k];
+		norm += d->path_sigma[k] * d->path_sigma[k];
+	}
+	norm = sqrt(norm);
+	hsig = norm / sqrt(1.0 - pow(1.0 - d->cs, 2.0 * (d->generation + 1)));
+	hsig = hsig / d->chi_n < 1.4 + 2.0 / (n + 1.0) ? 1.0 : 0.0;
+	for (size_t k = 0; k < n; k++)
+		d->path_c[k] = (1.0 - d->cc) * d->path_c[k] +
+			       hsig * sqrt(d->cc * (2.0 - d->cc) * d->mueff) *
+				       yw[k];
+
+	/* rank-one and rank-mu updates of the covariance */
+	c1a = d->c1 * (1.0 - (1.0 - hsig) * d->cc * (2.0 - d->cc));
+	for (size_t i = 0; i < n * n; i++)
+		d->covariance[i] *= 1.0 - c1a - d->cmu;
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j <= i; j++)
+			d->covariance[i * n + j] +=
+				d->c1 * d->path_c[i] * d->path_c[j];
+	for (size_t p = 0; p < d->num_parents; p++) {
+		_ccs_cma_es_transform(d, d->order[p]->z, y);
+		for (size_t i = 0; i < n; i++)
+			for (size_t j = 0; j <= i; j++)
+				d->covariance[i * n + j] +=
+					d->cmu * d->weights[p] * y[i] * y[j];
+	}
+	for (size_t i = 0; i < n; i++)
+		for (size_t j = 0; j < i; j++)
+			d->covariance[j * n + i] = d->covariance[i * n + j];
+	if (!_ccs_cma_es_cholesky(n, d->covariance, d->cholesky))
+		_ccs_cma_es_reset_covariance(d);
+
+	/* step size */
+	d->sigma *= exp((d->cs / d->damps) * (norm / d->chi_n - 1.0));
+	if (!isfinite(d->sigma) || d->sigma > CMA_ES_MAX_SIGMA)
+		d->sigma = CMA_ES_MAX_SIGMA;
+}
+
+/* Called once the population of the current generation has been evaluated.
+ * Offspring of the generation that are still pending can't be used anymore
+ * by the new generation and are discarded. */
+static ccs_result_t
+_ccs_cma_es_next_generation(_ccs_cma_es_tuner_data_t *d)
+{
+	ccs_result_t err;
+	err = _ccs_cma_es_rank(d);
+	if (!err) {
+		_ccs_cma_es_update_discretes(d, d->order[0]->configuration);
+		if (d->dimension)
+			_ccs_cma_es_update_strategy(d);
+	}
+	for (size_t i = 0; i < d->num_selected; i++) {
+		ccs_release_object(CMA_ES_SELECTED(d, i)->configuration);
+		ccs_release_object(CMA_ES_SELECTED(d, i)->evaluation);
+	}
+	d->num_selected = 0;
+	d->generation++;
+	for (size_t i = utarray_len(d->pending); i > 0; i--) {
+		_ccs_cma_es_individual_t *ind =
+			(_ccs_cma_es_individual_t *)utarray_eltptr(
+				d->pending, i - 1);
+		if (ind->generation < d->generation) {
+			ccs_release_object(ind->configuration);
+			utarray_erase(d->pending, i - 1, 1);
+		}
+	}
+	return err;
+}
+
+/* Evaluations of configurations that were not returned by the tuner, or that
+ * were already reported, only contribute to the history and optima. */
+static ccs_result_t
+_ccs_cma_es_report(
+	_ccs_cma_es_tuner_data_t *d,
+	ccs_evaluation_t          evaluation,
+	ccs_evaluation_result_t   result)
+{
+	ccs_configuration_t configuration = evaluation->data->configuration;
+	_ccs_cma_es_individual_t *ind     = NULL;
+	size_t                    index   = 0;
+	while ((ind = (_ccs_cma_es_individual_t *)utarray_next(
+			d->pending, ind))) {
+		if (ind->configuration == configuration)
+			break;
+		index++;
+	}
+	if (!ind)
+		return CCS_RESULT_SUCCESS;
+	if (result || ind->generation != d->generation) {
+		ccs_release_object(ind->configuration);
+		utarray_erase(d->pending, index, 1);
+		return CCS_RESULT_SUCCESS;
+	}
+	ccs_retain_object(evaluation);
+	ind->evaluation = evaluation;
+	memcpy(CMA_ES_SELECTED(d, d->num_selected), ind, d->individual_size);
+	utarray_erase(d->pending, index, 1);
+	if (++d->num_selected == d->population_size)
+		CCS_VALIDATE(_ccs_cma_es_next_generation(d));
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Without optima, the suggested configuration is the mean of the search
+ * distribution, if it is valid. */
+static ccs_result_t
+_ccs_cma_es_suggest_mean(
+	_ccs_cma_es_tuner_data_t *d,
+	ccs_configuration_t      *configuration)
+{
+	ccs_configuration_space_t configuration_space;
+	ccs_configuration_t       config;
+	ccs_result_t              err;
+	ccs_bool_t                found;
+	configuration_space = d->common_data.configuration_space;
+	CCS_VALIDATE(ccs_create_configuration(
+		configuration_space, 0, NULL, &config));
+	_ccs_cma_es_fill(d, NULL, NULL, config->data->values);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		_ccs_configuration_space_set_actives(
+			configuration_space, config->data->values),
+		errc);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		_ccs_configuration_space_test_forbidden(
+			configuration_space, config->data->values, &found),
+		errc);
+	if (found) {
+		*configuration = config;
+		return CCS_RESULT_SUCCESS;
+	}
+	ccs_release_object(config);
+	CCS_VALIDATE(ccs_configuration_space_sample(
+		configuration_space, configuration));
+	return CCS_RESULT_SUCCESS;
+errc:
+	ccs_release_object(config);
+	return err;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+static ccs_result_t
+_ccs_tuner_cma_es_tell(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations)
+{
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	UT_array                 *history = d->history;
+	ccs_result_t              err;
+	for (size_t i = 0; i < num_evaluations; i++) {
+		ccs_evaluation_result_t result;
+		CCS_VALIDATE(
+			ccs_evaluation_get_result(evaluations[i], &result));
+		if (!result) {
+			int       discard = 0;
+			UT_array *tmp;
+			ccs_retain_object(evaluations[i]);
+			utarray_push_back(history, evaluations + i);
+			tmp           = d->old_optima;
+			d->old_optima = d->optima;
+			d->optima     = tmp;
+			utarray_clear(d->optima);
+			ccs_evaluation_t *eval = NULL;
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		d->optima = d->old_optima;                                     \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+			while ((eval = (ccs_evaluation_t *)utarray_next(
+					d->old_optima, eval))) {
+				if (!discard) {
+					ccs_comparison_t cmp;
+					err = ccs_evaluation_compare(
+						evaluations[i], *eval, &cmp);
+					if (err)
+						discard = 1;
+					else
+						switch (cmp) {
+						case CCS_COMPARISON_EQUIVALENT:
+						case CCS_COMPARISON_WORSE:
+							discard = 1;
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						case CCS_COMPARISON_BETTER:
+							break;
+						case CCS_COMPARISON_NOT_COMPARABLE:
+						default:
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						}
+				} else {
+					utarray_push_back(d->optima, eval);
+				}
+			}
+			if (!discard)
+				utarray_push_back(d->optima, evaluations + i);
+		}
+		CCS_VALIDATE(_ccs_cma_es_report(d, evaluations[i], result));
+	}
+	return CCS_RESULT_SUCCESS;
+}
+static ccs_result_t
+_ccs_tuner_cma_es_get_optima(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	size_t                    count = utarray_len(d->optima);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->optima, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_cma_es_get_history(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	size_t                    count = utarray_len(d->history);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->history, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_cma_es_suggest(
+	ccs_tuner_t          tuner,
+	ccs_configuration_t *configuration)
+{
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	size_t                    count = utarray_len(d->optima);
+	if (count > 0) {
+		ccs_rng_t         rng;
+		unsigned long int indx;
+		CCS_VALIDATE(ccs_configuration_space_get_rng(
+			d->common_data.configuration_space, &rng));
+		CCS_VALIDATE(ccs_rng_get(rng, &indx));
+		indx = indx % count;
+		ccs_evaluation_t *eval =
+			(ccs_evaluation_t *)utarray_eltptr(d->optima, indx);
+		CCS_VALIDATE(
+			ccs_evaluation_get_configuration(*eval, configuration));
+		CCS_VALIDATE(ccs_retain_object(*configuration));
+	} else
+		CCS_VALIDATE(_ccs_cma_es_suggest_mean(d, configuration));
+	return CCS_RESULT_SUCCESS;
+}
+
+static _ccs_tuner_ops_t _ccs_tuner_cma_es_ops = {
+	{&_ccs_tuner_cma_es_del, &_ccs_tuner_cma_es_serialize_size,
+	 &_ccs_tuner_cma_es_serialize},
+	&_ccs_tuner_cma_es_ask,
+	&_ccs_tuner_cma_es_tell,
+	&_ccs_tuner_cma_es_get_optima,
+	&_ccs_tuner_cma_es_get_history,
+	&_ccs_tuner_cma_es_suggest};
+
+static const UT_icd _evaluation_icd = {
+	sizeof(ccs_evaluation_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+static ccs_result_t
+_ccs_cma_es_parameter_init_numerical(
+	ccs_configuration_space_t configuration_space,
+	size_t                    index,
+	_ccs_cma_es_parameter_t  *p,
+	ccs_float_t              *mean)
+{
+	ccs_distribution_t      distribution;
+	ccs_distribution_type_t distribution_type;
+	ccs_scale_type_t        scale_type = CCS_SCALE_TYPE_LINEAR;
+	ccs_datum_t             default_value;
+	ccs_float_t             x;
+	size_t                  dindex;
+	CCS_VALIDATE(ccs_numerical_parameter_get_properties(
+		p->parameter, &p->data_type, &p->value_lower, &p->value_upper,
+		&p->quantization));
+	if (p->data_type == CCS_NUMERIC_TYPE_FLOAT) {
+		p->lower = p->value_lower.f;
+		p->upper = p->value_upper.f;
+	} else {
+		p->lower = (ccs_float_t)p->value_lower.i;
+		p->upper = (ccs_float_t)p->value_upper.i;
+	}
+	CCS_VALIDATE(ccs_configuration_space_get_parameter_distribution(
+		configuration_space, index, &distribution, &dindex));
+	CCS_VALIDATE(
+		ccs_distribution_get_type(distribution, &distribution_type));
+	if (distribution_type == CCS_DISTRIBUTION_TYPE_UNIFORM)
+		CCS_VALIDATE(ccs_uniform_distribution_get_properties(
+			distribution, NULL, NULL, &scale_type, NULL));
+	else if (distribution_type == CCS_DISTRIBUTION_TYPE_NORMAL)
+		CCS_VALIDATE(ccs_normal_distribution_get_properties(
+			distribution, NULL, NULL, &scale_type, NULL));
+	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC && p->lower > 0.0) {
+		p->log   = CCS_TRUE;
+		p->lower = log(p->lower);
+		p->upper = log(p->upper);
+	}
+	/* the search starts from the default value, integers are centered in
+	 * their quantization step */
+	CCS_VALIDATE(
+		ccs_parameter_get_default_value(p->parameter, &default_value));
+	if (p->data_type == CCS_NUMERIC_TYPE_FLOAT)
+		x = default_value.value.f;
+	else
+		x = (ccs_float_t)default_value.value.i +
+		    0.5 * (p->quantization.i ? p->quantization.i : 1);
+	if (p->log)
+		x = log(x);
+	x     = (x - p->lower) / (p->upper - p->lower);
+	*mean = x < 0.0 ? 0.0 : x > 1.0 ? 1.0 : x;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_cma_es_parameter_init_discrete(_ccs_cma_es_parameter_t *p)
+{
+	ccs_result_t   err = CCS_RESULT_SUCCESS;
+	ccs_interval_t interval;
+	ccs_numeric_t *indexes;
+	ccs_datum_t    default_value;
+	CCS_VALIDATE(ccs_parameter_sampling_interval(p->parameter, &interval));
+	CCS_VALIDATE(
+		ccs_parameter_get_default_value(p->parameter, &default_value));
+	p->num_values = (size_t)interval.upper.i;
+	p->values =
+		(ccs_datum_t *)malloc(p->num_values * sizeof(ccs_datum_t));
+	CCS_REFUTE(!p->values, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	indexes = (ccs_numeric_t *)malloc(
+		p->num_values * sizeof(ccs_numeric_t));
+	CCS_REFUTE(!indexes, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	for (size_t i = 0; i < p->num_values; i++)
+		indexes[i].i = (ccs_int_t)i;
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_parameter_convert_samples(
+			p->parameter, CCS_FALSE, p->num_values, indexes,
+			p->values),
+		end);
+	for (size_t i = 0; i < p->num_values; i++)
+		if (!_datum_cmp(p->values + i, &default_value)) {
+			p->current = i;
+			break;
+		}
+end:
+	free(indexes);
+	return err;
+}
+
+static ccs_result_t
+_ccs_cma_es_create_normal(_ccs_cma_es_tuner_data_t *d)
+{
+	ccs_result_t        err = CCS_RESULT_SUCCESS;
+	ccs_distribution_t *normals;
+	size_t              i;
+	normals = (ccs_distribution_t *)malloc(
+		d->dimension * sizeof(ccs_distribution_t));
+	CCS_REFUTE(!normals, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	for (i = 0; i < d->dimension; i++)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_create_normal_float_distribution(
+				0.0, 1.0, CCS_SCALE_TYPE_LINEAR, 0.0,
+				normals + i),
+			end);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_create_multivariate_distribution(
+			d->dimension, normals, &d->normal),
+		end);
+end:
+	while (i--)
+		ccs_release_object(normals[i]);
+	free(normals);
+	return err;
+}
+
+static void
+_ccs_cma_es_strategy_init(_ccs_cma_es_tuner_data_t *d)
+{
+	ccs_float_t n   = (ccs_float_t)d->dimension;
+	ccs_float_t mu  = (ccs_float_t)d->num_parents;
+	ccs_float_t sum = 0.0, sum_sq = 0.0;
+	for (size_t i = 0; i < d->num_parents; i++) {
+		d->weights[i] = log(mu + 0.5) - log(i + 1.0);
+		sum += d->weights[i];
+	}
+	for (size_t i = 0; i < d->num_parents; i++) {
+		d->weights[i] /= sum;
+		sum_sq += d->weights[i] * d->weights[i];
+	}
+	d->mueff = 1.0 / sum_sq;
+	if (!d->dimension)
+		return;
+	d->cc  = (4.0 + d->mueff / n) / (n + 4.0 + 2.0 * d->mueff / n);
+	d->cs  = (d->mueff + 2.0) / (n + d->mueff + 5.0);
+	d->c1  = 2.0 / ((n + 1.3) * (n + 1.3) + d->mueff);
+	d->cmu = 2.0 * (d->mueff - 2.0 + 1.0 / d->mueff) /
+		 ((n + 2.0) * (n + 2.0) + d->mueff);
+	if (d->cmu > 1.0 - d->c1)
+		d->cmu = 1.0 - d->c1;
+	d->damps = 1.0 + d->cs +
+		   2.0 * fmax(0.0, sqrt((d->mueff - 1.0) / (n + 1.0)) - 1.0);
+	d->chi_n = sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+	d->sigma = d->initial_sigma;
+	_ccs_cma_es_reset_covariance(d);
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, arrays,           \
+			"Out of memory to allocate array");                    \
+	}
+ccs_result_t
+ccs_create_cma_es_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	size_t                    population_size,
+	ccs_float_t               sigma,
+	ccs_tuner_t              *tuner_ret)
+{
+	CCS_CHECK_PTR(name);
+	CCS_CHECK_OBJ(configuration_space, CCS_OBJECT_TYPE_CONFIGURATION_SPACE);
+	CCS_CHECK_OBJ(objective_space, CCS_OBJECT_TYPE_OBJECTIVE_SPACE);
+	CCS_CHECK_PTR(tuner_ret);
+	CCS_REFUTE(population_size == 1, CCS_RESULT_ERROR_INVALID_VALUE);
+	CCS_REFUTE(
+		!(sigma >= 0.0 && sigma <= CMA_ES_MAX_SIGMA),
+		CCS_RESULT_ERROR_INVALID_VALUE);
+
+	size_t num_parameters, dimension = 0;
+	CCS_VALIDATE(ccs_configuration_space_get_num_parameters(
+		configuration_space, &num_parameters));
+	for (size_t i = 0; i < num_parameters; i++) {
+		ccs_parameter_t      parameter;
+		ccs_parameter_type_t type;
+		CCS_VALIDATE(ccs_configuration_space_get_parameter(
+			configuration_space, i, &parameter));
+		CCS_VALIDATE(ccs_parameter_get_type(parameter, &type));
+		CCS_REFUTE_MSG(
+			type == CCS_PARAMETER_TYPE_STRING,
+			CCS_RESULT_ERROR_INVALID_PARAMETER,
+			"Unsupported parameter type: %d", type);
+		if (type == CCS_PARAMETER_TYPE_NUMERICAL)
+			dimension++;
+	}
+	if (!population_size)
+		population_size =
+			4 + (size_t)floor(
+				    3.0 * log(dimension ? dimension : 1.0));
+	size_t individual_size = sizeof(_ccs_cma_es_individual_t) +
+				 dimension * sizeof(ccs_numeric_t);
+	size_t num_parents = population_size / 2;
+	uintptr_t mem = (uintptr_t)calloc(
+		1, sizeof(struct _ccs_tuner_s) +
+			   sizeof(struct _ccs_cma_es_tuner_data_s) +
+			   num_parameters * sizeof(_ccs_cma_es_parameter_t) +
+			   population_size * individual_size +
+			   population_size *
+				   sizeof(_ccs_cma_es_individual_t *) +
+			   (num_parents + 6 * dimension +
+			    2 * dimension * dimension) *
+				   sizeof(ccs_float_t) +
+			   strlen(name) + 1);
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	uintptr_t                 mem_cur = mem;
+	ccs_tuner_t               tun;
+	_ccs_cma_es_tuner_data_t *data;
+	ccs_result_t              err;
+	UT_icd                    individual_icd = {
+		individual_size,
+		NULL,
+		NULL,
+		NULL,
+	};
+	tun = (ccs_tuner_t)mem_cur;
+	mem_cur += sizeof(struct _ccs_tuner_s);
+	data = (_ccs_cma_es_tuner_data_t *)mem_cur;
+	mem_cur += sizeof(struct _ccs_cma_es_tuner_data_s);
+	data->parameters = (_ccs_cma_es_parameter_t *)mem_cur;
+	mem_cur += num_parameters * sizeof(_ccs_cma_es_parameter_t);
+	data->selected = (char *)mem_cur;
+	mem_cur += population_size * individual_size;
+	data->order = (_ccs_cma_es_individual_t **)mem_cur;
+	mem_cur += population_size * sizeof(_ccs_cma_es_individual_t *);
+	data->weights = (ccs_float_t *)mem_cur;
+	mem_cur += num_parents * sizeof(ccs_float_t);
+	data->mean = (ccs_float_t *)mem_cur;
+	mem_cur += dimension * sizeof(ccs_float_t);
+	data->path_sigma = (ccs_float_t *)mem_cur;
+	mem_cur += dimension * sizeof(ccs_float_t);
+	data->path_c = (ccs_float_t *)mem_cur;
+	mem_cur += dimension * sizeof(ccs_float_t);
+	data->work = (ccs_float_t *)mem_cur;
+	mem_cur += 3 * dimension * sizeof(ccs_float_t);
+	data->covariance = (ccs_float_t *)mem_cur;
+	mem_cur += dimension * dimension * sizeof(ccs_float_t);
+	data->cholesky = (ccs_float_t *)mem_cur;
+	mem_cur += dimension * dimension * sizeof(ccs_float_t);
+	data->common_data.name = (const char *)mem_cur;
+	data->num_parameters   = num_parameters;
+	data->dimension        = dimension;
+	data->population_size  = population_size;
+	data->num_parents      = num_parents;
+	data->individual_size  = individual_size;
+	data->initial_sigma    = sigma > 0.0 ? sigma : CMA_ES_DEFAULT_SIGMA;
+
+	for (size_t i = 0, k = 0; i < num_parameters; i++) {
+		_ccs_cma_es_parameter_t *p = data->parameters + i;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_configuration_space_get_parameter(
+				configuration_space, i, &p->parameter),
+			parameters);
+		CCS_VALIDATE_ERR_GOTO(
+			err, ccs_parameter_get_type(p->parameter, &p->type),
+			parameters);
+		if (p->type == CCS_PARAMETER_TYPE_NUMERICAL) {
+			p->dimension = k++;
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_cma_es_parameter_init_numerical(
+					configuration_space, i, p,
+					data->mean + p->dimension),
+				parameters);
+		} else {
+			data->num_discretes++;
+			CCS_VALIDATE_ERR_GOTO(
+				err, _ccs_cma_es_parameter_init_discrete(p),
+				parameters);
+		}
+	}
+	_ccs_cma_es_strategy_init(data);
+	if (data->dimension)
+		CCS_VALIDATE_ERR_GOTO(
+			err, _ccs_cma_es_create_normal(data), parameters);
+
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(configuration_space), normal);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(objective_space), errconfigs);
+	_ccs_object_init(
+		&(tun->obj), CCS_OBJECT_TYPE_TUNER,
+		(_ccs_object_ops_t *)&_ccs_tuner_cma_es_ops);
+	tun->data              = (struct _ccs_tuner_data_s *)data;
+	data->common_data.type = CCS_TUNER_TYPE_CMA_ES;
+	data->common_data.configuration_space = configuration_space;
+	data->common_data.objective_space     = objective_space;
+	utarray_new(data->history, &_evaluation_icd);
+	utarray_new(data->optima, &_evaluation_icd);
+	utarray_new(data->old_optima, &_evaluation_icd);
+	utarray_new(data->pending, &individual_icd);
+	strcpy((char *)data->common_data.name, name);
+	*tuner_ret = tun;
+	return CCS_RESULT_SUCCESS;
+
+arrays:
+	if (data->history)
+		utarray_free(data->history);
+	if (data->optima)
+		utarray_free(data->optima);
+	if (data->old_optima)
+		utarray_free(data->old_optima);
+	if (data->pending)
+		utarray_free(data->pending);
+	ccs_release_object(objective_space);
+errconfigs:
+	ccs_release_object(configuration_space);
+normal:
+	if (data->normal)
+		ccs_release_object(data->normal);
+parameters:
+	_ccs_cma_es_parameters_fini(num_parameters, data->parameters);
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_cma_es_tuner_get_properties(
+	ccs_tuner_t  tuner,
+	size_t      *population_size_ret,
+	ccs_float_t *sigma_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_TUNER);
+	_ccs_cma_es_tuner_data_t *d = (_ccs_cma_es_tuner_data_t *)tuner->data;
+	CCS_REFUTE(
+		d->common_data.type != CCS_TUNER_TYPE_CMA_ES,
+		CCS_RESULT_ERROR_INVALID_TUNER);
+	CCS_REFUTE(
+		!population_size_ret && !sigma_ret,
+		CCS_RESULT_ERROR_INVALID_VALUE);
+	if (population_size_ret)
+		*population_size_ret = d->population_size;
+	if (sigma_ret)
+		*sigma_ret = d->initial_sigma;
+	return CCS_RESULT_SUCCESS;
+}
@@ -149,6 +149,208 @@ end:
 
 #undef utarray_oom
 
+/* TPE tuners share the random tuner serialization format, the model is
+ * rebuilt by reporting the history to the new tuner. */
+static inline ccs_result_t
+_ccs_deserialize_bin_tpe_tuner(
+	ccs_tuner_t                       *tuner_ret,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	_ccs_random_tuner_data_mock_t data = {
+		{(ccs_tuner_type_t)0, NULL, NULL, NULL}, 0, 0, NULL, NULL};
+	ccs_result_t res = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		_ccs_deserialize_bin_ccs_random_tuner_data(
+			&data, version, buffer_size, buffer, opts),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_create_tpe_tuner(
+			data.common_data.name,
+			data.common_data.configuration_space,
+			data.common_data.objective_space, tuner_ret),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_tuner_tell(*tuner_ret, data.size_history, data.history),
+		tuner);
+	goto end;
+tuner:
+	ccs_release_object(*tuner_ret);
+	*tuner_ret = NULL;
+end:
+	if (data.common_data.configuration_space)
+		ccs_release_object(data.common_data.configuration_space);
+	if (data.common_data.objective_space)
+		ccs_release_object(data.common_data.objective_space);
+	if (data.history) {
+		for (size_t i = 0; i < data.size_history; i++)
+			if (data.history[i])
+				ccs_release_object(data.history[i]);
+		free(data.history);
+	}
+	return res;
+}
+
+struct _ccs_hyperband_tuner_data_mock_s {
+	_ccs_random_tuner_data_mock_t base_data;
+	size_t                        fidelity_index;
+	ccs_float_t                   eta;
+};
+typedef struct _ccs_hyperband_tuner_data_mock_s
+	_ccs_hyperband_tuner_data_mock_t;
+
+static inline ccs_result_t
+_ccs_deserialize_bin_ccs_hyperband_tuner_data(
+	_ccs_hyperband_tuner_data_mock_t  *data,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_random_tuner_data(
+		&data->base_data, version, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_deserialize_bin_size(
+		&data->fidelity_index, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_float(
+		&data->eta, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Brackets in progress are not serialized, the history is reported to the
+ * new tuner to restore the optima. */
+static inline ccs_result_t
+_ccs_deserialize_bin_hyperband_tuner(
+	ccs_tuner_t                       *tuner_ret,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	_ccs_hyperband_tuner_data_mock_t data = {
+		{{(ccs_tuner_type_t)0, NULL, NULL, NULL}, 0, 0, NULL, NULL},
+		0,
+		0.0};
+	ccs_result_t res = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		_ccs_deserialize_bin_ccs_hyperband_tuner_data(
+			&data, version, buffer_size, buffer, opts),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_create_hyperband_tuner(
+			data.base_data.common_data.name,
+			data.base_data.common_data.configuration_space,
+			data.base_data.common_data.objective_space,
+			data.fidelity_index, data.eta, tuner_ret),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_tuner_tell(
+			*tuner_ret, data.base_data.size_history,
+			data.base_data.history),
+		tuner);
+	goto end;
+tuner:
+	ccs_release_object(*tuner_ret);
+	*tuner_ret = NULL;
+end:
+	if (data.base_data.common_data.configuration_space)
+		ccs_release_object(
+			data.base_data.common_data.configuration_space);
+	if (data.base_data.common_data.objective_space)
+		ccs_release_object(data.base_data.common_data.objective_space);
+	if (data.base_data.history) {
+		for (size_t i = 0; i < data.base_data.size_history; i++)
+			if (data.base_data.history[i])
+				ccs_release_object(data.base_data.history[i]);
+		free(data.base_data.history);
+	}
+	return res;
+}
+
+struct _ccs_cma_es_tuner_data_mock_s {
+	_ccs_random_tuner_data_mock_t base_data;
+	size_t                        population_size;
+	ccs_float_t                   sigma;
+};
+typedef struct _ccs_cma_es_tuner_data_mock_s _ccs_cma_es_tuner_data_mock_t;
+
+static inline ccs_result_t
+_ccs_deserialize_bin_ccs_cma_es_tuner_data(
+	_ccs_cma_es_tuner_data_mock_t     *data,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_random_tuner_data(
+		&data->base_data, version, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_deserialize_bin_size(
+		&data->population_size, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_deserialize_bin_ccs_float(
+		&data->sigma, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+/* The state of the evolution strategy is not serialized, the history is
+ * reported to the new tuner to restore the optima. */
+static inline ccs_result_t
+_ccs_deserialize_bin_cma_es_tuner(
+	ccs_tuner_t                       *tuner_ret,
+	uint32_t                           version,
+	size_t                            *buffer_size,
+	const char                       **buffer,
+	_ccs_object_deserialize_options_t *opts)
+{
+	_ccs_cma_es_tuner_data_mock_t data = {
+		{{(ccs_tuner_type_t)0, NULL, NULL, NULL}, 0, 0, NULL, NULL},
+		0,
+		0.0};
+	ccs_result_t res = CCS_RESULT_SUCCESS;
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		_ccs_deserialize_bin_ccs_cma_es_tuner_data(
+			&data, version, buffer_size, buffer, opts),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_create_cma_es_tuner(
+			data.base_data.common_data.name,
+			data.base_data.common_data.configuration_space,
+			data.base_data.common_data.objective_space,
+			data.population_size, data.sigma, tuner_ret),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		res,
+		ccs_tuner_tell(
+			*tuner_ret, data.base_data.size_history,
+			data.base_data.history),
+		tuner);
+	goto end;
+tuner:
+	ccs_release_object(*tuner_ret);
+	*tuner_ret = NULL;
+end:
+	if (data.base_data.common_data.configuration_space)
+		ccs_release_object(
+			data.base_data.common_data.configuration_space);
+	if (data.base_data.common_data.objective_space)
+		ccs_release_object(data.base_data.common_data.objective_space);
+	if (data.base_data.history) {
+		for (size_t i = 0; i < data.base_data.size_history; i++)
+			if (data.base_data.history[i])
+				ccs_release_object(data.base_data.history[i]);
+		free(data.base_data.history);
+	}
+	return res;
+}
+
 struct _ccs_user_defined_tuner_data_mock_s {
 	_ccs_random_tuner_data_mock_t base_data;
 	_ccs_blob_t                   blob;
@@ -269,6 +471,30 @@ _ccs_deserialize_bin_tuner(
 				&new_opts),
 			end);
 		break;
+	case CCS_TUNER_TYPE_TPE:
+		CCS_VALIDATE_ERR_GOTO(
+			res,
+			_ccs_deserialize_bin_tpe_tuner(
+				tuner_ret, version, buffer_size, buffer,
+				&new_opts),
+			end);
+		break;
+	case CCS_TUNER_TYPE_HYPERBAND:
+		CCS_VALIDATE_ERR_GOTO(
+			res,
+			_ccs_deserialize_bin_hyperband_tuner(
+				tuner_ret, version, buffer_size, buffer,
+				&new_opts),
+			end);
+		break;
+	case CCS_TUNER_TYPE_CMA_ES:
+		CCS_VALIDATE_ERR_GOTO(
+			res,
+			_ccs_deserialize_bin_cma_es_tuner(
+				tuner_ret, version, buffer_size, buffer,
+				&new_opts),
+			end);
+		break;
 	case CCS_TUNER_TYPE_USER_DEFINED:
 		CCS_VALIDATE_ERR_GOTO(
 			res,
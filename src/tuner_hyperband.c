@@ -0,0 +1,922 @@
+#include "cconfigspace_internal.h"
+#include "tuner_internal.h"
+#include "evaluation_internal.h"
+#include "configuration_internal.h"
+#include <math.h>
+#include <string.h>
+
+#include "utarray.h"
+#include "utlist.h"
+
+/* Hyperband runs successive halving brackets of decreasing aggressiveness.
+ * Bracket s starts configurations at max_budget * eta^-s, and once every
+ * configuration of a rung has been reported, the best 1/eta of them are
+ * promoted to the next rung with a budget multiplied by eta, until the
+ * maximum budget is reached. Brackets are run concurrently when
+ * configurations are asked before the pending rungs are complete. */
+struct _ccs_hyperband_entry_s {
+	ccs_configuration_t configuration;
+	ccs_evaluation_t    evaluation;
+	size_t              rank;
+	size_t              index;
+};
+typedef struct _ccs_hyperband_entry_s _ccs_hyperband_entry_t;
+
+struct _ccs_hyperband_bracket_s;
+typedef struct _ccs_hyperband_bracket_s _ccs_hyperband_bracket_t;
+
+struct _ccs_hyperband_bracket_s {
+	size_t                    bracket;
+	size_t                    rung;
+	size_t                    num_entries;
+	size_t                    num_asked;
+	size_t                    num_told;
+	_ccs_hyperband_entry_t   *entries;
+	_ccs_hyperband_bracket_t *prev;
+	_ccs_hyperband_bracket_t *next;
+};
+
+struct _ccs_hyperband_tuner_data_s {
+	_ccs_tuner_common_data_t  common_data;
+	UT_array                 *history;
+	UT_array                 *optima;
+	UT_array                 *old_optima;
+	size_t                    fidelity_index;
+	ccs_float_t               eta;
+	ccs_numeric_type_t        fidelity_type;
+	ccs_float_t               min_budget;
+	ccs_float_t               max_budget;
+	ccs_float_t               quantization;
+	size_t                    num_brackets;
+	size_t                    next_bracket;
+	_ccs_hyperband_bracket_t *brackets;
+};
+typedef struct _ccs_hyperband_tuner_data_s _ccs_hyperband_tuner_data_t;
+
+static void
+_ccs_hyperband_bracket_del(_ccs_hyperband_bracket_t *b)
+{
+	for (size_t i = 0; i < b->num_entries; i++) {
+		if (b->entries[i].configuration)
+			ccs_release_object(b->entries[i].configuration);
+		if (b->entries[i].evaluation)
+			ccs_release_object(b->entries[i].evaluation);
+	}
+	free(b);
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_del(ccs_object_t o)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)((ccs_tuner_t)o)->data;
+	_ccs_hyperband_bracket_t *b, *tmp;
+	DL_FOREACH_SAFE(d->brackets, b, tmp)
+	{
+		DL_DELETE(d->brackets, b);
+		_ccs_hyperband_bracket_del(b);
+	}
+	ccs_release_object(d->common_data.configuration_space);
+	ccs_release_object(d->common_data.objective_space);
+	ccs_evaluation_t *e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(d->history, e)))
+		ccs_release_object(*e);
+	utarray_free(d->history);
+	utarray_free(d->optima);
+	utarray_free(d->old_optima);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_hyperband_tuner_data(
+	_ccs_hyperband_tuner_data_t     *data,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tuner_common_data(
+		&data->common_data, cum_size, opts));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->history));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->optima));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize_size(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, cum_size, opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		*cum_size += _ccs_serialize_bin_size_ccs_object(*e);
+	*cum_size += _ccs_serialize_bin_size_size(data->fidelity_index);
+	*cum_size += _ccs_serialize_bin_size_ccs_float(data->eta);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_hyperband_tuner_data(
+	_ccs_hyperband_tuner_data_t     *data,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tuner_common_data(
+		&data->common_data, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->history), buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->optima), buffer_size, buffer));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, buffer_size, buffer,
+			opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		CCS_VALIDATE(
+			_ccs_serialize_bin_ccs_object(*e, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		data->fidelity_index, buffer_size, buffer));
+	CCS_VALIDATE(
+		_ccs_serialize_bin_ccs_float(data->eta, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_hyperband_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_hyperband_tuner_data_t *data =
+		(_ccs_hyperband_tuner_data_t *)(tuner->data);
+	*cum_size += _ccs_serialize_bin_size_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner);
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_hyperband_tuner_data(
+		data, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_hyperband_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_hyperband_tuner_data_t *data =
+		(_ccs_hyperband_tuner_data_t *)(tuner->data);
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_hyperband_tuner_data(
+		data, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_serialize_size(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_size_ccs_hyperband_tuner(
+			(ccs_tuner_t)object, cum_size, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data_size(
+		object, format, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_serialize(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_ccs_hyperband_tuner(
+			(ccs_tuner_t)object, buffer_size, buffer, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data(
+		object, format, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_datum_t
+_ccs_hyperband_budget(
+	_ccs_hyperband_tuner_data_t *d,
+	size_t                       bracket,
+	size_t                       rung)
+{
+	ccs_float_t budget =
+		d->max_budget *
+		pow(d->eta, (ccs_float_t)rung - (ccs_float_t)bracket);
+	if (budget < d->min_budget)
+		budget = d->min_budget;
+	else if (budget > d->max_budget)
+		budget = d->max_budget;
+	/* the maximum budget is on the quantization grid of the fidelity */
+	if (d->quantization > 0.0) {
+		budget = d->min_budget +
+			 round((budget - d->min_budget) / d->quantization) *
+				 d->quantization;
+		if (budget > d->max_budget)
+			budget = d->max_budget;
+	}
+	if (d->fidelity_type == CCS_NUMERIC_TYPE_INT)
+		return ccs_int((ccs_int_t)round(budget));
+	return ccs_float(budget);
+}
+
+static inline size_t
+_ccs_hyperband_rung_size(
+	_ccs_hyperband_tuner_data_t *d,
+	size_t                       bracket,
+	size_t                       rung)
+{
+	ccs_float_t n = ceil(
+		(ccs_float_t)d->num_brackets / (bracket + 1) *
+			pow(d->eta, (ccs_float_t)bracket) -
+		1e-9);
+	n = floor(n * pow(d->eta, -(ccs_float_t)rung) + 1e-9);
+	return n < 1.0 ? 1 : (size_t)n;
+}
+
+static inline ccs_bool_t
+_ccs_hyperband_is_max_budget(
+	_ccs_hyperband_tuner_data_t *d,
+	ccs_configuration_t          configuration)
+{
+	ccs_datum_t budget;
+	if (configuration->data->num_values <= d->fidelity_index)
+		return CCS_FALSE;
+	budget = configuration->data->values[d->fidelity_index];
+	if (d->fidelity_type == CCS_NUMERIC_TYPE_INT)
+		return budget.type == CCS_DATA_TYPE_INT &&
+		       budget.value.i == (ccs_int_t)d->max_budget;
+	return budget.type == CCS_DATA_TYPE_FLOAT &&
+	       budget.value.f == d->max_budget;
+}
+
+/* Configurations are created from a copy of the values of a sampled or
+ * promoted configuration, with the fidelity set to the budget of their rung.
+ * The values are checked against the configuration space, which may have
+ * gained conditions or forbidden clauses since the tuner was created, and
+ * *configuration_ret is set to NULL if they are not valid. */
+static ccs_result_t
+_ccs_hyperband_create_configuration(
+	_ccs_hyperband_tuner_data_t *d,
+	ccs_configuration_t          configuration,
+	ccs_datum_t                  budget,
+	ccs_configuration_t         *configuration_ret)
+{
+	ccs_configuration_space_t configuration_space =
+		d->common_data.configuration_space;
+	size_t       num_values = configuration->data->num_values;
+	ccs_datum_t *values;
+	ccs_bool_t   is_valid;
+	ccs_result_t err   = CCS_RESULT_SUCCESS;
+	*configuration_ret = NULL;
+	values = (ccs_datum_t *)malloc(num_values * sizeof(ccs_datum_t));
+	CCS_REFUTE(!values, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	memcpy(values, configuration->data->values,
+	       num_values * sizeof(ccs_datum_t));
+	values[d->fidelity_index] = budget;
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_configuration_space_check_configuration_values(
+			configuration_space, num_values, values, &is_valid),
+		end);
+	if (is_valid)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_create_configuration(
+				configuration_space, num_values, values,
+				configuration_ret),
+			end);
+end:
+	free(values);
+	return err;
+}
+
+/* Samples a configuration of the configuration space at the given budget,
+ * retrying as the configuration space sampling routines do. */
+static ccs_result_t
+_ccs_hyperband_sample(
+	_ccs_hyperband_tuner_data_t *d,
+	ccs_datum_t                  budget,
+	ccs_configuration_t         *configuration_ret)
+{
+	ccs_configuration_t configuration = NULL;
+	ccs_result_t        err;
+	for (int counter = 0; !configuration && counter < 100; counter++) {
+		ccs_configuration_t sampled;
+		CCS_VALIDATE(ccs_configuration_space_sample(
+			d->common_data.configuration_space, &sampled));
+		err = _ccs_hyperband_create_configuration(
+			d, sampled, budget, &configuration);
+		ccs_release_object(sampled);
+		CCS_VALIDATE(err);
+	}
+	CCS_REFUTE(!configuration, CCS_RESULT_ERROR_SAMPLING_UNSUCCESSFUL);
+	*configuration_ret = configuration;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_hyperband_bracket_create(
+	_ccs_hyperband_tuner_data_t *d,
+	_ccs_hyperband_bracket_t   **bracket_ret)
+{
+	size_t                    s = d->next_bracket;
+	size_t                    n = _ccs_hyperband_rung_size(d, s, 0);
+	ccs_datum_t               budget = _ccs_hyperband_budget(d, s, 0);
+	_ccs_hyperband_bracket_t *b;
+	ccs_result_t              err;
+	b = (_ccs_hyperband_bracket_t *)calloc(
+		1, sizeof(_ccs_hyperband_bracket_t) +
+			   n * sizeof(_ccs_hyperband_entry_t));
+	CCS_REFUTE(!b, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	b->entries     = (_ccs_hyperband_entry_t *)(b + 1);
+	b->bracket     = s;
+	b->num_entries = n;
+	for (size_t i = 0; i < n; i++)
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_hyperband_sample(
+				d, budget, &b->entries[i].configuration),
+			errbracket);
+	d->next_bracket = s ? s - 1 : d->num_brackets - 1;
+	DL_APPEND(d->brackets, b);
+	*bracket_ret = b;
+	return CCS_RESULT_SUCCESS;
+errbracket:
+	_ccs_hyperband_bracket_del(b);
+	return err;
+}
+
+static int
+_ccs_hyperband_entry_sort(const void *a, const void *b)
+{
+	const _ccs_hyperband_entry_t *ea = (const _ccs_hyperband_entry_t *)a;
+	const _ccs_hyperband_entry_t *eb = (const _ccs_hyperband_entry_t *)b;
+	if (ea->rank != eb->rank)
+		return ea->rank < eb->rank ? -1 : 1;
+	return ea->index < eb->index ? -1 : ea->index > eb->index ? 1 : 0;
+}
+
+/* Called once every configuration of the current rung of a bracket has been
+ * reported. Entries are ranked by the number of entries of the rung
+ * reporting better objectives, failed evaluations being ranked last, and the
+ * best ones are promoted to the next rung. Entries that are no longer valid
+ * at the budget of the next rung are passed over. The bracket is removed
+ * once its last rung is complete, or if the promotion fails. */
+static ccs_result_t
+_ccs_hyperband_bracket_advance(
+	_ccs_hyperband_tuner_data_t *d,
+	_ccs_hyperband_bracket_t    *b)
+{
+	ccs_result_t           err = CCS_RESULT_SUCCESS;
+	size_t                 n, promoted = 0, count = b->num_entries;
+	ccs_datum_t            budget;
+	_ccs_hyperband_entry_t *entries = b->entries;
+	if (b->rung >= b->bracket)
+		goto remove;
+	for (size_t i = 0; i < count; i++) {
+		entries[i].index = i;
+		entries[i].rank  = 0;
+		if (entries[i].evaluation->data->result) {
+			entries[i].rank = count;
+			continue;
+		}
+		for (size_t j = 0; j < count; j++) {
+			ccs_comparison_t cmp;
+			if (j == i || entries[j].evaluation->data->result)
+				continue;
+			if (ccs_evaluation_compare(
+				    entries[j].evaluation,
+				    entries[i].evaluation,
+				    &cmp) == CCS_RESULT_SUCCESS &&
+			    cmp == CCS_COMPARISON_BETTER)
+				entries[i].rank++;
+		}
+	}
+	qsort(entries, count, sizeof(_ccs_hyperband_entry_t),
+	      &_ccs_hyperband_entry_sort);
+	n      = _ccs_hyperband_rung_size(d, b->bracket, b->rung + 1);
+	budget = _ccs_hyperband_budget(d, b->bracket, b->rung + 1);
+	for (size_t i = 0; i < count && promoted < n; i++) {
+		_ccs_hyperband_entry_t entry = entries[i];
+		ccs_configuration_t    configuration;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			_ccs_hyperband_create_configuration(
+				d, entry.configuration, budget, &configuration),
+			remove);
+		if (!configuration)
+			continue;
+		ccs_release_object(entry.configuration);
+		entry.configuration = configuration;
+		entries[i]          = entries[promoted];
+		entries[promoted++] = entry;
+	}
+	if (!promoted)
+		goto remove;
+	for (size_t i = 0; i < count; i++) {
+		ccs_release_object(entries[i].evaluation);
+		entries[i].evaluation = NULL;
+		if (i >= promoted) {
+			ccs_release_object(entries[i].configuration);
+			entries[i].configuration = NULL;
+		}
+	}
+	b->rung++;
+	b->num_entries = promoted;
+	b->num_asked   = 0;
+	b->num_told    = 0;
+	return CCS_RESULT_SUCCESS;
+remove:
+	DL_DELETE(d->brackets, b);
+	_ccs_hyperband_bracket_del(b);
+	return err;
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_ask(
+	ccs_tuner_t          tuner,
+	size_t               num_configurations,
+	ccs_configuration_t *configurations,
+	size_t              *num_configurations_ret)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	_ccs_hyperband_bracket_t *b;
+	size_t                    available = 0, count = 0;
+	if (!configurations) {
+		*num_configurations_ret = 1;
+		return CCS_RESULT_SUCCESS;
+	}
+	DL_FOREACH(d->brackets, b)
+	{
+		available += b->num_entries - b->num_asked;
+	}
+	while (available < num_configurations) {
+		CCS_VALIDATE(_ccs_hyperband_bracket_create(d, &b));
+		available += b->num_entries;
+	}
+	DL_FOREACH(d->brackets, b)
+	{
+		while (count < num_configurations &&
+		       b->num_asked < b->num_entries) {
+			configurations[count] =
+				b->entries[b->num_asked++].configuration;
+			ccs_retain_object(configurations[count]);
+			count++;
+		}
+		if (count == num_configurations)
+			break;
+	}
+	if (num_configurations_ret)
+		*num_configurations_ret = num_configurations;
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Evaluations of configurations that were not returned by the tuner, or that
+ * were already reported, only contribute to the history and optima. */
+static ccs_result_t
+_ccs_hyperband_report(
+	_ccs_hyperband_tuner_data_t *d,
+	ccs_evaluation_t             evaluation)
+{
+	ccs_configuration_t configuration = evaluation->data->configuration;
+	_ccs_hyperband_bracket_t *b;
+	DL_FOREACH(d->brackets, b)
+	{
+		for (size_t i = 0; i < b->num_asked; i++) {
+			_ccs_hyperband_entry_t *e = b->entries + i;
+			if (e->configuration != configuration || e->evaluation)
+				continue;
+			ccs_retain_object(evaluation);
+			e->evaluation = evaluation;
+			if (++b->num_told == b->num_entries)
+				CCS_VALIDATE(
+					_ccs_hyperband_bracket_advance(d, b));
+			return CCS_RESULT_SUCCESS;
+		}
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+static ccs_result_t
+_ccs_tuner_hyperband_tell(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	UT_array    *history = d->history;
+	ccs_result_t err;
+	for (size_t i = 0; i < num_evaluations; i++) {
+		ccs_evaluation_result_t result;
+		CCS_VALIDATE(
+			ccs_evaluation_get_result(evaluations[i], &result));
+		if (!result) {
+			ccs_retain_object(evaluations[i]);
+			utarray_push_back(history, evaluations + i);
+		}
+		/* only evaluations at the maximum budget are comparable */
+		if (!result &&
+		    _ccs_hyperband_is_max_budget(
+			    d, evaluations[i]->data->configuration)) {
+			int       discard = 0;
+			UT_array *tmp;
+			tmp           = d->old_optima;
+			d->old_optima = d->optima;
+			d->optima     = tmp;
+			utarray_clear(d->optima);
+			ccs_evaluation_t *eval = NULL;
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		d->optima = d->old_optima;                                     \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+			while ((eval = (ccs_evaluation_t *)utarray_next(
+					d->old_optima, eval))) {
+				if (!discard) {
+					ccs_comparison_t cmp;
+					err = ccs_evaluation_compare(
+						evaluations[i], *eval, &cmp);
+					if (err)
+						discard = 1;
+					else
+						switch (cmp) {
+						case CCS_COMPARISON_EQUIVALENT:
+						case CCS_COMPARISON_WORSE:
+							discard = 1;
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						case CCS_COMPARISON_BETTER:
+							break;
+						case CCS_COMPARISON_NOT_COMPARABLE:
+						default:
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						}
+				} else {
+					utarray_push_back(d->optima, eval);
+				}
+			}
+			if (!discard)
+				utarray_push_back(d->optima, evaluations + i);
+		}
+		CCS_VALIDATE(_ccs_hyperband_report(d, evaluations[i]));
+	}
+	return CCS_RESULT_SUCCESS;
+}
+static ccs_result_t
+_ccs_tuner_hyperband_get_optima(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->optima);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->optima, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_get_history(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->history);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->history, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_hyperband_suggest(
+	ccs_tuner_t          tuner,
+	ccs_configuration_t *configuration)
+{
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	size_t count = utarray_len(d->optima);
+	if (count > 0) {
+		ccs_rng_t         rng;
+		unsigned long int indx;
+		CCS_VALIDATE(ccs_configuration_space_get_rng(
+			d->common_data.configuration_space, &rng));
+		CCS_VALIDATE(ccs_rng_get(rng, &indx));
+		indx = indx % count;
+		ccs_evaluation_t *eval =
+			(ccs_evaluation_t *)utarray_eltptr(d->optima, indx);
+		CCS_VALIDATE(
+			ccs_evaluation_get_configuration(*eval, configuration));
+		CCS_VALIDATE(ccs_retain_object(*configuration));
+	} else {
+		CCS_VALIDATE(_ccs_hyperband_sample(
+			d, _ccs_hyperband_budget(d, 0, 0), configuration));
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static _ccs_tuner_ops_t _ccs_tuner_hyperband_ops = {
+	{&_ccs_tuner_hyperband_del, &_ccs_tuner_hyperband_serialize_size,
+	 &_ccs_tuner_hyperband_serialize},
+	&_ccs_tuner_hyperband_ask,
+	&_ccs_tuner_hyperband_tell,
+	&_ccs_tuner_hyperband_get_optima,
+	&_ccs_tuner_hyperband_get_history,
+	&_ccs_tuner_hyperband_suggest};
+
+static const UT_icd _evaluation_icd = {
+	sizeof(ccs_evaluation_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+/* The tuner sets the fidelity of the configurations it returns, so the
+ * fidelity must neither be conditional nor be referenced by the conditions
+ * or the forbidden clauses of the configuration space. */
+static ccs_result_t
+_ccs_hyperband_check_fidelity(
+	ccs_configuration_space_t configuration_space,
+	size_t                    fidelity_index,
+	ccs_parameter_t           fidelity)
+{
+	ccs_result_t      err = CCS_RESULT_SUCCESS;
+	size_t            num_conditions, num_forbidden_clauses, count;
+	size_t            num_parameters = 0;
+	ccs_expression_t *expressions    = NULL;
+	ccs_parameter_t  *parameters     = NULL;
+	ccs_expression_t  condition;
+	CCS_VALIDATE(ccs_configuration_space_get_condition(
+		configuration_space, fidelity_index, &condition));
+	CCS_REFUTE_MSG(
+		condition, CCS_RESULT_ERROR_INVALID_PARAMETER,
+		"The fidelity parameter must not be conditional");
+	CCS_VALIDATE(ccs_configuration_space_get_conditions(
+		configuration_space, 0, NULL, &num_conditions));
+	CCS_VALIDATE(ccs_configuration_space_get_forbidden_clauses(
+		configuration_space, 0, NULL, &num_forbidden_clauses));
+	count = num_conditions + num_forbidden_clauses;
+	if (!count)
+		return CCS_RESULT_SUCCESS;
+	expressions = (ccs_expression_t *)malloc(
+		count * sizeof(ccs_expression_t));
+	CCS_REFUTE(!expressions, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_configuration_space_get_conditions(
+			configuration_space, num_conditions, expressions,
+			NULL),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_configuration_space_get_forbidden_clauses(
+			configuration_space, num_forbidden_clauses,
+			expressions + num_conditions, NULL),
+		end);
+	for (size_t i = 0; i < count; i++) {
+		size_t           num;
+		ccs_parameter_t *tmp;
+		if (!expressions[i])
+			continue;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_expression_get_parameters(
+				expressions[i], 0, NULL, &num),
+			end);
+		if (num > num_parameters) {
+			tmp = (ccs_parameter_t *)realloc(
+				parameters, num * sizeof(ccs_parameter_t));
+			CCS_REFUTE_ERR_GOTO(
+				err, !tmp, CCS_RESULT_ERROR_OUT_OF_MEMORY, end);
+			parameters     = tmp;
+			num_parameters = num;
+		}
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_expression_get_parameters(
+				expressions[i], num, parameters, NULL),
+			end);
+		for (size_t j = 0; j < num; j++)
+			if (parameters[j] == fidelity)
+				CCS_RAISE_ERR_GOTO(
+					err, CCS_RESULT_ERROR_INVALID_PARAMETER,
+					end,
+					"The fidelity parameter must not be "
+					"constrained");
+	}
+end:
+	free(parameters);
+	free(expressions);
+	return err;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, arrays,           \
+			"Out of memory to allocate array");                    \
+	}
+ccs_result_t
+ccs_create_hyperband_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	size_t                    fidelity_index,
+	ccs_float_t               eta,
+	ccs_tuner_t              *tuner_ret)
+{
+	CCS_CHECK_PTR(name);
+	CCS_CHECK_OBJ(configuration_space, CCS_OBJECT_TYPE_CONFIGURATION_SPACE);
+	CCS_CHECK_OBJ(objective_space, CCS_OBJECT_TYPE_OBJECTIVE_SPACE);
+	CCS_CHECK_PTR(tuner_ret);
+	CCS_REFUTE(!(eta > 1.0), CCS_RESULT_ERROR_INVALID_VALUE);
+
+	ccs_parameter_t      fidelity;
+	ccs_parameter_type_t parameter_type;
+	ccs_numeric_type_t   fidelity_type;
+	ccs_numeric_t        lower, upper, q;
+	ccs_float_t          min_budget, max_budget, quantization;
+	CCS_VALIDATE(ccs_configuration_space_get_parameter(
+		configuration_space, fidelity_index, &fidelity));
+	CCS_VALIDATE(ccs_parameter_get_type(fidelity, &parameter_type));
+	CCS_REFUTE_MSG(
+		parameter_type != CCS_PARAMETER_TYPE_NUMERICAL,
+		CCS_RESULT_ERROR_INVALID_PARAMETER,
+		"The fidelity parameter must be numerical");
+	CCS_VALIDATE(
+		_ccs_hyperband_check_fidelity(
+			configuration_space, fidelity_index, fidelity));
+	CCS_VALIDATE(ccs_numerical_parameter_get_properties(
+		fidelity, &fidelity_type, &lower, &upper, &q));
+	/* the upper bound of parameters is excluded, and the maximum budget is
+	 * the last value of the quantization grid below it */
+	if (fidelity_type == CCS_NUMERIC_TYPE_INT) {
+		quantization = (ccs_float_t)q.i;
+		min_budget   = (ccs_float_t)lower.i;
+		if (q.i > 0)
+			max_budget = (ccs_float_t)(lower.i +
+						   (upper.i - 1 - lower.i) /
+							   q.i * q.i);
+		else
+			max_budget = (ccs_float_t)(upper.i - 1);
+	} else {
+		quantization = q.f;
+		min_budget   = lower.f;
+		if (q.f > 0.0) {
+			ccs_float_t k = ceil((upper.f - lower.f) / q.f) - 1.0;
+			max_budget    = lower.f + k * q.f;
+			if (max_budget >= upper.f)
+				max_budget = lower.f + (k - 1.0) * q.f;
+		} else
+			max_budget = nextafter(upper.f, lower.f);
+	}
+	CCS_REFUTE_MSG(
+		!(min_budget > 0.0), CCS_RESULT_ERROR_INVALID_PARAMETER,
+		"The fidelity parameter must be strictly positive");
+
+	uintptr_t mem = (uintptr_t)calloc(
+		1, sizeof(struct _ccs_tuner_s) +
+			   sizeof(struct _ccs_hyperband_tuner_data_s) +
+			   strlen(name) + 1);
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	ccs_tuner_t                  tun;
+	_ccs_hyperband_tuner_data_t *data;
+	ccs_result_t                 err;
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(configuration_space), errmemory);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(objective_space), errconfigs);
+	tun = (ccs_tuner_t)mem;
+	_ccs_object_init(
+		&(tun->obj), CCS_OBJECT_TYPE_TUNER,
+		(_ccs_object_ops_t *)&_ccs_tuner_hyperband_ops);
+	tun->data =
+		(struct _ccs_tuner_data_s *)(mem + sizeof(struct _ccs_tuner_s));
+	data                   = (_ccs_hyperband_tuner_data_t *)tun->data;
+	data->common_data.type = CCS_TUNER_TYPE_HYPERBAND;
+	data->common_data.name =
+		(const char
+			 *)(mem + sizeof(struct _ccs_tuner_s) + sizeof(struct _ccs_hyperband_tuner_data_s));
+	data->common_data.configuration_space = configuration_space;
+	data->common_data.objective_space     = objective_space;
+	data->fidelity_index                  = fidelity_index;
+	data->eta                             = eta;
+	data->fidelity_type                   = fidelity_type;
+	data->min_budget                      = min_budget;
+	data->max_budget                      = max_budget;
+	data->quantization                    = quantization;
+	data->num_brackets =
+		(size_t)floor(log(max_budget / min_budget) / log(eta) + 1e-9) +
+		1;
+	data->next_bracket = data->num_brackets - 1;
+	utarray_new(data->history, &_evaluation_icd);
+	utarray_new(data->optima, &_evaluation_icd);
+	utarray_new(data->old_optima, &_evaluation_icd);
+	strcpy((char *)data->common_data.name, name);
+	*tuner_ret = tun;
+	return CCS_RESULT_SUCCESS;
+
+arrays:
+	if (data->history)
+		utarray_free(data->history);
+	if (data->optima)
+		utarray_free(data->optima);
+	if (data->old_optima)
+		utarray_free(data->old_optima);
+	ccs_release_object(objective_space);
+errconfigs:
+	ccs_release_object(configuration_space);
+errmemory:
+	free((void *)mem);
+	return err;
+}
+
+ccs_result_t
+ccs_hyperband_tuner_get_properties(
+	ccs_tuner_t  tuner,
+	size_t      *fidelity_index_ret,
+	ccs_float_t *eta_ret)
+{
+	CCS_CHECK_OBJ(tuner, CCS_OBJECT_TYPE_TUNER);
+	_ccs_hyperband_tuner_data_t *d =
+		(_ccs_hyperband_tuner_data_t *)tuner->data;
+	CCS_REFUTE(
+		d->common_data.type != CCS_TUNER_TYPE_HYPERBAND,
+		CCS_RESULT_ERROR_INVALID_TUNER);
+	CCS_REFUTE(
+		!fidelity_index_ret && !eta_ret,
+		CCS_RESULT_ERROR_INVALID_VALUE);
+	if (fidelity_index_ret)
+		*fidelity_index_ret = d->fidelity_index;
+	if (eta_ret)
+		*eta_ret = d->eta;
+	return CCS_RESULT_SUCCESS;
+}
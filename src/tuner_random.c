@@ -168,14 +168,92 @@ _ccs_tuner_random_ask(
 		*num_configurations_ret = num_configurations;
 	return CCS_RESULT_SUCCESS;
 }
+/* Insert an evaluation in a Pareto front stored in an array, in place:
+ * members it dominates are removed, and it is discarded if a member is
+ * equivalent or better. */
+static void
+_ccs_tuner_random_front_insert(
+	ccs_evaluation_t *front,
+	size_t           *count,
+	ccs_evaluation_t  evaluation)
+{
+	size_t kept    = 0;
+	int    discard = 0;
+	for (size_t j = 0; j < *count; j++) {
+		ccs_comparison_t cmp;
+		if (!discard) {
+			if (ccs_evaluation_compare(evaluation, front[j], &cmp))
+				discard = 1;
+			else if (
+				cmp == CCS_COMPARISON_EQUIVALENT ||
+				cmp == CCS_COMPARISON_WORSE)
+				discard = 1;
+			else if (cmp == CCS_COMPARISON_BETTER)
+				continue;
+		}
+		front[kept++] = front[j];
+	}
+	if (!discard)
+		front[kept++] = evaluation;
+	*count = kept;
+}
+
 #undef utarray_oom
 #define utarray_oom()                                                          \
 	{                                                                      \
-		ccs_release_object(evaluations[i]);                            \
+		tmp           = d->optima;                                     \
+		d->optima     = d->old_optima;                                 \
+		d->old_optima = tmp;                                           \
 		CCS_RAISE(                                                     \
 			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
 			"Out of memory to allocate array");                    \
 	}
+/* Merge the front of a batch of evaluations into the optima in one pass.
+ * Optima dominated by the batch are dropped, and batch evaluations that an
+ * optimum is equivalent or better than are discarded. */
+static ccs_result_t
+_ccs_tuner_random_merge_optima(
+	_ccs_random_tuner_data_t *d,
+	ccs_evaluation_t         *batch,
+	size_t                    num_batch)
+{
+	UT_array         *tmp  = d->old_optima;
+	ccs_evaluation_t *eval = NULL;
+	d->old_optima          = d->optima;
+	d->optima              = tmp;
+	utarray_clear(d->optima);
+	while ((eval = (ccs_evaluation_t *)utarray_next(d->old_optima, eval))) {
+		int dominated = 0;
+		for (size_t j = 0; j < num_batch; j++) {
+			ccs_comparison_t cmp;
+			if (!batch[j])
+				continue;
+			if (ccs_evaluation_compare(batch[j], *eval, &cmp))
+				batch[j] = NULL;
+			else if (
+				cmp == CCS_COMPARISON_EQUIVALENT ||
+				cmp == CCS_COMPARISON_WORSE)
+				batch[j] = NULL;
+			else if (cmp == CCS_COMPARISON_BETTER)
+				dominated = 1;
+		}
+		if (!dominated)
+			utarray_push_back(d->optima, eval);
+	}
+	for (size_t j = 0; j < num_batch; j++)
+		if (batch[j])
+			utarray_push_back(d->optima, batch + j);
+	return CCS_RESULT_SUCCESS;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, merge,            \
+			"Out of memory to allocate array");                    \
+	}
 static ccs_result_t
 _ccs_tuner_random_tell(
 	ccs_tuner_t       tuner,
@@ -183,65 +261,38 @@ _ccs_tuner_random_tell(
 	ccs_evaluation_t *evaluations)
 {
 	_ccs_random_tuner_data_t *d = (_ccs_random_tuner_data_t *)tuner->data;
-	UT_array                 *history = d->history;
-	ccs_result_t              err;
+	UT_array                 *history   = d->history;
+	ccs_evaluation_t         *batch     = NULL;
+	size_t                    num_batch = 0;
+	ccs_result_t              err       = CCS_RESULT_SUCCESS;
+	if (!num_evaluations)
+		return CCS_RESULT_SUCCESS;
+	batch = (ccs_evaluation_t *)malloc(
+		num_evaluations * sizeof(ccs_evaluation_t));
+	CCS_REFUTE(!batch, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	/* the batch is reduced to its own front first, so that the optima are
+	 * only rebuilt once */
 	for (size_t i = 0; i < num_evaluations; i++) {
 		ccs_evaluation_result_t result;
-		CCS_VALIDATE(
-			ccs_evaluation_get_result(evaluations[i], &result));
+		CCS_VALIDATE_ERR_GOTO(
+			err, ccs_evaluation_get_result(evaluations[i], &result),
+			merge);
 		if (!result) {
-			int       discard = 0;
-			UT_array *tmp;
 			ccs_retain_object(evaluations[i]);
 			utarray_push_back(history, evaluations + i);
-			tmp           = d->old_optima;
-			d->old_optima = d->optima;
-			d->optima     = tmp;
-			utarray_clear(d->optima);
-			ccs_evaluation_t *eval = NULL;
-#undef utarray_oom
-#define utarray_oom()                                                          \
-	{                                                                      \
-		d->optima = d->old_optima;                                     \
-		CCS_RAISE(                                                     \
-			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
-			"Out of memory to allocate array");                    \
-	}
-			while ((eval = (ccs_evaluation_t *)utarray_next(
-					d->old_optima, eval))) {
-				if (!discard) {
-					ccs_comparison_t cmp;
-					err = ccs_evaluation_compare(
-						evaluations[i], *eval, &cmp);
-					if (err)
-						discard = 1;
-					else
-						switch (cmp) {
-						case CCS_COMPARISON_EQUIVALENT:
-						case CCS_COMPARISON_WORSE:
-							discard = 1;
-							utarray_push_back(
-								d->optima,
-								eval);
-							break;
-						case CCS_COMPARISON_BETTER:
-							break;
-						case CCS_COMPARISON_NOT_COMPARABLE:
-						default:
-							utarray_push_back(
-								d->optima,
-								eval);
-							break;
-						}
-				} else {
-					utarray_push_back(d->optima, eval);
-				}
-			}
-			if (!discard)
-				utarray_push_back(d->optima, evaluations + i);
+			_ccs_tuner_random_front_insert(
+				batch, &num_batch, evaluations[i]);
 		}
 	}
-	return CCS_RESULT_SUCCESS;
+merge:
+	if (num_batch) {
+		ccs_result_t merge_err =
+			_ccs_tuner_random_merge_optima(d, batch, num_batch);
+		if (!err)
+			err = merge_err;
+	}
+	free(batch);
+	return err;
 }
 
 static ccs_result_t
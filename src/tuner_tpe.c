@@ -0,0 +1,1039 @@
+#include "cconfigspace_internal.h"
+#include "tuner_internal.h"
+#include "evaluation_internal.h"
+#include "configuration_internal.h"
+/* only datum hashes are manipulated in this file */
+#undef HASH_FUNCTION
+#undef HASH_KEYCMP
+#include "datum_uthash.h"
+#include "datum_hash.h"
+#include <math.h>
+#include <string.h>
+
+#include "utarray.h"
+
+/* Meta parameters of the estimator, using the usual hyperopt defaults:
+ * random sampling is used until enough evaluations have been reported, then
+ * the best quantile of the history is used to build the "good" density l(x)
+ * and the rest to build the "bad" density g(x). Each returned configuration
+ * is the best, with regard to l(x)/g(x), of a set of candidates drawn from
+ * l(x). */
+#define TPE_NUM_STARTUP 10
+#define TPE_NUM_CANDIDATES 24
+#define TPE_GAMMA 0.25
+#define TPE_MAX_GOOD 25
+
+struct _ccs_tpe_parameter_s {
+	ccs_parameter_t      parameter;
+	ccs_parameter_type_t type;
+	/* numerical parameters, bounds are in the modeling space */
+	ccs_numeric_type_t   data_type;
+	ccs_numeric_t        quantization;
+	ccs_bool_t           log;
+	ccs_float_t          lower;
+	ccs_float_t          upper;
+	/* categorical, ordinal and discrete parameters */
+	size_t               num_values;
+	_ccs_hash_datum_t   *values;
+	_ccs_hash_datum_t   *hash;
+};
+typedef struct _ccs_tpe_parameter_s _ccs_tpe_parameter_t;
+
+/* Successful evaluations as seen by the model: parameter values in the
+ * modeling space (NAN when inactive) followed by objective values oriented
+ * for minimization. */
+struct _ccs_tpe_observation_s {
+	size_t      dominated;
+	ccs_float_t values[];
+};
+typedef struct _ccs_tpe_observation_s _ccs_tpe_observation_t;
+
+struct _ccs_tpe_tuner_data_s {
+	_ccs_tuner_common_data_t common_data;
+	UT_array                *history;
+	UT_array                *optima;
+	UT_array                *old_optima;
+	size_t                   num_parameters;
+	_ccs_tpe_parameter_t    *parameters;
+	size_t                   num_objectives;
+	ccs_objective_type_t    *objective_types;
+	size_t                   max_num_values;
+	UT_array                *observations;
+};
+typedef struct _ccs_tpe_tuner_data_s _ccs_tpe_tuner_data_t;
+
+static void
+_ccs_tpe_parameters_fini(size_t num_parameters, _ccs_tpe_parameter_t *params)
+{
+	for (size_t i = 0; i < num_parameters; i++)
+		if (params[i].values) {
+			HASH_CLEAR(hh, params[i].hash);
+			free(params[i].values);
+		}
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_del(ccs_object_t o)
+{
+	_ccs_tpe_tuner_data_t *d =
+		(_ccs_tpe_tuner_data_t *)((ccs_tuner_t)o)->data;
+	ccs_release_object(d->common_data.configuration_space);
+	ccs_release_object(d->common_data.objective_space);
+	ccs_evaluation_t *e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(d->history, e)))
+		ccs_release_object(*e);
+	utarray_free(d->history);
+	utarray_free(d->optima);
+	utarray_free(d->old_optima);
+	utarray_free(d->observations);
+	_ccs_tpe_parameters_fini(d->num_parameters, d->parameters);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_tpe_tuner_data(
+	_ccs_tpe_tuner_data_t           *data,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tuner_common_data(
+		&data->common_data, cum_size, opts));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->history));
+	*cum_size += _ccs_serialize_bin_size_size(utarray_len(data->optima));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize_size(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, cum_size, opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		*cum_size += _ccs_serialize_bin_size_ccs_object(*e);
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_tpe_tuner_data(
+	_ccs_tpe_tuner_data_t           *data,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	ccs_evaluation_t *e = NULL;
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tuner_common_data(
+		&data->common_data, buffer_size, buffer, opts));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->history), buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_size(
+		utarray_len(data->optima), buffer_size, buffer));
+	while ((e = (ccs_evaluation_t *)utarray_next(data->history, e)))
+		CCS_VALIDATE((*e)->obj.ops->serialize(
+			*e, CCS_SERIALIZE_FORMAT_BINARY, buffer_size, buffer,
+			opts));
+	e = NULL;
+	while ((e = (ccs_evaluation_t *)utarray_next(data->optima, e)))
+		CCS_VALIDATE(
+			_ccs_serialize_bin_ccs_object(*e, buffer_size, buffer));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_size_ccs_tpe_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_tpe_tuner_data_t *data = (_ccs_tpe_tuner_data_t *)(tuner->data);
+	*cum_size += _ccs_serialize_bin_size_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner);
+	CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tpe_tuner_data(
+		data, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_result_t
+_ccs_serialize_bin_ccs_tpe_tuner(
+	ccs_tuner_t                      tuner,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	_ccs_tpe_tuner_data_t *data = (_ccs_tpe_tuner_data_t *)(tuner->data);
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_object_internal(
+		(_ccs_object_internal_t *)tuner, buffer_size, buffer));
+	CCS_VALIDATE(_ccs_serialize_bin_ccs_tpe_tuner_data(
+		data, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_serialize_size(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *cum_size,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_size_ccs_tpe_tuner(
+			(ccs_tuner_t)object, cum_size, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data_size(
+		object, format, cum_size, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_serialize(
+	ccs_object_t                     object,
+	ccs_serialize_format_t           format,
+	size_t                          *buffer_size,
+	char                           **buffer,
+	_ccs_object_serialize_options_t *opts)
+{
+	switch (format) {
+	case CCS_SERIALIZE_FORMAT_BINARY:
+		CCS_VALIDATE(_ccs_serialize_bin_ccs_tpe_tuner(
+			(ccs_tuner_t)object, buffer_size, buffer, opts));
+		break;
+	default:
+		CCS_RAISE(
+			CCS_RESULT_ERROR_INVALID_VALUE,
+			"Unsupported serialization format: %d", format);
+	}
+	CCS_VALIDATE(_ccs_object_serialize_user_data(
+		object, format, buffer_size, buffer, opts));
+	return CCS_RESULT_SUCCESS;
+}
+
+static inline ccs_float_t
+_ccs_tpe_to_model(_ccs_tpe_parameter_t *p, ccs_datum_t value)
+{
+	if (value.type == CCS_DATA_TYPE_INACTIVE)
+		return NAN;
+	if (p->values) {
+		_ccs_hash_datum_t *h;
+		HASH_FIND(hh, p->hash, &value, sizeof(ccs_datum_t), h);
+		return h ? (ccs_float_t)(h - p->values) : NAN;
+	}
+	ccs_float_t x = value.type == CCS_DATA_TYPE_INT ?
+				(ccs_float_t)value.value.i :
+				value.value.f;
+	return p->log ? log(x) : x;
+}
+
+static int
+_ccs_float_sort(const void *a, const void *b)
+{
+	const ccs_float_t fa = *(const ccs_float_t *)a;
+	const ccs_float_t fb = *(const ccs_float_t *)b;
+	return fa < fb ? -1 : fa > fb ? 1 : 0;
+}
+
+/* Adaptive Parzen estimator: one truncated normal per observation, whose
+ * width is the distance to the farthest neighbor, plus a wide prior
+ * component. mus must be able to hold count + 1 values. */
+static void
+_ccs_tpe_parzen(
+	ccs_float_t  lower,
+	ccs_float_t  upper,
+	size_t       count,
+	ccs_float_t *mus,
+	ccs_float_t *sigmas,
+	ccs_float_t *norms)
+{
+	ccs_float_t width     = upper - lower;
+	ccs_float_t min_sigma = width / (count + 1 < 100 ? count + 1 : 100);
+	qsort(mus, count, sizeof(ccs_float_t), &_ccs_float_sort);
+	for (size_t i = 0; i < count; i++) {
+		ccs_float_t left  = mus[i] - (i > 0 ? mus[i - 1] : lower);
+		ccs_float_t right = (i + 1 < count ? mus[i + 1] : upper) -
+				    mus[i];
+		ccs_float_t sigma = left > right ? left : right;
+		sigmas[i]         = sigma < min_sigma ? min_sigma :
+				    sigma > width   ? width :
+						      sigma;
+	}
+	mus[count]    = lower + 0.5 * width;
+	sigmas[count] = width;
+	/* normalization of the components truncated to [lower, upper] */
+	for (size_t i = 0; i <= count; i++) {
+		ccs_float_t s    = sigmas[i] * 1.4142135623730951;
+		ccs_float_t mass = 0.5 * (erf((upper - mus[i]) / s) -
+					  erf((lower - mus[i]) / s));
+		norms[i]         = 1.0 / (sigmas[i] * mass * (count + 1));
+	}
+}
+
+static inline ccs_float_t
+_ccs_tpe_parzen_log_pdf(
+	size_t       count,
+	ccs_float_t *mus,
+	ccs_float_t *sigmas,
+	ccs_float_t *norms,
+	ccs_float_t  x)
+{
+	ccs_float_t p = 0.0;
+	for (size_t i = 0; i <= count; i++) {
+		ccs_float_t z = (x - mus[i]) / sigmas[i];
+		p += norms[i] * exp(-0.5 * z * z);
+	}
+	return log(p * 0.3989422804014327);
+}
+
+static inline ccs_result_t
+_ccs_tpe_sample_numerical(
+	_ccs_tpe_parameter_t *p,
+	ccs_rng_t             rng,
+	size_t                num_components,
+	ccs_float_t          *mus,
+	ccs_float_t          *sigmas,
+	ccs_float_t          *weights,
+	ccs_distribution_t   *distributions,
+	size_t                num_values,
+	ccs_datum_t          *values)
+{
+	ccs_result_t       err = CCS_RESULT_SUCCESS;
+	ccs_distribution_t mixture;
+	size_t             i;
+	for (i = 0; i < num_components; i++) {
+		weights[i] = 1.0;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_create_normal_distribution(
+				p->data_type, mus[i], sigmas[i],
+				p->log ? CCS_SCALE_TYPE_LOGARITHMIC :
+					 CCS_SCALE_TYPE_LINEAR,
+				p->quantization, distributions + i),
+			end);
+	}
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_create_mixture_distribution(
+			num_components, distributions, weights, &mixture),
+		end);
+	err = ccs_parameter_samples(
+		p->parameter, mixture, rng, num_values, values);
+	ccs_release_object(mixture);
+end:
+	while (i--)
+		ccs_release_object(distributions[i]);
+	return err;
+}
+
+static inline ccs_result_t
+_ccs_tpe_sample_categorical(
+	_ccs_tpe_parameter_t *p,
+	ccs_rng_t             rng,
+	ccs_float_t          *areas,
+	ccs_numeric_t        *indexes,
+	size_t                num_values,
+	ccs_datum_t          *values)
+{
+	ccs_result_t       err;
+	ccs_distribution_t roulette;
+	CCS_VALIDATE(ccs_create_roulette_distribution(
+		p->num_values, areas, &roulette));
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_distribution_samples(roulette, rng, num_values, indexes),
+		end);
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_parameter_convert_samples(
+			p->parameter, CCS_FALSE, num_values, indexes, values),
+		end);
+end:
+	ccs_release_object(roulette);
+	return err;
+}
+
+struct _ccs_tpe_rank_s {
+	size_t dominated;
+	size_t index;
+};
+typedef struct _ccs_tpe_rank_s _ccs_tpe_rank_t;
+
+static int
+_ccs_tpe_rank_sort(const void *a, const void *b)
+{
+	const _ccs_tpe_rank_t *ra = (const _ccs_tpe_rank_t *)a;
+	const _ccs_tpe_rank_t *rb = (const _ccs_tpe_rank_t *)b;
+	if (ra->dominated != rb->dominated)
+		return ra->dominated < rb->dominated ? -1 : 1;
+	return ra->index < rb->index ? -1 : ra->index > rb->index ? 1 : 0;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_ask(
+	ccs_tuner_t          tuner,
+	size_t               num_configurations,
+	ccs_configuration_t *configurations,
+	size_t              *num_configurations_ret)
+{
+	_ccs_tpe_tuner_data_t    *d = (_ccs_tpe_tuner_data_t *)tuner->data;
+	ccs_configuration_space_t configuration_space =
+		d->common_data.configuration_space;
+	if (!configurations) {
+		*num_configurations_ret = 1;
+		return CCS_RESULT_SUCCESS;
+	}
+	size_t num_observations = utarray_len(d->observations);
+	size_t num_parameters   = d->num_parameters;
+	/* the constraint graph is rebuilt lazily by the sampling routines */
+	if (num_observations < TPE_NUM_STARTUP || !num_parameters ||
+	    !configuration_space->data->graph_ok) {
+		CCS_VALIDATE(ccs_configuration_space_samples(
+			configuration_space, num_configurations,
+			configurations));
+		if (num_configurations_ret)
+			*num_configurations_ret = num_configurations;
+		return CCS_RESULT_SUCCESS;
+	}
+
+	ccs_result_t err = CCS_RESULT_SUCCESS;
+	ccs_rng_t    rng;
+	CCS_VALIDATE(
+		ccs_configuration_space_get_rng(configuration_space, &rng));
+	size_t num_candidates = num_configurations * TPE_NUM_CANDIDATES;
+	size_t num_components = num_observations + 1;
+	size_t num_good       = (size_t)ceil(TPE_GAMMA * num_observations);
+	if (num_good > TPE_MAX_GOOD)
+		num_good = TPE_MAX_GOOD;
+
+	_ccs_tpe_rank_t    *ranks;
+	ccs_float_t        *floats, *good_mus, *good_sigmas, *good_norms;
+	ccs_float_t        *bad_mus, *bad_sigmas, *bad_norms;
+	ccs_float_t        *weights, *good_weights, *bad_weights, *scores;
+	ccs_numeric_t      *indexes;
+	ccs_distribution_t *distributions;
+	ccs_datum_t        *candidates, *row, *best_row;
+	uintptr_t           mem;
+	mem = (uintptr_t)malloc(
+		num_observations * sizeof(_ccs_tpe_rank_t) +
+		(7 * num_components + 2 * d->max_num_values +
+		 num_candidates * num_parameters) *
+			sizeof(ccs_float_t) +
+		num_candidates * sizeof(ccs_numeric_t) +
+		num_components * sizeof(ccs_distribution_t) +
+		(num_candidates * num_parameters + 2 * num_parameters) *
+			sizeof(ccs_datum_t));
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	candidates    = (ccs_datum_t *)mem;
+	row           = candidates + num_candidates * num_parameters;
+	best_row      = row + num_parameters;
+	ranks         = (_ccs_tpe_rank_t *)(best_row + num_parameters);
+	floats        = (ccs_float_t *)(ranks + num_observations);
+	good_mus      = floats;
+	good_sigmas   = good_mus + num_components;
+	good_norms    = good_sigmas + num_components;
+	bad_mus       = good_norms + num_components;
+	bad_sigmas    = bad_mus + num_components;
+	bad_norms     = bad_sigmas + num_components;
+	weights       = bad_norms + num_components;
+	good_weights  = weights + num_components;
+	bad_weights   = good_weights + d->max_num_values;
+	scores        = bad_weights + d->max_num_values;
+	indexes =
+		(ccs_numeric_t *)(scores + num_candidates * num_parameters);
+	distributions = (ccs_distribution_t *)(indexes + num_candidates);
+
+	for (size_t i = 0; i < num_configurations; i++)
+		configurations[i] = NULL;
+
+	/* split the observations according to their Pareto rank */
+	for (size_t i = 0; i < num_observations; i++) {
+		_ccs_tpe_observation_t *o =
+			(_ccs_tpe_observation_t *)utarray_eltptr(
+				d->observations, (unsigned int)i);
+		ranks[i].dominated = o->dominated;
+		ranks[i].index     = i;
+	}
+	qsort(ranks, num_observations, sizeof(_ccs_tpe_rank_t),
+	      &_ccs_tpe_rank_sort);
+
+	/* draw candidates from l(x) and score them with log(l(x)/g(x)),
+	 * one parameter at a time */
+	for (size_t j = 0; j < num_parameters; j++) {
+		_ccs_tpe_parameter_t *p      = d->parameters + j;
+		ccs_datum_t          *values = candidates + j * num_candidates;
+		ccs_float_t          *param_scores = scores + j * num_candidates;
+		size_t                num_g = 0, num_b = 0;
+		if (p->values)
+			for (size_t k = 0; k < p->num_values; k++) {
+				good_weights[k] = 1.0;
+				bad_weights[k]  = 1.0;
+			}
+		for (size_t i = 0; i < num_observations; i++) {
+			_ccs_tpe_observation_t *o =
+				(_ccs_tpe_observation_t *)utarray_eltptr(
+					d->observations,
+					(unsigned int)ranks[i].index);
+			ccs_float_t x = o->values[j];
+			if (isnan(x))
+				continue;
+			if (p->values) {
+				if (i < num_good)
+					good_weights[(size_t)x] += 1.0;
+				else
+					bad_weights[(size_t)x] += 1.0;
+			} else if (i < num_good)
+				good_mus[num_g++] = x;
+			else
+				bad_mus[num_b++] = x;
+		}
+		if (p->values) {
+			ccs_float_t good_sum = 0.0, bad_sum = 0.0;
+			for (size_t k = 0; k < p->num_values; k++) {
+				good_sum += good_weights[k];
+				bad_sum += bad_weights[k];
+			}
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_tpe_sample_categorical(
+					p, rng, good_weights, indexes,
+					num_candidates, values),
+				memory);
+			for (size_t r = 0; r < num_candidates; r++) {
+				size_t k = (size_t)indexes[r].i;
+				param_scores[r] =
+					log(good_weights[k] / good_sum) -
+					log(bad_weights[k] / bad_sum);
+			}
+		} else {
+			_ccs_tpe_parzen(
+				p->lower, p->upper, num_g, good_mus,
+				good_sigmas, good_norms);
+			_ccs_tpe_parzen(
+				p->lower, p->upper, num_b, bad_mus, bad_sigmas,
+				bad_norms);
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_tpe_sample_numerical(
+					p, rng, num_g + 1, good_mus,
+					good_sigmas, weights, distributions,
+					num_candidates, values),
+				memory);
+			for (size_t r = 0; r < num_candidates; r++) {
+				ccs_float_t x = _ccs_tpe_to_model(p, values[r]);
+				param_scores[r] =
+					_ccs_tpe_parzen_log_pdf(
+						num_g, good_mus, good_sigmas,
+						good_norms, x) -
+					_ccs_tpe_parzen_log_pdf(
+						num_b, bad_mus, bad_sigmas,
+						bad_norms, x);
+			}
+		}
+	}
+
+	/* keep the best valid candidate of each group */
+	for (size_t i = 0; i < num_configurations; i++) {
+		ccs_float_t best_score = -INFINITY;
+		ccs_bool_t  found      = CCS_FALSE;
+		for (size_t r = i * TPE_NUM_CANDIDATES;
+		     r < (i + 1) * TPE_NUM_CANDIDATES; r++) {
+			ccs_bool_t  valid;
+			ccs_float_t score = 0.0;
+			for (size_t j = 0; j < num_parameters; j++)
+				row[j] = candidates[j * num_candidates + r];
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_configuration_space_set_actives(
+					configuration_space, row),
+				configurations);
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_configuration_space_test_forbidden(
+					configuration_space, row, &valid),
+				configurations);
+			if (!valid)
+				continue;
+			for (size_t j = 0; j < num_parameters; j++)
+				if (row[j].type != CCS_DATA_TYPE_INACTIVE)
+					score += scores[j * num_candidates + r];
+			if (!found || score > best_score) {
+				found      = CCS_TRUE;
+				best_score = score;
+				memcpy(best_row, row,
+				       num_parameters * sizeof(ccs_datum_t));
+			}
+		}
+		if (found)
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_create_configuration(
+					configuration_space, num_parameters,
+					best_row, configurations + i),
+				configurations);
+		else
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				ccs_configuration_space_sample(
+					configuration_space,
+					configurations + i),
+				configurations);
+	}
+	if (num_configurations_ret)
+		*num_configurations_ret = num_configurations;
+	goto memory;
+configurations:
+	for (size_t i = 0; i < num_configurations; i++)
+		if (configurations[i]) {
+			ccs_release_object(configurations[i]);
+			configurations[i] = NULL;
+		}
+memory:
+	free((void *)mem);
+	return err;
+}
+
+static inline int
+_ccs_tpe_dominates(size_t num_objectives, ccs_float_t *a, ccs_float_t *b)
+{
+	int strict = 0;
+	for (size_t k = 0; k < num_objectives; k++) {
+		if (a[k] > b[k])
+			return 0;
+		if (a[k] < b[k])
+			strict = 1;
+	}
+	return strict;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+/* Record a successful evaluation in the model and maintain the domination
+ * counts used to rank observations. Evaluations of another configuration
+ * space, or with non numerical objective values, are only kept in the
+ * history. */
+static ccs_result_t
+_ccs_tpe_observe(_ccs_tpe_tuner_data_t *d, ccs_evaluation_t evaluation)
+{
+	ccs_configuration_t     configuration = evaluation->data->configuration;
+	size_t                  num_parameters = d->num_parameters;
+	size_t                  num_objectives = d->num_objectives;
+	_ccs_tpe_observation_t *o, *q = NULL;
+	ccs_float_t            *objectives;
+	ccs_result_t            err;
+	if (configuration->data->configuration_space !=
+		    d->common_data.configuration_space ||
+	    configuration->data->num_values != num_parameters)
+		return CCS_RESULT_SUCCESS;
+	utarray_extend_back(d->observations);
+	o = (_ccs_tpe_observation_t *)utarray_back(d->observations);
+	for (size_t j = 0; j < num_parameters; j++)
+		o->values[j] = _ccs_tpe_to_model(
+			d->parameters + j, configuration->data->values[j]);
+	objectives = o->values + num_parameters;
+	for (size_t k = 0; k < num_objectives; k++) {
+		ccs_datum_t v;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_evaluation_get_objective_value(evaluation, k, &v),
+			err_observation);
+		if (v.type == CCS_DATA_TYPE_INT)
+			objectives[k] = (ccs_float_t)v.value.i;
+		else if (v.type == CCS_DATA_TYPE_FLOAT)
+			objectives[k] = v.value.f;
+		else {
+			utarray_pop_back(d->observations);
+			return CCS_RESULT_SUCCESS;
+		}
+		if (d->objective_types[k] == CCS_OBJECTIVE_TYPE_MAXIMIZE)
+			objectives[k] = -objectives[k];
+	}
+	o->dominated = 0;
+	while ((q = (_ccs_tpe_observation_t *)utarray_next(
+			d->observations, q)) != o) {
+		ccs_float_t *other = q->values + num_parameters;
+		if (_ccs_tpe_dominates(num_objectives, other, objectives))
+			o->dominated++;
+		else if (_ccs_tpe_dominates(num_objectives, objectives, other))
+			q->dominated++;
+	}
+	return CCS_RESULT_SUCCESS;
+err_observation:
+	utarray_pop_back(d->observations);
+	return err;
+}
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		ccs_release_object(evaluations[i]);                            \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+static ccs_result_t
+_ccs_tuner_tpe_tell(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations)
+{
+	_ccs_tpe_tuner_data_t *d       = (_ccs_tpe_tuner_data_t *)tuner->data;
+	UT_array              *history = d->history;
+	ccs_result_t           err;
+	for (size_t i = 0; i < num_evaluations; i++) {
+		ccs_evaluation_result_t result;
+		CCS_VALIDATE(
+			ccs_evaluation_get_result(evaluations[i], &result));
+		if (!result) {
+			int       discard = 0;
+			UT_array *tmp;
+			ccs_retain_object(evaluations[i]);
+			utarray_push_back(history, evaluations + i);
+			tmp           = d->old_optima;
+			d->old_optima = d->optima;
+			d->optima     = tmp;
+			utarray_clear(d->optima);
+			ccs_evaluation_t *eval = NULL;
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		d->optima = d->old_optima;                                     \
+		CCS_RAISE(                                                     \
+			CCS_RESULT_ERROR_OUT_OF_MEMORY,                        \
+			"Out of memory to allocate array");                    \
+	}
+			while ((eval = (ccs_evaluation_t *)utarray_next(
+					d->old_optima, eval))) {
+				if (!discard) {
+					ccs_comparison_t cmp;
+					err = ccs_evaluation_compare(
+						evaluations[i], *eval, &cmp);
+					if (err)
+						discard = 1;
+					else
+						switch (cmp) {
+						case CCS_COMPARISON_EQUIVALENT:
+						case CCS_COMPARISON_WORSE:
+							discard = 1;
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						case CCS_COMPARISON_BETTER:
+							break;
+						case CCS_COMPARISON_NOT_COMPARABLE:
+						default:
+							utarray_push_back(
+								d->optima,
+								eval);
+							break;
+						}
+				} else {
+					utarray_push_back(d->optima, eval);
+				}
+			}
+			if (!discard)
+				utarray_push_back(d->optima, evaluations + i);
+			CCS_VALIDATE(_ccs_tpe_observe(d, evaluations[i]));
+		}
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_get_optima(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_tpe_tuner_data_t *d     = (_ccs_tpe_tuner_data_t *)tuner->data;
+	size_t                 count = utarray_len(d->optima);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->optima, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_get_history(
+	ccs_tuner_t       tuner,
+	size_t            num_evaluations,
+	ccs_evaluation_t *evaluations,
+	size_t           *num_evaluations_ret)
+{
+	_ccs_tpe_tuner_data_t *d     = (_ccs_tpe_tuner_data_t *)tuner->data;
+	size_t                 count = utarray_len(d->history);
+	if (evaluations) {
+		CCS_REFUTE(
+			num_evaluations < count,
+			CCS_RESULT_ERROR_INVALID_VALUE);
+		ccs_evaluation_t *eval  = NULL;
+		size_t            index = 0;
+		while ((eval = (ccs_evaluation_t *)utarray_next(
+				d->history, eval)))
+			evaluations[index++] = *eval;
+		for (size_t i = count; i < num_evaluations; i++)
+			evaluations[i] = NULL;
+	}
+	if (num_evaluations_ret)
+		*num_evaluations_ret = count;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tuner_tpe_suggest(ccs_tuner_t tuner, ccs_configuration_t *configuration)
+{
+	_ccs_tpe_tuner_data_t *d     = (_ccs_tpe_tuner_data_t *)tuner->data;
+	size_t                 count = utarray_len(d->optima);
+	if (count > 0) {
+		ccs_rng_t         rng;
+		unsigned long int indx;
+		CCS_VALIDATE(ccs_configuration_space_get_rng(
+			d->common_data.configuration_space, &rng));
+		CCS_VALIDATE(ccs_rng_get(rng, &indx));
+		indx = indx % count;
+		ccs_evaluation_t *eval =
+			(ccs_evaluation_t *)utarray_eltptr(d->optima, indx);
+		CCS_VALIDATE(
+			ccs_evaluation_get_configuration(*eval, configuration));
+		CCS_VALIDATE(ccs_retain_object(*configuration));
+	} else
+		CCS_VALIDATE(
+			_ccs_tuner_tpe_ask(tuner, 1, configuration, NULL));
+	return CCS_RESULT_SUCCESS;
+}
+
+static _ccs_tuner_ops_t _ccs_tuner_tpe_ops = {
+	{&_ccs_tuner_tpe_del, &_ccs_tuner_tpe_serialize_size,
+	 &_ccs_tuner_tpe_serialize},
+	&_ccs_tuner_tpe_ask,
+	&_ccs_tuner_tpe_tell,
+	&_ccs_tuner_tpe_get_optima,
+	&_ccs_tuner_tpe_get_history,
+	&_ccs_tuner_tpe_suggest};
+
+static const UT_icd _evaluation_icd = {
+	sizeof(ccs_evaluation_t),
+	NULL,
+	NULL,
+	NULL,
+};
+
+/* Numerical parameters sampled on a logarithmic scale in the configuration
+ * space are also modeled on a logarithmic scale. */
+static ccs_result_t
+_ccs_tpe_parameter_init_numerical(
+	ccs_configuration_space_t configuration_space,
+	size_t                    index,
+	_ccs_tpe_parameter_t     *p)
+{
+	ccs_distribution_t      distribution;
+	ccs_distribution_type_t distribution_type;
+	ccs_scale_type_t        scale_type = CCS_SCALE_TYPE_LINEAR;
+	ccs_numeric_t           lower, upper;
+	size_t                  dindex;
+	CCS_VALIDATE(ccs_numerical_parameter_get_properties(
+		p->parameter, &p->data_type, &lower, &upper, &p->quantization));
+	if (p->data_type == CCS_NUMERIC_TYPE_FLOAT) {
+		p->lower = lower.f;
+		p->upper = upper.f;
+	} else {
+		p->lower = (ccs_float_t)lower.i;
+		p->upper = (ccs_float_t)upper.i;
+	}
+	CCS_VALIDATE(ccs_configuration_space_get_parameter_distribution(
+		configuration_space, index, &distribution, &dindex));
+	CCS_VALIDATE(
+		ccs_distribution_get_type(distribution, &distribution_type));
+	if (distribution_type == CCS_DISTRIBUTION_TYPE_UNIFORM)
+		CCS_VALIDATE(ccs_uniform_distribution_get_properties(
+			distribution, NULL, NULL, &scale_type, NULL));
+	else if (distribution_type == CCS_DISTRIBUTION_TYPE_NORMAL)
+		CCS_VALIDATE(ccs_normal_distribution_get_properties(
+			distribution, NULL, NULL, &scale_type, NULL));
+	if (scale_type == CCS_SCALE_TYPE_LOGARITHMIC && p->lower > 0.0) {
+		p->log   = CCS_TRUE;
+		p->lower = log(p->lower);
+		p->upper = log(p->upper);
+	}
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+_ccs_tpe_parameter_init_categorical(_ccs_tpe_parameter_t *p)
+{
+	ccs_result_t   err = CCS_RESULT_SUCCESS;
+	ccs_interval_t interval;
+	ccs_numeric_t *indexes;
+	ccs_datum_t   *values;
+	CCS_VALIDATE(ccs_parameter_sampling_interval(p->parameter, &interval));
+	p->num_values = (size_t)interval.upper.i;
+	p->values     = (_ccs_hash_datum_t *)calloc(
+		p->num_values, sizeof(_ccs_hash_datum_t));
+	CCS_REFUTE(!p->values, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	indexes = (ccs_numeric_t *)malloc(
+		p->num_values * (sizeof(ccs_numeric_t) + sizeof(ccs_datum_t)));
+	CCS_REFUTE(!indexes, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	values = (ccs_datum_t *)(indexes + p->num_values);
+	for (size_t i = 0; i < p->num_values; i++)
+		indexes[i].i = (ccs_int_t)i;
+	CCS_VALIDATE_ERR_GOTO(
+		err,
+		ccs_parameter_convert_samples(
+			p->parameter, CCS_FALSE, p->num_values, indexes,
+			values),
+		end);
+	for (size_t i = 0; i < p->num_values; i++) {
+		p->values[i].d = values[i];
+		HASH_ADD(hh, p->hash, d, sizeof(ccs_datum_t), p->values + i);
+	}
+end:
+	free(indexes);
+	return err;
+}
+
+#undef utarray_oom
+#define utarray_oom()                                                          \
+	{                                                                      \
+		CCS_RAISE_ERR_GOTO(                                            \
+			err, CCS_RESULT_ERROR_OUT_OF_MEMORY, arrays,           \
+			"Out of memory to allocate array");                    \
+	}
+ccs_result_t
+ccs_create_tpe_tuner(
+	const char               *name,
+	ccs_configuration_space_t configuration_space,
+	ccs_objective_space_t     objective_space,
+	ccs_tuner_t              *tuner_ret)
+{
+	CCS_CHECK_PTR(name);
+	CCS_CHECK_OBJ(configuration_space, CCS_OBJECT_TYPE_CONFIGURATION_SPACE);
+	CCS_CHECK_OBJ(objective_space, CCS_OBJECT_TYPE_OBJECTIVE_SPACE);
+	CCS_CHECK_PTR(tuner_ret);
+
+	size_t num_parameters, num_objectives;
+	CCS_VALIDATE(ccs_configuration_space_get_num_parameters(
+		configuration_space, &num_parameters));
+	CCS_VALIDATE(ccs_objective_space_get_objectives(
+		objective_space, 0, NULL, NULL, &num_objectives));
+	uintptr_t mem = (uintptr_t)calloc(
+		1, sizeof(struct _ccs_tuner_s) +
+			   sizeof(struct _ccs_tpe_tuner_data_s) +
+			   num_parameters * sizeof(_ccs_tpe_parameter_t) +
+			   num_objectives * sizeof(ccs_objective_type_t) +
+			   strlen(name) + 1);
+	CCS_REFUTE(!mem, CCS_RESULT_ERROR_OUT_OF_MEMORY);
+	uintptr_t              mem_cur = mem;
+	ccs_tuner_t            tun;
+	_ccs_tpe_tuner_data_t *data;
+	ccs_result_t           err;
+	UT_icd                 observation_icd = {
+		sizeof(_ccs_tpe_observation_t) +
+			(num_parameters + num_objectives) * sizeof(ccs_float_t),
+		NULL,
+		NULL,
+		NULL,
+	};
+	tun = (ccs_tuner_t)mem_cur;
+	mem_cur += sizeof(struct _ccs_tuner_s);
+	data = (_ccs_tpe_tuner_data_t *)mem_cur;
+	mem_cur += sizeof(struct _ccs_tpe_tuner_data_s);
+	data->parameters = (_ccs_tpe_parameter_t *)mem_cur;
+	mem_cur += num_parameters * sizeof(_ccs_tpe_parameter_t);
+	data->objective_types = (ccs_objective_type_t *)mem_cur;
+	mem_cur += num_objectives * sizeof(ccs_objective_type_t);
+	data->common_data.name = (const char *)mem_cur;
+	data->num_parameters   = num_parameters;
+	data->num_objectives   = num_objectives;
+
+	for (size_t i = 0; i < num_parameters; i++) {
+		_ccs_tpe_parameter_t *p = data->parameters + i;
+		CCS_VALIDATE_ERR_GOTO(
+			err,
+			ccs_configuration_space_get_parameter(
+				configuration_space, i, &p->parameter),
+			parameters);
+		CCS_VALIDATE_ERR_GOTO(
+			err, ccs_parameter_get_type(p->parameter, &p->type),
+			parameters);
+		switch (p->type) {
+		case CCS_PARAMETER_TYPE_NUMERICAL:
+			CCS_VALIDATE_ERR_GOTO(
+				err,
+				_ccs_tpe_parameter_init_numerical(
+					configuration_space, i, p),
+				parameters);
+			break;
+		case CCS_PARAMETER_TYPE_CATEGORICAL:
+		case CCS_PARAMETER_TYPE_ORDINAL:
+		case CCS_PARAMETER_TYPE_DISCRETE:
+			CCS_VALIDATE_ERR_GOTO(
+				err, _ccs_tpe_parameter_init_categorical(p),
+				parameters);
+			if (p->num_values > data->max_num_values)
+				data->max_num_values = p->num_values;
+			break;
+		default:
+			CCS_RAISE_ERR_GOTO(
+				err, CCS_RESULT_ERROR_INVALID_PARAMETER,
+				parameters,
+				"Unsupported parameter type: %d", p->type);
+		}
+	}
+	for (size_t k = 0; k < num_objectives; k++)
+		data->objective_types[k] =
+			((_ccs_objective_t *)utarray_eltptr(
+				 objective_space->data->objectives,
+				 (unsigned int)k))
+				->type;
+
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(configuration_space), parameters);
+	CCS_VALIDATE_ERR_GOTO(
+		err, ccs_retain_object(objective_space), errconfigs);
+	_ccs_object_init(
+		&(tun->obj), CCS_OBJECT_TYPE_TUNER,
+		(_ccs_object_ops_t *)&_ccs_tuner_tpe_ops);
+	tun->data              = (struct _ccs_tuner_data_s *)data;
+	data->common_data.type = CCS_TUNER_TYPE_TPE;
+	data->common_data.configuration_space = configuration_space;
+	data->common_data.objective_space     = objective_space;
+	utarray_new(data->history, &_evaluation_icd);
+	utarray_new(data->optima, &_evaluation_icd);
+	utarray_new(data->old_optima, &_evaluation_icd);
+	utarray_new(data->observations, &observation_icd);
+	strcpy((char *)data->common_data.name, name);
+	*tuner_ret = tun;
+	return CCS_RESULT_SUCCESS;
+
+arrays:
+	if (data->history)
+		utarray_free(data->history);
+	if (data->optima)
+		utarray_free(data->optima);
+	if (data->old_optima)
+		utarray_free(data->old_optima);
+	if (data->observations)
+		utarray_free(data->observations);
+	ccs_release_object(objective_space);
+errconfigs:
+	ccs_release_object(configuration_space);
+parameters:
+	_ccs_tpe_parameters_fini(num_parameters, data->parameters);
+	free((void *)mem);
+	return err;
+}
@@ -0,0 +1,456 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <cconfigspace.h>
+#include <string.h>
+#include <math.h>
+
+ccs_parameter_t
+create_numerical(const char *name, double lower, double upper)
+{
+	ccs_parameter_t parameter;
+	ccs_result_t    err;
+	err = ccs_create_numerical_parameter(
+		name, CCS_NUMERIC_TYPE_FLOAT, CCSF(lower), CCSF(upper),
+		CCSF(0.0), CCSF(0), &parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	return parameter;
+}
+
+static ccs_float_t
+sphere(ccs_datum_t *values)
+{
+	static const ccs_float_t optimum[4] = {1.0, 2.0, -1.0, 0.5};
+	ccs_float_t              res        = 0.0;
+	for (size_t i = 0; i < 4; i++)
+		res += (values[i].value.f - optimum[i]) *
+		       (values[i].value.f - optimum[i]);
+	return res;
+}
+
+static void
+evaluate(
+	ccs_objective_space_t ospace,
+	size_t                count,
+	ccs_configuration_t  *configurations,
+	ccs_evaluation_t     *evaluations)
+{
+	ccs_result_t err;
+	for (size_t j = 0; j < count; j++) {
+		ccs_datum_t values[4], res;
+		err = ccs_configuration_get_values(
+			configurations[j], 4, values, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		res = ccs_float(sphere(values));
+		err = ccs_create_evaluation(
+			ospace, configurations[j], CCS_RESULT_SUCCESS, 1, &res,
+			evaluations + j);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
+static void
+release(
+	size_t               count,
+	ccs_configuration_t *configurations,
+	ccs_evaluation_t    *evaluations)
+{
+	ccs_result_t err;
+	for (size_t j = 0; j < count; j++) {
+		err = ccs_release_object(configurations[j]);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(evaluations[j]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
+static void
+create_spaces(
+	ccs_parameter_t           *parameters,
+	ccs_configuration_space_t *cspace,
+	ccs_objective_space_t     *ospace,
+	ccs_expression_t          *expression)
+{
+	static const char *names[4] = {"x", "y", "z", "t"};
+	ccs_result_t       err;
+	err = ccs_create_configuration_space("4dspace", cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 4; i++) {
+		parameters[i] = create_numerical(names[i], -5.0, 5.0);
+		err           = ccs_configuration_space_add_parameter(
+			*cspace, parameters[i], NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	parameters[4] = create_numerical("h", -CCS_INFINITY, CCS_INFINITY);
+	err           = ccs_create_variable(parameters[4], expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("height", ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(*ospace, parameters[4]);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		*ospace, *expression, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static void
+release_spaces(
+	ccs_parameter_t          *parameters,
+	ccs_configuration_space_t cspace,
+	ccs_objective_space_t     ospace,
+	ccs_expression_t          expression)
+{
+	ccs_result_t err;
+	for (size_t i = 0; i < 5; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+void
+test()
+{
+	ccs_parameter_t           parameters[5];
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_tuner_t               tuner, tuner_copy;
+	ccs_result_t              err;
+	ccs_datum_t               d;
+	char                     *buff;
+	size_t                    buff_size;
+	size_t                    population_size;
+	ccs_float_t               sigma;
+	ccs_map_t                 map;
+	ccs_configuration_t       configurations[8];
+	ccs_evaluation_t          evaluations[8];
+
+	create_spaces(parameters, &cspace, &ospace, &expression);
+
+	err = ccs_create_cma_es_tuner(
+		"problem", cspace, ospace, 1, 0.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_create_cma_es_tuner(
+		"problem", cspace, ospace, 8, 2.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_create_cma_es_tuner(
+		"problem", cspace, ospace, 8, 0.0, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_cma_es_tuner_get_properties(tuner, &population_size, &sigma);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(population_size == 8);
+	assert(sigma == 0.3);
+
+	/* the suggested batch completes the current generation */
+	err = ccs_tuner_ask(tuner, 0, NULL, &population_size);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(population_size == 8);
+	err = ccs_tuner_ask(tuner, 3, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	evaluate(ospace, 3, configurations, evaluations);
+	err = ccs_tuner_tell(tuner, 3, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	release(3, configurations, evaluations);
+	err = ccs_tuner_ask(tuner, 0, NULL, &population_size);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(population_size == 5);
+	err = ccs_tuner_ask(tuner, 5, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	evaluate(ospace, 5, configurations, evaluations);
+	err = ccs_tuner_tell(tuner, 5, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	release(5, configurations, evaluations);
+
+	for (size_t i = 1; i < 60; i++) {
+		err = ccs_tuner_ask(tuner, 8, configurations, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		evaluate(ospace, 8, configurations, evaluations);
+		err = ccs_tuner_tell(tuner, 8, evaluations);
+		assert(err == CCS_RESULT_SUCCESS);
+		release(8, configurations, evaluations);
+	}
+
+	size_t           count;
+	ccs_evaluation_t history[480];
+	ccs_datum_t      min = ccs_float(INFINITY);
+	err = ccs_tuner_get_history(tuner, 480, history, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 480);
+
+	for (size_t i = 0; i < 480; i++) {
+		ccs_datum_t res;
+		err = ccs_evaluation_get_objective_value(history[i], 0, &res);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (res.value.f < min.value.f)
+			min.value.f = res.value.f;
+	}
+
+	ccs_evaluation_t evaluation;
+	ccs_datum_t      res;
+	err = ccs_tuner_get_optima(tuner, 1, &evaluation, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(res.value.f == min.value.f);
+	/* the strategy should have converged to the minimum */
+	assert(min.value.f < 1e-4);
+
+	/* Test (de)serialization */
+	err = ccs_create_map(&map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_SIZE, &buff_size,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	buff = (char *)malloc(buff_size);
+	assert(buff);
+
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_object_deserialize(
+		(ccs_object_t *)&tuner_copy, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_DESERIALIZE_OPTION_HANDLE_MAP, map,
+		CCS_DESERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_tuner_get_history(tuner_copy, 480, history, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 480);
+	err = ccs_tuner_get_optima(tuner_copy, 1, &evaluation, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_cma_es_tuner_get_properties(
+		tuner_copy, &population_size, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(population_size == 8);
+
+	err = ccs_map_get(map, ccs_object((ccs_object_t)tuner), &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.type == CCS_DATA_TYPE_OBJECT);
+	assert(d.value.o == (ccs_object_t)tuner_copy);
+
+	free(buff);
+	err = ccs_release_object(map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner_copy);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	release_spaces(parameters, cspace, ospace, expression);
+}
+
+void
+test_stale()
+{
+	ccs_parameter_t           parameters[5];
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_tuner_t               tuner;
+	ccs_result_t              err;
+	size_t                    count;
+	ccs_configuration_t       configurations[16];
+	ccs_evaluation_t          evaluations[16];
+
+	create_spaces(parameters, &cspace, &ospace, &expression);
+	err = ccs_create_cma_es_tuner(
+		"problem", cspace, ospace, 0, 0.5, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_ask(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 8);
+
+	/* a batch larger than the population, the second half is reported
+	 * after the generation has been updated */
+	err = ccs_tuner_ask(tuner, 16, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	evaluate(ospace, 16, configurations, evaluations);
+	err = ccs_tuner_tell(tuner, 16, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_ask(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 8);
+	/* reporting twice is harmless */
+	err = ccs_tuner_tell(tuner, 4, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_get_history(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 20);
+	release(16, configurations, evaluations);
+
+	/* configurations asked but never reported */
+	err = ccs_tuner_ask(tuner, 5, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t j = 0; j < 5; j++) {
+		err = ccs_release_object(configurations[j]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	release_spaces(parameters, cspace, ospace, expression);
+}
+
+void
+test_conditions()
+{
+	ccs_parameter_t           parameters[3], parameter4;
+	ccs_distribution_t        distribution;
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_tuner_t               tuner;
+	ccs_result_t              err;
+	ccs_datum_t               kinds[3] = {
+		ccs_string("a"), ccs_string("b"), ccs_string("c")};
+
+	err = ccs_create_categorical_parameter(
+		"kind", 3, kinds, 0, parameters);
+	assert(err == CCS_RESULT_SUCCESS);
+	parameters[1] = create_numerical("x", -5.0, 5.0);
+	err           = ccs_create_numerical_parameter(
+		"y", CCS_NUMERIC_TYPE_INT, CCSI(1), CCSI(1000), CCSI(0),
+		CCSI(10), parameters + 2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_uniform_distribution(
+		CCS_NUMERIC_TYPE_INT, CCSI(1), CCSI(1000),
+		CCS_SCALE_TYPE_LOGARITHMIC, CCSI(0), &distribution);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_configuration_space("conditions", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(
+		cspace, parameters[0], NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(
+		cspace, parameters[1], NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(
+		cspace, parameters[2], distribution);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* x is only active for kind "a" */
+	err = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_EQUAL, ccs_object(parameters[0]),
+		ccs_string("a"), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_set_condition(cspace, 1, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* y must be at least 10 */
+	err = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_LESS, ccs_object(parameters[2]),
+		ccs_int(10), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_forbidden_clause(cspace, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameter4 = create_numerical("z", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter4, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("score", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression, CCS_OBJECTIVE_TYPE_MAXIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_cma_es_tuner(
+		"conditions", cspace, ospace, 0, 0.0, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	for (size_t i = 0; i < 25; i++) {
+		ccs_configuration_t configurations[4];
+		ccs_evaluation_t    evaluations[4];
+		err = ccs_tuner_ask(tuner, 4, configurations, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 4; j++) {
+			ccs_datum_t values[3], res;
+			ccs_bool_t  valid;
+			err = ccs_configuration_space_check_configuration(
+				cspace, configurations[j], &valid);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(valid);
+			err = ccs_configuration_get_values(
+				configurations[j], 3, values, NULL);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(values[2].type == CCS_DATA_TYPE_INT);
+			assert(values[2].value.i >= 10 &&
+			       values[2].value.i < 1000);
+			if (!strcmp(values[0].value.s, "a")) {
+				assert(values[1].type == CCS_DATA_TYPE_FLOAT);
+				res = ccs_float(
+					-values[1].value.f * values[1].value.f -
+					log((double)values[2].value.i));
+			} else {
+				assert(values[1].type ==
+				       CCS_DATA_TYPE_INACTIVE);
+				res = ccs_float(-10.0);
+			}
+			err = ccs_create_evaluation(
+				ospace, configurations[j], CCS_RESULT_SUCCESS,
+				1, &res, evaluations + j);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+		err = ccs_tuner_tell(tuner, 4, evaluations);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 4; j++) {
+			err = ccs_release_object(configurations[j]);
+			assert(err == CCS_RESULT_SUCCESS);
+			err = ccs_release_object(evaluations[j]);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+	}
+
+	ccs_evaluation_t evaluation;
+	ccs_datum_t      res;
+	err = ccs_tuner_get_optima(tuner, 1, &evaluation, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(res.value.f > -10.0);
+
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(distribution);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+int
+main()
+{
+	ccs_init();
+	test();
+	test_stale();
+	test_conditions();
+	ccs_clear_thread_error();
+	ccs_fini();
+	return 0;
+}
@@ -636,6 +636,242 @@ test_deserialize()
 	free(buff);
 }
 
+void
+test_binding_pool()
+{
+	ccs_parameter_t           parameters[3];
+	ccs_configuration_space_t configuration_space;
+	ccs_configuration_t       configurations[8], configuration;
+	ccs_datum_t               value;
+	ccs_result_t              err;
+	size_t                    capacity;
+	int                       reused;
+
+	err = ccs_create_configuration_space(
+		"my_config_space", &configuration_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameters[0] = create_dummy_parameter("param1");
+	parameters[1] = create_dummy_parameter("param2");
+	parameters[2] = create_dummy_parameter("param3");
+
+	err           = ccs_configuration_space_add_parameters(
+                configuration_space, 2, parameters, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_context_get_binding_pool_capacity(
+		(ccs_context_t)configuration_space, &capacity);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(capacity == 0);
+
+	err = ccs_context_set_binding_pool_capacity(
+		(ccs_context_t)configuration_space, 4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_context_get_binding_pool_capacity(
+		(ccs_context_t)configuration_space, &capacity);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(capacity == 4);
+
+	err = ccs_configuration_space_samples(
+		configuration_space, 8, configurations);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 8; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_configuration_get_value(configurations[0], 0, &value);
+	assert(err == CCS_RESULT_ERROR_INVALID_OBJECT);
+
+	err = ccs_configuration_space_sample(
+		configuration_space, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	reused = 0;
+	for (size_t i = 0; i < 8; i++)
+		if (configuration == configurations[i])
+			reused = 1;
+	assert(reused);
+	check_configuration(configuration_space, 2, parameters);
+	err = ccs_release_object(configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_configuration_space_add_parameter(
+		configuration_space, parameters[2], NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	check_configuration(configuration_space, 3, parameters);
+
+	err = ccs_configuration_space_samples(
+		configuration_space, 8, configurations);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_context_set_binding_pool_capacity(
+		(ccs_context_t)configuration_space, 2);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	for (size_t i = 0; i < 8; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(configuration_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+void
+test_neighbors()
+{
+	ccs_parameter_t           parameters[4];
+	ccs_configuration_space_t space;
+	ccs_expression_t          expression;
+	ccs_configuration_t       configuration, other;
+	ccs_configuration_t       neighbors[200];
+	ccs_datum_t               values[4], nvalues[4];
+	ccs_datum_t               possible_values[5];
+	ccs_result_t              err;
+	ccs_bool_t                check;
+	size_t                    activated = 0;
+	size_t                    moved[3]  = {0, 0, 0};
+
+	for (int i = 0; i < 5; i++)
+		possible_values[i] = ccs_int(i + 1);
+	err = ccs_create_numerical_parameter(
+		"p0", CCS_NUMERIC_TYPE_FLOAT, CCSF(-1.0), CCSF(1.0), CCSF(0.0),
+		CCSF(0.5), parameters);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_ordinal_parameter(
+		"p1", 5, possible_values, 2, parameters + 1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_categorical_parameter(
+		"p2", 3, possible_values, 0, parameters + 2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_numerical_parameter(
+		"p3", CCS_NUMERIC_TYPE_INT, CCSI(0), CCSI(10), CCSI(0), CCSI(0),
+		parameters + 3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_configuration_space("space", &space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameters(
+		space, 4, parameters, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* p3 is only active when p0 is negative */
+	err = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_LESS, ccs_object(parameters[0]),
+		ccs_float(0.0), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_set_condition(space, 3, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	/* p2 cannot take its last value */
+	err = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_EQUAL, ccs_object(parameters[2]),
+		ccs_int(3), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_forbidden_clause(space, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	values[0] = ccs_float(0.5);
+	values[1] = ccs_int(3);
+	values[2] = ccs_int(1);
+	values[3] = ccs_inactive;
+	err       = ccs_create_configuration(space, 4, values, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_configuration_space_get_neighbors(
+		space, configuration, 200, NULL, neighbors);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 200; i++) {
+		size_t changes = 0;
+		err = ccs_configuration_space_check_configuration(
+			space, neighbors[i], &check);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(check);
+		err = ccs_configuration_get_values(
+			neighbors[i], 4, nvalues, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 3; j++)
+			if (memcmp(nvalues + j, values + j,
+				   sizeof(ccs_datum_t))) {
+				changes++;
+				moved[j]++;
+			}
+		assert(changes == 1);
+		if (nvalues[1].value.i != 3)
+			assert(nvalues[1].value.i == 2 ||
+			       nvalues[1].value.i == 4);
+		assert(nvalues[2].value.i != 3);
+		if (nvalues[0].value.f < 0.0) {
+			assert(nvalues[3].type == CCS_DATA_TYPE_INT);
+			activated++;
+		} else
+			assert(nvalues[3].type == CCS_DATA_TYPE_INACTIVE);
+		err = ccs_release_object(neighbors[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	for (size_t j = 0; j < 3; j++)
+		assert(moved[j] > 0);
+	assert(activated > 0);
+
+	/* moving p0 back deactivates p3 */
+	values[0] = ccs_float(-0.5);
+	values[3] = ccs_int(5);
+	err       = ccs_create_configuration(space, 4, values, &other);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_get_neighbors(
+		space, other, 200, NULL, neighbors);
+	assert(err == CCS_RESULT_SUCCESS);
+	activated = 0;
+	for (size_t i = 0; i < 200; i++) {
+		err = ccs_configuration_get_values(
+			neighbors[i], 4, nvalues, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (nvalues[0].value.f >= 0.0)
+			assert(nvalues[3].type == CCS_DATA_TYPE_INACTIVE);
+		else {
+			assert(nvalues[3].type == CCS_DATA_TYPE_INT);
+			assert(nvalues[3].value.i >= 0 &&
+			       nvalues[3].value.i < 10);
+			activated++;
+		}
+		err = ccs_release_object(neighbors[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	assert(activated < 200);
+	err = ccs_release_object(other);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_configuration_space_get_neighbors(
+		space, configuration, 0, NULL, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_get_neighbors(
+		space, configuration, 1, NULL, NULL);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	values[2] = ccs_int(4);
+	err       = ccs_create_configuration(space, 4, values, &other);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_get_neighbors(
+		space, other, 1, NULL, neighbors);
+	assert(err == CCS_RESULT_ERROR_INVALID_CONFIGURATION);
+	err = ccs_release_object(other);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_release_object(configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(space);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 4; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
 int
 main()
 {
@@ -647,6 +883,8 @@ main()
 	test_set_distribution();
 	test_deserialize();
 	test_configuration_deserialize();
+	test_binding_pool();
+	test_neighbors();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 #include <cconfigspace.h>
 
 #define NUM_SAMPLES 20000
@@ -35,6 +36,134 @@ my_tree_get_child(
 	return CCS_RESULT_SUCCESS;
 }
 
+static size_t num_get_child = 0;
+
+static ccs_result_t
+my_counting_tree_get_child(
+	ccs_tree_space_t tree_space,
+	ccs_tree_t       parent,
+	size_t           child_index,
+	ccs_tree_t      *child_ret)
+{
+	__atomic_add_fetch(&num_get_child, 1, __ATOMIC_RELAXED);
+	return my_tree_get_child(tree_space, parent, child_index, child_ret);
+}
+
+static size_t
+walk_tree_space(
+	ccs_tree_space_t tree_space,
+	size_t          *position,
+	size_t           position_size)
+{
+	ccs_result_t err;
+	ccs_tree_t   tree;
+	ccs_datum_t  values[5];
+	size_t       arity, count = 1;
+
+	err = ccs_tree_space_get_values_at_position(
+		tree_space, position_size, position, 5, values);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(values[0].value.i == 400);
+	for (size_t i = 0; i < position_size; i++)
+		assert(values[i + 1].value.i ==
+		       (ccs_int_t)((3 - i) * 100 + position[i]));
+	err = ccs_tree_space_get_node_at_position(
+		tree_space, position_size, position, &tree);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		position[position_size] = i;
+		count += walk_tree_space(
+			tree_space, position, position_size + 1);
+	}
+	return count;
+}
+
+void
+test_prefetch()
+{
+	ccs_result_t                    err;
+	ccs_bool_t                      is_valid;
+	ccs_tree_t                      root;
+	ccs_tree_space_t                tree_space;
+	size_t                          num_threads, depth, max_pending;
+	size_t                          position[4], num_nodes;
+	ccs_dynamic_tree_space_vector_t vector = {
+		&my_tree_del, &my_counting_tree_get_child, NULL, NULL};
+
+	err = ccs_create_tree(4, ccs_int(4 * 100), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_dynamic_tree_space(
+		"space", root, &vector, NULL, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_dynamic_tree_space_get_prefetch(
+		tree_space, &num_threads, &depth, &max_pending);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(num_threads == 0);
+	assert(depth == 0);
+	assert(max_pending == 0);
+
+	err = ccs_dynamic_tree_space_set_prefetch(tree_space, 4, 0, 8);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_dynamic_tree_space_set_prefetch(tree_space, 4, 2, 0);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_dynamic_tree_space_set_prefetch(tree_space, 4, 2, 8);
+	/* built without POSIX threads */
+	if (err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION) {
+		ccs_clear_thread_error();
+		err = ccs_release_object(root);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(tree_space);
+		assert(err == CCS_RESULT_SUCCESS);
+		return;
+	}
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_dynamic_tree_space_get_prefetch(
+		tree_space, &num_threads, &depth, &max_pending);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(num_threads == 4);
+	assert(depth == 2);
+	assert(max_pending == 8);
+
+	/* every node is generated exactly once, whether it was prefetched,
+	 * waited for, or generated on demand */
+	num_nodes = walk_tree_space(tree_space, position, 0);
+	assert(num_nodes == 24);
+	assert(__atomic_load_n(&num_get_child, __ATOMIC_RELAXED) ==
+	       num_nodes - 1);
+
+	err = ccs_dynamic_tree_space_set_prefetch(tree_space, 0, 0, 0);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_dynamic_tree_space_get_prefetch(
+		tree_space, &num_threads, NULL, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(num_threads == 0);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* pending prefetches are dropped with the tree space */
+	err = ccs_create_tree(4, ccs_int(4 * 100), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_dynamic_tree_space(
+		"space", root, &vector, NULL, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_dynamic_tree_space_set_prefetch(tree_space, 2, 3, 4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_space_check_position(tree_space, 0, NULL, &is_valid);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(is_valid == CCS_TRUE);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 void
 test_dynamic_tree_space()
 {
@@ -214,11 +343,170 @@ test_dynamic_tree_space()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static ccs_result_t
+my_weighted_tree_get_child(
+	ccs_tree_space_t tree_space,
+	ccs_tree_t       parent,
+	size_t           child_index,
+	ccs_tree_t      *child_ret)
+{
+	ccs_result_t err;
+	size_t       depth;
+
+	err = my_tree_get_child(tree_space, parent, child_index, child_ret);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_position(parent, 0, NULL, &depth);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_weight(*child_ret, (depth + 1 + child_index) % 3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_bias(*child_ret, child_index % 2 ? 2.0 : 1.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Only valid once every node of the tree has been generated. */
+static ccs_float_t
+subtree_weight(ccs_tree_t tree)
+{
+	ccs_result_t err;
+	ccs_float_t  weight, bias;
+	size_t       arity;
+
+	err = ccs_tree_get_weight(tree, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_bias(tree, &bias);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(child);
+		weight += subtree_weight(child);
+	}
+	return weight * bias;
+}
+
+/* Nodes are identified by their position, read as a base 5 number with
+ * digits offset by one. */
+#define MAX_NODE_ID 3125
+
+static void
+expected_distribution(
+	ccs_tree_t   tree,
+	size_t       id,
+	ccs_float_t  probability,
+	ccs_float_t *expected)
+{
+	ccs_result_t err;
+	ccs_float_t  weight, total, child_weights[4];
+	ccs_tree_t   children[4];
+	size_t       arity;
+
+	err = ccs_tree_get_weight(tree, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	total = weight;
+	for (size_t i = 0; i < arity; i++) {
+		err = ccs_tree_get_child(tree, i, children + i);
+		assert(err == CCS_RESULT_SUCCESS);
+		child_weights[i] = subtree_weight(children[i]);
+		total += child_weights[i];
+	}
+	expected[id] = probability * weight / total;
+	for (size_t i = 0; i < arity; i++)
+		if (child_weights[i] != 0.0)
+			expected_distribution(
+				children[i], id * 5 + i + 1,
+				probability * child_weights[i] / total,
+				expected);
+}
+
+static void
+count_samples(
+	ccs_tree_space_t          tree_space,
+	size_t                    num_samples,
+	ccs_tree_configuration_t *configs,
+	size_t                   *counts)
+{
+	ccs_result_t err;
+	ccs_bool_t   is_valid;
+	size_t       position_size, position[4], id;
+
+	err = ccs_tree_space_samples(tree_space, num_samples, configs);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < num_samples; i++) {
+		err = ccs_tree_configuration_get_position(
+			configs[i], 4, position, &position_size);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_space_check_position(
+			tree_space, position_size, position, &is_valid);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(is_valid == CCS_TRUE);
+		id = 0;
+		for (size_t j = 0; j < position_size; j++)
+			id = id * 5 + position[j] + 1;
+		counts[id]++;
+		err = ccs_release_object(configs[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
+void
+test_sampling_distribution()
+{
+	ccs_result_t                    err;
+	ccs_tree_t                      root;
+	ccs_tree_space_t                tree_space;
+	size_t                          position[4], num_nodes;
+	static size_t                   counts[MAX_NODE_ID];
+	static ccs_float_t              expected[MAX_NODE_ID];
+	static ccs_tree_configuration_t configs[NUM_SAMPLES];
+	ccs_dynamic_tree_space_vector_t vector = {
+		&my_tree_del, &my_weighted_tree_get_child, NULL, NULL};
+
+	err = ccs_create_tree(4, ccs_int(4 * 100), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_dynamic_tree_space(
+		"space", root, &vector, NULL, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* positions sampled while the tree is being generated are valid */
+	count_samples(tree_space, NUM_SAMPLES, configs, counts);
+
+	num_nodes = walk_tree_space(tree_space, position, 0);
+	assert(num_nodes == 24);
+	memset(counts, 0, sizeof(counts));
+	expected_distribution(root, 0, 1.0, expected);
+	count_samples(tree_space, NUM_SAMPLES, configs, counts);
+
+	/* stopping at a node of weight 0, or entering a subtree of weight 0,
+	 * never happens; other outcomes are within 6 standard deviations */
+	for (size_t id = 0; id < MAX_NODE_ID; id++) {
+		ccs_float_t mean = NUM_SAMPLES * expected[id];
+		if (expected[id] == 0.0)
+			assert(counts[id] == 0);
+		else
+			assert(fabs(counts[id] - mean) <=
+			       6.0 * sqrt(mean * (1.0 - expected[id])) + 1.0);
+	}
+	assert(expected[3] == 0.0);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test_dynamic_tree_space();
+	test_prefetch();
+	test_sampling_distribution();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
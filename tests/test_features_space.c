@@ -434,6 +434,135 @@ test_features_deserialize()
 	}
 }
 
+void
+test_intern_features()
+{
+	ccs_parameter_t      parameters[3];
+	ccs_features_space_t features_space;
+	ccs_features_t       features1, features2, features3, features_ref;
+	ccs_datum_t          possible_values[2] = {
+                ccs_string("small"), ccs_string("large")};
+	ccs_datum_t values[3] = {ccs_float(-1.0), ccs_float(0.0), ccs_none};
+	ccs_datum_t value;
+	char        name[8];
+	ccs_hash_t  hash1, hash2;
+	size_t      capacity;
+	int32_t     refcount;
+	int         cmp;
+	ccs_result_t err;
+
+	err = ccs_create_features_space("my_config_space", &features_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	parameters[0] = create_dummy_parameter("param1");
+	parameters[1] = create_dummy_parameter("param2");
+	err           = ccs_create_categorical_parameter(
+                "param3", 2, possible_values, 0, parameters + 2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_space_add_parameters(features_space, 3, parameters);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_features_space_get_interned_features_capacity(
+		features_space, &capacity);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(capacity == 64);
+
+	/* transient strings are memoized by the features space */
+	strcpy(name, "large");
+	values[2]       = ccs_string(name);
+	values[2].flags = CCS_DATUM_FLAG_TRANSIENT;
+	err             = ccs_features_space_intern_features(
+                features_space, 3, values, &features1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_get_value(features1, 2, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(value.type == CCS_DATA_TYPE_STRING);
+	assert(value.value.s != name);
+	assert(!strcmp(value.value.s, "large"));
+
+	values[2] = ccs_string("large");
+	err       = ccs_features_space_intern_features(
+                features_space, 3, values, &features2);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(features1 == features2);
+	err = ccs_object_get_refcount(features1, &refcount);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(refcount == 2);
+
+	err = ccs_create_features(features_space, 3, values, &features_ref);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_hash(features1, &hash1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_hash(features_ref, &hash2);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(hash1 == hash2);
+	err = ccs_features_cmp(features1, features_ref, &cmp);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(!cmp);
+
+	/* interned features are immutable */
+	err = ccs_features_set_value(features1, 0, ccs_float(1.0));
+	assert(err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+	err = ccs_binding_set_value(
+		(ccs_binding_t)features1, 0, ccs_float(1.0));
+	assert(err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+	err = ccs_features_set_value(features_ref, 0, ccs_float(1.0));
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* released features are revived */
+	err = ccs_release_object(features1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(features2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_space_intern_features(
+		features_space, 3, values, &features2);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(features1 == features2);
+	err = ccs_object_get_refcount(features2, &refcount);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(refcount == 1);
+
+	values[0] = ccs_float(1.0);
+	err       = ccs_features_space_intern_features(
+                features_space, 3, values, &features3);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(features3 != features2);
+	err = ccs_features_cmp(features3, features_ref, &cmp);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(!cmp);
+
+	err = ccs_features_space_intern_features(
+		features_space, 2, values, &features1);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	values[0] = ccs_float(10.0);
+	err       = ccs_features_space_intern_features(
+                features_space, 3, values, &features1);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+
+	err = ccs_features_space_set_interned_features_capacity(
+		features_space, 0);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(features3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(features_ref);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* interned features keep their features space alive */
+	err = ccs_release_object(features_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_get_value(features2, 0, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(value.value.f == -1.0);
+	err = ccs_features_space_set_interned_features_capacity(
+		features_space, 64);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(features2);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
 int
 main()
 {
@@ -444,6 +573,7 @@ main()
 	test_features();
 	test_deserialize();
 	test_features_deserialize();
+	test_intern_features();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
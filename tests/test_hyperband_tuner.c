@@ -0,0 +1,449 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <cconfigspace.h>
+#include <string.h>
+
+ccs_parameter_t
+create_numerical(const char *name, double lower, double upper)
+{
+	ccs_parameter_t parameter;
+	ccs_result_t    err;
+	err = ccs_create_numerical_parameter(
+		name, CCS_NUMERIC_TYPE_FLOAT, CCSF(lower), CCSF(upper),
+		CCSF(0.0), CCSF(0), &parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	return parameter;
+}
+
+ccs_evaluation_t
+evaluate(ccs_objective_space_t ospace, ccs_configuration_t configuration)
+{
+	ccs_datum_t      values[3], res;
+	ccs_evaluation_t evaluation;
+	ccs_result_t     err;
+	err = ccs_configuration_get_values(configuration, 3, values, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	res = ccs_float(
+		(values[0].value.f - 1) * (values[0].value.f - 1) +
+		(values[1].value.f - 2) * (values[1].value.f - 2) +
+		10.0 / values[2].value.i);
+	err = ccs_create_evaluation(
+		ospace, configuration, CCS_RESULT_SUCCESS, 1, &res,
+		&evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	return evaluation;
+}
+
+void
+test()
+{
+	ccs_parameter_t           parameter1, parameter2, fidelity;
+	ccs_parameter_t           parameter3;
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_tuner_t               tuner, tuner_copy;
+	ccs_result_t              err;
+	ccs_datum_t               d;
+	char                     *buff;
+	size_t                    buff_size;
+	ccs_map_t                 map;
+	ccs_configuration_t       configurations[81], extra;
+	ccs_evaluation_t          evaluations[81];
+	size_t                    fidelity_index, count;
+	ccs_float_t               eta;
+
+	parameter1 = create_numerical("x", -5.0, 5.0);
+	parameter2 = create_numerical("y", -5.0, 5.0);
+	err        = ccs_create_numerical_parameter(
+		"iterations", CCS_NUMERIC_TYPE_INT, CCSI(1), CCSI(82), CCSI(0),
+		CCSI(1), &fidelity);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_configuration_space("2dplane", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter1, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter2, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, fidelity, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameter3 = create_numerical("z", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter3, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_objective_space("height", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 0, 3.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_PARAMETER);
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 1.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 3.0, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_hyperband_tuner_get_properties(tuner, &fidelity_index, &eta);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(fidelity_index == 2);
+	assert(eta == 3.0);
+
+	/* first bracket: 81 configurations with 1 iteration */
+	err = ccs_tuner_ask(tuner, 81, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 81; i++) {
+		err = ccs_configuration_get_value(configurations[i], 2, &d);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(d.type == CCS_DATA_TYPE_INT && d.value.i == 1);
+		evaluations[i] = evaluate(ospace, configurations[i]);
+	}
+	/* the first rung is pending: the second bracket is started, with 3
+	 * iterations */
+	err = ccs_tuner_ask(tuner, 1, &extra, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_get_value(extra, 2, &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.type == CCS_DATA_TYPE_INT && d.value.i == 3);
+
+	err = ccs_tuner_tell(tuner, 81, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_get_optima(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 0);
+
+	/* the best third of the first rung is promoted to 3 iterations */
+	ccs_datum_t threshold = ccs_float(-INFINITY);
+	{
+		ccs_float_t objectives[81];
+		for (size_t i = 0; i < 81; i++) {
+			err = ccs_evaluation_get_objective_value(
+				evaluations[i], 0, &d);
+			assert(err == CCS_RESULT_SUCCESS);
+			objectives[i] = d.value.f;
+		}
+		for (size_t i = 0; i < 27; i++) {
+			size_t best = 0;
+			for (size_t j = 1; j < 81; j++)
+				if (objectives[j] < objectives[best])
+					best = j;
+			threshold.value.f = objectives[best];
+			objectives[best]  = INFINITY;
+		}
+	}
+	for (size_t i = 0; i < 81; i++) {
+		ccs_release_object(configurations[i]);
+		ccs_release_object(evaluations[i]);
+	}
+	err = ccs_tuner_ask(tuner, 27, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 27; i++) {
+		ccs_datum_t values[3];
+		err = ccs_configuration_get_values(
+			configurations[i], 3, values, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(values[2].type == CCS_DATA_TYPE_INT &&
+		       values[2].value.i == 3);
+		/* objective at the previous rung */
+		assert((values[0].value.f - 1) * (values[0].value.f - 1) +
+			       (values[1].value.f - 2) *
+				       (values[1].value.f - 2) +
+			       10.0 <=
+		       threshold.value.f);
+		evaluations[i] = evaluate(ospace, configurations[i]);
+	}
+	err = ccs_tuner_tell(tuner, 27, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 27; i++) {
+		ccs_release_object(configurations[i]);
+		ccs_release_object(evaluations[i]);
+	}
+	evaluations[0] = evaluate(ospace, extra);
+	err            = ccs_tuner_tell(tuner, 1, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	ccs_release_object(extra);
+	ccs_release_object(evaluations[0]);
+
+	/* run until some configurations reach the maximum budget */
+	for (size_t i = 0; i < 50; i++) {
+		err = ccs_tuner_ask(tuner, 10, configurations, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 10; j++) {
+			err = ccs_configuration_get_value(
+				configurations[j], 2, &d);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(d.value.i == 1 || d.value.i == 3 ||
+			       d.value.i == 9 || d.value.i == 27 ||
+			       d.value.i == 81);
+			evaluations[j] = evaluate(ospace, configurations[j]);
+		}
+		err = ccs_tuner_tell(tuner, 10, evaluations);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 10; j++) {
+			ccs_release_object(configurations[j]);
+			ccs_release_object(evaluations[j]);
+		}
+	}
+	err = ccs_tuner_get_history(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 81 + 27 + 1 + 500);
+
+	ccs_evaluation_t    optimum;
+	ccs_configuration_t configuration;
+	err = ccs_tuner_get_optima(tuner, 1, &optimum, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_evaluation_get_configuration(optimum, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_get_value(configuration, 2, &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.value.i == 81);
+	err = ccs_tuner_suggest(tuner, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_get_value(configuration, 2, &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.value.i == 81);
+	ccs_release_object(configuration);
+
+	/* Test (de)serialization */
+	err = ccs_create_map(&map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_SIZE, &buff_size,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	buff = (char *)malloc(buff_size);
+	assert(buff);
+
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_object_deserialize(
+		(ccs_object_t *)&tuner_copy, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_DESERIALIZE_OPTION_HANDLE_MAP, map,
+		CCS_DESERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_hyperband_tuner_get_properties(
+		tuner_copy, &fidelity_index, &eta);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(fidelity_index == 2);
+	assert(eta == 3.0);
+	err = ccs_tuner_get_history(tuner_copy, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 81 + 27 + 1 + 500);
+	err = ccs_tuner_get_optima(tuner_copy, 1, &optimum, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+
+	err = ccs_map_get(map, ccs_object((ccs_object_t)tuner), &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.type == CCS_DATA_TYPE_OBJECT);
+	assert(d.value.o == (ccs_object_t)tuner_copy);
+
+	free(buff);
+	err = ccs_release_object(map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner_copy);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(fidelity);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+ccs_configuration_space_t
+create_quantized_space(ccs_parameter_t *parameters)
+{
+	ccs_configuration_space_t cspace;
+	ccs_result_t              err;
+	parameters[0] = create_numerical("x", -5.0, 5.0);
+	parameters[1] = create_numerical("y", -5.0, 5.0);
+	err           = ccs_create_numerical_parameter(
+		"epochs", CCS_NUMERIC_TYPE_FLOAT, CCSF(0.5), CCSF(10.0),
+		CCSF(0.5), CCSF(0.5), &parameters[2]);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_configuration_space("quantized", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_configuration_space_add_parameter(
+			cspace, parameters[i], NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	return cspace;
+}
+
+void
+release_quantized_space(
+	ccs_configuration_space_t cspace,
+	ccs_parameter_t          *parameters)
+{
+	ccs_result_t err;
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(parameters[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+void
+test_quantized_fidelity()
+{
+	ccs_parameter_t           parameters[3], objective;
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_tuner_t               tuner;
+	ccs_result_t              err;
+	ccs_configuration_t       configurations[10];
+	ccs_evaluation_t          evaluations[10];
+	size_t                    count, max_budget_count = 0;
+
+	objective = create_numerical("z", -CCS_INFINITY, CCS_INFINITY);
+	err       = ccs_create_variable(objective, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("height", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, objective);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* the fidelity must not take part in conditions */
+	cspace = create_quantized_space(parameters);
+	err    = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_LESS, ccs_object(parameters[2]),
+		ccs_float(5.0), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_set_condition(cspace, 0, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 3.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_PARAMETER);
+	release_quantized_space(cspace, parameters);
+
+	/* nor be conditional */
+	cspace = create_quantized_space(parameters);
+	err    = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_LESS, ccs_object(parameters[0]),
+		ccs_float(0.0), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_set_condition(cspace, 2, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 3.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_PARAMETER);
+	release_quantized_space(cspace, parameters);
+
+	/* nor take part in forbidden clauses */
+	cspace = create_quantized_space(parameters);
+	err    = ccs_create_binary_expression(
+		CCS_EXPRESSION_TYPE_GREATER, ccs_object(parameters[2]),
+		ccs_float(9.0), &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_forbidden_clause(cspace, expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 3.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_PARAMETER);
+	release_quantized_space(cspace, parameters);
+
+	/* budgets are on the quantization grid of the fidelity: 9.5 is the
+	 * maximum budget, and 9.5 / 3 and 9.5 / 9 are rounded to 3.0 and 1.0 */
+	cspace = create_quantized_space(parameters);
+	err    = ccs_create_hyperband_tuner(
+		"problem", cspace, ospace, 2, 3.0, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 30; i++) {
+		err = ccs_tuner_ask(tuner, 10, configurations, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 10; j++) {
+			ccs_datum_t values[3], res;
+			ccs_bool_t  is_valid;
+			err = ccs_configuration_get_values(
+				configurations[j], 3, values, NULL);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(values[2].type == CCS_DATA_TYPE_FLOAT);
+			assert(values[2].value.f == 1.0 ||
+			       values[2].value.f == 3.0 ||
+			       values[2].value.f == 9.5);
+			if (values[2].value.f == 9.5)
+				max_budget_count++;
+			err = ccs_configuration_check(
+				configurations[j], &is_valid);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(is_valid);
+			res = ccs_float(
+				values[0].value.f * values[0].value.f +
+				values[1].value.f * values[1].value.f +
+				1.0 / values[2].value.f);
+			err = ccs_create_evaluation(
+				ospace, configurations[j], CCS_RESULT_SUCCESS,
+				1, &res, evaluations + j);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+		err = ccs_tuner_tell(tuner, 10, evaluations);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t j = 0; j < 10; j++) {
+			ccs_release_object(configurations[j]);
+			ccs_release_object(evaluations[j]);
+		}
+	}
+	assert(max_budget_count > 0);
+	/* only evaluations at the maximum budget are optima */
+	err = ccs_tuner_get_optima(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	release_quantized_space(cspace, parameters);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(objective);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+int
+main()
+{
+	ccs_init();
+	test();
+	test_quantized_fidelity();
+	ccs_clear_thread_error();
+	ccs_fini();
+	return 0;
+}
@@ -0,0 +1,429 @@
+#include <stdlib.h>
+#include <assert.h>
+#include <math.h>
+#include <cconfigspace.h>
+#include <string.h>
+
+#define NUM_EVALUATIONS 300
+#define BATCH_SIZE      16
+
+ccs_parameter_t
+create_numerical(const char *name, double lower, double upper)
+{
+	ccs_parameter_t parameter;
+	ccs_result_t    err;
+	err = ccs_create_numerical_parameter(
+		name, CCS_NUMERIC_TYPE_FLOAT, CCSF(lower), CCSF(upper),
+		CCSF(0.0), CCSF(0), &parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	return parameter;
+}
+
+void
+generate_tree(ccs_tree_t *tree, size_t depth, size_t rank)
+{
+	ccs_result_t err;
+	ssize_t      ar    = depth - rank;
+	size_t       arity = (size_t)(ar < 0 ? 0 : ar);
+
+	err = ccs_create_tree(arity, ccs_int(depth * 100 + rank), tree);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		generate_tree(&child, depth - 1, i);
+		err = ccs_tree_set_child(*tree, i, child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(child);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+}
+
+/* Best sum of values along a path starting at tree. */
+ccs_int_t
+best_sum(ccs_tree_t tree)
+{
+	ccs_result_t err;
+	ccs_datum_t  value;
+	size_t       arity;
+	ccs_int_t    best = 0;
+
+	err = ccs_tree_get_value(tree, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		ccs_int_t sum = best_sum(child);
+		if (sum > best)
+			best = sum;
+	}
+	return value.value.i + best;
+}
+
+void
+create_objective_space(
+	ccs_objective_type_t   objective_type,
+	ccs_objective_space_t *ospace)
+{
+	ccs_parameter_t  parameter;
+	ccs_expression_t expression;
+	ccs_result_t     err;
+
+	parameter = create_numerical("sum", -CCS_INFINITY, CCS_INFINITY);
+	err       = ccs_create_variable(parameter, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_objective_space("ospace", ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(*ospace, parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		*ospace, expression, objective_type);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_release_object(parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+ccs_tree_evaluation_t
+evaluate(ccs_objective_space_t ospace, ccs_tree_configuration_t configuration)
+{
+	ccs_datum_t           values[16], res;
+	size_t                num_values;
+	ccs_tree_evaluation_t evaluation;
+	ccs_int_t             v = 0;
+	ccs_result_t          err;
+
+	err = ccs_tree_configuration_get_values(
+		configuration, 16, values, &num_values);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < num_values; i++)
+		v += values[i].value.i;
+	res = ccs_float(v);
+	err = ccs_create_tree_evaluation(
+		ospace, configuration, CCS_RESULT_SUCCESS, 1, &res,
+		&evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	return evaluation;
+}
+
+/* Run the tuner one configuration at a time and return the number of
+ * evaluations reaching the optimum in the second half of the run. */
+size_t
+run(ccs_tree_tuner_t tuner, ccs_objective_space_t ospace, ccs_float_t best)
+{
+	size_t       count = 0;
+	ccs_result_t err;
+
+	for (size_t i = 0; i < NUM_EVALUATIONS; i++) {
+		ccs_tree_configuration_t configuration;
+		ccs_tree_evaluation_t    evaluation;
+		ccs_datum_t              res;
+		err = ccs_tree_tuner_ask(tuner, 1, &configuration, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		evaluation = evaluate(ospace, configuration);
+		err        = ccs_tree_evaluation_get_objective_value(
+                        evaluation, 0, &res);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (i >= NUM_EVALUATIONS / 2 && res.value.f == best)
+			count++;
+		err = ccs_tree_tuner_tell(tuner, 1, &evaluation);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(configuration);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(evaluation);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	return count;
+}
+
+void
+test()
+{
+	ccs_tree_t            root;
+	ccs_tree_space_t      tree_space;
+	ccs_objective_space_t ospace;
+	ccs_tree_tuner_t      tuner, tuner_copy, random_tuner;
+	ccs_tree_tuner_type_t type;
+	ccs_float_t           exploration, best;
+	ccs_result_t          err;
+	ccs_datum_t           d, res;
+	char                 *buff;
+	size_t                buff_size, count, mcts_hits, random_hits;
+	ccs_map_t             map;
+	ccs_tree_evaluation_t evaluation;
+
+	generate_tree(&root, 5, 0);
+	best = best_sum(root);
+	err  = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	create_objective_space(CCS_OBJECTIVE_TYPE_MAXIMIZE, &ospace);
+
+	err = ccs_create_mcts_tree_tuner(
+		"problem", tree_space, ospace, -1.0, &tuner);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_create_mcts_tree_tuner(
+		"problem", tree_space, ospace, 0.25, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_tuner_get_type(tuner, &type);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(type == CCS_TREE_TUNER_TYPE_MCTS);
+	err = ccs_mcts_tree_tuner_get_properties(tuner, &exploration);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(exploration == 0.25);
+
+	err = ccs_create_random_tree_tuner(
+		"random", tree_space, ospace, &random_tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_mcts_tree_tuner_get_properties(random_tuner, &exploration);
+	assert(err == CCS_RESULT_ERROR_INVALID_TUNER);
+
+	mcts_hits   = run(tuner, ospace, best);
+	random_hits = run(random_tuner, ospace, best);
+	assert(mcts_hits > 2 * random_hits);
+
+	err = ccs_tree_tuner_get_optima(tuner, 1, &evaluation, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_tree_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(res.value.f == best);
+
+	/* Test (de)serialization */
+	err = ccs_create_map(&map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_SIZE, &buff_size,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	buff = (char *)malloc(buff_size);
+	assert(buff);
+	err = ccs_object_serialize(
+		tuner, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_object_deserialize(
+		(ccs_object_t *)&tuner_copy, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_DESERIALIZE_OPTION_HANDLE_MAP, map,
+		CCS_DESERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_tree_tuner_get_type(tuner_copy, &type);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(type == CCS_TREE_TUNER_TYPE_MCTS);
+	err = ccs_mcts_tree_tuner_get_properties(tuner_copy, &exploration);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(exploration == 0.25);
+
+	err = ccs_tree_tuner_get_history(tuner_copy, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == NUM_EVALUATIONS);
+	err = ccs_tree_tuner_get_optima(tuner_copy, 1, &evaluation, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_tree_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(res.value.f == best);
+
+	/* The copy rebuilt its statistics from the history */
+	assert(run(tuner_copy, ospace, best) > 2 * random_hits);
+
+	err = ccs_map_get(map, ccs_object((ccs_object_t)tuner), &d);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(d.type == CCS_DATA_TYPE_OBJECT);
+	assert(d.value.o == (ccs_object_t)tuner_copy);
+
+	free(buff);
+	err = ccs_release_object(map);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner_copy);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(random_tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+/* Configurations asked in a batch are spread by the virtual loss. */
+void
+test_batch()
+{
+	ccs_tree_t               root;
+	ccs_tree_space_t         tree_space;
+	ccs_objective_space_t    ospace;
+	ccs_tree_tuner_t         tuner;
+	ccs_tree_configuration_t configurations[BATCH_SIZE];
+	ccs_tree_evaluation_t    evaluations[BATCH_SIZE];
+	ccs_float_t              exploration;
+	ccs_result_t             err;
+	size_t                   count;
+
+	generate_tree(&root, 5, 0);
+	err = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	create_objective_space(CCS_OBJECTIVE_TYPE_MAXIMIZE, &ospace);
+	err = ccs_create_mcts_tree_tuner(
+		"problem", tree_space, ospace, 0.0, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_mcts_tree_tuner_get_properties(tuner, &exploration);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(exploration == sqrt(0.5));
+
+	err = ccs_tree_tuner_ask(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+
+	for (size_t round = 0; round < 10; round++) {
+		size_t distinct = 0;
+		err = ccs_tree_tuner_ask(
+			tuner, BATCH_SIZE, configurations, &count);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(count == BATCH_SIZE);
+		for (size_t i = 0; i < BATCH_SIZE; i++) {
+			int unique = 1;
+			for (size_t j = 0; j < i && unique; j++) {
+				int cmp;
+				err = ccs_tree_configuration_cmp(
+					configurations[i], configurations[j],
+					&cmp);
+				assert(err == CCS_RESULT_SUCCESS);
+				unique = cmp != 0;
+			}
+			distinct += unique;
+		}
+		assert(distinct >= BATCH_SIZE / 2);
+		for (size_t i = 0; i < BATCH_SIZE; i++)
+			evaluations[i] = evaluate(ospace, configurations[i]);
+		err = ccs_tree_tuner_tell(tuner, BATCH_SIZE, evaluations);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t i = 0; i < BATCH_SIZE; i++) {
+			err = ccs_release_object(configurations[i]);
+			assert(err == CCS_RESULT_SUCCESS);
+			err = ccs_release_object(evaluations[i]);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+	}
+	err = ccs_tree_tuner_get_history(tuner, 0, NULL, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 10 * BATCH_SIZE);
+
+	/* Configurations never told are released with the tuner */
+	err = ccs_tree_tuner_ask(tuner, BATCH_SIZE, configurations, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < BATCH_SIZE; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static ccs_result_t
+my_tree_del(ccs_tree_space_t tree_space)
+{
+	(void)tree_space;
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+my_tree_get_child(
+	ccs_tree_space_t tree_space,
+	ccs_tree_t       parent,
+	size_t           child_index,
+	ccs_tree_t      *child_ret)
+{
+	(void)tree_space;
+	ccs_result_t err;
+	size_t       depth;
+	err = ccs_tree_get_position(parent, 0, NULL, &depth);
+	assert(err == CCS_RESULT_SUCCESS);
+	size_t  child_depth = depth + 1;
+	ssize_t ar          = 5 - child_depth - child_index;
+	size_t  arity       = (size_t)(ar < 0 ? 0 : ar);
+
+	err = ccs_create_tree(
+		arity, ccs_int((5 - child_depth) * 100 + child_index),
+		child_ret);
+	assert(err == CCS_RESULT_SUCCESS);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Children of dynamic tree spaces are created on demand, and minimization is
+ * supported. */
+void
+test_dynamic()
+{
+	ccs_tree_t                      root;
+	ccs_tree_space_t                tree_space;
+	ccs_objective_space_t           ospace;
+	ccs_tree_tuner_t                tuner;
+	ccs_tree_evaluation_t           evaluation;
+	ccs_datum_t                     res;
+	ccs_result_t                    err;
+	size_t                          count, hits;
+	ccs_dynamic_tree_space_vector_t vector = {
+		&my_tree_del, &my_tree_get_child, NULL, NULL};
+
+	err = ccs_create_tree(5, ccs_int(500), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_dynamic_tree_space(
+		"space", root, &vector, NULL, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	create_objective_space(CCS_OBJECTIVE_TYPE_MINIMIZE, &ospace);
+	err = ccs_create_mcts_tree_tuner(
+		"problem", tree_space, ospace, 0.5, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* Stopping at the root is the best configuration */
+	hits = run(tuner, ospace, 500.0);
+	assert(hits > NUM_EVALUATIONS / 4);
+
+	err = ccs_tree_tuner_get_optima(tuner, 1, &evaluation, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_tree_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(res.value.f == 500.0);
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+int
+main()
+{
+	ccs_init();
+	test();
+	test_batch();
+	test_dynamic();
+	ccs_clear_thread_error();
+	ccs_fini();
+	return 0;
+}
@@ -601,6 +601,55 @@ test_normal_distribution_strided_samples()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static void
+test_normal_distribution_strided_consistency()
+{
+	ccs_distribution_t distrib     = NULL;
+	ccs_rng_t          rng         = NULL;
+	ccs_result_t       err         = CCS_RESULT_SUCCESS;
+	const size_t       num_samples = 103;
+	ccs_numeric_t      samples[103];
+	ccs_numeric_t      strided_samples[103 * 2];
+
+	err = ccs_create_rng(&rng);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	// contiguous samples go through the batch kernels, strided ones don't
+	for (int i = 0; i < 8; i++) {
+		ccs_scale_type_t scale = (i & 1) ? CCS_SCALE_TYPE_LOGARITHMIC :
+						   CCS_SCALE_TYPE_LINEAR;
+		if (i & 4)
+			err = ccs_create_normal_distribution(
+				CCS_NUMERIC_TYPE_INT, 2.0, 3.0, scale,
+				CCSI((i & 2) ? 3 : 0), &distrib);
+		else
+			err = ccs_create_normal_distribution(
+				CCS_NUMERIC_TYPE_FLOAT, 2.0, 3.0, scale,
+				CCSF((i & 2) ? 0.3 : 0.0), &distrib);
+		assert(err == CCS_RESULT_SUCCESS);
+
+		err = ccs_rng_set_seed(rng, 1234);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_distribution_samples(
+			distrib, rng, num_samples, samples);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_rng_set_seed(rng, 1234);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_distribution_strided_samples(
+			distrib, rng, num_samples, 2, strided_samples);
+		assert(err == CCS_RESULT_SUCCESS);
+
+		for (size_t j = 0; j < num_samples; j++)
+			assert(samples[j].i == strided_samples[j * 2].i);
+
+		err = ccs_release_object(distrib);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_release_object(rng);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 static void
 test_normal_distribution_soa_samples()
 {
@@ -663,6 +712,7 @@ main()
 	test_normal_distribution_float_quantize();
 	test_normal_distribution_float_log_quantize();
 	test_normal_distribution_strided_samples();
+	test_normal_distribution_strided_consistency();
 	test_normal_distribution_soa_samples();
 	ccs_clear_thread_error();
 	ccs_fini();
@@ -2,6 +2,7 @@
 #include <assert.h>
 #include <cconfigspace.h>
 #include <string.h>
+#include <math.h>
 
 #define NUM_SAMPLES 10000
 
@@ -181,6 +182,69 @@ test_oversampling()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+void
+test_convert_samples()
+{
+	ccs_parameter_t parameter;
+	ccs_numeric_t   values[6];
+	ccs_datum_t     results[6];
+	ccs_result_t    err;
+
+	err = ccs_create_numerical_parameter(
+		"my_param", CCS_NUMERIC_TYPE_FLOAT, CCSF(-1.0), CCSF(1.0),
+		CCSF(0.0), CCSF(0.0), &parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	values[0].f = -1.0;
+	values[1].f = 0.5;
+	values[2].f = 1.0;
+	values[3].f = -1.5;
+	values[4].f = nextafter(1.0, 0.0);
+	values[5].f = NAN;
+	err = ccs_parameter_convert_samples(
+		parameter, CCS_TRUE, 6, values, results);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 6; i++) {
+		assert(results[i].flags == CCS_DATUM_FLAG_DEFAULT);
+		if (i == 2 || i == 3 || i == 5)
+			assert(!memcmp(results + i, &ccs_inactive,
+				       sizeof(ccs_datum_t)));
+		else {
+			assert(results[i].type == CCS_DATA_TYPE_FLOAT);
+			assert(results[i].value.f == values[i].f);
+		}
+	}
+	err = ccs_parameter_convert_samples(
+		parameter, CCS_FALSE, 6, values, results);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 5; i++) {
+		assert(results[i].type == CCS_DATA_TYPE_FLOAT);
+		assert(results[i].value.f == values[i].f);
+	}
+	err = ccs_release_object(parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_numerical_parameter(
+		"my_param", CCS_NUMERIC_TYPE_INT, CCSI(-2), CCSI(3), CCSI(0),
+		CCSI(0), &parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 6; i++)
+		values[i].i = (ccs_int_t)i - 3;
+	err = ccs_parameter_convert_samples(
+		parameter, CCS_TRUE, 6, values, results);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 6; i++) {
+		if (i == 0)
+			assert(!memcmp(results + i, &ccs_inactive,
+				       sizeof(ccs_datum_t)));
+		else {
+			assert(results[i].type == CCS_DATA_TYPE_INT);
+			assert(results[i].value.i == values[i].i);
+		}
+	}
+	err = ccs_release_object(parameter);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
@@ -188,6 +252,7 @@ main()
 	test_create();
 	test_samples();
 	test_oversampling();
+	test_convert_samples();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
@@ -32,6 +32,7 @@ test()
 	ccs_datum_t d;
 	char       *buff;
 	size_t      buff_size;
+	size_t      count;
 	ccs_map_t   map;
 
 	parameter1 = create_numerical("x", -5.0, 5.0);
@@ -73,6 +74,13 @@ test()
 		"problem", cspace, fspace, ospace, &tuner);
 	assert(err == CCS_RESULT_SUCCESS);
 
+	/* Categorical features have no distance */
+	err = ccs_features_tuner_set_nearest_features(tuner, 3);
+	assert(err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+	err = ccs_features_tuner_get_nearest_features(tuner, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 0);
+
 	for (size_t i = 0; i < 50; i++) {
 		ccs_datum_t               values[2], res;
 		ccs_configuration_t       configuration;
@@ -123,7 +131,6 @@ test()
 		assert(err == CCS_RESULT_SUCCESS);
 	}
 
-	size_t                    count;
 	ccs_features_evaluation_t history[100];
 	ccs_features_evaluation_t evaluation;
 	ccs_datum_t               min_on  = ccs_float(INFINITY);
@@ -395,12 +402,459 @@ test_evaluation_deserialize()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static void
+tell_nearest(
+	ccs_features_tuner_t      tuner,
+	ccs_configuration_space_t cspace,
+	ccs_objective_space_t     ospace,
+	ccs_features_t            features,
+	ccs_int_t                 x,
+	ccs_float_t               height)
+{
+	ccs_datum_t               value = ccs_int(x), res = ccs_float(height);
+	ccs_configuration_t       configuration;
+	ccs_features_evaluation_t evaluation;
+	ccs_result_t              err;
+	err = ccs_create_configuration(cspace, 1, &value, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_features_evaluation(
+		ospace, configuration, features, CCS_RESULT_SUCCESS, 1, &res,
+		&evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_tell(tuner, 1, &evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static ccs_int_t
+suggest_nearest(
+	ccs_features_tuner_t tuner,
+	ccs_features_space_t fspace,
+	ccs_float_t          size)
+{
+	ccs_datum_t         value = ccs_float(size);
+	ccs_features_t      features;
+	ccs_configuration_t configuration;
+	ccs_result_t        err;
+	err = ccs_create_features(fspace, 1, &value, &features);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_suggest(tuner, features, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_get_value(configuration, 0, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(features);
+	assert(err == CCS_RESULT_SUCCESS);
+	return value.value.i;
+}
+
+void
+test_nearest_features()
+{
+	ccs_parameter_t           parameter1, parameter2, feature;
+	ccs_configuration_space_t cspace;
+	ccs_features_space_t      fspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_features_tuner_t      tuner;
+	ccs_features_t            features;
+	ccs_configuration_t       configurations[4];
+	ccs_datum_t               value;
+	ccs_result_t              err;
+	size_t                    count;
+
+	err = ccs_create_numerical_parameter(
+		"x", CCS_NUMERIC_TYPE_INT, CCSI(0), CCSI(101), CCSI(0),
+		CCSI(0), &parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_configuration_space("line", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter1, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameter2 = create_numerical("z", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter2, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("height", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	feature = create_numerical("size", 0.0, 100.0);
+	err     = ccs_create_features_space("sizes", &fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_space_add_parameter(fspace, feature);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_random_features_tuner(
+		"problem", cspace, fspace, ospace, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_set_nearest_features(tuner, 1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_get_nearest_features(tuner, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+
+	/* Even sizes are seen, the best x is the size itself, except for
+	 * size 46 which shares its optimum with size 50. Enough sizes are
+	 * seen for the index to hold both a tree and unindexed points. */
+	for (ccs_int_t size = 0; size < 100; size += 2) {
+		value = ccs_float(size);
+		err   = ccs_create_features(fspace, 1, &value, &features);
+		assert(err == CCS_RESULT_SUCCESS);
+		tell_nearest(
+			tuner, cspace, ospace, features,
+			size == 46 ? 50 : size, 0.0);
+		tell_nearest(
+			tuner, cspace, ospace, features, size + 1, 1.0);
+		err = ccs_release_object(features);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	/* Unseen sizes get the optimum of the nearest seen size */
+	for (ccs_int_t size = 0; size < 100; size += 2)
+		assert(suggest_nearest(tuner, fspace, size + 0.3) ==
+		       (size == 46 ? 50 : size));
+
+	/* With 3 neighbors of 47.2 (48, 46 and 50), 50 gets the most votes,
+	 * then comes the optimum of the nearest neighbor */
+	err = ccs_features_tuner_set_nearest_features(tuner, 3);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(suggest_nearest(tuner, fspace, 47.2) == 50);
+
+	value = ccs_float(47.2);
+	err   = ccs_create_features(fspace, 1, &value, &features);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_ask(tuner, features, 4, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_get_value(configurations[0], 0, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(value.value.i == 50);
+	err = ccs_configuration_get_value(configurations[1], 0, &value);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(value.value.i == 48);
+	for (size_t i = 0; i < 4; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(features);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* Seen sizes still use their own optima */
+	assert(suggest_nearest(tuner, fspace, 46.0) == 50);
+	assert(suggest_nearest(tuner, fspace, 48.0) == 48);
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(feature);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static ccs_int_t
+suggest_values(ccs_features_tuner_t tuner, ccs_float_t size)
+{
+	ccs_datum_t  feature = ccs_float(size);
+	ccs_datum_t  values[2];
+	size_t       count;
+	ccs_result_t err;
+	err = ccs_features_tuner_suggest_values(
+		tuner, 1, &feature, 2, values, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	assert(values[0].type == CCS_DATA_TYPE_INT);
+	assert(values[1].type == CCS_DATA_TYPE_NONE);
+	return values[0].value.i;
+}
+
+void
+test_suggest_values()
+{
+	ccs_parameter_t           parameter1, parameter2, feature;
+	ccs_configuration_space_t cspace;
+	ccs_features_space_t      fspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression;
+	ccs_features_tuner_t      tuner;
+	ccs_features_t            features;
+	ccs_datum_t               value, values[2];
+	ccs_int_t                 x;
+	size_t                    i, capacity;
+	ccs_result_t              err;
+
+	err = ccs_create_numerical_parameter(
+		"x", CCS_NUMERIC_TYPE_INT, CCSI(0), CCSI(101), CCSI(0),
+		CCSI(0), &parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_configuration_space("line", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter1, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameter2 = create_numerical("z", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter2, &expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("height", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	feature = create_numerical("size", 0.0, 100.0);
+	err     = ccs_create_features_space("sizes", &fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_space_add_parameter(fspace, feature);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_random_features_tuner(
+		"problem", cspace, fspace, ospace, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	value = ccs_float(200.0);
+	err   = ccs_features_tuner_suggest_values(
+		tuner, 1, &value, 1, values, NULL);
+	assert(err == CCS_RESULT_ERROR_INVALID_FEATURES);
+	err = ccs_features_tuner_suggest_values(
+		tuner, 1, &value, 0, NULL, NULL);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+
+	err = ccs_features_tuner_get_suggestion_cache_capacity(
+		tuner, &capacity);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(capacity == 1024);
+
+	/* Random suggestions for features without optima are not cached */
+	x = suggest_values(tuner, 10.0);
+	for (i = 0; i < 20 && suggest_values(tuner, 10.0) == x; i++)
+		;
+	assert(i < 20);
+
+	value = ccs_float(10.0);
+	err   = ccs_create_features(fspace, 1, &value, &features);
+	assert(err == CCS_RESULT_SUCCESS);
+	tell_nearest(tuner, cspace, ospace, features, 10, 1.0);
+	assert(suggest_values(tuner, 10.0) == 10);
+	/* Worse evaluations do not change the optima */
+	tell_nearest(tuner, cspace, ospace, features, 11, 2.0);
+	assert(suggest_values(tuner, 10.0) == 10);
+	tell_nearest(tuner, cspace, ospace, features, 12, 0.0);
+	assert(suggest_values(tuner, 10.0) == 12);
+	err = ccs_release_object(features);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* Suggestions derived from nearest features follow their optima */
+	err = ccs_features_tuner_set_nearest_features(tuner, 1);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(suggest_values(tuner, 33.0) == 12);
+	value = ccs_float(30.0);
+	err   = ccs_create_features(fspace, 1, &value, &features);
+	assert(err == CCS_RESULT_SUCCESS);
+	tell_nearest(tuner, cspace, ospace, features, 30, 0.0);
+	err = ccs_release_object(features);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(suggest_values(tuner, 33.0) == 30);
+	assert(suggest_values(tuner, 10.0) == 12);
+
+	/* Suggestions stay correct when the cache evicts them */
+	err = ccs_features_tuner_set_suggestion_cache_capacity(tuner, 1);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (i = 0; i < 5; i++) {
+		assert(suggest_values(tuner, 10.0) == 12);
+		assert(suggest_values(tuner, 33.0) == 30);
+		assert(suggest_values(tuner, 30.0) == 30);
+	}
+	err = ccs_features_tuner_set_suggestion_cache_capacity(tuner, 0);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_get_suggestion_cache_capacity(
+		tuner, &capacity);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(capacity == 0);
+	assert(suggest_values(tuner, 10.0) == 12);
+	assert(suggest_values(tuner, 33.0) == 30);
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(feature);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+void
+test_batch_tell()
+{
+	ccs_parameter_t           parameter1, parameter2;
+	ccs_parameter_t           parameter3, parameter4, feature;
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_features_space_t      fspace;
+	ccs_expression_t          expression1, expression2;
+	ccs_features_tuner_t      tuner_batch, tuner_single;
+	ccs_features_t            features[3];
+	ccs_configuration_t       configuration;
+	ccs_features_evaluation_t evaluations[300];
+	ccs_features_evaluation_t optima_batch[300], optima_single[300];
+	size_t                    count_batch, count_single;
+	ccs_result_t              err;
+
+	parameter1 = create_numerical("x", -5.0, 5.0);
+	parameter2 = create_numerical("y", -5.0, 5.0);
+	err        = ccs_create_configuration_space("2dplane", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter1, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter2, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	parameter3 = create_numerical("u", -CCS_INFINITY, CCS_INFINITY);
+	parameter4 = create_numerical("v", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter3, &expression1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_variable(parameter4, &expression2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("distances", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression1, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression2, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	feature = create_numerical("size", 0.0, 10.0);
+	err     = ccs_create_features_space("sizes", &fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_space_add_parameter(fspace, feature);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 3; i++) {
+		ccs_datum_t value = ccs_float(i);
+		err = ccs_create_features(fspace, 1, &value, features + i);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_create_random_features_tuner(
+		"batch", cspace, fspace, ospace, &tuner_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_random_features_tuner(
+		"single", cspace, fspace, ospace, &tuner_single);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	for (size_t i = 0; i < 300; i++) {
+		ccs_datum_t values[2], res[2];
+		err = ccs_features_tuner_ask(
+			tuner_batch, features[i % 3], 1, &configuration, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_configuration_get_values(
+			configuration, 2, values, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		/* integral objectives, so that equivalent evaluations occur */
+		res[0] = ccs_float((long)(values[0].value.f + i % 3));
+		res[1] = ccs_float(
+			(long)(values[1].value.f - values[0].value.f));
+		err = ccs_create_features_evaluation(
+			ospace, configuration, features[i % 3],
+			CCS_RESULT_SUCCESS, 2, res, evaluations + i);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(configuration);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	/* telling a batch or its evaluations one at a time gives the same
+	 * optima, in the same order */
+	err = ccs_features_tuner_tell(tuner_batch, 300, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 300; i++) {
+		err = ccs_features_tuner_tell(tuner_single, 1, evaluations + i);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_features_tuner_get_optima(
+		tuner_batch, NULL, 300, optima_batch, &count_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_features_tuner_get_optima(
+		tuner_single, NULL, 300, optima_single, &count_single);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count_batch > 3);
+	assert(count_batch == count_single);
+	for (size_t i = 0; i < count_batch; i++)
+		assert(optima_batch[i] == optima_single[i]);
+
+	for (size_t i = 0; i < 300; i++) {
+		err = ccs_release_object(evaluations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	for (size_t i = 0; i < 3; i++) {
+		err = ccs_release_object(features[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(tuner_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner_single);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(feature);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(fspace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test();
 	test_evaluation_deserialize();
+	test_nearest_features();
+	test_suggest_values();
+	test_batch_tell();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
@@ -277,12 +277,326 @@ test_tree_evaluation_deserialize()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static ccs_result_t
+depth_key(
+	ccs_tree_space_t   tree_space,
+	size_t             num_values,
+	const ccs_datum_t *values,
+	void              *user_data,
+	ccs_datum_t       *key_ret)
+{
+	(void)tree_space;
+	(void)values;
+	(void)user_data;
+	*key_ret = ccs_int(num_values);
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_result_t
+constant_key(
+	ccs_tree_space_t   tree_space,
+	size_t             num_values,
+	const ccs_datum_t *values,
+	void              *user_data,
+	ccs_datum_t       *key_ret)
+{
+	(void)tree_space;
+	(void)num_values;
+	(void)values;
+	*key_ret = ccs_string((const char *)user_data);
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Keys of different types sharing the same raw value. */
+static ccs_result_t
+typed_key(
+	ccs_tree_space_t   tree_space,
+	size_t             num_values,
+	const ccs_datum_t *values,
+	void              *user_data,
+	ccs_datum_t       *key_ret)
+{
+	(void)tree_space;
+	(void)values;
+	(void)user_data;
+	*key_ret = ccs_int(1);
+	if (num_values > 2)
+		key_ret->type = CCS_DATA_TYPE_FLOAT;
+	return CCS_RESULT_SUCCESS;
+}
+
+/* Fails once the integer pointed to by user_data is set. */
+static ccs_result_t
+failing_key(
+	ccs_tree_space_t   tree_space,
+	size_t             num_values,
+	const ccs_datum_t *values,
+	void              *user_data,
+	ccs_datum_t       *key_ret)
+{
+	(void)tree_space;
+	(void)values;
+	if (*(int *)user_data)
+		return CCS_RESULT_ERROR_INVALID_VALUE;
+	*key_ret = ccs_int(num_values);
+	return CCS_RESULT_SUCCESS;
+}
+
+static ccs_tree_configuration_t
+create_configuration(
+	ccs_tree_space_t tree_space,
+	size_t           position_size,
+	const size_t    *position)
+{
+	ccs_tree_configuration_t configuration;
+	ccs_result_t             err;
+	err = ccs_create_tree_configuration(
+		tree_space, position_size, position, &configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+	return configuration;
+}
+
+static void
+tell_configuration(
+	ccs_tree_tuner_t         tuner,
+	ccs_objective_space_t    ospace,
+	ccs_tree_configuration_t configuration,
+	double                   value)
+{
+	ccs_tree_evaluation_t evaluation;
+	ccs_datum_t           res = ccs_float(value);
+	ccs_result_t          err;
+	err = ccs_create_tree_evaluation(
+		ospace, configuration, CCS_RESULT_SUCCESS, 1, &res,
+		&evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_tuner_tell(tuner, 1, &evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+/* Check the evaluation of configuration built from the transposition table,
+ * if any. */
+static void
+check_transposition(
+	ccs_tree_space_t         tree_space,
+	ccs_tree_configuration_t configuration,
+	int                      found,
+	double                   value)
+{
+	ccs_tree_evaluation_t    evaluation;
+	ccs_tree_configuration_t evaluated;
+	ccs_datum_t              res;
+	ccs_result_t             err;
+	err = ccs_tree_space_get_transposition(
+		tree_space, configuration, &evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+	if (!found) {
+		assert(!evaluation);
+		return;
+	}
+	assert(evaluation);
+	err = ccs_tree_evaluation_get_configuration(evaluation, &evaluated);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(evaluated == configuration);
+	err = ccs_tree_evaluation_get_objective_value(evaluation, 0, &res);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(res.value.f == value);
+	err = ccs_release_object(evaluation);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static void
+destroy_tree_space(ccs_object_t object, void *user_data)
+{
+	(void)object;
+	*(int *)user_data = 1;
+}
+
+void
+test_transpositions()
+{
+	ccs_tree_space_t         tree_space;
+	ccs_objective_space_t    ospace;
+	ccs_tree_tuner_t         tuner;
+	ccs_tree_configuration_t c1, c2, c00, croot, configuration;
+	ccs_tree_evaluation_t    history[32];
+	ccs_datum_t              res;
+	size_t                   count;
+	ccs_result_t             err;
+	const size_t             p1[] = {1}, p2[] = {2}, p00[] = {0, 0};
+
+	create_tree_tuning_problem(&tree_space, &ospace);
+	err = ccs_create_random_tree_tuner(
+		"problem", tree_space, ospace, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &depth_key, NULL, 0);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &depth_key, NULL, 2);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	c1    = create_configuration(tree_space, 1, p1);
+	c2    = create_configuration(tree_space, 1, p2);
+	c00   = create_configuration(tree_space, 2, p00);
+	croot = create_configuration(tree_space, 0, NULL);
+
+	/* positions at the same depth are transpositions of each other */
+	check_transposition(tree_space, c2, 0, 0.0);
+	tell_configuration(tuner, ospace, c1, 1.0);
+	check_transposition(tree_space, c2, 1, 1.0);
+	check_transposition(tree_space, c00, 0, 0.0);
+
+	/* the oldest entry is evicted once the table is full */
+	tell_configuration(tuner, ospace, c00, 2.0);
+	tell_configuration(tuner, ospace, croot, 3.0);
+	check_transposition(tree_space, c2, 0, 0.0);
+	check_transposition(tree_space, c00, 1, 2.0);
+
+	/* when every state is known, the tuner is told the recorded
+	 * evaluation for each configuration it would have suggested */
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &constant_key, (void *)"state", 16);
+	assert(err == CCS_RESULT_SUCCESS);
+	tell_configuration(tuner, ospace, c1, 4.0);
+	err = ccs_tree_tuner_ask(tuner, 1, &configuration, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 1);
+	err = ccs_tree_tuner_get_history(tuner, 32, history, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 4 + 16);
+	for (size_t i = 4; i < count; i++) {
+		err = ccs_tree_evaluation_get_objective_value(
+			history[i], 0, &res);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(res.value.f == 4.0);
+	}
+	err = ccs_release_object(configuration);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* keys only match if their types do */
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &typed_key, NULL, 16);
+	assert(err == CCS_RESULT_SUCCESS);
+	tell_configuration(tuner, ospace, c1, 5.0);
+	check_transposition(tree_space, c00, 0, 0.0);
+	tell_configuration(tuner, ospace, c00, 6.0);
+	check_transposition(tree_space, c00, 1, 6.0);
+	check_transposition(tree_space, c2, 1, 5.0);
+
+	err = ccs_tree_space_set_transposition_table(tree_space, NULL, NULL, 0);
+	assert(err == CCS_RESULT_SUCCESS);
+	check_transposition(tree_space, c2, 0, 0.0);
+
+	err = ccs_release_object(c1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(c2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(c00);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(croot);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+/* A populated transposition table must not keep its tree space alive. */
+void
+test_transpositions_release()
+{
+	ccs_tree_space_t         tree_space;
+	ccs_objective_space_t    ospace;
+	ccs_tree_tuner_t         tuner;
+	ccs_tree_configuration_t c1;
+	ccs_result_t             err;
+	int                      destroyed = 0;
+	const size_t             p1[]      = {1};
+
+	create_tree_tuning_problem(&tree_space, &ospace);
+	err = ccs_object_set_destroy_callback(
+		tree_space, &destroy_tree_space, &destroyed);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_random_tree_tuner(
+		"problem", tree_space, ospace, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &depth_key, NULL, 16);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	c1 = create_configuration(tree_space, 1, p1);
+	tell_configuration(tuner, ospace, c1, 1.0);
+	check_transposition(tree_space, c1, 1, 1.0);
+
+	err = ccs_release_object(c1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(destroyed);
+}
+
+/* Configurations suggested before a transposition table failure are not
+ * returned. */
+void
+test_transpositions_error()
+{
+	ccs_tree_space_t         tree_space;
+	ccs_objective_space_t    ospace;
+	ccs_tree_tuner_t         tuner;
+	ccs_tree_configuration_t configurations[4];
+	size_t                   count;
+	ccs_result_t             err;
+	int                      fail = 0;
+
+	create_tree_tuning_problem(&tree_space, &ospace);
+	err = ccs_create_random_tree_tuner(
+		"problem", tree_space, ospace, &tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_space_set_transposition_table(
+		tree_space, &failing_key, &fail, 16);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	fail = 1;
+	err  = ccs_tree_tuner_ask(tuner, 4, configurations, &count);
+	assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+	for (size_t i = 0; i < 4; i++)
+		assert(!configurations[i]);
+	fail = 0;
+	err  = ccs_tree_tuner_ask(tuner, 4, configurations, &count);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count == 4);
+	for (size_t i = 0; i < 4; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_release_object(tuner);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test();
 	test_tree_evaluation_deserialize();
+	test_transpositions();
+	test_transpositions_release();
+	test_transpositions_error();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
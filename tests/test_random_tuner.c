@@ -280,12 +280,156 @@ test_evaluation_deserialize()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static ccs_float_t
+coarse(ccs_float_t v)
+{
+	return (ccs_float_t)(long)(v * 2.0) / 2.0;
+}
+
+void
+test_batch_tell()
+{
+	ccs_parameter_t           parameter1, parameter2;
+	ccs_parameter_t           parameter3, parameter4;
+	ccs_configuration_space_t cspace;
+	ccs_objective_space_t     ospace;
+	ccs_expression_t          expression1, expression2;
+	ccs_tuner_t               tuner_batch, tuner_single;
+	ccs_configuration_t       configurations[500];
+	ccs_evaluation_t          evaluations[500];
+	ccs_evaluation_t          optima_batch[500], optima_single[500];
+	size_t                    count_batch, count_single;
+	ccs_result_t              err;
+
+	parameter1 = create_numerical("x", -5.0, 5.0);
+	parameter2 = create_numerical("y", -5.0, 5.0);
+	err        = ccs_create_configuration_space("2dplane", &cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter1, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_configuration_space_add_parameter(cspace, parameter2, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	/* two conflicting objectives, rounded so that equivalent evaluations
+	 * occur */
+	parameter3 = create_numerical("u", -CCS_INFINITY, CCS_INFINITY);
+	parameter4 = create_numerical("v", -CCS_INFINITY, CCS_INFINITY);
+	err        = ccs_create_variable(parameter3, &expression1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_variable(parameter4, &expression2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_objective_space("distances", &ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_parameter(ospace, parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression1, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_objective_space_add_objective(
+		ospace, expression2, CCS_OBJECTIVE_TYPE_MINIMIZE);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_create_random_tuner("batch", cspace, ospace, &tuner_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_random_tuner("single", cspace, ospace, &tuner_single);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_tuner_ask(tuner_batch, 500, configurations, NULL);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 500; i++) {
+		ccs_evaluation_result_t result =
+			i % 50 ? CCS_RESULT_SUCCESS :
+				 CCS_RESULT_ERROR_INVALID_VALUE;
+		ccs_datum_t             values[2], res[2];
+		err = ccs_configuration_get_values(
+			configurations[i], 2, values, NULL);
+		assert(err == CCS_RESULT_SUCCESS);
+		res[0] = ccs_float(coarse(
+			values[0].value.f * values[0].value.f +
+			values[1].value.f * values[1].value.f));
+		res[1] = ccs_float(coarse(
+			(values[0].value.f - 2) * (values[0].value.f - 2) +
+			values[1].value.f * values[1].value.f));
+		err = ccs_create_evaluation(
+			ospace, configurations[i], result, 2, res,
+			evaluations + i);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	/* telling a batch or its evaluations one at a time gives the same
+	 * optima, in the same order */
+	err = ccs_tuner_tell(tuner_batch, 200, evaluations);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_tell(tuner_batch, 300, evaluations + 200);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 500; i++) {
+		err = ccs_tuner_tell(tuner_single, 1, evaluations + i);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_tuner_get_optima(
+		tuner_batch, 500, optima_batch, &count_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tuner_get_optima(
+		tuner_single, 500, optima_single, &count_single);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(count_batch > 1);
+	assert(count_batch == count_single);
+	for (size_t i = 0; i < count_batch; i++)
+		assert(optima_batch[i] == optima_single[i]);
+
+	/* no evaluation is better than an optimum */
+	for (size_t i = 0; i < count_batch; i++)
+		for (size_t j = 0; j < 500; j++) {
+			ccs_evaluation_result_t result;
+			ccs_comparison_t        cmp;
+			err = ccs_evaluation_get_result(
+				evaluations[j], &result);
+			assert(err == CCS_RESULT_SUCCESS);
+			if (result || evaluations[j] == optima_batch[i])
+				continue;
+			err = ccs_evaluation_compare(
+				evaluations[j], optima_batch[i], &cmp);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(cmp != CCS_COMPARISON_BETTER);
+		}
+
+	for (size_t i = 0; i < 500; i++) {
+		err = ccs_release_object(configurations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(evaluations[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_release_object(tuner_batch);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tuner_single);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(expression2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter1);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter2);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(parameter4);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(cspace);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(ospace);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test();
 	test_evaluation_deserialize();
+	test_batch_tell();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
@@ -1,6 +1,7 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <string.h>
+#include <math.h>
 #include <cconfigspace.h>
 
 #define NUM_SAMPLES 200000
@@ -252,11 +253,395 @@ test_static_tree_space()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+void
+test_frozen_tree_space()
+{
+	ccs_result_t             err;
+	ccs_tree_t               root, tree, child;
+	ccs_tree_space_t         tree_space;
+	ccs_bool_t               is_frozen, is_valid;
+	size_t                   position_size, position[3], depths[5];
+	size_t                   counts[6];
+	ccs_datum_t              values[4];
+	ccs_float_t              areas[5] = {1.0, 4.0, 6.0, 8.0, 5.0};
+	ccs_float_t              inv_sum;
+	ccs_tree_configuration_t configs[NUM_SAMPLES];
+
+	generate_tree(&root, 4, 0);
+	err = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_static_tree_space_is_frozen(tree_space, &is_frozen);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(is_frozen == CCS_FALSE);
+	err = ccs_static_tree_space_freeze(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_static_tree_space_freeze(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_static_tree_space_is_frozen(tree_space, &is_frozen);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(is_frozen == CCS_TRUE);
+
+	position[0] = 1;
+	position[1] = 1;
+	err         = ccs_tree_space_get_node_at_position(
+                tree_space, 2, position, &tree);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_value(tree, values);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(values[0].value.i == 200 + 1);
+	err = ccs_tree_space_get_values_at_position(
+		tree_space, 2, position, 4, values);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(values[0].value.i == 400 + 0);
+	assert(values[1].value.i == 300 + 1);
+	assert(values[2].value.i == 200 + 1);
+	assert(values[3].type == CCS_DATA_TYPE_NONE);
+	position[1] = 3;
+	err         = ccs_tree_space_get_node_at_position(
+                tree_space, 2, position, &tree);
+	assert(err == CCS_RESULT_ERROR_OUT_OF_BOUNDS);
+	err = ccs_tree_space_check_position(
+		tree_space, 2, position, &is_valid);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(is_valid == CCS_FALSE);
+
+	err = ccs_tree_set_weight(root, 2.0);
+	assert(err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+	err = ccs_tree_set_bias(tree, 2.0);
+	assert(err == CCS_RESULT_ERROR_UNSUPPORTED_OPERATION);
+
+	err = ccs_tree_space_samples(tree_space, NUM_SAMPLES, configs);
+	assert(err == CCS_RESULT_SUCCESS);
+	inv_sum = 0;
+	for (size_t i = 0; i < 5; i++) {
+		depths[i] = 0;
+		inv_sum += areas[i];
+	}
+	inv_sum = 1.0 / inv_sum;
+	for (size_t i = 0; i < NUM_SAMPLES; i++) {
+		err = ccs_tree_space_check_configuration(
+			tree_space, configs[i], &is_valid);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(is_valid == CCS_TRUE);
+		err = ccs_tree_configuration_get_position(
+			configs[i], 0, NULL, &position_size);
+		assert(err == CCS_RESULT_SUCCESS);
+		depths[position_size]++;
+		err = ccs_release_object(configs[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	for (size_t i = 0; i < 5; i++) {
+		ccs_float_t target = NUM_SAMPLES * areas[i] * inv_sum;
+		assert(depths[i] >= target * 0.95 &&
+		       depths[i] <= target * 1.05);
+	}
+
+	err = ccs_static_tree_space_thaw(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_static_tree_space_is_frozen(tree_space, &is_frozen);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(is_frozen == CCS_FALSE);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	// Unset children and weight updates between freezes
+	err = ccs_create_tree(3, ccs_int(0), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_tree(2, ccs_int(1), &child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_child(root, 2, child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	for (int pass = 0; pass < 2; pass++) {
+		err = ccs_static_tree_space_freeze(tree_space);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_space_samples(tree_space, NUM_SAMPLES, configs);
+		assert(err == CCS_RESULT_SUCCESS);
+		for (size_t i = 0; i < 6; i++)
+			counts[i] = 0;
+		for (size_t i = 0; i < NUM_SAMPLES; i++) {
+			err = ccs_tree_configuration_get_position(
+				configs[i], 3, position, &position_size);
+			assert(err == CCS_RESULT_SUCCESS);
+			err = ccs_tree_space_check_configuration(
+				tree_space, configs[i], &is_valid);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(is_valid == CCS_TRUE);
+			if (position_size == 0)
+				counts[0]++;
+			else if (position_size == 1)
+				counts[1 + position[0]]++;
+			else {
+				assert(position[0] == 2);
+				counts[4 + position[1]]++;
+			}
+			err = ccs_release_object(configs[i]);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+		// child 2 subtree weighs 3 in the first pass, 0 in the second
+		for (size_t i = 0; i < 6; i++) {
+			ccs_float_t target = NUM_SAMPLES / 6.0;
+			if (pass)
+				target = i < 3 ? NUM_SAMPLES / 3.0 : 0.0;
+			assert(counts[i] >= target * 0.95 &&
+			       counts[i] <= target * 1.05);
+		}
+		position[0] = 0;
+		err         = ccs_tree_space_get_node_at_position(
+                        tree_space, 1, position, &tree);
+		assert(err == CCS_RESULT_ERROR_INVALID_TREE);
+		err = ccs_tree_space_check_position(
+			tree_space, 1, position, &is_valid);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(is_valid == CCS_TRUE);
+		err = ccs_static_tree_space_thaw(tree_space);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_bias(child, 0.0);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_static_tree_space_freeze(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	err = ccs_release_object(child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+void
+test_configuration_cache()
+{
+	ccs_result_t             err;
+	ccs_tree_t               root, child, tree;
+	ccs_tree_space_t         tree_space;
+	ccs_tree_configuration_t config, configs[100];
+	ccs_datum_t              values[4];
+	size_t                   position[2] = {2, 1}, num_values;
+
+	err = ccs_create_tree(3, ccs_int(0), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_tree(2, ccs_int(1), &child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_child(root, 2, child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	// Sampled configurations know their node
+	err = ccs_tree_space_samples(tree_space, 100, configs);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < 100; i++) {
+		size_t position_size, pos[2];
+		err = ccs_tree_configuration_get_position(
+			configs[i], 2, pos, &position_size);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_configuration_get_node(configs[i], &tree);
+		if (position_size == 0)
+			assert(err == CCS_RESULT_SUCCESS && tree == root);
+		else if (position_size == 1 && pos[0] == 2)
+			assert(err == CCS_RESULT_SUCCESS && tree == child);
+		else
+			assert(err == CCS_RESULT_ERROR_INVALID_TREE);
+		err = ccs_release_object(configs[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	// Failed lookups are not cached
+	err = ccs_create_tree_configuration(tree_space, 2, position, &config);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_configuration_get_node(config, &tree);
+	assert(err == CCS_RESULT_ERROR_INVALID_TREE);
+	err = ccs_tree_configuration_get_values(config, 3, values, NULL);
+	assert(err == CCS_RESULT_ERROR_INVALID_TREE);
+	err = ccs_create_tree(0, ccs_int(2), &tree);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_child(child, 1, tree);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	for (int i = 0; i < 2; i++) {
+		err = ccs_tree_configuration_get_node(config, &tree);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_get_value(tree, values);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(values[0].value.i == 2);
+		err = ccs_tree_configuration_get_values(
+			config, 2, values, NULL);
+		assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+		err = ccs_tree_configuration_get_values(
+			config, 4, values, &num_values);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(num_values == 3);
+		assert(values[0].value.i == 0);
+		assert(values[1].value.i == 1);
+		assert(values[2].value.i == 2);
+		assert(values[3].type == CCS_DATA_TYPE_NONE);
+	}
+
+	err = ccs_release_object(config);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(child);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+/* Node weights and biases used by the sampling distribution test: nodes of
+ * weight 0 can never be selected, some subtrees are favored by their bias. */
+static void
+weigh_tree(ccs_tree_t tree, size_t depth, size_t index)
+{
+	ccs_result_t err;
+	size_t       arity;
+
+	err = ccs_tree_set_weight(tree, (depth + index) % 3);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_bias(tree, index % 2 ? 2.0 : 1.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		weigh_tree(child, depth + 1, i);
+	}
+}
+
+static ccs_float_t
+subtree_weight(ccs_tree_t tree)
+{
+	ccs_result_t err;
+	ccs_float_t  weight, bias;
+	size_t       arity;
+
+	err = ccs_tree_get_weight(tree, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_bias(tree, &bias);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		weight += subtree_weight(child);
+	}
+	return weight * bias;
+}
+
+/* Nodes are identified by their position, read as a base 5 number with
+ * digits offset by one. */
+#define MAX_NODE_ID 3125
+
+static void
+expected_distribution(
+	ccs_tree_t   tree,
+	size_t       id,
+	ccs_float_t  probability,
+	ccs_float_t *expected)
+{
+	ccs_result_t err;
+	ccs_float_t  weight, total, child_weights[4];
+	size_t       arity;
+
+	err = ccs_tree_get_weight(tree, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_get_arity(tree, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	total = weight;
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		child_weights[i] = subtree_weight(child);
+		total += child_weights[i];
+	}
+	expected[id] = probability * weight / total;
+	for (size_t i = 0; i < arity; i++) {
+		ccs_tree_t child;
+		if (child_weights[i] == 0.0)
+			continue;
+		err = ccs_tree_get_child(tree, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		expected_distribution(
+			child, id * 5 + i + 1,
+			probability * child_weights[i] / total, expected);
+	}
+}
+
+void
+test_sampling_distribution()
+{
+	ccs_result_t                    err;
+	ccs_tree_t                      root;
+	ccs_tree_space_t                tree_space;
+	ccs_bool_t                      is_valid;
+	size_t                          position_size, position[4], id;
+	static size_t                   counts[MAX_NODE_ID];
+	static ccs_float_t              expected[MAX_NODE_ID];
+	static ccs_tree_configuration_t configs[NUM_SAMPLES];
+
+	generate_tree(&root, 4, 0);
+	weigh_tree(root, 0, 0);
+	err = ccs_create_static_tree_space("space", root, &tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+	expected_distribution(root, 0, 1.0, expected);
+
+	err = ccs_tree_space_samples(tree_space, NUM_SAMPLES, configs);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < NUM_SAMPLES; i++) {
+		err = ccs_tree_configuration_get_position(
+			configs[i], 4, position, &position_size);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_space_check_position(
+			tree_space, position_size, position, &is_valid);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(is_valid == CCS_TRUE);
+		id = 0;
+		for (size_t j = 0; j < position_size; j++)
+			id = id * 5 + position[j] + 1;
+		counts[id]++;
+		err = ccs_release_object(configs[i]);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	/* stopping at a node of weight 0, or entering a subtree of weight 0,
+	 * never happens; other outcomes are within 6 standard deviations */
+	for (id = 0; id < MAX_NODE_ID; id++) {
+		ccs_float_t mean = NUM_SAMPLES * expected[id];
+		if (expected[id] == 0.0)
+			assert(counts[id] == 0);
+		else
+			assert(fabs(counts[id] - mean) <=
+			       6.0 * sqrt(mean * (1.0 - expected[id])) + 1.0);
+	}
+	assert(expected[0] == 0.0);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(tree_space);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test_static_tree_space();
+	test_frozen_tree_space();
+	test_configuration_cache();
+	test_sampling_distribution();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
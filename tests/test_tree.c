@@ -281,11 +281,311 @@ test_tree()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+void
+test_wide_tree()
+{
+	const size_t arity = 1000;
+	ccs_tree_t   root, child;
+	ccs_rng_t    rng;
+	ccs_float_t  areas[arity + 1];
+	size_t       samples[NUM_SAMPLES];
+	int          counts[arity + 1];
+	ccs_result_t err;
+
+	err = ccs_create_rng(&rng);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_tree(arity, ccs_int(0), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_weight(root, 0.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i <= arity; i++)
+		areas[i] = 0.0;
+
+	for (size_t i = 0; i < arity; i++) {
+		err = ccs_create_tree(0, ccs_int(i + 1), &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_child(root, i, child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_release_object(child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_weight(child, 0.0);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_tree_sample(root, rng, samples);
+	assert(err == CCS_RESULT_ERROR_INVALID_DISTRIBUTION);
+
+	for (size_t i = 0; i < arity; i += 97) {
+		err = ccs_tree_get_child(root, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_weight(child, 1.0 + i % 3);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_bias(child, 2.0);
+		assert(err == CCS_RESULT_SUCCESS);
+		areas[i] = 2.0 * (1.0 + i % 3);
+	}
+	err = ccs_tree_set_weight(root, 4.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	areas[arity] = 4.0;
+
+	err = ccs_tree_samples(root, rng, NUM_SAMPLES, samples);
+	assert(err == CCS_RESULT_SUCCESS);
+	check_samples(arity + 1, areas, counts, NUM_SAMPLES, samples);
+
+	for (size_t i = 0; i < arity; i += 97) {
+		err = ccs_tree_get_child(root, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_bias(child, 0.0);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	err = ccs_tree_set_weight(root, 0.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_sample(root, rng, samples);
+	assert(err == CCS_RESULT_ERROR_INVALID_DISTRIBUTION);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(rng);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+static void
+check_sparse_samples(
+	ccs_tree_t  root,
+	ccs_rng_t   rng,
+	ccs_float_t own_area,
+	ccs_float_t children_area,
+	ccs_float_t untouched_area)
+{
+	size_t       arity, samples[NUM_SAMPLES];
+	ccs_tree_t   child;
+	ccs_float_t  bias;
+	int          own = 0, children = 0, untouched = 0;
+	ccs_float_t  sum, target;
+	ccs_result_t err;
+
+	err = ccs_tree_get_arity(root, &arity);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_samples(root, rng, NUM_SAMPLES, samples);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 0; i < NUM_SAMPLES; i++) {
+		if (samples[i] == arity) {
+			own++;
+			continue;
+		}
+		assert(samples[i] < arity);
+		err = ccs_tree_get_child(root, samples[i], &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (child) {
+			err = ccs_tree_get_bias(child, &bias);
+			assert(err == CCS_RESULT_SUCCESS);
+			assert(bias > 0.0);
+			children++;
+		} else
+			untouched++;
+	}
+	sum    = own_area + children_area + untouched_area;
+	target = NUM_SAMPLES * own_area / sum;
+	assert(own >= target * 0.9 && own <= target * 1.1);
+	target = NUM_SAMPLES * children_area / sum;
+	assert(children >= target * 0.9 && children <= target * 1.1);
+	target = NUM_SAMPLES * untouched_area / sum;
+	assert(untouched >= target * 0.9 && untouched <= target * 1.1);
+}
+
+void
+test_sparse_tree()
+{
+	const size_t arity        = 1000000;
+	const size_t num_children = 50;
+	ccs_tree_t   root, child, *children;
+	ccs_rng_t    rng;
+	ccs_datum_t  value;
+	ccs_float_t  weight;
+	size_t       index, num_children_ret, buff_size;
+	char        *buff;
+	ccs_result_t err;
+
+	err = ccs_create_rng(&rng);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_create_tree(arity, ccs_int(0), &root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_tree_set_weight(root, 100000.0);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	// set children out of order, every other one with a null weight
+	for (size_t i = 1; i <= num_children; i++) {
+		index = (i * 48271) % arity;
+		err   = ccs_create_tree(0, ccs_int(index), &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (i % 2) {
+			err = ccs_tree_set_bias(child, 10000.0);
+			assert(err == CCS_RESULT_SUCCESS);
+		} else {
+			err = ccs_tree_set_weight(child, 0.0);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+		err = ccs_tree_set_child(root, index, child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_child(root, index, child);
+		assert(err == CCS_RESULT_ERROR_INVALID_VALUE);
+		err = ccs_release_object(child);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	children = (ccs_tree_t *)malloc(arity * sizeof(ccs_tree_t));
+	assert(children);
+	err = ccs_tree_get_children(
+		root, arity, children, &num_children_ret);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(num_children_ret == arity);
+	num_children_ret = 0;
+	for (size_t i = 0; i < arity; i++) {
+		err = ccs_tree_get_child(root, i, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(child == children[i]);
+		if (!child)
+			continue;
+		num_children_ret++;
+		err = ccs_tree_get_value(child, &value);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(value.value.i == (ccs_int_t)i);
+		err = ccs_tree_get_parent(child, &child, &index);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(child == root && index == i);
+	}
+	assert(num_children_ret == num_children);
+	free(children);
+
+	err = ccs_tree_get_weight(root, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(weight == 100000.0);
+	check_sparse_samples(
+		root, rng, 100000.0, 10000.0 * num_children / 2,
+		arity - num_children);
+
+	err = ccs_object_serialize(
+		root, CCS_SERIALIZE_FORMAT_BINARY, CCS_SERIALIZE_OPERATION_SIZE,
+		&buff_size, CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	buff = (char *)malloc(buff_size);
+	assert(buff);
+	err = ccs_object_serialize(
+		root, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_object_deserialize(
+		(ccs_object_t *)&root, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_DESERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	free(buff);
+
+	for (size_t i = 1; i <= num_children; i++) {
+		index = (i * 48271) % arity;
+		err   = ccs_tree_get_child(root, index, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(child);
+		err = ccs_tree_get_value(child, &value);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(value.value.i == (ccs_int_t)index);
+	}
+	check_sparse_samples(
+		root, rng, 100000.0, 10000.0 * num_children / 2,
+		arity - num_children);
+
+	// only untouched children remain
+	err = ccs_tree_set_weight(root, 0.0);
+	assert(err == CCS_RESULT_SUCCESS);
+	for (size_t i = 1; i <= num_children; i += 2) {
+		err = ccs_tree_get_child(root, (i * 48271) % arity, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_tree_set_bias(child, 0.0);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+	check_sparse_samples(root, rng, 0.0, 0.0, arity - num_children);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(rng);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
+// trees deeper than the call stack can hold
+void
+test_deep_tree()
+{
+	const size_t depth = 1000000;
+	ccs_tree_t   root = NULL, tree, child;
+	ccs_datum_t  value;
+	ccs_float_t  weight;
+	size_t       buff_size, count;
+	char        *buff;
+	ccs_result_t err;
+
+	for (size_t i = depth; i > 0; i--) {
+		err = ccs_create_tree(2, ccs_int(i - 1), &tree);
+		assert(err == CCS_RESULT_SUCCESS);
+		if (root) {
+			err = ccs_tree_set_child(tree, 1, root);
+			assert(err == CCS_RESULT_SUCCESS);
+			err = ccs_release_object(root);
+			assert(err == CCS_RESULT_SUCCESS);
+		}
+		root = tree;
+	}
+
+	err = ccs_object_serialize(
+		root, CCS_SERIALIZE_FORMAT_BINARY, CCS_SERIALIZE_OPERATION_SIZE,
+		&buff_size, CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	buff = (char *)malloc(buff_size);
+	assert(buff);
+	err = ccs_object_serialize(
+		root, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_SERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+	err = ccs_object_deserialize(
+		(ccs_object_t *)&root, CCS_SERIALIZE_FORMAT_BINARY,
+		CCS_SERIALIZE_OPERATION_MEMORY, buff_size, buff,
+		CCS_DESERIALIZE_OPTION_END);
+	assert(err == CCS_RESULT_SUCCESS);
+	free(buff);
+
+	err = ccs_tree_get_weight(root, &weight);
+	assert(err == CCS_RESULT_SUCCESS);
+	assert(weight == 1.0);
+	count = 0;
+	for (tree = root; tree; tree = child) {
+		err = ccs_tree_get_value(tree, &value);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(value.value.i == (ccs_int_t)count);
+		err = ccs_tree_get_child(tree, 0, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		assert(!child);
+		err = ccs_tree_get_child(tree, 1, &child);
+		assert(err == CCS_RESULT_SUCCESS);
+		count++;
+	}
+	assert(count == depth);
+
+	err = ccs_release_object(root);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 int
 main()
 {
 	ccs_init();
 	test_tree();
+	test_wide_tree();
+	test_sparse_tree();
+	test_deep_tree();
 	ccs_clear_thread_error();
 	ccs_fini();
 	return 0;
@@ -452,6 +452,55 @@ test_uniform_distribution_strided_samples()
 	assert(err == CCS_RESULT_SUCCESS);
 }
 
+static void
+test_uniform_distribution_strided_consistency()
+{
+	ccs_distribution_t distrib     = NULL;
+	ccs_rng_t          rng         = NULL;
+	ccs_result_t       err         = CCS_RESULT_SUCCESS;
+	const size_t       num_samples = NUM_SAMPLES + 3;
+	ccs_numeric_t      samples[NUM_SAMPLES + 3];
+	ccs_numeric_t      strided_samples[(NUM_SAMPLES + 3) * 2];
+
+	err = ccs_create_rng(&rng);
+	assert(err == CCS_RESULT_SUCCESS);
+
+	// contiguous samples go through the batch kernels, strided ones don't
+	for (int i = 0; i < 8; i++) {
+		ccs_scale_type_t scale = (i & 1) ? CCS_SCALE_TYPE_LOGARITHMIC :
+						   CCS_SCALE_TYPE_LINEAR;
+		if (i & 4)
+			err = ccs_create_uniform_distribution(
+				CCS_NUMERIC_TYPE_INT, CCSI(3), CCSI(1000),
+				scale, CCSI((i & 2) ? 7 : 0), &distrib);
+		else
+			err = ccs_create_uniform_distribution(
+				CCS_NUMERIC_TYPE_FLOAT, CCSF(0.5), CCSF(1000.0),
+				scale, CCSF((i & 2) ? 0.7 : 0.0), &distrib);
+		assert(err == CCS_RESULT_SUCCESS);
+
+		err = ccs_rng_set_seed(rng, 1234);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_distribution_samples(
+			distrib, rng, num_samples, samples);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_rng_set_seed(rng, 1234);
+		assert(err == CCS_RESULT_SUCCESS);
+		err = ccs_distribution_strided_samples(
+			distrib, rng, num_samples, 2, strided_samples);
+		assert(err == CCS_RESULT_SUCCESS);
+
+		for (size_t j = 0; j < num_samples; j++)
+			assert(samples[j].i == strided_samples[j * 2].i);
+
+		err = ccs_release_object(distrib);
+		assert(err == CCS_RESULT_SUCCESS);
+	}
+
+	err = ccs_release_object(rng);
+	assert(err == CCS_RESULT_SUCCESS);
+}
+
 static void
 test_uniform_distribution_soa_samples()
 {
@@ -502,6 +551,7 @@ main()
 	test_uniform_distribution_float_quantize();
 	test_uniform_distribution_float_log_quantize();
 	test_uniform_distribution_strided_samples();
+	test_uniform_distribution_strided_consistency();
 	test_uniform_distribution_soa_samples();
 	ccs_clear_thread_error();
 	ccs_fini();